@@ -93,9 +93,13 @@ int main(int argc, char** argv)
     oskar_settings_log(s);
 
     // Set up the sky model and telescope model.
+    // A chunked sky model file is used directly, if possible.
     oskar_Telescope* tel = 0;
-    oskar_Sky* sky = oskar_settings_to_sky(s, NULL, &status);
-    if (!sky || status)
+    oskar_Sky* sky = 0;
+    const char* sky_file = oskar_settings_to_sky_chunked_file(s, &status);
+    if (!sky_file)
+        sky = oskar_settings_to_sky(s, NULL, &status);
+    if ((!sky && !sky_file) || status)
         oskar_log_error("Failed to set up sky model: %s.",
                 oskar_get_error_string(status));
     else
@@ -109,12 +113,19 @@ int main(int argc, char** argv)
     // Set up the interferometer simulator.
     const char *warning_source_count = 0, *warning_gpu = 0;
     oskar_Interferometer* sim = 0;
-    if (sky && tel)
+    if ((sky || sky_file) && tel)
     {
         sim = oskar_settings_to_interferometer(s, NULL, &status);
-        oskar_interferometer_set_sky_model(sim, sky, &status);
+        if (sky_file)
+        {
+            oskar_log_message('M', 0,
+                    "Using chunked sky model file '%s'", sky_file);
+            oskar_interferometer_set_sky_model_file(sim, sky_file, &status);
+        }
+        else
+            oskar_interferometer_set_sky_model(sim, sky, &status);
         oskar_interferometer_set_telescope_model(sim, tel, &status);
-        if (oskar_sky_num_sources(sky) < 32 &&
+        if (sky && oskar_sky_num_sources(sky) < 32 &&
                 oskar_interferometer_num_gpus(sim) > 0)
         {
             warning_source_count = "It may be faster to use CPU cores only, "
@@ -59,6 +59,26 @@ OSKAR_APPS_EXPORT
 oskar_Sky* oskar_settings_to_sky(oskar::SettingsTree* s,
         oskar_Log* log, int* status);
 
+/**
+ * @brief
+ * Returns the name of a chunked sky model file, if it can be used directly.
+ *
+ * @details
+ * If the sky model settings specify only a single OSKAR binary sky model
+ * file written by oskar_sky_write_chunked(), with no other sources,
+ * filters or overrides, this function returns its pathname, so that it
+ * can be passed to oskar_interferometer_set_sky_model_file().
+ * Otherwise, NULL is returned, and oskar_settings_to_sky() should be used.
+ *
+ * @param[in] s           A pointer to the settings tree.
+ * @param[in,out] status  Status return code.
+ *
+ * @return The pathname of the sky model file, or NULL.
+ */
+OSKAR_APPS_EXPORT
+const char* oskar_settings_to_sky_chunked_file(oskar::SettingsTree* s,
+        int* status);
+
 #endif
 
 #endif /* OSKAR_SETTINGS_TO_SKY_H_ */
@@ -75,6 +75,8 @@ oskar_Imager* oskar_settings_to_imager(oskar::SettingsTree* s,
             s->to_int("scale_norm_with_num_input_files", status));
     oskar_imager_set_ms_column(h,
             s->to_string("ms_column", status), status);
+    oskar_imager_set_coords_cache_size(h,
+            s->to_double("coords_cache_size_mb", status));
     oskar_imager_set_output_root(h, s->to_string("root_path", status));
 
     // Set remaining imager options.
@@ -108,6 +110,11 @@ oskar_Imager* oskar_settings_to_imager(oskar::SettingsTree* s,
     if (!s->starts_with("wproj/num_w_planes", "auto", status))
         oskar_imager_set_num_w_planes(h,
                 s->to_int("wproj/num_w_planes", status));
+    if (s->starts_with("wproj/num_threads", "auto", status))
+        oskar_imager_set_num_threads(h, -1);
+    else
+        oskar_imager_set_num_threads(h,
+                s->to_int("wproj/num_threads", status));
     oskar_imager_set_fft_on_gpu(h, s->to_int("fft/use_gpu", status));
     oskar_imager_set_generate_w_kernels_on_gpu(h,
             s->to_int("wproj/generate_w_kernels_on_gpu", status));
@@ -27,6 +27,7 @@
  */
 
 #include "apps/oskar_settings_to_interferometer.h"
+#include "math/oskar_cmath.h"
 
 #include <cstdlib>
 #include <cstring>
@@ -67,6 +68,11 @@ oskar_Interferometer* oskar_settings_to_interferometer(oskar::SettingsTree* s,
     else
         oskar_interferometer_set_num_devices(h,
                 s->to_int("num_devices", status));
+    if (s->starts_with("num_threads_per_device", "auto", status))
+        oskar_interferometer_set_num_threads_per_device(h, -1);
+    else
+        oskar_interferometer_set_num_threads_per_device(h,
+                s->to_int("num_threads_per_device", status));
     oskar_log_set_keep_file(s->to_int("keep_log_file", status));
     oskar_log_set_file_priority(s->to_int("write_status_to_log_file", status) ?
                     OSKAR_LOG_STATUS : OSKAR_LOG_MESSAGE);
@@ -101,6 +107,8 @@ oskar_Interferometer* oskar_settings_to_interferometer(oskar::SettingsTree* s,
             s->to_string("correlation_type", status), status);
     oskar_interferometer_set_max_times_per_block(h,
             s->to_int("max_time_samples_per_block", status));
+    oskar_interferometer_set_max_channels_per_beam(h,
+            s->to_int("max_channels_per_station_beam", status));
     oskar_interferometer_set_output_vis_file(h,
             s->to_string("oskar_vis_filename", status));
     oskar_interferometer_set_output_measurement_set(h,
@@ -111,6 +119,21 @@ oskar_Interferometer* oskar_settings_to_interferometer(oskar::SettingsTree* s,
             s->to_int("ignore_w_components", status));
     s->end_group();
 
+    // Set ionosphere settings.
+    s->begin_group("ionosphere");
+    if (s->to_int("enable", status))
+    {
+        int num_files = 0;
+        const char* const* files =
+                s->to_string_list("TID_file", &num_files, status);
+        if (num_files > 0)
+            oskar_interferometer_set_ionosphere(h, files[0],
+                    s->to_double("TEC0", status),
+                    s->to_double("min_elevation_deg", status) * M_PI / 180.0,
+                    status);
+    }
+    s->end_group();
+
     // Return handle to interferometer simulator.
     s->clear_group();
     return h;
@@ -28,6 +28,7 @@
 
 #include "apps/oskar_settings_to_sky.h"
 
+#include "binary/oskar_binary.h"
 #include "convert/oskar_convert_brightness_to_jy.h"
 #include "convert/oskar_convert_healpix_ring_to_theta_phi.h"
 #include "math/oskar_healpix_npix_to_nside.h"
@@ -35,6 +36,7 @@
 #include "math/oskar_random_broken_power_law.h"
 #include "sky/oskar_generate_random_coordinate.h"
 #include "sky/oskar_sky.h"
+#include "settings/oskar_SettingsNode.h"
 #include "utility/oskar_get_error_string.h"
 
 #include "math/oskar_cmath.h"
@@ -156,6 +158,45 @@ oskar_Sky* oskar_settings_to_sky(SettingsTree* s, oskar_Log* log, int* status)
 }
 
 
+const char* oskar_settings_to_sky_chunked_file(SettingsTree* s, int* status)
+{
+    int num_files = 0, error = 0;
+    if (*status || !s) return 0;
+
+    /* Check that only the OSKAR sky model file name has been set,
+     * ignoring options used by the simulator itself. */
+    const oskar::SettingsNode* sky = s->root_node()->child("sky");
+    if (!sky) return 0;
+    for (int i = 0; i < sky->num_children(); ++i)
+    {
+        const oskar::SettingsNode* node = sky->child(i);
+        if (!node->value_or_child_set()) continue;
+        if (!strcmp(node->key(), "sky/oskar_sky_model"))
+        {
+            for (int j = 0; j < node->num_children(); ++j)
+                if (node->child(j)->value_or_child_set() &&
+                        strcmp(node->child(j)->key(),
+                                "sky/oskar_sky_model/file"))
+                    return 0;
+        }
+        else if (strcmp(node->key(), "sky/common_flux_filter") &&
+                strcmp(node->key(), "sky/advanced"))
+            return 0;
+    }
+    s->clear_group();
+    const char* const* files = s->to_string_list("sky/oskar_sky_model/file",
+            &num_files, status);
+    if (*status || num_files != 1 || !files[0] || strlen(files[0]) == 0)
+        return 0;
+
+    /* Check the file is chunked. */
+    oskar_Binary* h = oskar_binary_create(files[0], 'r', &error);
+    const int num_chunks = oskar_sky_read_num_chunks(h, &error);
+    oskar_binary_free(h);
+    return (!error && num_chunks > 0) ? files[0] : 0;
+}
+
+
 static void load_osm(oskar_Sky* sky, SettingsTree* s,
         double ra0, double dec0, int* status)
 {
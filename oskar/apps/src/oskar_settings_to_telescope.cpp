@@ -35,6 +35,7 @@
 #include <limits.h>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 
 using oskar::SettingsTree;
 
@@ -71,8 +72,40 @@ oskar_Telescope* oskar_settings_to_telescope(SettingsTree* s,
 
     /************************************************************************/
     /* Load telescope model folders to define the stations. */
-    oskar_telescope_load(t,
-            s->to_string("telescope/input_directory", status), log, status);
+    const char* dir = s->to_string("telescope/input_directory", status);
+    const char* compiled = s->to_string("telescope/compiled_model_file",
+            status);
+    if (compiled && strlen(compiled) > 0)
+    {
+        /* Use the compiled model, if it is up to date. */
+        char* hash = oskar_telescope_source_hash(t, dir, status);
+        oskar_Telescope* tc = oskar_telescope_load_compiled(compiled,
+                hash, status);
+        if (tc)
+        {
+            oskar_log_message('M', 0, "Using compiled telescope model '%s'",
+                    compiled);
+            oskar_telescope_free(t, status);
+            t = tc;
+        }
+        else
+        {
+            oskar_telescope_load(t, dir, log, status);
+            if (!*status)
+            {
+                /* Failure to write the compiled model is not fatal. */
+                int compile_status = 0;
+                oskar_telescope_compile(t, compiled, hash, &compile_status);
+                if (compile_status)
+                    oskar_log_warning("Unable to write compiled telescope "
+                            "model '%s': %s", compiled,
+                            oskar_get_error_string(compile_status));
+            }
+        }
+        free(hash);
+    }
+    else
+        oskar_telescope_load(t, dir, log, status);
     if (*status) return t;
 
     /* Return if no stations were found. */
@@ -265,6 +298,7 @@ void set_station_data(oskar_Station* station, SettingsTree* s, int* status)
     char taper_type = s->first_letter("taper/type", status);
     double cosine_power = s->to_double("taper/cosine_power", status);
     double fwhm_rad = s->to_double("taper/gaussian_fwhm_deg", status) * D2R;
+    int interpolate_freq = s->to_int("interpolate_frequency", status);
     for (int i = 0; i < oskar_station_num_element_types(station); ++i)
     {
         oskar_Element* element = oskar_station_element(station, i);
@@ -273,6 +307,7 @@ void set_station_data(oskar_Station* station, SettingsTree* s, int* status)
         oskar_element_set_taper_type(element, &taper_type, status);
         oskar_element_set_cosine_power(element, cosine_power);
         oskar_element_set_gaussian_fwhm_rad(element, fwhm_rad);
+        oskar_element_set_interpolate_freq(element, interpolate_freq);
     }
 
     /* Recursively set data for child stations. */
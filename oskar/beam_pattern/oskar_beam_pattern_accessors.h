@@ -101,6 +101,10 @@ void oskar_beam_pattern_set_max_chunk_size(oskar_BeamPattern* h, int value);
 OSKAR_EXPORT
 void oskar_beam_pattern_set_num_devices(oskar_BeamPattern* h, int value);
 
+OSKAR_EXPORT
+void oskar_beam_pattern_set_num_threads_per_device(oskar_BeamPattern* h,
+        int value);
+
 OSKAR_EXPORT
 void oskar_beam_pattern_set_observation_frequency(oskar_BeamPattern* h,
         double start_hz, double inc_hz, int num_channels);
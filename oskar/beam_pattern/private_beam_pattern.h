@@ -87,7 +87,7 @@ struct oskar_BeamPattern
 {
     /* Settings. */
     int prec, num_devices, num_gpus_avail, dev_loc, num_gpus, *gpu_ids;
-    int coord_type, max_chunk_size;
+    int num_threads_per_device, coord_type, max_chunk_size;
     int num_time_steps, num_channels, num_chunks;
     int pol_mode, width, height, num_pixels, nside;
     int num_active_stations, *station_ids;
@@ -103,9 +103,7 @@ struct oskar_BeamPattern
     char *root_path, *sky_model_file;
 
     /* State. */
-    oskar_Mutex* mutex;
-    oskar_Barrier* barrier;
-    int i_global, status;
+    int status;
 
     /* Input data. */
     oskar_Mem *x, *y, *z;
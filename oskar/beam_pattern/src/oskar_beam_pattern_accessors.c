@@ -194,6 +194,13 @@ void oskar_beam_pattern_set_num_devices(oskar_BeamPattern* h, int value)
 }
 
 
+void oskar_beam_pattern_set_num_threads_per_device(oskar_BeamPattern* h,
+        int value)
+{
+    h->num_threads_per_device = value;
+}
+
+
 void oskar_beam_pattern_set_observation_frequency(oskar_BeamPattern* h,
         double start_hz, double inc_hz, int num_channels)
 {
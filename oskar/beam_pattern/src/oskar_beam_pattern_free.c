@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2017, The University of Oxford
+ * Copyright (c) 2016-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -42,8 +42,6 @@ void oskar_beam_pattern_free(oskar_BeamPattern* h, int* status)
     oskar_telescope_free(h->tel, status);
     oskar_timer_free(h->tmr_sim);
     oskar_timer_free(h->tmr_write);
-    oskar_mutex_free(h->mutex);
-    oskar_barrier_free(h->barrier);
     free(h->d);
     free(h->root_path);
     free(h->sky_model_file);
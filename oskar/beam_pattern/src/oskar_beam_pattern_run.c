@@ -37,6 +37,7 @@
 #include "utility/oskar_device.h"
 #include "utility/oskar_file_exists.h"
 #include "utility/oskar_get_memory_usage.h"
+#include "utility/oskar_get_thread_budget.h"
 #include "oskar_version.h"
 
 #include <stdlib.h>
@@ -52,11 +53,17 @@
 extern "C" {
 #endif
 
+struct Schedule;
 static void* run_blocks(void* arg);
-static void sim_chunks(oskar_BeamPattern* h, int i_chunk_start, int i_time,
-        int i_channel, int i_active, int device_id, int* status);
-static void write_chunks(oskar_BeamPattern* h, int i_chunk_start, int i_time,
-        int i_channel, int i_active, int* status);
+static int unit_indices(const oskar_BeamPattern* h, int i_unit,
+        int* i_time, int* i_channel);
+static int claim_unit(const oskar_BeamPattern* h, struct Schedule* s,
+        int device_id, int num_free);
+static void sim_chunk(oskar_BeamPattern* h, int i_chunk, int i_time,
+        int i_channel, int slot, int device_id, int* status);
+static void write_chunk(oskar_BeamPattern* h, int i_chunk, int i_time,
+        int i_channel, const DeviceData* src, int slot, DeviceData* d,
+        int* status);
 static void write_pixels(oskar_BeamPattern* h, int i_chunk, int i_time,
         int i_channel, int num_pix, int channel_average, int time_average,
         const oskar_Mem* in, int chunk_desc, int stokes_in, int* status);
@@ -78,18 +85,35 @@ static void record_timing(oskar_BeamPattern* h);
 static unsigned int disp_width(unsigned int value);
 
 
+/* Number of host buffers per device for results waiting to be written. */
+#define NUM_SLOTS 2
+
+/* Work queues and reorder buffer, shared by all threads. */
+struct Schedule
+{
+    oskar_ConditionVar* var;    /* Guards all members, and signals changes. */
+    int num_units;              /* Total number of work units. */
+    int window;                 /* Maximum lead of a queue before stealing. */
+    int* next;                  /* Next unit in each device's queue. */
+    int* slot_unit;             /* Unit held in each host buffer, or -1. */
+    int* slot_ready;            /* True if the unit in the buffer is done. */
+};
+typedef struct Schedule Schedule;
+
 struct ThreadArgs
 {
     oskar_BeamPattern* h;
+    Schedule* s;
     int num_threads, thread_id;
 };
 typedef struct ThreadArgs ThreadArgs;
 
 void oskar_beam_pattern_run(oskar_BeamPattern* h, int* status)
 {
-    int i;
+    int i, num_inner, num_outer;
     oskar_Thread** threads = 0;
     ThreadArgs* args = 0;
+    Schedule s;
     if (*status || !h) return;
 
     /* Check root name exists. */
@@ -103,14 +127,42 @@ void oskar_beam_pattern_run(oskar_BeamPattern* h, int* status)
     /* Initialise if required. */
     oskar_beam_pattern_check_init(h, status);
 
+    /* Set up the work queues. Units of work are pixel chunks at one time
+     * and channel, ordered in the same way as they are written.
+     * Initially, the chunks are shared between the devices in turn, and
+     * each device takes the next unit from its own queue. */
+    const int num_devices = h->num_devices;
+    const int num_groups = (h->num_chunks + num_devices - 1) / num_devices;
+    num_inner = h->average_single_axis != 'T' ?
+            h->num_channels : h->num_time_steps;
+    num_outer = h->average_single_axis != 'T' ?
+            h->num_time_steps : h->num_channels;
+    s.var = oskar_condition_create();
+    s.num_units = num_groups * num_outer * num_inner * num_devices;
+    s.window = NUM_SLOTS * num_devices;
+    s.next = (int*) calloc(num_devices, sizeof(int));
+    s.slot_unit = (int*) calloc(NUM_SLOTS * num_devices, sizeof(int));
+    s.slot_ready = (int*) calloc(NUM_SLOTS * num_devices, sizeof(int));
+    if (!s.var || !s.next || !s.slot_unit || !s.slot_ready)
+    {
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        oskar_condition_free(s.var);
+        free(s.next);
+        free(s.slot_unit);
+        free(s.slot_ready);
+        return;
+    }
+    for (i = 0; i < num_devices; ++i) s.next[i] = i;
+    for (i = 0; i < NUM_SLOTS * num_devices; ++i) s.slot_unit[i] = -1;
+
     /* Set up worker threads. */
-    const int num_threads = h->num_devices + 1;
-    oskar_barrier_set_num_threads(h->barrier, num_threads);
+    const int num_threads = num_devices + 1;
     threads = (oskar_Thread**) calloc(num_threads, sizeof(oskar_Thread*));
     args = (ThreadArgs*) calloc(num_threads, sizeof(ThreadArgs));
     for (i = 0; i < num_threads; ++i)
     {
         args[i].h = h;
+        args[i].s = &s;
         args[i].num_threads = num_threads;
         args[i].thread_id = i;
     }
@@ -132,7 +184,9 @@ void oskar_beam_pattern_run(oskar_BeamPattern* h, int* status)
     /* Start simulation timer. */
     oskar_timer_start(h->tmr_sim);
 
-    /* Start the worker threads. */
+    /* Start the worker threads, logging asynchronously while they run. */
+    const int log_async = oskar_log_async();
+    oskar_log_set_async(1);
     for (i = 0; i < num_threads; ++i)
         threads[i] = oskar_thread_create(run_blocks, (void*)&args[i], 0);
 
@@ -142,6 +196,11 @@ void oskar_beam_pattern_run(oskar_BeamPattern* h, int* status)
         oskar_thread_join(threads[i]);
         oskar_thread_free(threads[i]);
     }
+    oskar_log_set_async(log_async);
+    oskar_condition_free(s.var);
+    free(s.next);
+    free(s.slot_unit);
+    free(s.slot_ready);
     free(threads);
     free(args);
 
@@ -171,106 +230,180 @@ void oskar_beam_pattern_run(oskar_BeamPattern* h, int* status)
 static void* run_blocks(void* arg)
 {
     oskar_BeamPattern* h;
-    int i_inner, i_outer, num_inner, num_outer, c, t, f, *status;
-
-    /* Loop indices for previous iteration (accessed only by thread 0). */
-    int cp = 0, tp = 0, fp = 0;
+    Schedule* s;
+    int i, c, t, f, u, *status;
 
     /* Get thread function arguments. */
     h = ((ThreadArgs*)arg)->h;
+    s = ((ThreadArgs*)arg)->s;
     status = &(h->status);
-    const int num_threads = ((ThreadArgs*)arg)->num_threads;
     const int thread_id = ((ThreadArgs*)arg)->thread_id;
     const int device_id = thread_id - 1;
 
 #ifdef _OPENMP
-    /* Disable any nested parallelism. */
+    /* Disable any nested parallelism, and share the available OpenMP
+     * threads between the compute devices, unless the size of the team
+     * for each device has been set explicitly. */
     omp_set_nested(0);
-    omp_set_num_threads(1);
+    omp_set_num_threads(h->num_threads_per_device > 0 ?
+            h->num_threads_per_device :
+            oskar_get_thread_budget(h->num_devices));
 #endif
 
     if (device_id >= 0 && device_id < h->num_gpus)
         oskar_device_set(h->dev_loc, h->gpu_ids[device_id], status);
 
-    /* Set ranges of inner and outer loops based on averaging mode. */
-    if (h->average_single_axis != 'T')
-    {
-        num_outer = h->num_time_steps;
-        num_inner = h->num_channels; /* Channel on inner loop. */
-    }
-    else
-    {
-        num_outer = h->num_channels;
-        num_inner = h->num_time_steps; /* Time on inner loop. */
-    }
-
-    /* Loop over image pixel chunks, running simulation and file writing one
-     * chunk at a time. Simulation and file output are overlapped by using
-     * double buffering, and a dedicated thread is used for file output.
+    /* Simulation and file output are overlapped by using a pool of host
+     * buffers for each device, and a dedicated thread is used for file
+     * output.
+     *
+     * Thread 0 is used for file writes. It takes the completed units
+     * from the host buffers in order, so the output files are written
+     * in the same order regardless of which device simulated each unit.
      *
-     * Thread 0 is used for file writes.
      * Threads 1 to n (mapped to compute devices) do the simulation.
+     * Each claims a free host buffer, then claims a unit of work,
+     * either from its own queue or by stealing from another device.
      */
-    for (c = 0; c < h->num_chunks; c += h->num_devices)
+    if (thread_id == 0)
     {
-        for (i_outer = 0; i_outer < num_outer; ++i_outer)
+        for (u = 0; u < s->num_units; ++u)
         {
-            for (i_inner = 0; i_inner < num_inner; ++i_inner)
+            int slot = -1;
+            c = unit_indices(h, u, &t, &f);
+            if (c >= h->num_chunks) continue;
+
+            /* Wait for the unit to be completed. */
+            oskar_condition_lock(s->var);
+            while (!*status)
             {
-                /* Set time and channel indices based on averaging mode. */
-                if (h->average_single_axis != 'T')
-                {
-                    t = i_outer;
-                    f = i_inner;
-                }
-                else
-                {
-                    f = i_outer;
-                    t = i_inner;
-                }
-                if (thread_id > 0 || num_threads == 1)
-                    sim_chunks(h, c, t, f, h->i_global & 1, device_id, status);
-                if (thread_id == 0 && h->i_global > 0)
-                    write_chunks(h, cp, tp, fp, h->i_global & 1, status);
-
-                /* Barrier 1: Set indices of the previous chunk(s). */
-                oskar_barrier_wait(h->barrier);
-                if (thread_id == 0)
+                for (i = 0; i < NUM_SLOTS * h->num_devices; ++i)
+                    if (s->slot_unit[i] == u && s->slot_ready[i]) slot = i;
+                if (slot >= 0) break;
+                oskar_condition_wait(s->var);
+            }
+            oskar_condition_unlock(s->var);
+            if (slot < 0) break;
+
+            /* Write it, using the averaging buffers for the position of
+             * the chunk in its group, then release the host buffer. */
+            write_chunk(h, c, t, f, &h->d[slot / NUM_SLOTS], slot % NUM_SLOTS,
+                    &h->d[c % h->num_devices], status);
+            oskar_condition_lock(s->var);
+            s->slot_unit[slot] = -1;
+            oskar_condition_notify_all(s->var);
+            oskar_condition_unlock(s->var);
+        }
+    }
+    else
+    {
+        int* const slot_unit = &s->slot_unit[NUM_SLOTS * device_id];
+        int* const slot_ready = &s->slot_ready[NUM_SLOTS * device_id];
+        for (;;)
+        {
+            int slot = -1, num_free = 0;
+
+            /* Wait for a free host buffer, then claim a unit of work. */
+            oskar_condition_lock(s->var);
+            while (!*status)
+            {
+                for (i = 0; i < NUM_SLOTS; ++i)
                 {
-                    cp = c;
-                    tp = t;
-                    fp = f;
-                    h->i_global++;
+                    if (slot_unit[i] >= 0) continue;
+                    slot = i;
+                    num_free++;
                 }
-
-                /* Barrier 2: Check sim and write are done. */
-                oskar_barrier_wait(h->barrier);
+                if (slot >= 0) break;
+                oskar_condition_wait(s->var);
+            }
+            u = (slot >= 0) ? claim_unit(h, s, device_id, num_free) : -1;
+            if (u >= 0)
+            {
+                slot_unit[slot] = u;
+                slot_ready[slot] = 0;
             }
+            oskar_condition_unlock(s->var);
+            if (u < 0) break;
+
+            /* Simulate it, and signal the writer. */
+            c = unit_indices(h, u, &t, &f);
+            sim_chunk(h, c, t, f, slot, device_id, status);
+            oskar_condition_lock(s->var);
+            slot_ready[slot] = 1;
+            oskar_condition_notify_all(s->var);
+            oskar_condition_unlock(s->var);
         }
     }
+    return 0;
+}
 
-    /* Write the very last chunk(s). */
-    if (thread_id == 0)
-        write_chunks(h, cp, tp, fp, h->i_global & 1, status);
 
-    return 0;
+/* Returns the chunk, time and channel indices of a unit of work.
+ * Units run over chunks fastest, then the inner (time or channel) and
+ * outer loops, then over groups of num_devices chunks. */
+static int unit_indices(const oskar_BeamPattern* h, int i_unit,
+        int* i_time, int* i_channel)
+{
+    const int num_devices = h->num_devices;
+    const int i_step = i_unit / num_devices;
+    const int i_group = i_step / (h->num_channels * h->num_time_steps);
+    if (h->average_single_axis != 'T')
+    {
+        *i_channel = i_step % h->num_channels;
+        *i_time = (i_step / h->num_channels) % h->num_time_steps;
+    }
+    else
+    {
+        *i_time = i_step % h->num_time_steps;
+        *i_channel = (i_step / h->num_time_steps) % h->num_channels;
+    }
+    return i_group * num_devices + i_unit % num_devices;
+}
+
+
+/* Claims the next unit of work for a device, or returns -1 if none are
+ * left. Must be called with the schedule locked. */
+static int claim_unit(const oskar_BeamPattern* h, Schedule* s,
+        int device_id, int num_free)
+{
+    int i, t, f, q = device_id, earliest = -1;
+    const int num_devices = h->num_devices;
+
+    /* Skip units beyond the last chunk, and find the queue holding the
+     * earliest unit. */
+    for (i = 0; i < num_devices; ++i)
+    {
+        while (s->next[i] < s->num_units &&
+                unit_indices(h, s->next[i], &t, &f) >= h->num_chunks)
+            s->next[i] += num_devices;
+        if (s->next[i] < s->num_units &&
+                (earliest < 0 || s->next[i] < s->next[earliest]))
+            earliest = i;
+    }
+    if (earliest < 0) return -1;
+
+    /* Steal the earliest unit if this device's own queue is empty or too
+     * far ahead of the others. The last free host buffer of a device is
+     * always used for the earliest unit, as the writer may be waiting
+     * for it. */
+    if (s->next[q] >= s->num_units || num_free == 1 ||
+            s->next[q] - s->next[earliest] >= s->window)
+        q = earliest;
+    const int i_unit = s->next[q];
+    s->next[q] += num_devices;
+    return i_unit;
 }
 
 
-static void sim_chunks(oskar_BeamPattern* h, int i_chunk_start, int i_time,
-        int i_channel, int i_active, int device_id, int* status)
+static void sim_chunk(oskar_BeamPattern* h, int i_chunk, int i_time,
+        int i_channel, int slot, int device_id, int* status)
 {
     int chunk_size, i;
     DeviceData* d;
 
     /* Check if safe to proceed. */
     if (*status) return;
-
-    /* Get chunk index from GPU ID and chunk start,
-     * and return immediately if it's out of range. */
     d = &h->d[device_id];
-    const int i_chunk = i_chunk_start + device_id;
-    if (i_chunk >= h->num_chunks) return;
 
     /* Get time and frequency values. */
     oskar_timer_resume(d->tmr_compute);
@@ -324,184 +457,173 @@ static void sim_chunks(oskar_BeamPattern* h, int i_chunk_start, int i_time,
                 d->jones_data, 0, d->cross_power[I], status);
 
     /* Copy the output data into host memory. */
-    if (d->jones_data_cpu[i_active])
-        oskar_mem_copy_contents(d->jones_data_cpu[i_active], d->jones_data,
+    if (d->jones_data_cpu[slot])
+        oskar_mem_copy_contents(d->jones_data_cpu[slot], d->jones_data,
                 0, 0, chunk_size * h->num_active_stations, status);
     for (i = 0; i < 4; ++i)
     {
         if (d->auto_power[i])
-            oskar_mem_copy_contents(d->auto_power_cpu[i][i_active],
+            oskar_mem_copy_contents(d->auto_power_cpu[i][slot],
                     d->auto_power[i], 0, 0,
                     chunk_size * h->num_active_stations, status);
         if (d->cross_power[i])
-            oskar_mem_copy_contents(d->cross_power_cpu[i][i_active],
+            oskar_mem_copy_contents(d->cross_power_cpu[i][slot],
                     d->cross_power[i], 0, 0, chunk_size, status);
     }
-    oskar_mutex_lock(h->mutex);
     oskar_log_message('S', 1, "Chunk %*i/%i, "
             "Time %*i/%i, Channel %*i/%i [Device %i]",
             disp_width(h->num_chunks), i_chunk+1, h->num_chunks,
             disp_width(h->num_time_steps), i_time+1, h->num_time_steps,
             disp_width(h->num_channels), i_channel+1, h->num_channels,
             device_id);
-    oskar_mutex_unlock(h->mutex);
     oskar_timer_pause(d->tmr_compute);
 }
 
 
-static void write_chunks(oskar_BeamPattern* h, int i_chunk_start,
-        int i_time, int i_channel, int i_active, int* status)
+static void write_chunk(oskar_BeamPattern* h, int i_chunk, int i_time,
+        int i_channel, const DeviceData* src, int slot, DeviceData* d,
+        int* status)
 {
-    int i, chunk_sources, stokes;
+    int chunk_sources, stokes;
     if (*status) return;
-
-    /* Write inactive chunk(s) from all GPUs. */
     oskar_timer_resume(h->tmr_write);
-    for (i = 0; i < h->num_devices; ++i)
-    {
-        DeviceData* d = &h->d[i];
 
-        /* Get chunk index from GPU ID & chunk start. Stop if out of range. */
-        const int i_chunk = i_chunk_start + i;
-        if (i_chunk >= h->num_chunks || *status) break;
+    /* Get the size of the chunk. */
+    chunk_sources = h->max_chunk_size;
+    if ((i_chunk + 1) * h->max_chunk_size > h->num_pixels)
+        chunk_sources = h->num_pixels - i_chunk * h->max_chunk_size;
+    const int chunk_size = chunk_sources * h->num_active_stations;
 
-        /* Get the size of the chunk. */
-        chunk_sources = h->max_chunk_size;
-        if ((i_chunk + 1) * h->max_chunk_size > h->num_pixels)
-            chunk_sources = h->num_pixels - i_chunk * h->max_chunk_size;
-        const int chunk_size = chunk_sources * h->num_active_stations;
+    /* Write non-averaged raw data, if required. */
+    write_pixels(h, i_chunk, i_time, i_channel, chunk_sources, 0, 0,
+            src->jones_data_cpu[slot], JONES_DATA, -1, status);
 
-        /* Write non-averaged raw data, if required. */
+    /* Loop over Stokes parameters. */
+    for (stokes = 0; stokes < 4; ++stokes)
+    {
+        /* Write non-averaged data, if required. */
         write_pixels(h, i_chunk, i_time, i_channel, chunk_sources, 0, 0,
-                d->jones_data_cpu[!i_active], JONES_DATA, -1, status);
-
-        /* Loop over Stokes parameters. */
-        for (stokes = 0; stokes < 4; ++stokes)
+                src->auto_power_cpu[stokes][slot],
+                AUTO_POWER_DATA, stokes, status);
+        write_pixels(h, i_chunk, i_time, i_channel, chunk_sources, 0, 0,
+                src->cross_power_cpu[stokes][slot],
+                CROSS_POWER_DATA, stokes, status);
+
+        /* Time-average the data if required. */
+        if (d->auto_power_time_avg[stokes])
+            oskar_mem_add(d->auto_power_time_avg[stokes],
+                    d->auto_power_time_avg[stokes],
+                    src->auto_power_cpu[stokes][slot],
+                    0, 0, 0, chunk_size, status);
+        if (d->cross_power_time_avg[stokes])
+            oskar_mem_add(d->cross_power_time_avg[stokes],
+                    d->cross_power_time_avg[stokes],
+                    src->cross_power_cpu[stokes][slot],
+                    0, 0, 0, chunk_sources, status);
+
+        /* Channel-average the data if required. */
+        if (d->auto_power_channel_avg[stokes])
+            oskar_mem_add(d->auto_power_channel_avg[stokes],
+                    d->auto_power_channel_avg[stokes],
+                    src->auto_power_cpu[stokes][slot],
+                    0, 0, 0, chunk_size, status);
+        if (d->cross_power_channel_avg[stokes])
+            oskar_mem_add(d->cross_power_channel_avg[stokes],
+                    d->cross_power_channel_avg[stokes],
+                    src->cross_power_cpu[stokes][slot],
+                    0, 0, 0, chunk_sources, status);
+
+        /* Channel- and time-average the data if required. */
+        if (d->auto_power_channel_and_time_avg[stokes])
+            oskar_mem_add(d->auto_power_channel_and_time_avg[stokes],
+                    d->auto_power_channel_and_time_avg[stokes],
+                    src->auto_power_cpu[stokes][slot],
+                    0, 0, 0, chunk_size, status);
+        if (d->cross_power_channel_and_time_avg[stokes])
+            oskar_mem_add(d->cross_power_channel_and_time_avg[stokes],
+                    d->cross_power_channel_and_time_avg[stokes],
+                    src->cross_power_cpu[stokes][slot],
+                    0, 0, 0, chunk_sources, status);
+
+        /* Write time-averaged data. */
+        if (i_time == h->num_time_steps - 1)
         {
-            /* Write non-averaged data, if required. */
-            write_pixels(h, i_chunk, i_time, i_channel, chunk_sources, 0, 0,
-                    d->auto_power_cpu[stokes][!i_active],
-                    AUTO_POWER_DATA, stokes, status);
-            write_pixels(h, i_chunk, i_time, i_channel, chunk_sources, 0, 0,
-                    d->cross_power_cpu[stokes][!i_active],
-                    CROSS_POWER_DATA, stokes, status);
-
-            /* Time-average the data if required. */
             if (d->auto_power_time_avg[stokes])
-                oskar_mem_add(d->auto_power_time_avg[stokes],
+            {
+                oskar_mem_scale_real(d->auto_power_time_avg[stokes],
+                        1.0 / h->num_time_steps, 0, chunk_size, status);
+                write_pixels(h, i_chunk, 0, i_channel, chunk_sources, 0, 1,
                         d->auto_power_time_avg[stokes],
-                        d->auto_power_cpu[stokes][!i_active],
-                        0, 0, 0, chunk_size, status);
+                        AUTO_POWER_DATA, stokes, status);
+                oskar_mem_clear_contents(d->auto_power_time_avg[stokes],
+                        status);
+            }
             if (d->cross_power_time_avg[stokes])
-                oskar_mem_add(d->cross_power_time_avg[stokes],
+            {
+                oskar_mem_scale_real(d->cross_power_time_avg[stokes],
+                        1.0 / h->num_time_steps, 0, chunk_sources, status);
+                write_pixels(h, i_chunk, 0, i_channel, chunk_sources, 0, 1,
                         d->cross_power_time_avg[stokes],
-                        d->cross_power_cpu[stokes][!i_active],
-                        0, 0, 0, chunk_sources, status);
+                        CROSS_POWER_DATA, stokes, status);
+                oskar_mem_clear_contents(d->cross_power_time_avg[stokes],
+                        status);
+            }
+        }
 
-            /* Channel-average the data if required. */
+        /* Write channel-averaged data. */
+        if (i_channel == h->num_channels - 1)
+        {
             if (d->auto_power_channel_avg[stokes])
-                oskar_mem_add(d->auto_power_channel_avg[stokes],
+            {
+                oskar_mem_scale_real(d->auto_power_channel_avg[stokes],
+                        1.0 / h->num_channels, 0, chunk_size, status);
+                write_pixels(h, i_chunk, i_time, 0, chunk_sources, 1, 0,
                         d->auto_power_channel_avg[stokes],
-                        d->auto_power_cpu[stokes][!i_active],
-                        0, 0, 0, chunk_size, status);
+                        AUTO_POWER_DATA, stokes, status);
+                oskar_mem_clear_contents(d->auto_power_channel_avg[stokes],
+                        status);
+            }
             if (d->cross_power_channel_avg[stokes])
-                oskar_mem_add(d->cross_power_channel_avg[stokes],
-                        d->cross_power_channel_avg[stokes],
-                        d->cross_power_cpu[stokes][!i_active],
-                        0, 0, 0, chunk_sources, status);
-
-            /* Channel- and time-average the data if required. */
-            if (d->auto_power_channel_and_time_avg[stokes])
-                oskar_mem_add(d->auto_power_channel_and_time_avg[stokes],
-                        d->auto_power_channel_and_time_avg[stokes],
-                        d->auto_power_cpu[stokes][!i_active],
-                        0, 0, 0, chunk_size, status);
-            if (d->cross_power_channel_and_time_avg[stokes])
-                oskar_mem_add(d->cross_power_channel_and_time_avg[stokes],
-                        d->cross_power_channel_and_time_avg[stokes],
-                        d->cross_power_cpu[stokes][!i_active],
-                        0, 0, 0, chunk_sources, status);
-
-            /* Write time-averaged data. */
-            if (i_time == h->num_time_steps - 1)
             {
-                if (d->auto_power_time_avg[stokes])
-                {
-                    oskar_mem_scale_real(d->auto_power_time_avg[stokes],
-                            1.0 / h->num_time_steps, 0, chunk_size, status);
-                    write_pixels(h, i_chunk, 0, i_channel, chunk_sources, 0, 1,
-                            d->auto_power_time_avg[stokes],
-                            AUTO_POWER_DATA, stokes, status);
-                    oskar_mem_clear_contents(d->auto_power_time_avg[stokes],
-                            status);
-                }
-                if (d->cross_power_time_avg[stokes])
-                {
-                    oskar_mem_scale_real(d->cross_power_time_avg[stokes],
-                            1.0 / h->num_time_steps, 0, chunk_sources, status);
-                    write_pixels(h, i_chunk, 0, i_channel, chunk_sources, 0, 1,
-                            d->cross_power_time_avg[stokes],
-                            CROSS_POWER_DATA, stokes, status);
-                    oskar_mem_clear_contents(d->cross_power_time_avg[stokes],
-                            status);
-                }
+                oskar_mem_scale_real(d->cross_power_channel_avg[stokes],
+                        1.0 / h->num_channels, 0, chunk_sources, status);
+                write_pixels(h, i_chunk, i_time, 0, chunk_sources, 1, 0,
+                        d->cross_power_channel_avg[stokes],
+                        CROSS_POWER_DATA, stokes, status);
+                oskar_mem_clear_contents(
+                        d->cross_power_channel_avg[stokes], status);
             }
+        }
 
-            /* Write channel-averaged data. */
-            if (i_channel == h->num_channels - 1)
+        /* Write channel- and time-averaged data. */
+        if ((i_time == h->num_time_steps - 1) &&
+                (i_channel == h->num_channels - 1))
+        {
+            if (d->auto_power_channel_and_time_avg[stokes])
             {
-                if (d->auto_power_channel_avg[stokes])
-                {
-                    oskar_mem_scale_real(d->auto_power_channel_avg[stokes],
-                            1.0 / h->num_channels, 0, chunk_size, status);
-                    write_pixels(h, i_chunk, i_time, 0, chunk_sources, 1, 0,
-                            d->auto_power_channel_avg[stokes],
-                            AUTO_POWER_DATA, stokes, status);
-                    oskar_mem_clear_contents(d->auto_power_channel_avg[stokes],
-                            status);
-                }
-                if (d->cross_power_channel_avg[stokes])
-                {
-                    oskar_mem_scale_real(d->cross_power_channel_avg[stokes],
-                            1.0 / h->num_channels, 0, chunk_sources, status);
-                    write_pixels(h, i_chunk, i_time, 0, chunk_sources, 1, 0,
-                            d->cross_power_channel_avg[stokes],
-                            CROSS_POWER_DATA, stokes, status);
-                    oskar_mem_clear_contents(
-                            d->cross_power_channel_avg[stokes], status);
-                }
+                oskar_mem_scale_real(
+                        d->auto_power_channel_and_time_avg[stokes],
+                        1.0 / (h->num_channels * h->num_time_steps),
+                        0, chunk_size, status);
+                write_pixels(h, i_chunk, 0, 0, chunk_sources, 1, 1,
+                        d->auto_power_channel_and_time_avg[stokes],
+                        AUTO_POWER_DATA, stokes, status);
+                oskar_mem_clear_contents(
+                        d->auto_power_channel_and_time_avg[stokes],
+                        status);
             }
-
-            /* Write channel- and time-averaged data. */
-            if ((i_time == h->num_time_steps - 1) &&
-                    (i_channel == h->num_channels - 1))
+            if (d->cross_power_channel_and_time_avg[stokes])
             {
-                if (d->auto_power_channel_and_time_avg[stokes])
-                {
-                    oskar_mem_scale_real(
-                            d->auto_power_channel_and_time_avg[stokes],
-                            1.0 / (h->num_channels * h->num_time_steps),
-                            0, chunk_size, status);
-                    write_pixels(h, i_chunk, 0, 0, chunk_sources, 1, 1,
-                            d->auto_power_channel_and_time_avg[stokes],
-                            AUTO_POWER_DATA, stokes, status);
-                    oskar_mem_clear_contents(
-                            d->auto_power_channel_and_time_avg[stokes],
-                            status);
-                }
-                if (d->cross_power_channel_and_time_avg[stokes])
-                {
-                    oskar_mem_scale_real(
-                            d->cross_power_channel_and_time_avg[stokes],
-                            1.0 / (h->num_channels * h->num_time_steps),
-                            0, chunk_sources, status);
-                    write_pixels(h, i_chunk, 0, 0, chunk_sources, 1, 1,
-                            d->cross_power_channel_and_time_avg[stokes],
-                            CROSS_POWER_DATA, stokes, status);
-                    oskar_mem_clear_contents(
-                            d->cross_power_channel_and_time_avg[stokes],
-                            status);
-                }
+                oskar_mem_scale_real(
+                        d->cross_power_channel_and_time_avg[stokes],
+                        1.0 / (h->num_channels * h->num_time_steps),
+                        0, chunk_sources, status);
+                write_pixels(h, i_chunk, 0, 0, chunk_sources, 1, 1,
+                        d->cross_power_channel_and_time_avg[stokes],
+                        CROSS_POWER_DATA, stokes, status);
+                oskar_mem_clear_contents(
+                        d->cross_power_channel_and_time_avg[stokes],
+                        status);
             }
         }
     }
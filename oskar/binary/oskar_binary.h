@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2014-2015, The University of Oxford
+ * Copyright (c) 2014-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -67,7 +67,9 @@ enum OSKAR_TAG_GROUPS
     OSKAR_TAG_GROUP_SPLINE_DATA      = 9,
     OSKAR_TAG_GROUP_ELEMENT_DATA     = 10,
     OSKAR_TAG_GROUP_VIS_HEADER       = 11,
-    OSKAR_TAG_GROUP_VIS_BLOCK        = 12
+    OSKAR_TAG_GROUP_VIS_BLOCK        = 12,
+    OSKAR_TAG_GROUP_TELESCOPE        = 13,
+    OSKAR_TAG_GROUP_STATION          = 14
 };
 
 /* Standard metadata tags. */
@@ -59,6 +59,37 @@ OSKAR_BINARY_EXPORT
 void oskar_binary_read_block(oskar_Binary* handle,
         int chunk_index, size_t data_size, void* data, int* status);
 
+/**
+ * @brief Returns a pointer to the payload of a tag in a memory-mapped file.
+ *
+ * @details
+ * This low-level function returns a pointer to the payload data for a
+ * single tag, without copying it. The whole file is memory-mapped the first
+ * time this is called, and remains mapped until the handle is freed.
+ * The mapping is private, so any changes made to the data are not written
+ * back to the file.
+ *
+ * The tag is specified by its sequence number in the stream, as returned by
+ * oskar_binary_query() or oskar_binary_query_ext().
+ *
+ * If memory-mapping is not available on this platform, or the file cannot
+ * be mapped, NULL is returned without setting an error, and the data should
+ * be read using oskar_binary_read_block() instead.
+ *
+ * If \p check_crc is set, the CRC code of the chunk is checked the first
+ * time its payload is accessed.
+ *
+ * @param[in,out] handle   Binary file handle.
+ * @param[in] chunk_index  Sequence index of the chunk's tag in the file.
+ * @param[in] check_crc    If set, check the CRC code of the chunk.
+ * @param[in,out] status   Status return code.
+ *
+ * @return Pointer to the payload, or NULL if unavailable.
+ */
+OSKAR_BINARY_EXPORT
+void* oskar_binary_map_block(oskar_Binary* handle, int chunk_index,
+        int check_crc, int* status);
+
 /**
  * @brief Reads a block of binary data for a single tag from an input stream.
  *
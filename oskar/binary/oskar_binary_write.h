@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2012-2015, The University of Oxford
+ * Copyright (c) 2012-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -178,6 +178,26 @@ OSKAR_BINARY_EXPORT
 void oskar_binary_write_ext_int(oskar_Binary* handle, const char* name_group,
         const char* name_tag, int user_index, int value, int* status);
 
+/**
+ * @brief Aligns the payload of the next standard tag written to the stream.
+ *
+ * @details
+ * This function writes a padding chunk if required, so that the payload
+ * of the next standard tag written to the stream starts at a multiple of
+ * \p alignment bytes from the start of the file. This allows the payload
+ * to be used directly if the file is memory-mapped.
+ *
+ * The padding chunk is a standard tag of type OSKAR_CHAR with a group ID
+ * and tag ID of 0, and its payload should be ignored.
+ *
+ * @param[in,out] handle   Binary file handle.
+ * @param[in] alignment    Required alignment in bytes (at most 64).
+ * @param[in,out] status   Status return code.
+ */
+OSKAR_BINARY_EXPORT
+void oskar_binary_write_align(oskar_Binary* handle, size_t alignment,
+        int* status);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2012-2015, The University of Oxford
+ * Copyright (c) 2012-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -141,7 +141,44 @@ typedef struct oskar_BinaryHeader oskar_BinaryHeader;
  *
  * Note: The block size in the tag is the total number of bytes until
  * the next tag, including any extended tag names and CRC code.
+ *
+ * Files created in write mode end with an index chunk, which lists every
+ * other chunk in the file so that it can be opened without scanning all the
+ * tags. This is a normal extended tag, with group name "oskar_binary",
+ * tag name "index" and type OSKAR_CHAR, so older readers see it only as an
+ * extra chunk. The payload holds one entry for each preceding chunk:
+ *
+ * Offset  Length  Description
+ * ----------------------------------------------------------------------------
+ *  0      8       Offset of the tag from the start of the file, as
+ *                 little-endian 8-byte integer.
+ *  8      4       CRC-32C code of the tag and any extended tag names,
+ *                 as little-endian 4-byte integer.
+ * 12      4       CRC-32C code of the chunk (0 if not present),
+ *                 as little-endian 4-byte integer.
+ * 16      20      Copy of the tag.
+ * 36      *       Copy of the group and tag names, if the tag is extended.
+ *
+ * and ends with a 24-byte trailer:
+ *
+ * Offset  Length  Description
+ * ----------------------------------------------------------------------------
+ *  0      8       Number of entries, as little-endian 8-byte integer.
+ *  8      8       Offset of the index tag from the start of the file, as
+ *                 little-endian 8-byte integer.
+ * 16      8       The ASCII string "OSKARIDX", without trailing zero.
+ *
+ * As the CRC code follows the payload, the trailer always ends 4 bytes before
+ * the end of the file. If the file does not end with a valid index chunk
+ * (for example, if it was written by an older version, or if more chunks
+ * were appended to it), then all the tags in the file are scanned instead.
  */
+#define OSKAR_BINARY_INDEX_GROUP "oskar_binary"
+#define OSKAR_BINARY_INDEX_TAG   "index"
+#define OSKAR_BINARY_INDEX_MAGIC "OSKARIDX"
+#define OSKAR_BINARY_INDEX_ENTRY_BYTES 36
+#define OSKAR_BINARY_INDEX_TRAILER_BYTES 24
+
 struct oskar_BinaryTag
 {
     char magic[4];           /* Tag identifier and payload element size. */
@@ -190,6 +227,25 @@ struct oskar_Binary
     unsigned long* crc;         /* CRC-32C code. */
     unsigned long* crc_header;  /* CRC-32C code of payload identifier. */
 
+    /* Hash index of tags, keyed on everything except the data type. */
+    int index_num_buckets;      /* Number of hash buckets (power of two). */
+    int* index_bucket;          /* First tag in each bucket, or -1. */
+    int* index_next;            /* Next tag in the same bucket, or -1. */
+
+    /* Index chunk entries accumulated while writing. */
+    int write_index;            /* If set, write index chunk when closing. */
+    size_t index_num_entries;   /* Number of index entries. */
+    size_t index_data_size;     /* Size of index entry data, in bytes. */
+    size_t index_data_capacity; /* Allocated size of index entry data. */
+    long index_end_bytes;       /* File offset at end of last indexed chunk. */
+    char* index_data;           /* Index entry data. */
+
+    /* Memory-mapped file, used by oskar_binary_map_block(). */
+    void* map_data;             /* Start of mapped file, or NULL. */
+    size_t map_size;            /* Size of mapped file, in bytes. */
+    int map_failed;             /* Set if the file could not be mapped. */
+    char* crc_checked;          /* Set for each tag once its CRC is checked. */
+
     /* Data tables used for CRC computation. */
     oskar_CRC* crc_data;
 };
@@ -199,6 +255,24 @@ struct oskar_Binary
 typedef struct oskar_Binary oskar_Binary;
 #endif /* OSKAR_BINARY_TYPEDEF_ */
 
+/* Returns the hash of the given tag identifiers. */
+unsigned int oskar_binary_index_hash(int extended, int id_group, int id_tag,
+        int user_index, const char* name_group, const char* name_tag);
+
+/* (Re)builds the hash index from the tag data. */
+void oskar_binary_index_build(oskar_Binary* handle);
+
+/* Records a chunk that has just been written, for the index chunk. */
+void oskar_binary_index_append(oskar_Binary* handle, long tag_offset,
+        const oskar_BinaryTag* tag, const char* name_group,
+        const char* name_tag, unsigned long crc_header, unsigned long crc);
+
+/* Writes the index chunk, if required, at the end of the file. */
+void oskar_binary_index_write(oskar_Binary* handle, int* status);
+
+/* Releases the memory-mapped file, if it is mapped. */
+void oskar_binary_unmap(oskar_Binary* handle);
+
 #ifdef __cplusplus
 }
 #endif
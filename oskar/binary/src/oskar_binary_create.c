@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2012-2015, The University of Oxford
+ * Copyright (c) 2012-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -40,6 +40,12 @@ extern "C" {
 #define MIN(X,Y) ((X) < (Y) ? (X) : (Y))
 
 static void oskar_binary_resize(oskar_Binary* handle, int m);
+static int oskar_binary_check_tag(const oskar_BinaryTag* tag, int* status);
+static void oskar_binary_store_tag(oskar_Binary* handle, int i,
+        const oskar_BinaryTag* tag);
+static int oskar_binary_read_index(oskar_Binary* handle, int* capacity);
+static int oskar_binary_load_index(oskar_Binary* handle, int* capacity,
+        char** data);
 static void oskar_binary_read_header(FILE* stream, oskar_BinaryHeader* header,
         int* status);
 static void oskar_binary_write_header(FILE* stream, oskar_BinaryHeader* header,
@@ -51,7 +57,7 @@ oskar_Binary* oskar_binary_create(const char* filename, char mode, int* status)
     oskar_Binary* handle;
     oskar_BinaryHeader header;
     FILE* stream;
-    int i;
+    int i, capacity = 0;
 
     /* Open the file and check or write the header, depending on the mode. */
     if (mode == 'r')
@@ -118,6 +124,20 @@ oskar_Binary* oskar_binary_create(const char* filename, char mode, int* status)
     handle->block_size_bytes = 0;
     handle->crc = 0;
     handle->crc_header = 0;
+    handle->index_num_buckets = 0;
+    handle->index_bucket = 0;
+    handle->index_next = 0;
+
+    handle->write_index = (mode == 'w');
+    handle->index_num_entries = 0;
+    handle->index_data_size = 0;
+    handle->index_data_capacity = 0;
+    handle->index_end_bytes = (long) sizeof(oskar_BinaryHeader);
+    handle->index_data = 0;
+    handle->map_data = 0;
+    handle->map_size = 0;
+    handle->map_failed = 0;
+    handle->crc_checked = 0;
 
     /* Store the contents of the header for later use. */
     handle->bin_version = header.bin_version;
@@ -126,174 +146,345 @@ oskar_Binary* oskar_binary_create(const char* filename, char mode, int* status)
     if (mode == 'w')
         return handle;
 
-    /* Read all tags in the stream. */
-    for (i = 0;; ++i)
+    /* Load the index chunk if there is one, otherwise read all the tags. */
+    if (mode != 'r' || !oskar_binary_read_index(handle, &capacity))
     {
-        oskar_BinaryTag tag;
-        unsigned long crc;
-        int format_version, element_size;
-        size_t memcpy_size = 0;
-
-        /* Try to read a tag, and end the loop if unsuccessful. */
-        if (fread(&tag, sizeof(oskar_BinaryTag), 1, stream) != 1)
-            break;
-
-        /* If the bytes read are not a tag, or the reserved flag bits
-         * are not zero, then return an error. */
-        if (tag.magic[0] != 'T' || tag.magic[2] != 'G'
-                || (tag.flags & 0x1F) != 0)
+        for (i = 0;; ++i)
         {
-            *status = OSKAR_ERR_BINARY_FILE_INVALID;
-            break;
-        }
-
-        /* Get the binary format version. */
-        format_version = tag.magic[1] - 0x40;
-        if (format_version < 1 || format_version > OSKAR_BINARY_FORMAT_VERSION)
-        {
-            *status = OSKAR_ERR_BINARY_VERSION_UNKNOWN;
-            break;
-        }
+            oskar_BinaryTag tag;
+            unsigned long crc;
 
-        /* Additional checks if format version > 1. */
-        if (format_version > 1)
-        {
-            /* Check system byte order is compatible. */
-            if (oskar_endian() && !(tag.flags & (1 << 5)))
-            {
-                *status = OSKAR_ERR_BINARY_ENDIAN_MISMATCH;
+            /* Try to read a tag, and end the loop if unsuccessful. */
+            if (fread(&tag, sizeof(oskar_BinaryTag), 1, stream) != 1)
                 break;
-            }
 
-            /* Check data size is compatible. */
-            element_size = tag.magic[3];
-            if (tag.data_type & OSKAR_MATRIX)
-                element_size /= 4;
-            if (tag.data_type & OSKAR_COMPLEX)
-                element_size /= 2;
-            if (tag.data_type & OSKAR_CHAR)
+            /* Check the tag and store its data in the index. */
+            if (oskar_binary_check_tag(&tag, status))
+                break;
+            if (i >= capacity)
             {
-                if (element_size != sizeof(char))
-                    *status = OSKAR_ERR_BINARY_FORMAT_BAD;
+                capacity = (capacity == 0) ? 16 : 2 * capacity;
+                oskar_binary_resize(handle, capacity);
             }
-            else if (tag.data_type & OSKAR_INT)
+            oskar_binary_store_tag(handle, i, &tag);
+            crc = oskar_crc_compute(handle->crc_data, &tag,
+                    sizeof(oskar_BinaryTag));
+
+            /* Check if the tag is extended. */
+            if (handle->extended[i])
             {
-                if (element_size != sizeof(int))
-                    *status = OSKAR_ERR_BINARY_INT_UNKNOWN;
+                /* Store the tag names. */
+                if (fread(handle->name_group[i], tag.group.bytes, 1,
+                        stream) != 1)
+                    *status = OSKAR_ERR_BINARY_FILE_INVALID;
+                if (fread(handle->name_tag[i], tag.tag.bytes, 1,
+                        stream) != 1)
+                    *status = OSKAR_ERR_BINARY_FILE_INVALID;
+                if (*status)
+                {
+                    handle->num_chunks = i + 1;
+                    break;
+                }
+
+                /* Update the CRC code. */
+                crc = oskar_crc_update(handle->crc_data, crc,
+                        handle->name_group[i], tag.group.bytes);
+                crc = oskar_crc_update(handle->crc_data, crc,
+                        handle->name_tag[i], tag.tag.bytes);
             }
-            else if (tag.data_type & OSKAR_SINGLE)
+
+            /* Store the current stream pointer as the payload offset. */
+            handle->payload_offset_bytes[i] = ftell(stream);
+
+            /* Save the number of tags read from the stream. */
+            handle->num_chunks = i + 1;
+
+            /* Increment stream pointer by payload size. */
+            if (fseek(stream, (long int) handle->payload_size_bytes[i],
+                    SEEK_CUR))
             {
-                if (element_size != sizeof(float))
-                    *status = OSKAR_ERR_BINARY_FLOAT_UNKNOWN;
+                *status = OSKAR_ERR_BINARY_FILE_INVALID;
+                break;
             }
-            else if (tag.data_type & OSKAR_DOUBLE)
+
+            /* Store header CRC code and get file CRC code in native byte
+             * order. */
+            handle->crc_header[i] = crc;
+            if (tag.flags & (1 << 6))
             {
-                if (element_size != sizeof(double))
-                    *status = OSKAR_ERR_BINARY_DOUBLE_UNKNOWN;
+                if (fread(&handle->crc[i], 4, 1, stream) != 1)
+                {
+                    *status = OSKAR_ERR_BINARY_FILE_INVALID;
+                    break;
+                }
+
+                if (oskar_endian() != OSKAR_LITTLE_ENDIAN)
+                    oskar_endian_swap(&handle->crc[i], sizeof(unsigned long));
             }
-            else
-                *status = OSKAR_ERR_BINARY_TYPE_UNKNOWN;
         }
+    }
 
-        /* Check if we need to allocate more storage for the tag data. */
-        if (i % 10 == 0)
-            oskar_binary_resize(handle, i + 10);
-
-        /* Initialise the tag index data. */
-        handle->extended[i] = 0;
-        handle->data_type[i] = 0;
-        handle->id_group[i] = 0;
-        handle->id_tag[i] = 0;
-        handle->name_group[i] = 0;
-        handle->name_tag[i] = 0;
-        handle->user_index[i] = 0;
-        handle->payload_offset_bytes[i] = 0;
-        handle->payload_size_bytes[i] = 0;
-        handle->block_size_bytes[i] = 0;
-        handle->crc[i] = 0;
-        handle->crc_header[i] = 0;
-
-        /* Start computing the CRC code. */
-        crc = oskar_crc_compute(handle->crc_data, &tag,
-                sizeof(oskar_BinaryTag));
-
-        /* Store the data type and IDs. */
-        handle->data_type[i] = (int) tag.data_type;
-        handle->id_group[i] = (int) tag.group.id;
-        handle->id_tag[i] = (int) tag.tag.id;
-
-        /* Store the index in native byte order. */
-        memcpy_size = MIN(sizeof(int), sizeof(tag.user_index));
-        memcpy(&handle->user_index[i], tag.user_index, memcpy_size);
-        if (oskar_endian() != OSKAR_LITTLE_ENDIAN)
-            oskar_endian_swap(&handle->user_index[i], sizeof(int));
-
-        /* Store the number of bytes in the block in native byte order. */
-        memcpy_size = MIN(sizeof(size_t), sizeof(tag.size_bytes));
-        memcpy(&handle->block_size_bytes[i], tag.size_bytes, memcpy_size);
-        if (oskar_endian() != OSKAR_LITTLE_ENDIAN)
-            oskar_endian_swap(&handle->block_size_bytes[i], sizeof(size_t));
-
-        /* Set payload size to block size, minus 4 bytes if CRC-32 present. */
-        handle->payload_size_bytes[i] = handle->block_size_bytes[i];
-        handle->payload_size_bytes[i] -= (tag.flags & (1 << 6) ? 4 : 0);
-
-        /* Check if the tag is extended. */
-        if (tag.flags & (1 << 7))
-        {
-            /* Extended tag: set the extended flag. */
-            handle->extended[i] = 1;
+    /* Build the hash index used for tag queries. */
+    oskar_binary_index_build(handle);
+    return handle;
+}
 
-            /* Reduce payload size by sum of length of tag names. */
-            handle->payload_size_bytes[i] -= (tag.group.bytes + tag.tag.bytes);
+static int oskar_binary_check_tag(const oskar_BinaryTag* tag, int* status)
+{
+    int format_version, element_size;
 
-            /* Allocate memory for the tag names. */
-            handle->name_group[i] = (char*) malloc(tag.group.bytes);
-            handle->name_tag[i]   = (char*) malloc(tag.tag.bytes);
+    /* If the bytes read are not a tag, or the reserved flag bits
+     * are not zero, then return an error. */
+    if (tag->magic[0] != 'T' || tag->magic[2] != 'G'
+            || (tag->flags & 0x1F) != 0)
+    {
+        *status = OSKAR_ERR_BINARY_FILE_INVALID;
+        return 1;
+    }
 
-            /* Store the tag names. */
-            if (fread(handle->name_group[i], tag.group.bytes, 1, stream) != 1)
-                *status = OSKAR_ERR_BINARY_FILE_INVALID;
-            if (fread(handle->name_tag[i], tag.tag.bytes, 1, stream) != 1)
-                *status = OSKAR_ERR_BINARY_FILE_INVALID;
-            if (*status) break;
+    /* Get the binary format version. */
+    format_version = tag->magic[1] - 0x40;
+    if (format_version < 1 || format_version > OSKAR_BINARY_FORMAT_VERSION)
+    {
+        *status = OSKAR_ERR_BINARY_VERSION_UNKNOWN;
+        return 1;
+    }
 
-            /* Update the CRC code. */
-            crc = oskar_crc_update(handle->crc_data, crc,
-                    handle->name_group[i], tag.group.bytes);
-            crc = oskar_crc_update(handle->crc_data, crc,
-                    handle->name_tag[i], tag.tag.bytes);
+    /* Additional checks if format version > 1. */
+    if (format_version > 1)
+    {
+        /* Check system byte order is compatible. */
+        if (oskar_endian() && !(tag->flags & (1 << 5)))
+        {
+            *status = OSKAR_ERR_BINARY_ENDIAN_MISMATCH;
+            return 1;
+        }
+
+        /* Check data size is compatible. */
+        element_size = tag->magic[3];
+        if (tag->data_type & OSKAR_MATRIX)
+            element_size /= 4;
+        if (tag->data_type & OSKAR_COMPLEX)
+            element_size /= 2;
+        if (tag->data_type & OSKAR_CHAR)
+        {
+            if (element_size != sizeof(char))
+                *status = OSKAR_ERR_BINARY_FORMAT_BAD;
+        }
+        else if (tag->data_type & OSKAR_INT)
+        {
+            if (element_size != sizeof(int))
+                *status = OSKAR_ERR_BINARY_INT_UNKNOWN;
+        }
+        else if (tag->data_type & OSKAR_SINGLE)
+        {
+            if (element_size != sizeof(float))
+                *status = OSKAR_ERR_BINARY_FLOAT_UNKNOWN;
+        }
+        else if (tag->data_type & OSKAR_DOUBLE)
+        {
+            if (element_size != sizeof(double))
+                *status = OSKAR_ERR_BINARY_DOUBLE_UNKNOWN;
         }
+        else
+            *status = OSKAR_ERR_BINARY_TYPE_UNKNOWN;
+    }
+    return 0;
+}
 
-        /* Store the current stream pointer as the payload offset. */
-        handle->payload_offset_bytes[i] = ftell(stream);
+static void oskar_binary_store_tag(oskar_Binary* handle, int i,
+        const oskar_BinaryTag* tag)
+{
+    size_t memcpy_size = 0;
+
+    /* Initialise the tag index data. */
+    handle->extended[i] = 0;
+    handle->data_type[i] = 0;
+    handle->id_group[i] = 0;
+    handle->id_tag[i] = 0;
+    handle->name_group[i] = 0;
+    handle->name_tag[i] = 0;
+    handle->user_index[i] = 0;
+    handle->payload_offset_bytes[i] = 0;
+    handle->payload_size_bytes[i] = 0;
+    handle->block_size_bytes[i] = 0;
+    handle->crc[i] = 0;
+    handle->crc_header[i] = 0;
+
+    /* Store the data type and IDs. */
+    handle->data_type[i] = (int) tag->data_type;
+    handle->id_group[i] = (int) tag->group.id;
+    handle->id_tag[i] = (int) tag->tag.id;
+
+    /* Store the index in native byte order. */
+    memcpy_size = MIN(sizeof(int), sizeof(tag->user_index));
+    memcpy(&handle->user_index[i], tag->user_index, memcpy_size);
+    if (oskar_endian() != OSKAR_LITTLE_ENDIAN)
+        oskar_endian_swap(&handle->user_index[i], sizeof(int));
+
+    /* Store the number of bytes in the block in native byte order. */
+    memcpy_size = MIN(sizeof(size_t), sizeof(tag->size_bytes));
+    memcpy(&handle->block_size_bytes[i], tag->size_bytes, memcpy_size);
+    if (oskar_endian() != OSKAR_LITTLE_ENDIAN)
+        oskar_endian_swap(&handle->block_size_bytes[i], sizeof(size_t));
+
+    /* Set payload size to block size, minus 4 bytes if CRC-32 present. */
+    handle->payload_size_bytes[i] = handle->block_size_bytes[i];
+    handle->payload_size_bytes[i] -= (tag->flags & (1 << 6) ? 4 : 0);
+
+    /* Check if the tag is extended. */
+    if (tag->flags & (1 << 7))
+    {
+        /* Extended tag: set the extended flag. */
+        handle->extended[i] = 1;
+
+        /* Reduce payload size by sum of length of tag names. */
+        handle->payload_size_bytes[i] -= (tag->group.bytes + tag->tag.bytes);
 
-        /* Increment stream pointer by payload size. */
-        if (fseek(stream, (long int) handle->payload_size_bytes[i], SEEK_CUR))
+        /* Allocate memory for the tag names. */
+        handle->name_group[i] = (char*) malloc(tag->group.bytes);
+        handle->name_tag[i]   = (char*) malloc(tag->tag.bytes);
+    }
+}
+
+static size_t get_le(const char* p, int num_bytes)
+{
+    size_t value = 0;
+    int i;
+    for (i = num_bytes - 1; i >= 0; --i)
+        value = (value << 8) | (unsigned char) p[i];
+    return value;
+}
+
+static int oskar_binary_read_index(oskar_Binary* handle, int* capacity)
+{
+    int i, ok;
+    char* data = 0;
+    ok = oskar_binary_load_index(handle, capacity, &data);
+    free(data);
+    if (!ok)
+    {
+        /* Discard anything loaded so far, and go back to the first tag. */
+        for (i = 0; i < handle->num_chunks; ++i)
         {
-            *status = OSKAR_ERR_BINARY_FILE_INVALID;
-            break;
+            free(handle->name_group[i]);
+            free(handle->name_tag[i]);
         }
+        handle->num_chunks = 0;
+        fseek(handle->stream, (long) sizeof(oskar_BinaryHeader), SEEK_SET);
+    }
+    return ok;
+}
 
-        /* Store header CRC code and get file CRC code in native byte order. */
-        handle->crc_header[i] = crc;
-        if (tag.flags & (1 << 6))
+static int oskar_binary_load_index(oskar_Binary* handle, int* capacity,
+        char** data)
+{
+    oskar_BinaryTag index_tag, tag;
+    FILE* stream = handle->stream;
+    char trailer[OSKAR_BINARY_INDEX_TRAILER_BYTES + 4], *p, *end;
+    size_t j, num_entries, names, block_size, payload_size;
+    long file_size, index_offset;
+    unsigned long index_crc_header, index_crc, crc_header, crc;
+    int i = 0, status = 0;
+
+    /* Read the trailer from the end of the file. */
+    if (fseek(stream, 0, SEEK_END)) return 0;
+    file_size = ftell(stream);
+    if (file_size < (long) (sizeof(oskar_BinaryHeader) +
+            sizeof(oskar_BinaryTag) + sizeof(trailer))) return 0;
+    if (fseek(stream, -(long) sizeof(trailer), SEEK_END)) return 0;
+    if (fread(trailer, sizeof(trailer), 1, stream) != 1) return 0;
+    if (memcmp(trailer + 16, OSKAR_BINARY_INDEX_MAGIC, 8)) return 0;
+    num_entries = get_le(trailer, 8);
+    index_offset = (long) get_le(trailer + 8, 8);
+    if (index_offset < (long) sizeof(oskar_BinaryHeader) ||
+            index_offset >= file_size) return 0;
+
+    /* Read and check the index tag, and make sure it ends the file. */
+    if (fseek(stream, index_offset, SEEK_SET)) return 0;
+    if (fread(&index_tag, sizeof(oskar_BinaryTag), 1, stream) != 1)
+        return 0;
+    if (oskar_binary_check_tag(&index_tag, &status) || status) return 0;
+    if (!(index_tag.flags & (1 << 7)) || !(index_tag.flags & (1 << 6)) ||
+            index_tag.group.bytes == 0 || index_tag.tag.bytes == 0)
+        return 0;
+    block_size = get_le(index_tag.size_bytes, 8);
+    names = index_tag.group.bytes + index_tag.tag.bytes;
+    if (index_offset + (long) (sizeof(oskar_BinaryTag) + block_size) !=
+            file_size || block_size < names + sizeof(trailer)) return 0;
+    payload_size = block_size - names - 4;
+
+    /* Read the names and payload, and check the CRC code. */
+    *data = (char*) malloc(names + payload_size);
+    if (!*data) return 0;
+    if (fread(*data, names + payload_size, 1, stream) != 1) return 0;
+    if ((*data)[index_tag.group.bytes - 1] || (*data)[names - 1] ||
+            strcmp(*data, OSKAR_BINARY_INDEX_GROUP) ||
+            strcmp(*data + index_tag.group.bytes, OSKAR_BINARY_INDEX_TAG))
+        return 0;
+    index_crc_header = oskar_crc_compute(handle->crc_data, &index_tag,
+            sizeof(oskar_BinaryTag));
+    index_crc_header = oskar_crc_update(handle->crc_data, index_crc_header,
+            *data, names);
+    index_crc = (unsigned long) get_le(trailer + sizeof(trailer) - 4, 4);
+    if (oskar_crc_update(handle->crc_data, index_crc_header, *data + names,
+            payload_size) != index_crc)
+        return 0;
+
+    /* Store the data for each entry. */
+    p = *data + names;
+    end = p + payload_size - OSKAR_BINARY_INDEX_TRAILER_BYTES;
+    for (j = 0; j <= num_entries; ++j, ++i)
+    {
+        const char* entry_names = 0;
+        long tag_offset;
+        if (j < num_entries)
         {
-            if (fread(&handle->crc[i], 4, 1, stream) != 1)
+            /* Entry for a chunk listed in the index. */
+            if (p + OSKAR_BINARY_INDEX_ENTRY_BYTES > end) return 0;
+            tag_offset = (long) get_le(p, 8);
+            crc_header = (unsigned long) get_le(p + 8, 4);
+            crc = (unsigned long) get_le(p + 12, 4);
+            memcpy(&tag, p + 16, sizeof(oskar_BinaryTag));
+            if (oskar_binary_check_tag(&tag, &status) || status) return 0;
+            entry_names = p + OSKAR_BINARY_INDEX_ENTRY_BYTES;
+            p += OSKAR_BINARY_INDEX_ENTRY_BYTES;
+            if (tag.flags & (1 << 7))
             {
-                *status = OSKAR_ERR_BINARY_FILE_INVALID;
-                break;
+                p += tag.group.bytes + tag.tag.bytes;
+                if (p > end) return 0;
             }
-
-            if (oskar_endian() != OSKAR_LITTLE_ENDIAN)
-                oskar_endian_swap(&handle->crc[i], sizeof(unsigned long));
         }
-
-        /* Save the number of tags read from the stream. */
+        else
+        {
+            /* Entry for the index chunk itself. */
+            if (p != end) return 0;
+            tag = index_tag;
+            tag_offset = index_offset;
+            crc_header = index_crc_header;
+            crc = index_crc;
+            entry_names = *data;
+        }
+        if (i >= *capacity)
+        {
+            *capacity = (*capacity == 0) ? 16 : 2 * *capacity;
+            oskar_binary_resize(handle, *capacity);
+        }
+        oskar_binary_store_tag(handle, i, &tag);
         handle->num_chunks = i + 1;
+        if (handle->extended[i])
+        {
+            memcpy(handle->name_group[i], entry_names, tag.group.bytes);
+            memcpy(handle->name_tag[i], entry_names + tag.group.bytes,
+                    tag.tag.bytes);
+        }
+        handle->payload_offset_bytes[i] = tag_offset +
+                (long) sizeof(oskar_BinaryTag) + (handle->extended[i] ?
+                        (long) (tag.group.bytes + tag.tag.bytes) : 0);
+        handle->crc_header[i] = crc_header;
+        handle->crc[i] = crc;
     }
-
-    return handle;
+    return 1;
 }
 
 static void oskar_binary_resize(oskar_Binary* handle, int m)
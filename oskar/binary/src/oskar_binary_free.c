@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2012-2015, The University of Oxford
+ * Copyright (c) 2012-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -41,9 +41,20 @@ void oskar_binary_free(oskar_Binary* handle)
     /* Check if structure exists. */
     if (!handle) return;
 
-    /* Close the file. */
+    /* Release the memory-mapped file, if any. */
+    oskar_binary_unmap(handle);
+
+    /* Write the index chunk and close the file.
+     * (The index is optional, so a file is still valid without it.) */
     if (handle->stream)
+    {
+        if (handle->open_mode == 'w')
+        {
+            int status = 0;
+            oskar_binary_index_write(handle, &status);
+        }
         fclose(handle->stream);
+    }
 
     /* Free string data. */
     for (i = 0; i < handle->num_chunks; ++i)
@@ -65,6 +76,9 @@ void oskar_binary_free(oskar_Binary* handle)
     free(handle->block_size_bytes);
     free(handle->crc);
     free(handle->crc_header);
+    free(handle->index_bucket);
+    free(handle->index_next);
+    free(handle->index_data);
 
     /* Free the CRC data. */
     oskar_crc_free(handle->crc_data);
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "binary/oskar_binary.h"
+#include "binary/private_binary.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static void put_le(char* p, size_t value, int num_bytes)
+{
+    int i;
+    for (i = 0; i < num_bytes; ++i, value >>= 8)
+        p[i] = (char) (value & 0xFF);
+}
+
+static char* reserve(oskar_Binary* handle, size_t num_bytes)
+{
+    char* p;
+    const size_t required = handle->index_data_size + num_bytes;
+    if (required > handle->index_data_capacity)
+    {
+        size_t capacity = handle->index_data_capacity;
+        if (capacity == 0) capacity = 4096;
+        while (capacity < required) capacity *= 2;
+        p = (char*) realloc(handle->index_data, capacity);
+        if (!p) return 0;
+        handle->index_data = p;
+        handle->index_data_capacity = capacity;
+    }
+    p = handle->index_data + handle->index_data_size;
+    handle->index_data_size = required;
+    return p;
+}
+
+static unsigned int hash_bytes(unsigned int h, const void* data, size_t n)
+{
+    const unsigned char* p = (const unsigned char*) data;
+    size_t i;
+    for (i = 0; i < n; ++i)
+    {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static unsigned int hash_string(unsigned int h, const char* s)
+{
+    if (s)
+    {
+        for (; *s; ++s)
+        {
+            h ^= (unsigned char) *s;
+            h *= 16777619u;
+        }
+    }
+    return h;
+}
+
+unsigned int oskar_binary_index_hash(int extended, int id_group, int id_tag,
+        int user_index, const char* name_group, const char* name_tag)
+{
+    /* FNV-1a hash of the tag identifiers (but not the data type). */
+    unsigned int h = 2166136261u;
+    h = hash_bytes(h, &extended, sizeof(int));
+    h = hash_bytes(h, &id_group, sizeof(int));
+    h = hash_bytes(h, &id_tag, sizeof(int));
+    h = hash_bytes(h, &user_index, sizeof(int));
+    if (extended)
+    {
+        h = hash_string(h, name_group);
+        h = hash_string(h, name_tag);
+    }
+    return h;
+}
+
+void oskar_binary_index_build(oskar_Binary* handle)
+{
+    int i;
+
+    /* Use a power-of-two number of buckets, at least twice the tag count. */
+    free(handle->index_bucket);
+    free(handle->index_next);
+    handle->index_bucket = 0;
+    handle->index_next = 0;
+    handle->index_num_buckets = 0;
+    if (handle->num_chunks == 0) return;
+    handle->index_num_buckets = 16;
+    while (handle->index_num_buckets < 2 * handle->num_chunks)
+        handle->index_num_buckets *= 2;
+    handle->index_bucket = (int*) malloc(
+            handle->index_num_buckets * sizeof(int));
+    handle->index_next = (int*) malloc(handle->num_chunks * sizeof(int));
+    for (i = 0; i < handle->index_num_buckets; ++i)
+        handle->index_bucket[i] = -1;
+
+    /* Insert tags in reverse order, so each chain is in ascending order. */
+    for (i = handle->num_chunks - 1; i >= 0; --i)
+    {
+        const unsigned int b = oskar_binary_index_hash(handle->extended[i],
+                handle->id_group[i], handle->id_tag[i], handle->user_index[i],
+                handle->name_group[i], handle->name_tag[i]) &
+                (unsigned int) (handle->index_num_buckets - 1);
+        handle->index_next[i] = handle->index_bucket[b];
+        handle->index_bucket[b] = i;
+    }
+}
+
+void oskar_binary_index_append(oskar_Binary* handle, long tag_offset,
+        const oskar_BinaryTag* tag, const char* name_group,
+        const char* name_tag, unsigned long crc_header, unsigned long crc)
+{
+    char* p;
+    int i;
+    size_t block_size = 0, name_bytes = 0;
+    if (!handle->write_index) return;
+
+    /* Stop indexing if the chunk does not directly follow the last one. */
+    if (tag_offset != handle->index_end_bytes)
+    {
+        handle->write_index = 0;
+        return;
+    }
+    if (tag->flags & (1 << 7))
+        name_bytes = tag->group.bytes + tag->tag.bytes;
+    p = reserve(handle, OSKAR_BINARY_INDEX_ENTRY_BYTES + name_bytes);
+    if (!p)
+    {
+        handle->write_index = 0;
+        return;
+    }
+
+    /* Store the entry. */
+    put_le(p, (size_t) tag_offset, 8);
+    put_le(p + 8, crc_header, 4);
+    put_le(p + 12, crc, 4);
+    memcpy(p + 16, tag, sizeof(oskar_BinaryTag));
+    if (name_bytes > 0)
+    {
+        memcpy(p + OSKAR_BINARY_INDEX_ENTRY_BYTES,
+                name_group, tag->group.bytes);
+        memcpy(p + OSKAR_BINARY_INDEX_ENTRY_BYTES + tag->group.bytes,
+                name_tag, tag->tag.bytes);
+    }
+    handle->index_num_entries++;
+
+    /* Get the (little-endian) block size to find the end of the chunk. */
+    for (i = 7; i >= 0; --i)
+        block_size = (block_size << 8) | (unsigned char) tag->size_bytes[i];
+    handle->index_end_bytes = tag_offset + (long) sizeof(oskar_BinaryTag) +
+            (long) block_size;
+}
+
+void oskar_binary_index_write(oskar_Binary* handle, int* status)
+{
+    char* p;
+    long index_offset;
+    if (*status) return;
+    if (!handle->write_index || handle->index_num_entries == 0) return;
+
+    /* Only write the index if the file ends where it is expected to. */
+    handle->write_index = 0;
+    index_offset = ftell(handle->stream);
+    if (index_offset != handle->index_end_bytes) return;
+
+    /* Append the trailer and write the index chunk. */
+    p = reserve(handle, OSKAR_BINARY_INDEX_TRAILER_BYTES);
+    if (!p)
+    {
+        *status = OSKAR_ERR_BINARY_MEMORY_NOT_ALLOCATED;
+        return;
+    }
+    put_le(p, handle->index_num_entries, 8);
+    put_le(p + 8, (size_t) index_offset, 8);
+    memcpy(p + 16, OSKAR_BINARY_INDEX_MAGIC, 8);
+    oskar_binary_write_ext(handle, OSKAR_CHAR, OSKAR_BINARY_INDEX_GROUP,
+            OSKAR_BINARY_INDEX_TAG, 0, handle->index_data_size,
+            handle->index_data, status);
+    if (!*status && fflush(handle->stream) != 0)
+        *status = OSKAR_ERR_BINARY_WRITE_FAIL;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "binary/oskar_binary.h"
+#include "binary/private_binary.h"
+#include <stdlib.h>
+#include <stdio.h>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static void oskar_binary_map(oskar_Binary* handle)
+{
+    handle->map_failed = 1;
+#ifndef _WIN32
+    {
+        struct stat st;
+        void* p;
+        const int fd = fileno(handle->stream);
+        if (fd < 0 || fstat(fd, &st) != 0 || st.st_size <= 0) return;
+        p = mmap(0, (size_t) st.st_size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) return;
+        handle->crc_checked = (char*) calloc(handle->num_chunks, 1);
+        if (handle->num_chunks > 0 && !handle->crc_checked)
+        {
+            munmap(p, (size_t) st.st_size);
+            return;
+        }
+        handle->map_data = p;
+        handle->map_size = (size_t) st.st_size;
+        handle->map_failed = 0;
+    }
+#endif
+}
+
+void* oskar_binary_map_block(oskar_Binary* handle, int chunk_index,
+        int check_crc, int* status)
+{
+    char* p;
+    size_t offset, size;
+
+    /* Check if safe to proceed. */
+    if (*status) return 0;
+
+    /* Check file was opened for reading. */
+    if (handle->open_mode != 'r')
+    {
+        *status = OSKAR_ERR_BINARY_NOT_OPEN_FOR_READ;
+        return 0;
+    }
+
+    /* Check index is in range. */
+    if (chunk_index < 0 || chunk_index >= handle->num_chunks)
+    {
+        *status = OSKAR_ERR_BINARY_TAG_OUT_OF_RANGE;
+        return 0;
+    }
+
+    /* Map the file on first use. */
+    if (!handle->map_data && !handle->map_failed)
+        oskar_binary_map(handle);
+    if (!handle->map_data) return 0;
+
+    /* Check the payload is inside the mapped region. */
+    offset = (size_t) handle->payload_offset_bytes[chunk_index];
+    size = handle->payload_size_bytes[chunk_index];
+    if (offset + size > handle->map_size) return 0;
+    p = (char*) handle->map_data + offset;
+
+    /* Check CRC-32 code, if present and not already checked. */
+    if (check_crc && handle->crc[chunk_index] &&
+            !handle->crc_checked[chunk_index])
+    {
+        unsigned long crc;
+        crc = handle->crc_header[chunk_index];
+        crc = oskar_crc_update(handle->crc_data, crc, p, size);
+        if (crc != handle->crc[chunk_index])
+        {
+            *status = OSKAR_ERR_BINARY_CRC_FAIL;
+            return 0;
+        }
+        handle->crc_checked[chunk_index] = 1;
+    }
+    return p;
+}
+
+void oskar_binary_unmap(oskar_Binary* handle)
+{
+#ifndef _WIN32
+    if (handle->map_data)
+        munmap(handle->map_data, handle->map_size);
+#endif
+    free(handle->crc_checked);
+    handle->map_data = 0;
+    handle->map_size = 0;
+    handle->crc_checked = 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2012-2017, The University of Oxford
+ * Copyright (c) 2012-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -63,21 +63,30 @@ int oskar_binary_query(const oskar_Binary* handle,
     if (*status) return 0;
 
     /* Find the tag in the index. */
-    for (i = handle->query_search_start; i < handle->num_chunks; ++i)
+    i = -1;
+    if (handle->index_num_buckets > 0)
     {
-        if (!(handle->extended[i]) &&
-                ((handle->data_type[i] == (int) data_type) || (!data_type)) &&
-                handle->id_group[i] == (int) id_group &&
-                handle->id_tag[i] == (int) id_tag &&
-                handle->user_index[i] == user_index)
+        const unsigned int b = oskar_binary_index_hash(0, (int) id_group,
+                (int) id_tag, user_index, 0, 0) &
+                (unsigned int) (handle->index_num_buckets - 1);
+        for (i = handle->index_bucket[b]; i >= 0; i = handle->index_next[i])
         {
-            /* Match found, so break. */
-            break;
+            if (i >= handle->query_search_start &&
+                    !(handle->extended[i]) &&
+                    (handle->data_type[i] == (int) data_type ||
+                            !data_type) &&
+                    handle->id_group[i] == (int) id_group &&
+                    handle->id_tag[i] == (int) id_tag &&
+                    handle->user_index[i] == user_index)
+            {
+                /* Match found, so break. */
+                break;
+            }
         }
     }
 
     /* Check if tag is not present. */
-    if (i >= handle->num_chunks)
+    if (i < 0)
     {
         *status = OSKAR_ERR_BINARY_TAG_NOT_FOUND;
         return -1;
@@ -106,27 +115,36 @@ int oskar_binary_query_ext(const oskar_Binary* handle,
     }
 
     /* Find the tag in the index. */
-    for (i = handle->query_search_start; i < handle->num_chunks; ++i)
+    i = -1;
+    if (handle->index_num_buckets > 0)
     {
-        if (handle->extended[i] &&
-                ((handle->data_type[i] == (int) data_type) || (!data_type)) &&
-                handle->id_group[i] == (int) lgroup &&
-                handle->id_tag[i] == (int) ltag &&
-                handle->user_index[i] == user_index)
+        const unsigned int b = oskar_binary_index_hash(1, lgroup, ltag,
+                user_index, name_group, name_tag) &
+                (unsigned int) (handle->index_num_buckets - 1);
+        for (i = handle->index_bucket[b]; i >= 0; i = handle->index_next[i])
         {
-            /* Possible match: check names. */
-            if (strcmp(name_group, handle->name_group[i]))
-                continue;
-            if (strcmp(name_tag, handle->name_tag[i]))
-                continue;
-
-            /* Match found, so break. */
-            break;
+            if (i >= handle->query_search_start &&
+                    handle->extended[i] &&
+                    (handle->data_type[i] == (int) data_type ||
+                            !data_type) &&
+                    handle->id_group[i] == (int) lgroup &&
+                    handle->id_tag[i] == (int) ltag &&
+                    handle->user_index[i] == user_index)
+            {
+                /* Possible match: check names. */
+                if (strcmp(name_group, handle->name_group[i]))
+                    continue;
+                if (strcmp(name_tag, handle->name_tag[i]))
+                    continue;
+
+                /* Match found, so break. */
+                break;
+            }
         }
     }
 
     /* Check if tag is not present. */
-    if (i >= handle->num_chunks)
+    if (i < 0)
     {
         *status = OSKAR_ERR_BINARY_TAG_NOT_FOUND;
         return -1;
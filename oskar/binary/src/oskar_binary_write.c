@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2012-2015, The University of Oxford
+ * Copyright (c) 2012-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -42,7 +42,7 @@ void oskar_binary_write(oskar_Binary* handle, unsigned char data_type,
 {
     oskar_BinaryTag tag;
     size_t block_size;
-    unsigned long crc = 0;
+    unsigned long crc = 0, crc_header = 0;
 
     /* Check if safe to proceed. */
     if (*status) return;
@@ -108,7 +108,10 @@ void oskar_binary_write(oskar_Binary* handle, unsigned char data_type,
 
     /* Tag is complete at this point, so calculate CRC. */
     crc = oskar_crc_compute(handle->crc_data, &tag, sizeof(oskar_BinaryTag));
+    crc_header = crc;
     crc = oskar_crc_update(handle->crc_data, crc, data, data_size);
+    oskar_binary_index_append(handle, ftell(handle->stream), &tag, 0, 0,
+            crc_header, crc);
     if (oskar_endian() != OSKAR_LITTLE_ENDIAN)
         oskar_endian_swap(&crc, sizeof(unsigned long));
 
@@ -155,7 +158,7 @@ void oskar_binary_write_ext(oskar_Binary* handle, unsigned char data_type,
 {
     oskar_BinaryTag tag;
     size_t block_size, lgroup, ltag;
-    unsigned long crc = 0;
+    unsigned long crc = 0, crc_header = 0;
 
     /* Check if safe to proceed. */
     if (*status) return;
@@ -233,7 +236,10 @@ void oskar_binary_write_ext(oskar_Binary* handle, unsigned char data_type,
     crc = oskar_crc_compute(handle->crc_data, &tag, sizeof(oskar_BinaryTag));
     crc = oskar_crc_update(handle->crc_data, crc, name_group, tag.group.bytes);
     crc = oskar_crc_update(handle->crc_data, crc, name_tag, tag.tag.bytes);
+    crc_header = crc;
     crc = oskar_crc_update(handle->crc_data, crc, data, data_size);
+    oskar_binary_index_append(handle, ftell(handle->stream), &tag,
+            name_group, name_tag, crc_header, crc);
     if (oskar_endian() != OSKAR_LITTLE_ENDIAN)
         oskar_endian_swap(&crc, sizeof(unsigned long));
 
@@ -286,6 +292,33 @@ void oskar_binary_write_ext_int(oskar_Binary* handle, const char* name_group,
             name_tag, user_index, sizeof(int), &value, status);
 }
 
+void oskar_binary_write_align(oskar_Binary* handle, size_t alignment,
+        int* status)
+{
+    char padding[64];
+    size_t pos;
+    const size_t tag_size = sizeof(oskar_BinaryTag);
+
+    /* Check if safe to proceed. */
+    if (*status || alignment < 2) return;
+    if (alignment > sizeof(padding))
+    {
+        *status = OSKAR_ERR_BINARY_FORMAT_BAD;
+        return;
+    }
+
+    /* Check if the next payload is already aligned. */
+    pos = (size_t) ftell(handle->stream);
+    if ((pos + tag_size) % alignment == 0) return;
+
+    /* Write a padding chunk (tag, payload, CRC) that moves the next
+     * payload to the required alignment. */
+    memset(padding, 0, sizeof(padding));
+    oskar_binary_write(handle, OSKAR_CHAR, 0, 0, 0,
+            (alignment - (pos + 2 * tag_size + 4) % alignment) % alignment,
+            padding, status);
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -172,10 +172,48 @@ int main(void)
         status = 0;
     }
 
+    /* Check that the query search start is respected. */
+    {
+        int index;
+        index = oskar_binary_query(h, 0, 0, 0, 12345, 0, &status);
+        ASSERT_INT_EQ(0, status);
+        ASSERT_INT_EQ(0, index);
+        oskar_binary_set_query_search_start(h, index + 1, &status);
+        oskar_binary_query(h, 0, 0, 0, 12345, 0, &status);
+        ASSERT_INT_EQ((int) OSKAR_ERR_BINARY_TAG_NOT_FOUND, status);
+        status = 0;
+        oskar_binary_set_query_search_start(h, 0, &status);
+    }
+
     /* Free the handle. */
     oskar_binary_free(h);
     ASSERT_INT_EQ(0, status);
 
+    /* Append a tag, so the file no longer ends with its index chunk,
+     * and check that all tags can still be found by scanning the file. */
+    {
+        int num_tags_indexed = 0, d = 0;
+        h = oskar_binary_create(filename, 'r', &status);
+        num_tags_indexed = oskar_binary_num_tags(h);
+        oskar_binary_free(h);
+        ASSERT_INT_EQ(0, status);
+        ASSERT_INT_EQ(8, num_tags_indexed);
+        h = oskar_binary_create(filename, 'a', &status);
+        oskar_binary_write_int(h, 99, 1, 4, 4321, &status);
+        oskar_binary_free(h);
+        ASSERT_INT_EQ(0, status);
+        h = oskar_binary_create(filename, 'r', &status);
+        ASSERT_INT_EQ(0, status);
+        ASSERT_INT_EQ(num_tags_indexed + 1, oskar_binary_num_tags(h));
+        oskar_binary_read_int(h, 99, 1, 4, &d, &status);
+        ASSERT_INT_EQ(0, status);
+        ASSERT_INT_EQ(4321, d);
+        oskar_binary_read_int(h, 12, 0, 0, &b, &status);
+        ASSERT_INT_EQ(0, status);
+        ASSERT_INT_EQ(b1, b);
+        oskar_binary_free(h);
+    }
+
     /* Remove the file. */
     remove(filename);
 
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "binary/oskar_binary.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*
+ * Writes a file containing the given number of blocks, each made of
+ * several standard tags and one extended tag with the block index as the
+ * user index, then times opening the file and reading every tag back.
+ */
+int main(int argc, char** argv)
+{
+    const char filename[] = "temp_test_binary_benchmark.dat";
+    const int num_tags_per_block = 5, num_values = 64;
+    int b, i, j, num_blocks = 10000, status = 0;
+    double data[64], t_open, t_read;
+    oskar_Binary* h;
+    clock_t t;
+
+    if (argc > 1) num_blocks = atoi(argv[1]);
+    if (num_blocks < 1)
+    {
+        fprintf(stderr, "Usage: %s [number of blocks]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    /* Write the file. */
+    h = oskar_binary_create(filename, 'w', &status);
+    for (b = 0; b < num_blocks && !status; ++b)
+    {
+        for (j = 0; j < num_tags_per_block; ++j)
+        {
+            for (i = 0; i < num_values; ++i) data[i] = b + j + i;
+            oskar_binary_write(h, OSKAR_DOUBLE, 1, (unsigned char) j, b,
+                    sizeof(data), data, &status);
+        }
+        oskar_binary_write_ext_int(h, "benchmark", "block", b, b, &status);
+    }
+    oskar_binary_free(h);
+    if (status)
+    {
+        fprintf(stderr, "Error writing file (code %d).\n", status);
+        remove(filename);
+        return EXIT_FAILURE;
+    }
+
+    /* Open the file. */
+    t = clock();
+    h = oskar_binary_create(filename, 'r', &status);
+    t_open = (double)(clock() - t) / CLOCKS_PER_SEC;
+
+    /* Read all the blocks back, and check the values. */
+    t = clock();
+    for (b = 0; b < num_blocks && !status; ++b)
+    {
+        int value = -1;
+        for (j = 0; j < num_tags_per_block; ++j)
+        {
+            oskar_binary_read(h, OSKAR_DOUBLE, 1, (unsigned char) j, b,
+                    sizeof(data), data, &status);
+            if (data[num_values - 1] != (double)(b + j + num_values - 1))
+                status = OSKAR_ERR_BINARY_FILE_INVALID;
+        }
+        oskar_binary_read_ext_int(h, "benchmark", "block", b, &value, &status);
+        if (value != b) status = OSKAR_ERR_BINARY_FILE_INVALID;
+    }
+    t_read = (double)(clock() - t) / CLOCKS_PER_SEC;
+    oskar_binary_free(h);
+    remove(filename);
+    if (status)
+    {
+        fprintf(stderr, "Error reading file (code %d).\n", status);
+        return EXIT_FAILURE;
+    }
+
+    printf("Blocks: %d, tags: %d\n", num_blocks,
+            num_blocks * (num_tags_per_block + 1));
+    printf("Open: %.3f sec\n", t_open);
+    printf("Read: %.3f sec\n", t_read);
+    return 0;
+}
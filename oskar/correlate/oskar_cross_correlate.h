@@ -74,6 +74,26 @@ void oskar_cross_correlate(int num_sources,  const oskar_Jones* jones,
         double gast, double frequency_hz, int offset_out, oskar_Mem* vis,
         int* status);
 
+/**
+ * @brief Multiply a set of Jones matrices with a set of source brightness
+ * matrices to form visibilities, using the supplied workspace.
+ *
+ * @details
+ * This is the same as oskar_cross_correlate(), except that the workspace
+ * used by the vectorised CPU correlator is held in \p work, so that it can
+ * be reused between calls. If \p work is NULL, or the data are not in CPU
+ * memory, this is equivalent to oskar_cross_correlate().
+ *
+ * @param[in,out] work      Workspace for the vectorised CPU correlator,
+ *                          or NULL. It is resized as needed.
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_ws(int num_sources,  const oskar_Jones* jones,
+        const oskar_Sky* sky, const oskar_Telescope* tel,
+        const oskar_Mem* u, const oskar_Mem* v, const oskar_Mem* w,
+        double gast, double frequency_hz, int offset_out, oskar_Mem* vis,
+        oskar_Mem* work, int* status);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_CROSS_CORRELATE_BEAM_H_
+#define OSKAR_CROSS_CORRELATE_BEAM_H_
+
+/**
+ * @file oskar_cross_correlate_beam.h
+ */
+
+#include <oskar_global.h>
+#include <telescope/oskar_telescope.h>
+#include <interferometer/oskar_jones.h>
+#include <sky/oskar_sky.h>
+#include <mem/oskar_mem.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Forms visibilities directly from station beams and station
+ * coordinates.
+ *
+ * @details
+ * This function is equivalent to evaluating Jones K using
+ * oskar_evaluate_jones_K(), joining it with the station beams in \p beam,
+ * and calling oskar_cross_correlate() with the result.
+ *
+ * The interferometer phase is instead evaluated for blocks of stations
+ * and sources inside the correlator, so the Jones K and joined Jones
+ * arrays are not needed.
+ *
+ * The station beams may either be supplied for every station, or
+ * for a single station if the beams are identical.
+ *
+ * Sources with Stokes I values outside the range
+ * (\p source_filter_min, \p source_filter_max] are ignored.
+ *
+ * This is currently only available for data in CPU memory.
+ *
+ * @param[in]  num_sources  Number of sources to use.
+ * @param[in]  beam         Station beams (Jones E, or E joined with R).
+ * @param[in]  sky          Sky model.
+ * @param[in]  tel          Telescope model.
+ * @param[in]  u            Station u coordinates, in metres.
+ * @param[in]  v            Station v coordinates, in metres.
+ * @param[in]  w            Station w coordinates, in metres.
+ * @param[in]  gast         Greenwich apparent sidereal time, in radians.
+ * @param[in]  frequency_hz Current observing frequency, in Hz.
+ * @param[in]  source_filter_min Minimum allowed Stokes I value.
+ * @param[in]  source_filter_max Maximum allowed Stokes I value.
+ * @param[in]  ignore_w_components If true, set all w-coordinates to 0.
+ * @param[in]  offset_out   Output visibility start offset.
+ * @param[out] vis          Output visibility amplitudes.
+ * @param[in,out] work      Workspace for the vectorised CPU correlator,
+ *                          or NULL to allocate it for this call only.
+ *                          It is resized as needed, and can be reused
+ *                          between calls.
+ * @param[in,out] status    Status return code.
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_beam(int num_sources, const oskar_Jones* beam,
+        const oskar_Sky* sky, const oskar_Telescope* tel,
+        const oskar_Mem* u, const oskar_Mem* v, const oskar_Mem* w,
+        double gast, double frequency_hz, double source_filter_min,
+        double source_filter_max, int ignore_w_components, int offset_out,
+        oskar_Mem* vis, oskar_Mem* work, int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_CROSS_CORRELATE_BEAM_H_ */
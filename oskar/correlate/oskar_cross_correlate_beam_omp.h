@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_CROSS_CORRELATE_BEAM_OMP_H_
+#define OSKAR_CROSS_CORRELATE_BEAM_OMP_H_
+
+/**
+ * @file oskar_cross_correlate_beam_omp.h
+ */
+
+#include <oskar_global.h>
+#include <utility/oskar_vector_types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Correlate function for station beams, evaluating the interferometer
+ * phase on the fly (single precision).
+ *
+ * @details
+ * Forms visibilities on all baselines by correlating station beams for
+ * pairs of stations and summing along the source dimension.
+ *
+ * The interferometer phase (Jones K) of each station is evaluated for
+ * blocks of sources and stations as they are needed, so neither Jones K
+ * nor its product with the station beams is stored.
+ *
+ * Sources with Stokes I outside the range (\p source_filter_min,
+ * \p source_filter_max] are ignored.
+ *
+ * Note that the station x, y coordinates must be in the ECEF frame.
+ *
+ * @param[in] use_extended   If set, use Gaussian parameters a, b and c.
+ * @param[in] num_sources    Number of sources.
+ * @param[in] num_stations   Number of stations.
+ * @param[in] num_beams      Number of station beams (1, if shared).
+ * @param[in] offset_out     Output visibility start offset.
+ * @param[in] beam           Station beams (Jones E) for each source.
+ * @param[in] I              Source Stokes I values, in Jy.
+ * @param[in] Q              Source Stokes Q values, in Jy.
+ * @param[in] U              Source Stokes U values, in Jy.
+ * @param[in] V              Source Stokes V values, in Jy.
+ * @param[in] l              Source l-direction cosines from phase centre.
+ * @param[in] m              Source m-direction cosines from phase centre.
+ * @param[in] n              Source n-direction cosines from phase centre.
+ * @param[in] a              Source Gaussian parameter a.
+ * @param[in] b              Source Gaussian parameter b.
+ * @param[in] c              Source Gaussian parameter c.
+ * @param[in] station_u      Station u-coordinates, in metres.
+ * @param[in] station_v      Station v-coordinates, in metres.
+ * @param[in] station_w      Station w-coordinates, in metres.
+ * @param[in] station_x      Station x-coordinates, in metres.
+ * @param[in] station_y      Station y-coordinates, in metres.
+ * @param[in] uv_min_lambda  Minimum allowed UV length, in wavelengths.
+ * @param[in] uv_max_lambda  Maximum allowed UV length, in wavelengths.
+ * @param[in] inv_wavelength Inverse of the wavelength, in metres.
+ * @param[in] frac_bandwidth Bandwidth divided by frequency.
+ * @param[in] time_int_sec   Time averaging interval, in seconds.
+ * @param[in] gha0_rad       Greenwich Hour Angle of phase centre, in radians.
+ * @param[in] dec0_rad       Declination of phase centre, in radians.
+ * @param[in] source_filter_min   Minimum Stokes I value to include.
+ * @param[in] source_filter_max   Maximum Stokes I value to include.
+ * @param[in] ignore_w_components If set, ignore w in the phase.
+ * @param[in,out] vis        Modified output complex visibilities.
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_beam_omp_f(int use_extended,
+        int num_sources, int num_stations, int num_beams, int offset_out,
+        const float4c* beam, const float* I, const float* Q,
+        const float* U, const float* V,
+        const float* l, const float* m, const float* n,
+        const float* a, const float* b, const float* c,
+        const float* station_u, const float* station_v,
+        const float* station_w, const float* station_x,
+        const float* station_y, float uv_min_lambda, float uv_max_lambda,
+        float inv_wavelength, float frac_bandwidth, float time_int_sec,
+        float gha0_rad, float dec0_rad, float source_filter_min,
+        float source_filter_max, int ignore_w_components, float4c* vis);
+
+/**
+ * @brief
+ * Correlate function for station beams, evaluating the interferometer
+ * phase on the fly (double precision).
+ *
+ * @details
+ * Parameters are the same as those for oskar_cross_correlate_beam_omp_f().
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_beam_omp_d(int use_extended,
+        int num_sources, int num_stations, int num_beams, int offset_out,
+        const double4c* beam, const double* I, const double* Q,
+        const double* U, const double* V,
+        const double* l, const double* m, const double* n,
+        const double* a, const double* b, const double* c,
+        const double* station_u, const double* station_v,
+        const double* station_w, const double* station_x,
+        const double* station_y, double uv_min_lambda, double uv_max_lambda,
+        double inv_wavelength, double frac_bandwidth, double time_int_sec,
+        double gha0_rad, double dec0_rad, double source_filter_min,
+        double source_filter_max, int ignore_w_components, double4c* vis);
+
+/**
+ * @brief
+ * Correlate function for scalar station beams, evaluating the
+ * interferometer phase on the fly (single precision).
+ *
+ * @details
+ * As oskar_cross_correlate_beam_omp_f(), but for scalar station beams
+ * and Stokes I only.
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_scalar_beam_omp_f(int use_extended,
+        int num_sources, int num_stations, int num_beams, int offset_out,
+        const float2* beam, const float* I,
+        const float* l, const float* m, const float* n,
+        const float* a, const float* b, const float* c,
+        const float* station_u, const float* station_v,
+        const float* station_w, const float* station_x,
+        const float* station_y, float uv_min_lambda, float uv_max_lambda,
+        float inv_wavelength, float frac_bandwidth, float time_int_sec,
+        float gha0_rad, float dec0_rad, float source_filter_min,
+        float source_filter_max, int ignore_w_components, float2* vis);
+
+/**
+ * @brief
+ * Correlate function for scalar station beams, evaluating the
+ * interferometer phase on the fly (double precision).
+ *
+ * @details
+ * As oskar_cross_correlate_beam_omp_d(), but for scalar station beams
+ * and Stokes I only.
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_scalar_beam_omp_d(int use_extended,
+        int num_sources, int num_stations, int num_beams, int offset_out,
+        const double2* beam, const double* I,
+        const double* l, const double* m, const double* n,
+        const double* a, const double* b, const double* c,
+        const double* station_u, const double* station_v,
+        const double* station_w, const double* station_x,
+        const double* station_y, double uv_min_lambda, double uv_max_lambda,
+        double inv_wavelength, double frac_bandwidth, double time_int_sec,
+        double gha0_rad, double dec0_rad, double source_filter_min,
+        double source_filter_max, int ignore_w_components, double2* vis);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_CROSS_CORRELATE_BEAM_OMP_H_ */
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_CROSS_CORRELATE_CHANNELS_H_
+#define OSKAR_CROSS_CORRELATE_CHANNELS_H_
+
+/**
+ * @file oskar_cross_correlate_channels.h
+ */
+
+#include <oskar_global.h>
+#include <telescope/oskar_telescope.h>
+#include <interferometer/oskar_jones.h>
+#include <sky/oskar_sky.h>
+#include <mem/oskar_mem.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Forms visibilities for a batch of channels in one pass over a set
+ * of Jones matrices.
+ *
+ * @details
+ * This function is equivalent to calling oskar_cross_correlate() for each
+ * channel in turn, when the Jones matrices differ between channels only
+ * by the interferometer phase (Jones K).
+ *
+ * The supplied Jones matrices must be those for the first channel of the
+ * batch. The Jones matrices for channel \p c are obtained by multiplying
+ * them by the phase increments in \p jones_inc raised to the power \p c,
+ * where \p jones_inc is Jones K evaluated at the channel separation
+ * \p freq_inc_hz. This recurrence is evaluated inside the correlator,
+ * so the Jones matrices are loaded only once for all channels.
+ *
+ * The Stokes parameters for each channel must be supplied in the
+ * arrays \p stokes_I, \p stokes_Q, \p stokes_U and \p stokes_V,
+ * with the source dimension varying fastest, as written by
+ * oskar_sky_evaluate_flux(). Other source parameters are taken from \p sky.
+ *
+ * Visibilities for channel \p c are added at
+ * \p offset_out + \p c * \p stride_out.
+ *
+ * This is currently only available for data in CPU memory.
+ *
+ * @param[in]  num_sources  Number of sources to use.
+ * @param[in]  num_channels Number of channels in the batch.
+ * @param[in]  jones        Set of Jones matrices for the first channel.
+ * @param[in]  jones_inc    Jones K phase increments between channels.
+ * @param[in]  sky          Sky model.
+ * @param[in]  stokes_I     Source Stokes I values for all channels.
+ * @param[in]  stokes_Q     Source Stokes Q values for all channels.
+ * @param[in]  stokes_U     Source Stokes U values for all channels.
+ * @param[in]  stokes_V     Source Stokes V values for all channels.
+ * @param[in]  tel          Telescope model.
+ * @param[in]  u            Station u coordinates, in metres.
+ * @param[in]  v            Station v coordinates, in metres.
+ * @param[in]  w            Station w coordinates, in metres.
+ * @param[in]  gast         Greenwich apparent sidereal time, in radians.
+ * @param[in]  freq_start_hz Frequency of the first channel, in Hz.
+ * @param[in]  freq_inc_hz  Frequency increment between channels, in Hz.
+ * @param[in]  offset_out   Output visibility start offset.
+ * @param[in]  stride_out   Output visibility stride between channels.
+ * @param[out] vis          Output visibility amplitudes.
+ * @param[in,out] status    Status return code.
+ */
+OSKAR_EXPORT
+void oskar_cross_correlate_channels(int num_sources, int num_channels,
+        const oskar_Jones* jones, const oskar_Jones* jones_inc,
+        const oskar_Sky* sky, const oskar_Mem* stokes_I,
+        const oskar_Mem* stokes_Q, const oskar_Mem* stokes_U,
+        const oskar_Mem* stokes_V, const oskar_Telescope* tel,
+        const oskar_Mem* u, const oskar_Mem* v, const oskar_Mem* w,
+        double gast, double freq_start_hz, double freq_inc_hz,
+        int offset_out, int stride_out, oskar_Mem* vis, int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_CROSS_CORRELATE_CHANNELS_H_ */
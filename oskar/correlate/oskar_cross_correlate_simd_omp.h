@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_CROSS_CORRELATE_SIMD_OMP_H_
+#define OSKAR_CROSS_CORRELATE_SIMD_OMP_H_
+
+/**
+ * @file oskar_cross_correlate_simd_omp.h
+ */
+
+#include <oskar_global.h>
+#include <utility/oskar_vector_types.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Vectorised correlate function for point or Gaussian sources
+ * (single precision).
+ *
+ * @details
+ * Forms visibilities on all baselines by correlating Jones matrices for pairs
+ * of stations and summing along the source dimension.
+ *
+ * The Jones matrices are first transposed into a structure-of-arrays layout,
+ * so that the matrix products and the smearing terms can be evaluated for
+ * several sources at once in each SIMD lane. The widest instruction set
+ * supported by the host CPU is selected at run time.
+ *
+ * The transposed matrices are held in \p work, which must hold at least
+ * the number of elements returned by
+ * oskar_cross_correlate_simd_omp_work_size(). Its contents on entry
+ * are ignored, so the same buffer can be reused for every call.
+ *
+ * The function returns 0 without doing anything if \p work is NULL.
+ * In this case, the caller should use the reference kernel instead.
+ *
+ * Parameters are the same as those for
+ * oskar_cross_correlate_gaussian_omp_f(), except for \p use_extended
+ * and \p work.
+ *
+ * @param[in] use_extended   If set, use Gaussian parameters a, b and c.
+ * @param[in] work           Work buffer, or NULL.
+ *
+ * @return 1 if visibilities were computed, 0 otherwise.
+ */
+OSKAR_EXPORT
+int oskar_cross_correlate_simd_omp_f(int use_extended,
+        int num_sources, int num_stations, int offset_out,
+        const float4c* jones, const float* I, const float* Q,
+        const float* U, const float* V,
+        const float* l, const float* m, const float* n,
+        const float* a, const float* b, const float* c,
+        const float* station_u, const float* station_v,
+        const float* station_w, const float* station_x,
+        const float* station_y, float uv_min_lambda, float uv_max_lambda,
+        float inv_wavelength, float frac_bandwidth, float time_int_sec,
+        float gha0_rad, float dec0_rad, float4c* vis, float* work);
+
+/**
+ * @brief
+ * Vectorised correlate function for point or Gaussian sources
+ * (double precision).
+ *
+ * @details
+ * See oskar_cross_correlate_simd_omp_f().
+ *
+ * @return 1 if visibilities were computed, 0 otherwise.
+ */
+OSKAR_EXPORT
+int oskar_cross_correlate_simd_omp_d(int use_extended,
+        int num_sources, int num_stations, int offset_out,
+        const double4c* jones, const double* I, const double* Q,
+        const double* U, const double* V,
+        const double* l, const double* m, const double* n,
+        const double* a, const double* b, const double* c,
+        const double* station_u, const double* station_v,
+        const double* station_w, const double* station_x,
+        const double* station_y, double uv_min_lambda, double uv_max_lambda,
+        double inv_wavelength, double frac_bandwidth, double time_int_sec,
+        double gha0_rad, double dec0_rad, double4c* vis, double* work);
+
+/**
+ * @brief
+ * Vectorised correlate function for station beams, evaluating the
+ * interferometer phase on the fly (single precision).
+ *
+ * @details
+ * As oskar_cross_correlate_simd_omp_f(), but the Jones matrices are formed
+ * by multiplying the station beams by the interferometer phase (Jones K)
+ * while they are transposed.
+ *
+ * Parameters are the same as those for oskar_cross_correlate_beam_omp_f(),
+ * except for \p use_extended and \p work.
+ *
+ * @return 1 if visibilities were computed, 0 otherwise.
+ */
+OSKAR_EXPORT
+int oskar_cross_correlate_simd_beam_omp_f(int use_extended,
+        int num_sources, int num_stations, int num_beams, int offset_out,
+        const float4c* beam, const float* I, const float* Q,
+        const float* U, const float* V,
+        const float* l, const float* m, const float* n,
+        const float* a, const float* b, const float* c,
+        const float* station_u, const float* station_v,
+        const float* station_w, const float* station_x,
+        const float* station_y, float uv_min_lambda, float uv_max_lambda,
+        float inv_wavelength, float frac_bandwidth, float time_int_sec,
+        float gha0_rad, float dec0_rad, float source_filter_min,
+        float source_filter_max, int ignore_w_components, float4c* vis,
+        float* work);
+
+/**
+ * @brief
+ * Vectorised correlate function for station beams, evaluating the
+ * interferometer phase on the fly (double precision).
+ *
+ * @details
+ * See oskar_cross_correlate_simd_beam_omp_f().
+ *
+ * @return 1 if visibilities were computed, 0 otherwise.
+ */
+OSKAR_EXPORT
+int oskar_cross_correlate_simd_beam_omp_d(int use_extended,
+        int num_sources, int num_stations, int num_beams, int offset_out,
+        const double4c* beam, const double* I, const double* Q,
+        const double* U, const double* V,
+        const double* l, const double* m, const double* n,
+        const double* a, const double* b, const double* c,
+        const double* station_u, const double* station_v,
+        const double* station_w, const double* station_x,
+        const double* station_y, double uv_min_lambda, double uv_max_lambda,
+        double inv_wavelength, double frac_bandwidth, double time_int_sec,
+        double gha0_rad, double dec0_rad, double source_filter_min,
+        double source_filter_max, int ignore_w_components, double4c* vis,
+        double* work);
+
+/**
+ * @brief
+ * Returns the size of the work buffer needed by the vectorised correlator.
+ *
+ * @details
+ * Returns the number of real elements (float or double, to match the
+ * precision of the data) needed to correlate \p num_sources sources on
+ * \p num_stations stations.
+ *
+ * @param[in] num_sources  Number of sources.
+ * @param[in] num_stations Number of stations.
+ */
+OSKAR_EXPORT
+size_t oskar_cross_correlate_simd_omp_work_size(int num_sources,
+        int num_stations);
+
+/**
+ * @brief
+ * Returns the name of the instruction set used by the vectorised correlator.
+ *
+ * @details
+ * Returns "AVX-512", "AVX2" or "generic", depending on what the host CPU
+ * supports.
+ */
+OSKAR_EXPORT
+const char* oskar_cross_correlate_simd_omp_isa(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* include guard */
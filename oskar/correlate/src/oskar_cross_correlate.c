@@ -31,6 +31,7 @@
 #include "correlate/oskar_cross_correlate_omp.h"
 #include "correlate/oskar_cross_correlate_scalar_cuda.h"
 #include "correlate/oskar_cross_correlate_scalar_omp.h"
+#include "correlate/oskar_cross_correlate_simd_omp.h"
 #include "utility/oskar_device.h"
 
 #include <float.h>
@@ -45,6 +46,16 @@ void oskar_cross_correlate(int num_sources,  const oskar_Jones* jones,
         const oskar_Mem* u, const oskar_Mem* v, const oskar_Mem* w,
         double gast, double frequency_hz, int offset_out, oskar_Mem* vis,
         int* status)
+{
+    oskar_cross_correlate_ws(num_sources, jones, sky, tel, u, v, w,
+            gast, frequency_hz, offset_out, vis, 0, status);
+}
+
+void oskar_cross_correlate_ws(int num_sources,  const oskar_Jones* jones,
+        const oskar_Sky* sky, const oskar_Telescope* tel,
+        const oskar_Mem* u, const oskar_Mem* v, const oskar_Mem* w,
+        double gast, double frequency_hz, int offset_out, oskar_Mem* vis,
+        oskar_Mem* work, int* status)
 {
     const oskar_Mem *J, *src_a, *src_b, *src_c, *src_l, *src_m, *src_n;
     const oskar_Mem *src_I, *src_Q, *src_U, *src_V, *x, *y;
@@ -134,6 +145,79 @@ void oskar_cross_correlate(int num_sources,  const oskar_Jones* jones,
     x = oskar_telescope_station_true_x_offset_ecef_metres_const(tel);
     y = oskar_telescope_station_true_y_offset_ecef_metres_const(tel);
 
+    /* Use the vectorised CPU correlator, if its workspace is available. */
+    if (location == OSKAR_CPU && oskar_type_is_matrix(jones_type))
+    {
+        int done = 0, work_status = 0;
+        oskar_Mem* temp = 0;
+        if (!work)
+            work = temp = oskar_mem_create(base_type, OSKAR_CPU, 0,
+                    &work_status);
+        else if (oskar_mem_location(work) != OSKAR_CPU)
+        {
+            *status = OSKAR_ERR_BAD_LOCATION;
+            return;
+        }
+        else if (oskar_mem_type(work) != base_type)
+        {
+            *status = OSKAR_ERR_TYPE_MISMATCH;
+            return;
+        }
+
+        /* If the workspace cannot be allocated, use the reference kernel. */
+        oskar_mem_ensure(work, oskar_cross_correlate_simd_omp_work_size(
+                num_sources, num_stations), &work_status);
+        if (!work_status && base_type == OSKAR_SINGLE)
+            done = oskar_cross_correlate_simd_omp_f(use_extended,
+                    num_sources, num_stations, offset_out,
+                    oskar_mem_float4c_const(J, status),
+                    oskar_mem_float_const(src_I, status),
+                    oskar_mem_float_const(src_Q, status),
+                    oskar_mem_float_const(src_U, status),
+                    oskar_mem_float_const(src_V, status),
+                    oskar_mem_float_const(src_l, status),
+                    oskar_mem_float_const(src_m, status),
+                    oskar_mem_float_const(src_n, status),
+                    oskar_mem_float_const(src_a, status),
+                    oskar_mem_float_const(src_b, status),
+                    oskar_mem_float_const(src_c, status),
+                    oskar_mem_float_const(u, status),
+                    oskar_mem_float_const(v, status),
+                    oskar_mem_float_const(w, status),
+                    oskar_mem_float_const(x, status),
+                    oskar_mem_float_const(y, status),
+                    (float) uv_filter_min, (float) uv_filter_max,
+                    (float) inv_wavelength, (float) frac_bandwidth,
+                    (float) time_avg, (float) gha0, (float) dec0,
+                    oskar_mem_float4c(vis, status),
+                    oskar_mem_float(work, status));
+        else if (!work_status)
+            done = oskar_cross_correlate_simd_omp_d(use_extended,
+                    num_sources, num_stations, offset_out,
+                    oskar_mem_double4c_const(J, status),
+                    oskar_mem_double_const(src_I, status),
+                    oskar_mem_double_const(src_Q, status),
+                    oskar_mem_double_const(src_U, status),
+                    oskar_mem_double_const(src_V, status),
+                    oskar_mem_double_const(src_l, status),
+                    oskar_mem_double_const(src_m, status),
+                    oskar_mem_double_const(src_n, status),
+                    oskar_mem_double_const(src_a, status),
+                    oskar_mem_double_const(src_b, status),
+                    oskar_mem_double_const(src_c, status),
+                    oskar_mem_double_const(u, status),
+                    oskar_mem_double_const(v, status),
+                    oskar_mem_double_const(w, status),
+                    oskar_mem_double_const(x, status),
+                    oskar_mem_double_const(y, status),
+                    uv_filter_min, uv_filter_max, inv_wavelength,
+                    frac_bandwidth, time_avg, gha0, dec0,
+                    oskar_mem_double4c(vis, status),
+                    oskar_mem_double(work, status));
+        oskar_mem_free(temp, &work_status);
+        if (done || *status) return;
+    }
+
     /* Select kernel. */
     if (location == OSKAR_CPU)
     {
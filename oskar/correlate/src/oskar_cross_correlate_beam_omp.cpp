@@ -0,0 +1,610 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "correlate/define_correlate_utils.h"
+#include "correlate/oskar_cross_correlate_beam_omp.h"
+#include "math/define_multiply.h"
+#include "math/oskar_cmath.h"
+#include "math/oskar_kahan_sum.h"
+#include "utility/oskar_kernel_macros.h"
+#include "utility/oskar_vector_types.h"
+
+#include <cstdlib>
+
+/*
+ * Sources are processed in chunks of XCORR_CHUNK, and the Jones matrices
+ * for each chunk are formed once for all stations, by multiplying the
+ * station beams by the interferometer phase. Baselines are then processed
+ * in tiles of XCORR_TILE x XCORR_TILE stations.
+ */
+#define XCORR_TILE 16
+#define XCORR_CHUNK 256
+
+template<typename T1, typename T2>
+struct is_same
+{
+    enum { value = false }; // is_same represents a bool.
+    typedef is_same<T1,T2> type; // to qualify as a metafunction.
+};
+
+template<typename T>
+struct is_same<T,T>
+{
+    enum { value = true };
+    typedef is_same<T,T> type;
+};
+
+/* Multiplies a station beam by a complex phase factor. */
+static inline void scale_beam(float2& b, const float2& k)
+{
+    OSKAR_MUL_COMPLEX_IN_PLACE(float2, b, k)
+}
+
+static inline void scale_beam(double2& b, const double2& k)
+{
+    OSKAR_MUL_COMPLEX_IN_PLACE(double2, b, k)
+}
+
+static inline void scale_beam(float4c& b, const float2& k)
+{
+    OSKAR_MUL_COMPLEX_MATRIX_COMPLEX_SCALAR_IN_PLACE(float2, b, k)
+}
+
+static inline void scale_beam(double4c& b, const double2& k)
+{
+    OSKAR_MUL_COMPLEX_MATRIX_COMPLEX_SCALAR_IN_PLACE(double2, b, k)
+}
+
+/*
+ * Evaluates the Jones matrices for one station and a chunk of sources,
+ * by multiplying the station beam by the interferometer phase (Jones K),
+ * in the same way as oskar_evaluate_jones_K() and oskar_jones_join().
+ * Sources outside the flux range are set to zero.
+ */
+template<typename REAL, typename REAL2, typename JONES>
+static void station_jones(const int a, const int i0, const int i1,
+        const int num_sources, const int num_beams,
+        const JONES* const RESTRICT beam,
+        const REAL* const RESTRICT station_u,
+        const REAL* const RESTRICT station_v,
+        const REAL* const RESTRICT station_w,
+        const REAL* const RESTRICT source_I,
+        const REAL* const RESTRICT source_l,
+        const REAL* const RESTRICT source_m,
+        const REAL* const RESTRICT source_n,
+        const REAL wavenumber, const REAL source_filter_min,
+        const REAL source_filter_max, const int ignore_w_components,
+        JONES* RESTRICT jones)
+{
+    const JONES* const RESTRICT in =
+            &beam[(num_beams == 1 ? 0 : a) * num_sources];
+    const REAL u = station_u[a], v = station_v[a], w = station_w[a];
+    for (int i = i0; i < i1; ++i)
+    {
+        REAL2 k;
+        const REAL f = source_I[i];
+        if (f > source_filter_min && f <= source_filter_max)
+        {
+            REAL phase = u * source_l[i] + v * source_m[i];
+            if (!ignore_w_components)
+                phase += w * (source_n[i] - (REAL) 1);
+            phase *= wavenumber;
+            SINCOS(phase, k.y, k.x);
+        }
+        else
+        {
+            k.x = k.y = (REAL) 0;
+        }
+        jones[i - i0] = in[i];
+        scale_beam(jones[i - i0], k);
+    }
+}
+
+// Returns the station ranges for tile index t in the upper triangle
+// of the baseline matrix.
+static void tile_range(int t, const int num_blocks, const int num_stations,
+        int* q0, int* q1, int* p0, int* p1)
+{
+    // Row bq of the upper triangle holds (num_blocks - bq) tiles.
+    int bq = 0;
+    while (t >= num_blocks - bq)
+    {
+        t -= num_blocks - bq;
+        bq++;
+    }
+    *q0 = bq * XCORR_TILE;
+    *p0 = (bq + t) * XCORR_TILE;
+    *q1 = (*q0 + XCORR_TILE < num_stations) ? *q0 + XCORR_TILE : num_stations;
+    *p1 = (*p0 + XCORR_TILE < num_stations) ? *p0 + XCORR_TILE : num_stations;
+}
+
+template
+<
+// Compile-time parameters.
+bool BANDWIDTH_SMEARING, bool TIME_SMEARING, bool GAUSSIAN,
+typename REAL, typename REAL2, typename REAL4c
+>
+void oskar_xcorr_beam_omp(
+        const int                    num_sources,
+        const int                    num_stations,
+        const int                    num_beams,
+        const int                    offset_out,
+        const REAL4c* const RESTRICT beam,
+        const REAL*   const RESTRICT source_I,
+        const REAL*   const RESTRICT source_Q,
+        const REAL*   const RESTRICT source_U,
+        const REAL*   const RESTRICT source_V,
+        const REAL*   const RESTRICT source_l,
+        const REAL*   const RESTRICT source_m,
+        const REAL*   const RESTRICT source_n,
+        const REAL*   const RESTRICT source_a,
+        const REAL*   const RESTRICT source_b,
+        const REAL*   const RESTRICT source_c,
+        const REAL*   const RESTRICT station_u,
+        const REAL*   const RESTRICT station_v,
+        const REAL*   const RESTRICT station_w,
+        const REAL*   const RESTRICT station_x,
+        const REAL*   const RESTRICT station_y,
+        const REAL                   uv_min_lambda,
+        const REAL                   uv_max_lambda,
+        const REAL                   inv_wavelength,
+        const REAL                   frac_bandwidth,
+        const REAL                   time_int_sec,
+        const REAL                   gha0_rad,
+        const REAL                   dec0_rad,
+        const REAL                   source_filter_min,
+        const REAL                   source_filter_max,
+        const int                    ignore_w_components,
+        REAL4c*             RESTRICT vis)
+{
+    const REAL wavenumber = (REAL) (2.0 * M_PI) * inv_wavelength;
+    const int num_blocks = (num_stations + XCORR_TILE - 1) / XCORR_TILE;
+    const int num_tiles = num_blocks * (num_blocks + 1) / 2;
+    const int num_baselines = num_stations * (num_stations - 1) / 2;
+
+    // Jones matrices for all stations for one chunk of sources,
+    // and running sums for all baselines.
+    REAL4c* jones = (REAL4c*) malloc(num_stations * XCORR_CHUNK *
+            sizeof(REAL4c));
+    REAL4c* acc = (REAL4c*) calloc(2 * num_baselines, sizeof(REAL4c));
+    REAL4c* acc_guard = acc + num_baselines;
+
+#pragma omp parallel
+    {
+        // Loop over chunks of sources.
+        for (int i0 = 0; i0 < num_sources; i0 += XCORR_CHUNK)
+        {
+            const int i1 = (i0 + XCORR_CHUNK < num_sources) ?
+                    i0 + XCORR_CHUNK : num_sources;
+
+            // Evaluate the Jones matrices for the chunk.
+#pragma omp for schedule(static)
+            for (int a = 0; a < num_stations; ++a)
+                station_jones<REAL, REAL2>(a, i0, i1, num_sources,
+                        num_beams, beam, station_u, station_v, station_w,
+                        source_I, source_l, source_m, source_n, wavenumber,
+                        source_filter_min, source_filter_max,
+                        ignore_w_components, &jones[a * XCORR_CHUNK]);
+
+            // Loop over tiles on and above the diagonal of the
+            // baseline matrix, so the Jones matrices for each block of
+            // stations stay in cache while they are reused.
+#pragma omp for schedule(dynamic, 1)
+            for (int t = 0; t < num_tiles; ++t)
+            {
+                int q0, q1, p0, p1;
+                tile_range(t, num_blocks, num_stations, &q0, &q1, &p0, &p1);
+                for (int SQ = q0; SQ < q1; ++SQ)
+                {
+                    // Pointer to source vector for station q.
+                    const REAL4c* const station_q =
+                            &jones[SQ * XCORR_CHUNK - i0];
+
+                    // Loop over baselines for this station in the tile.
+                    for (int SP = (p0 > SQ ? p0 : SQ + 1); SP < p1; ++SP)
+                    {
+                        REAL uv_len, uu, vv, ww, uu2, vv2, uuvv;
+                        REAL du = (REAL) 0, dv = (REAL) 0, dw = (REAL) 0;
+                        REAL4c m1, m2;
+
+                        // Get common baseline values.
+                        OSKAR_BASELINE_TERMS(REAL,
+                                station_u[SP], station_u[SQ],
+                                station_v[SP], station_v[SQ],
+                                station_w[SP], station_w[SQ],
+                                uu, vv, ww, uu2, vv2, uuvv, uv_len);
+
+                        // Apply the baseline length filter.
+                        if (uv_len < uv_min_lambda || uv_len > uv_max_lambda)
+                            continue;
+
+                        // Compute the deltas for time-average smearing.
+                        if (TIME_SMEARING)
+                            OSKAR_BASELINE_DELTAS(REAL,
+                                    station_x[SP], station_x[SQ],
+                                    station_y[SP], station_y[SQ],
+                                    du, dv, dw);
+
+                        // Pointer to source vector for station p.
+                        const REAL4c* const station_p =
+                                &jones[SP * XCORR_CHUNK - i0];
+                        const int b = OSKAR_BASELINE_INDEX(
+                                num_stations, SP, SQ);
+                        REAL4c sum = acc[b], guard = acc_guard[b];
+
+                        // Loop over sources in the chunk.
+                        for (int i = i0; i < i1; ++i)
+                        {
+                            REAL smearing;
+                            if (GAUSSIAN)
+                            {
+                                const REAL t = source_a[i] * uu2 +
+                                        source_b[i] * uuvv +
+                                        source_c[i] * vv2;
+                                smearing = exp((REAL) -t);
+                            }
+                            else smearing = (REAL) 1;
+                            if (BANDWIDTH_SMEARING || TIME_SMEARING)
+                            {
+                                const REAL l = source_l[i];
+                                const REAL m = source_m[i];
+                                const REAL n = source_n[i] - (REAL) 1;
+                                if (BANDWIDTH_SMEARING)
+                                {
+                                    const REAL t = uu * l + vv * m + ww * n;
+                                    smearing *= OSKAR_SINC(REAL, t);
+                                }
+                                if (TIME_SMEARING)
+                                {
+                                    const REAL t = du * l + dv * m + dw * n;
+                                    smearing *= OSKAR_SINC(REAL, t);
+                                }
+                            }
+
+                            // Construct source brightness matrix.
+                            OSKAR_CONSTRUCT_B(REAL, m2, source_I[i],
+                                    source_Q[i], source_U[i], source_V[i])
+
+                            // Multiply first Jones matrix with source
+                            // brightness matrix.
+                            OSKAR_LOAD_MATRIX(m1, station_p[i])
+                            OSKAR_MUL_COMPLEX_MATRIX_HERMITIAN_IN_PLACE(
+                                    REAL2, m1, m2)
+
+                            // Multiply result with second (Hermitian
+                            // transposed) Jones matrix.
+                            OSKAR_LOAD_MATRIX(m2, station_q[i])
+                            OSKAR_MUL_COMPLEX_MATRIX_CONJUGATE_TRANSPOSE_IN_PLACE(
+                                    REAL2, m1, m2)
+
+                            // Multiply result by smearing term and
+                            // accumulate.
+                            if (is_same<REAL, float>::value)
+                            {
+                                OSKAR_KAHAN_SUM_MULTIPLY_COMPLEX_MATRIX(
+                                        REAL, sum, m1, smearing, guard)
+                            }
+                            else
+                            {
+                                OSKAR_MUL_ADD_COMPLEX_MATRIX_SCALAR(
+                                        sum, m1, smearing)
+                            }
+                        }
+                        acc[b] = sum;
+                        acc_guard[b] = guard;
+                    }
+                }
+            }
+        }
+    }
+
+    // Add results to the baseline visibilities.
+    for (int b = 0; b < num_baselines; ++b)
+        OSKAR_ADD_COMPLEX_MATRIX_IN_PLACE(vis[b + offset_out], acc[b]);
+    free(jones);
+    free(acc);
+}
+
+template
+<
+// Compile-time parameters.
+bool BANDWIDTH_SMEARING, bool TIME_SMEARING, bool GAUSSIAN,
+typename REAL, typename REAL2
+>
+void oskar_xcorr_scalar_beam_omp(
+        const int                   num_sources,
+        const int                   num_stations,
+        const int                   num_beams,
+        const int                   offset_out,
+        const REAL2* const RESTRICT beam,
+        const REAL*  const RESTRICT source_I,
+        const REAL*  const RESTRICT source_l,
+        const REAL*  const RESTRICT source_m,
+        const REAL*  const RESTRICT source_n,
+        const REAL*  const RESTRICT source_a,
+        const REAL*  const RESTRICT source_b,
+        const REAL*  const RESTRICT source_c,
+        const REAL*  const RESTRICT station_u,
+        const REAL*  const RESTRICT station_v,
+        const REAL*  const RESTRICT station_w,
+        const REAL*  const RESTRICT station_x,
+        const REAL*  const RESTRICT station_y,
+        const REAL                  uv_min_lambda,
+        const REAL                  uv_max_lambda,
+        const REAL                  inv_wavelength,
+        const REAL                  frac_bandwidth,
+        const REAL                  time_int_sec,
+        const REAL                  gha0_rad,
+        const REAL                  dec0_rad,
+        const REAL                  source_filter_min,
+        const REAL                  source_filter_max,
+        const int                   ignore_w_components,
+        REAL2*             RESTRICT vis)
+{
+    const REAL wavenumber = (REAL) (2.0 * M_PI) * inv_wavelength;
+    const int num_blocks = (num_stations + XCORR_TILE - 1) / XCORR_TILE;
+    const int num_tiles = num_blocks * (num_blocks + 1) / 2;
+    const int num_baselines = num_stations * (num_stations - 1) / 2;
+
+    // Jones scalars for all stations for one chunk of sources,
+    // and running sums for all baselines.
+    REAL2* jones = (REAL2*) malloc(num_stations * XCORR_CHUNK *
+            sizeof(REAL2));
+    REAL2* acc = (REAL2*) calloc(2 * num_baselines, sizeof(REAL2));
+    REAL2* acc_guard = acc + num_baselines;
+
+#pragma omp parallel
+    {
+        // Loop over chunks of sources.
+        for (int i0 = 0; i0 < num_sources; i0 += XCORR_CHUNK)
+        {
+            const int i1 = (i0 + XCORR_CHUNK < num_sources) ?
+                    i0 + XCORR_CHUNK : num_sources;
+
+            // Evaluate the Jones scalars for the chunk.
+#pragma omp for schedule(static)
+            for (int a = 0; a < num_stations; ++a)
+                station_jones<REAL, REAL2>(a, i0, i1, num_sources,
+                        num_beams, beam, station_u, station_v, station_w,
+                        source_I, source_l, source_m, source_n, wavenumber,
+                        source_filter_min, source_filter_max,
+                        ignore_w_components, &jones[a * XCORR_CHUNK]);
+
+            // Loop over tiles on and above the diagonal of the
+            // baseline matrix, so the Jones scalars for each block of
+            // stations stay in cache while they are reused.
+#pragma omp for schedule(dynamic, 1)
+            for (int t = 0; t < num_tiles; ++t)
+            {
+                int q0, q1, p0, p1;
+                tile_range(t, num_blocks, num_stations, &q0, &q1, &p0, &p1);
+                for (int SQ = q0; SQ < q1; ++SQ)
+                {
+                    // Pointer to source vector for station q.
+                    const REAL2* const station_q =
+                            &jones[SQ * XCORR_CHUNK - i0];
+
+                    // Loop over baselines for this station in the tile.
+                    for (int SP = (p0 > SQ ? p0 : SQ + 1); SP < p1; ++SP)
+                    {
+                        REAL uv_len, uu, vv, ww, uu2, vv2, uuvv;
+                        REAL du = (REAL) 0, dv = (REAL) 0, dw = (REAL) 0;
+                        REAL2 t1, t2;
+
+                        // Get common baseline values.
+                        OSKAR_BASELINE_TERMS(REAL,
+                                station_u[SP], station_u[SQ],
+                                station_v[SP], station_v[SQ],
+                                station_w[SP], station_w[SQ],
+                                uu, vv, ww, uu2, vv2, uuvv, uv_len);
+
+                        // Apply the baseline length filter.
+                        if (uv_len < uv_min_lambda || uv_len > uv_max_lambda)
+                            continue;
+
+                        // Compute the deltas for time-average smearing.
+                        if (TIME_SMEARING)
+                            OSKAR_BASELINE_DELTAS(REAL,
+                                    station_x[SP], station_x[SQ],
+                                    station_y[SP], station_y[SQ],
+                                    du, dv, dw);
+
+                        // Pointer to source vector for station p.
+                        const REAL2* const station_p =
+                                &jones[SP * XCORR_CHUNK - i0];
+                        const int b = OSKAR_BASELINE_INDEX(
+                                num_stations, SP, SQ);
+                        REAL2 sum = acc[b], guard = acc_guard[b];
+
+                        // Loop over sources in the chunk.
+                        for (int i = i0; i < i1; ++i)
+                        {
+                            REAL smearing;
+                            if (GAUSSIAN)
+                            {
+                                const REAL t = source_a[i] * uu2 +
+                                        source_b[i] * uuvv +
+                                        source_c[i] * vv2;
+                                smearing = exp((REAL) -t);
+                            }
+                            else smearing = (REAL) 1;
+                            smearing *= source_I[i];
+                            if (BANDWIDTH_SMEARING || TIME_SMEARING)
+                            {
+                                const REAL l = source_l[i];
+                                const REAL m = source_m[i];
+                                const REAL n = source_n[i] - (REAL) 1;
+                                if (BANDWIDTH_SMEARING)
+                                {
+                                    const REAL t = uu * l + vv * m + ww * n;
+                                    smearing *= OSKAR_SINC(REAL, t);
+                                }
+                                if (TIME_SMEARING)
+                                {
+                                    const REAL t = du * l + dv * m + dw * n;
+                                    smearing *= OSKAR_SINC(REAL, t);
+                                }
+                            }
+
+                            // Multiply Jones scalars.
+                            t1 = station_p[i];
+                            t2 = station_q[i];
+                            OSKAR_MUL_COMPLEX_CONJUGATE_IN_PLACE(REAL2, t1, t2)
+
+                            // Multiply result by smearing term and
+                            // accumulate.
+                            if (is_same<REAL, float>::value)
+                            {
+                                OSKAR_KAHAN_SUM_MULTIPLY_COMPLEX(
+                                        REAL, sum, t1, smearing, guard)
+                            }
+                            else
+                            {
+                                sum.x += t1.x * smearing;
+                                sum.y += t1.y * smearing;
+                            }
+                        }
+                        acc[b] = sum;
+                        acc_guard[b] = guard;
+                    }
+                }
+            }
+        }
+    }
+
+    // Add results to the baseline visibilities.
+    for (int b = 0; b < num_baselines; ++b)
+    {
+        vis[b + offset_out].x += acc[b].x;
+        vis[b + offset_out].y += acc[b].y;
+    }
+    free(jones);
+    free(acc);
+}
+
+#define XCORR_KERNEL(BS, TS, GAUSSIAN, REAL, REAL2, REAL4c)                 \
+        oskar_xcorr_beam_omp<BS, TS, GAUSSIAN, REAL, REAL2, REAL4c>         \
+        (num_sources, num_stations, num_beams, offset_out, d_beam,          \
+                d_I, d_Q, d_U, d_V, d_l, d_m, d_n, d_a, d_b, d_c,           \
+                d_station_u, d_station_v, d_station_w,                      \
+                d_station_x, d_station_y, uv_min_lambda, uv_max_lambda,     \
+                inv_wavelength, frac_bandwidth, time_int_sec,               \
+                gha0_rad, dec0_rad, source_filter_min, source_filter_max,   \
+                ignore_w_components, d_vis);
+
+#define XCORR_KERNEL_SCALAR(BS, TS, GAUSSIAN, REAL, REAL2, REAL4c)          \
+        oskar_xcorr_scalar_beam_omp<BS, TS, GAUSSIAN, REAL, REAL2>          \
+        (num_sources, num_stations, num_beams, offset_out, d_beam,          \
+                d_I, d_l, d_m, d_n, d_a, d_b, d_c,                          \
+                d_station_u, d_station_v, d_station_w,                      \
+                d_station_x, d_station_y, uv_min_lambda, uv_max_lambda,     \
+                inv_wavelength, frac_bandwidth, time_int_sec,               \
+                gha0_rad, dec0_rad, source_filter_min, source_filter_max,   \
+                ignore_w_components, d_vis);
+
+#define XCORR_SELECT(KERNEL, GAUSSIAN, REAL, REAL2, REAL4c)                 \
+        if (frac_bandwidth == (REAL)0 && time_int_sec == (REAL)0)           \
+            KERNEL(false, false, GAUSSIAN, REAL, REAL2, REAL4c)             \
+        else if (frac_bandwidth != (REAL)0 && time_int_sec == (REAL)0)      \
+            KERNEL(true, false, GAUSSIAN, REAL, REAL2, REAL4c)              \
+        else if (frac_bandwidth == (REAL)0 && time_int_sec != (REAL)0)      \
+            KERNEL(false, true, GAUSSIAN, REAL, REAL2, REAL4c)              \
+        else                                                                \
+            KERNEL(true, true, GAUSSIAN, REAL, REAL2, REAL4c)
+
+#define XCORR_SELECT_EXTENDED(KERNEL, REAL, REAL2, REAL4c)                  \
+        if (use_extended)                                                   \
+        {                                                                   \
+            XCORR_SELECT(KERNEL, true, REAL, REAL2, REAL4c)                 \
+        }                                                                   \
+        else                                                                \
+        {                                                                   \
+            XCORR_SELECT(KERNEL, false, REAL, REAL2, REAL4c)                \
+        }
+
+void oskar_cross_correlate_beam_omp_f(int use_extended,
+        int num_sources, int num_stations, int num_beams, int offset_out,
+        const float4c* d_beam, const float* d_I, const float* d_Q,
+        const float* d_U, const float* d_V,
+        const float* d_l, const float* d_m, const float* d_n,
+        const float* d_a, const float* d_b, const float* d_c,
+        const float* d_station_u, const float* d_station_v,
+        const float* d_station_w, const float* d_station_x,
+        const float* d_station_y, float uv_min_lambda, float uv_max_lambda,
+        float inv_wavelength, float frac_bandwidth, float time_int_sec,
+        float gha0_rad, float dec0_rad, float source_filter_min,
+        float source_filter_max, int ignore_w_components, float4c* d_vis)
+{
+    XCORR_SELECT_EXTENDED(XCORR_KERNEL, float, float2, float4c)
+}
+
+void oskar_cross_correlate_beam_omp_d(int use_extended,
+        int num_sources, int num_stations, int num_beams, int offset_out,
+        const double4c* d_beam, const double* d_I, const double* d_Q,
+        const double* d_U, const double* d_V,
+        const double* d_l, const double* d_m, const double* d_n,
+        const double* d_a, const double* d_b, const double* d_c,
+        const double* d_station_u, const double* d_station_v,
+        const double* d_station_w, const double* d_station_x,
+        const double* d_station_y, double uv_min_lambda, double uv_max_lambda,
+        double inv_wavelength, double frac_bandwidth, double time_int_sec,
+        double gha0_rad, double dec0_rad, double source_filter_min,
+        double source_filter_max, int ignore_w_components, double4c* d_vis)
+{
+    XCORR_SELECT_EXTENDED(XCORR_KERNEL, double, double2, double4c)
+}
+
+void oskar_cross_correlate_scalar_beam_omp_f(int use_extended,
+        int num_sources, int num_stations, int num_beams, int offset_out,
+        const float2* d_beam, const float* d_I,
+        const float* d_l, const float* d_m, const float* d_n,
+        const float* d_a, const float* d_b, const float* d_c,
+        const float* d_station_u, const float* d_station_v,
+        const float* d_station_w, const float* d_station_x,
+        const float* d_station_y, float uv_min_lambda, float uv_max_lambda,
+        float inv_wavelength, float frac_bandwidth, float time_int_sec,
+        float gha0_rad, float dec0_rad, float source_filter_min,
+        float source_filter_max, int ignore_w_components, float2* d_vis)
+{
+    XCORR_SELECT_EXTENDED(XCORR_KERNEL_SCALAR, float, float2, float4c)
+}
+
+void oskar_cross_correlate_scalar_beam_omp_d(int use_extended,
+        int num_sources, int num_stations, int num_beams, int offset_out,
+        const double2* d_beam, const double* d_I,
+        const double* d_l, const double* d_m, const double* d_n,
+        const double* d_a, const double* d_b, const double* d_c,
+        const double* d_station_u, const double* d_station_v,
+        const double* d_station_w, const double* d_station_x,
+        const double* d_station_y, double uv_min_lambda, double uv_max_lambda,
+        double inv_wavelength, double frac_bandwidth, double time_int_sec,
+        double gha0_rad, double dec0_rad, double source_filter_min,
+        double source_filter_max, int ignore_w_components, double2* d_vis)
+{
+    XCORR_SELECT_EXTENDED(XCORR_KERNEL_SCALAR, double, double2, double4c)
+}
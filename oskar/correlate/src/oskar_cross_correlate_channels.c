@@ -0,0 +1,302 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "correlate/oskar_cross_correlate_channels.h"
+#include "correlate/oskar_cross_correlate_channels_omp.h"
+
+#include <float.h>
+#include <math.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void oskar_cross_correlate_channels(int num_sources, int num_channels,
+        const oskar_Jones* jones, const oskar_Jones* jones_inc,
+        const oskar_Sky* sky, const oskar_Mem* stokes_I,
+        const oskar_Mem* stokes_Q, const oskar_Mem* stokes_U,
+        const oskar_Mem* stokes_V, const oskar_Telescope* tel,
+        const oskar_Mem* u, const oskar_Mem* v, const oskar_Mem* w,
+        double gast, double freq_start_hz, double freq_inc_hz,
+        int offset_out, int stride_out, oskar_Mem* vis, int* status)
+{
+    int c;
+    oskar_Mem *params;
+    const oskar_Mem *J, *J_inc, *src_a, *src_b, *src_c, *src_l, *src_m;
+    const oskar_Mem *src_n, *x, *y;
+    if (*status || num_channels <= 0) return;
+
+    /* Get the data dimensions. */
+    const int num_stations = oskar_telescope_num_stations(tel);
+    const int use_extended = oskar_sky_use_extended(sky);
+    const size_t num_flux = (size_t)num_channels * (size_t)num_sources;
+
+    /* Get time-average smearing term and Greenwich hour angle. */
+    const double time_avg = oskar_telescope_time_average_sec(tel);
+    const double gha0 = gast - oskar_telescope_phase_centre_ra_rad(tel);
+    const double dec0 = oskar_telescope_phase_centre_dec_rad(tel);
+
+    /* Check data locations. */
+    const int location = oskar_sky_mem_location(sky);
+    if (oskar_telescope_mem_location(tel) != location ||
+            oskar_jones_mem_location(jones) != location ||
+            oskar_jones_mem_location(jones_inc) != location ||
+            oskar_mem_location(stokes_I) != location ||
+            oskar_mem_location(stokes_Q) != location ||
+            oskar_mem_location(stokes_U) != location ||
+            oskar_mem_location(stokes_V) != location ||
+            oskar_mem_location(vis) != location ||
+            oskar_mem_location(u) != location ||
+            oskar_mem_location(v) != location ||
+            oskar_mem_location(w) != location)
+    {
+        *status = OSKAR_ERR_LOCATION_MISMATCH;
+        return;
+    }
+    if (location != OSKAR_CPU)
+    {
+        *status = OSKAR_ERR_BAD_LOCATION;
+        return;
+    }
+
+    /* Check for consistent data types. */
+    const int jones_type = oskar_jones_type(jones);
+    const int base_type = oskar_sky_precision(sky);
+    if (oskar_mem_precision(vis) != base_type ||
+            oskar_type_precision(jones_type) != base_type ||
+            oskar_jones_type(jones_inc) != (base_type | OSKAR_COMPLEX) ||
+            oskar_mem_type(stokes_I) != base_type ||
+            oskar_mem_type(stokes_Q) != base_type ||
+            oskar_mem_type(stokes_U) != base_type ||
+            oskar_mem_type(stokes_V) != base_type ||
+            oskar_mem_type(u) != base_type || oskar_mem_type(v) != base_type ||
+            oskar_mem_type(w) != base_type)
+    {
+        *status = OSKAR_ERR_TYPE_MISMATCH;
+        return;
+    }
+    if (oskar_mem_type(vis) != jones_type)
+    {
+        *status = OSKAR_ERR_TYPE_MISMATCH;
+        return;
+    }
+
+    /* Check the input dimensions. */
+    if (oskar_jones_num_sources(jones) < num_sources ||
+            oskar_jones_num_sources(jones_inc) < num_sources ||
+            oskar_jones_num_stations(jones) != num_stations ||
+            oskar_jones_num_stations(jones_inc) != num_stations ||
+            oskar_mem_length(stokes_I) < num_flux ||
+            oskar_mem_length(stokes_Q) < num_flux ||
+            oskar_mem_length(stokes_U) < num_flux ||
+            oskar_mem_length(stokes_V) < num_flux ||
+            (int)oskar_mem_length(u) != num_stations ||
+            (int)oskar_mem_length(v) != num_stations ||
+            (int)oskar_mem_length(w) != num_stations)
+    {
+        *status = OSKAR_ERR_DIMENSION_MISMATCH;
+        return;
+    }
+
+    /* Evaluate UV filter and bandwidth-smearing terms for each channel:
+     * UV filter limits in wavelengths, inverse wavelength,
+     * and fractional bandwidth. */
+    params = oskar_mem_create(base_type, OSKAR_CPU,
+            4 * (size_t)num_channels, status);
+    if (*status)
+    {
+        oskar_mem_free(params, status);
+        return;
+    }
+    for (c = 0; c < num_channels; ++c)
+    {
+        double uv_filter_min, uv_filter_max;
+        const double frequency_hz = fabs(freq_start_hz + c * freq_inc_hz);
+        const double inv_wavelength = frequency_hz / 299792458.0;
+        const double frac_bandwidth =
+                oskar_telescope_channel_bandwidth_hz(tel) / frequency_hz;
+        uv_filter_min = oskar_telescope_uv_filter_min(tel);
+        uv_filter_max = oskar_telescope_uv_filter_max(tel);
+        if (oskar_telescope_uv_filter_units(tel) == OSKAR_METRES)
+        {
+            uv_filter_min *= inv_wavelength;
+            uv_filter_max *= inv_wavelength;
+        }
+        if (uv_filter_max < 0.0 || uv_filter_max > FLT_MAX)
+            uv_filter_max = FLT_MAX;
+        if (base_type == OSKAR_DOUBLE)
+        {
+            double* p = oskar_mem_double(params, status);
+            p[c] = uv_filter_min;
+            p[c + num_channels] = uv_filter_max;
+            p[c + 2 * num_channels] = inv_wavelength;
+            p[c + 3 * num_channels] = frac_bandwidth;
+        }
+        else
+        {
+            float* p = oskar_mem_float(params, status);
+            p[c] = (float) uv_filter_min;
+            p[c + num_channels] = (float) uv_filter_max;
+            p[c + 2 * num_channels] = (float) inv_wavelength;
+            p[c + 3 * num_channels] = (float) frac_bandwidth;
+        }
+    }
+
+    /* Get handles to arrays. */
+    J = oskar_jones_mem_const(jones);
+    J_inc = oskar_jones_mem_const(jones_inc);
+    src_l = oskar_sky_l_const(sky);
+    src_m = oskar_sky_m_const(sky);
+    src_n = oskar_sky_n_const(sky);
+    src_a = oskar_sky_gaussian_a_const(sky);
+    src_b = oskar_sky_gaussian_b_const(sky);
+    src_c = oskar_sky_gaussian_c_const(sky);
+    x = oskar_telescope_station_true_x_offset_ecef_metres_const(tel);
+    y = oskar_telescope_station_true_y_offset_ecef_metres_const(tel);
+
+    /* Select kernel. */
+    switch (oskar_mem_type(vis))
+    {
+    case OSKAR_SINGLE_COMPLEX_MATRIX:
+    {
+        const float* p = oskar_mem_float_const(params, status);
+        oskar_cross_correlate_channels_omp_f(use_extended,
+                num_sources, num_stations, num_channels,
+                offset_out, stride_out,
+                oskar_mem_float4c_const(J, status),
+                oskar_mem_float2_const(J_inc, status),
+                oskar_mem_float_const(stokes_I, status),
+                oskar_mem_float_const(stokes_Q, status),
+                oskar_mem_float_const(stokes_U, status),
+                oskar_mem_float_const(stokes_V, status),
+                oskar_mem_float_const(src_l, status),
+                oskar_mem_float_const(src_m, status),
+                oskar_mem_float_const(src_n, status),
+                oskar_mem_float_const(src_a, status),
+                oskar_mem_float_const(src_b, status),
+                oskar_mem_float_const(src_c, status),
+                oskar_mem_float_const(u, status),
+                oskar_mem_float_const(v, status),
+                oskar_mem_float_const(w, status),
+                oskar_mem_float_const(x, status),
+                oskar_mem_float_const(y, status),
+                p, p + num_channels, p + 2 * num_channels,
+                p + 3 * num_channels, (float) time_avg,
+                (float) gha0, (float) dec0,
+                oskar_mem_float4c(vis, status));
+        break;
+    }
+    case OSKAR_DOUBLE_COMPLEX_MATRIX:
+    {
+        const double* p = oskar_mem_double_const(params, status);
+        oskar_cross_correlate_channels_omp_d(use_extended,
+                num_sources, num_stations, num_channels,
+                offset_out, stride_out,
+                oskar_mem_double4c_const(J, status),
+                oskar_mem_double2_const(J_inc, status),
+                oskar_mem_double_const(stokes_I, status),
+                oskar_mem_double_const(stokes_Q, status),
+                oskar_mem_double_const(stokes_U, status),
+                oskar_mem_double_const(stokes_V, status),
+                oskar_mem_double_const(src_l, status),
+                oskar_mem_double_const(src_m, status),
+                oskar_mem_double_const(src_n, status),
+                oskar_mem_double_const(src_a, status),
+                oskar_mem_double_const(src_b, status),
+                oskar_mem_double_const(src_c, status),
+                oskar_mem_double_const(u, status),
+                oskar_mem_double_const(v, status),
+                oskar_mem_double_const(w, status),
+                oskar_mem_double_const(x, status),
+                oskar_mem_double_const(y, status),
+                p, p + num_channels, p + 2 * num_channels,
+                p + 3 * num_channels, time_avg, gha0, dec0,
+                oskar_mem_double4c(vis, status));
+        break;
+    }
+    case OSKAR_SINGLE_COMPLEX:
+    {
+        const float* p = oskar_mem_float_const(params, status);
+        oskar_cross_correlate_scalar_channels_omp_f(use_extended,
+                num_sources, num_stations, num_channels,
+                offset_out, stride_out,
+                oskar_mem_float2_const(J, status),
+                oskar_mem_float2_const(J_inc, status),
+                oskar_mem_float_const(stokes_I, status),
+                oskar_mem_float_const(src_l, status),
+                oskar_mem_float_const(src_m, status),
+                oskar_mem_float_const(src_n, status),
+                oskar_mem_float_const(src_a, status),
+                oskar_mem_float_const(src_b, status),
+                oskar_mem_float_const(src_c, status),
+                oskar_mem_float_const(u, status),
+                oskar_mem_float_const(v, status),
+                oskar_mem_float_const(w, status),
+                oskar_mem_float_const(x, status),
+                oskar_mem_float_const(y, status),
+                p, p + num_channels, p + 2 * num_channels,
+                p + 3 * num_channels, (float) time_avg,
+                (float) gha0, (float) dec0,
+                oskar_mem_float2(vis, status));
+        break;
+    }
+    case OSKAR_DOUBLE_COMPLEX:
+    {
+        const double* p = oskar_mem_double_const(params, status);
+        oskar_cross_correlate_scalar_channels_omp_d(use_extended,
+                num_sources, num_stations, num_channels,
+                offset_out, stride_out,
+                oskar_mem_double2_const(J, status),
+                oskar_mem_double2_const(J_inc, status),
+                oskar_mem_double_const(stokes_I, status),
+                oskar_mem_double_const(src_l, status),
+                oskar_mem_double_const(src_m, status),
+                oskar_mem_double_const(src_n, status),
+                oskar_mem_double_const(src_a, status),
+                oskar_mem_double_const(src_b, status),
+                oskar_mem_double_const(src_c, status),
+                oskar_mem_double_const(u, status),
+                oskar_mem_double_const(v, status),
+                oskar_mem_double_const(w, status),
+                oskar_mem_double_const(x, status),
+                oskar_mem_double_const(y, status),
+                p, p + num_channels, p + 2 * num_channels,
+                p + 3 * num_channels, time_avg, gha0, dec0,
+                oskar_mem_double2(vis, status));
+        break;
+    }
+    default:
+        *status = OSKAR_ERR_BAD_DATA_TYPE;
+        break;
+    }
+    oskar_mem_free(params, status);
+}
+
+#ifdef __cplusplus
+}
+#endif
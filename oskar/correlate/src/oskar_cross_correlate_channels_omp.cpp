@@ -0,0 +1,543 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "correlate/define_correlate_utils.h"
+#include "correlate/oskar_cross_correlate_channels_omp.h"
+#include "math/define_multiply.h"
+#include "math/oskar_kahan_sum.h"
+#include "utility/oskar_kernel_macros.h"
+#include "utility/oskar_vector_types.h"
+
+#include <cmath>
+#include <cstdlib>
+
+// Number of channels after which the phase rotation is evaluated directly,
+// rather than by repeated multiplication, to stop rounding errors growing.
+#define PHASE_ANCHOR_CHANNELS 64
+
+template<typename T1, typename T2>
+struct is_same
+{
+    enum { value = false }; // is_same represents a bool.
+    typedef is_same<T1,T2> type; // to qualify as a metafunction.
+};
+
+template<typename T>
+struct is_same<T,T>
+{
+    enum { value = true };
+    typedef is_same<T,T> type;
+};
+
+// Baseline terms for one channel.
+template<typename REAL>
+struct ChannelTerms
+{
+    REAL uu, vv, ww, uu2, vv2, uuvv, du, dv, dw;
+    int active;
+};
+
+// Evaluates baseline terms for all channels. Returns the number of
+// channels that pass the baseline length filter.
+template<bool TIME_SMEARING, typename REAL>
+static int baseline_terms(const int num_channels, const int SP, const int SQ,
+        const REAL* const RESTRICT station_u,
+        const REAL* const RESTRICT station_v,
+        const REAL* const RESTRICT station_w,
+        const REAL* const RESTRICT station_x,
+        const REAL* const RESTRICT station_y,
+        const REAL* const RESTRICT uv_min_lambda,
+        const REAL* const RESTRICT uv_max_lambda,
+        const REAL* const RESTRICT channel_inv_wavelength,
+        const REAL* const RESTRICT channel_frac_bandwidth,
+        const REAL time_int_sec, const REAL gha0_rad, const REAL dec0_rad,
+        ChannelTerms<REAL>* RESTRICT terms)
+{
+    int num_active = 0;
+    for (int c = 0; c < num_channels; ++c)
+    {
+        REAL uv_len;
+        ChannelTerms<REAL>& t = terms[c];
+        const REAL inv_wavelength = channel_inv_wavelength[c];
+        const REAL frac_bandwidth = channel_frac_bandwidth[c];
+        OSKAR_BASELINE_TERMS(REAL, station_u[SP], station_u[SQ],
+                station_v[SP], station_v[SQ], station_w[SP], station_w[SQ],
+                t.uu, t.vv, t.ww, t.uu2, t.vv2, t.uuvv, uv_len);
+        t.du = t.dv = t.dw = (REAL) 0;
+        t.active = !(uv_len < uv_min_lambda[c] || uv_len > uv_max_lambda[c]);
+        if (!t.active) continue;
+        num_active++;
+
+        // Compute the deltas for time-average smearing.
+        if (TIME_SMEARING)
+            OSKAR_BASELINE_DELTAS(REAL, station_x[SP], station_x[SQ],
+                    station_y[SP], station_y[SQ], t.du, t.dv, t.dw);
+    }
+    return num_active;
+}
+
+// Returns rot^k, using De Moivre's formula.
+template<typename REAL, typename REAL2>
+static inline REAL2 phase_power(const REAL2 rot, const int k)
+{
+    REAL2 p;
+    const REAL r = pow(sqrt(rot.x * rot.x + rot.y * rot.y), (REAL) k);
+    const REAL theta = (REAL) k * atan2(rot.y, rot.x);
+    p.x = r * cos(theta);
+    p.y = r * sin(theta);
+    return p;
+}
+
+// Advances the phase rotation to channel k.
+template<typename REAL, typename REAL2>
+static inline void next_phase(REAL2& phase, const REAL2 rot, const int k)
+{
+    if (k % PHASE_ANCHOR_CHANNELS == 0)
+        phase = phase_power<REAL, REAL2>(rot, k);
+    else
+        OSKAR_MUL_COMPLEX_IN_PLACE(REAL2, phase, rot)
+}
+
+// Evaluates the smearing term for one source and one channel.
+template<bool BANDWIDTH_SMEARING, bool TIME_SMEARING, bool GAUSSIAN,
+        typename REAL>
+static inline REAL smearing_term(const ChannelTerms<REAL>& t,
+        const REAL l, const REAL m, const REAL n,
+        const REAL a, const REAL b, const REAL c)
+{
+    REAL smearing;
+    if (GAUSSIAN)
+    {
+        const REAL e = a * t.uu2 + b * t.uuvv + c * t.vv2;
+        smearing = exp((REAL) -e);
+    }
+    else smearing = (REAL) 1;
+    if (BANDWIDTH_SMEARING)
+    {
+        const REAL e = t.uu * l + t.vv * m + t.ww * n;
+        smearing *= OSKAR_SINC(REAL, e);
+    }
+    if (TIME_SMEARING)
+    {
+        const REAL e = t.du * l + t.dv * m + t.dw * n;
+        smearing *= OSKAR_SINC(REAL, e);
+    }
+    return smearing;
+}
+
+template
+<
+// Compile-time parameters.
+bool BANDWIDTH_SMEARING, bool TIME_SMEARING, bool GAUSSIAN,
+typename REAL, typename REAL2, typename REAL4c
+>
+void oskar_xcorr_channels_omp(
+        const int                    num_sources,
+        const int                    num_stations,
+        const int                    num_channels,
+        const int                    offset_out,
+        const int                    stride_out,
+        const REAL4c* const RESTRICT jones,
+        const REAL2*  const RESTRICT jones_inc,
+        const REAL*   const RESTRICT source_I,
+        const REAL*   const RESTRICT source_Q,
+        const REAL*   const RESTRICT source_U,
+        const REAL*   const RESTRICT source_V,
+        const REAL*   const RESTRICT source_l,
+        const REAL*   const RESTRICT source_m,
+        const REAL*   const RESTRICT source_n,
+        const REAL*   const RESTRICT source_a,
+        const REAL*   const RESTRICT source_b,
+        const REAL*   const RESTRICT source_c,
+        const REAL*   const RESTRICT station_u,
+        const REAL*   const RESTRICT station_v,
+        const REAL*   const RESTRICT station_w,
+        const REAL*   const RESTRICT station_x,
+        const REAL*   const RESTRICT station_y,
+        const REAL*   const RESTRICT uv_min_lambda,
+        const REAL*   const RESTRICT uv_max_lambda,
+        const REAL*   const RESTRICT inv_wavelength,
+        const REAL*   const RESTRICT frac_bandwidth,
+        const REAL                   time_int_sec,
+        const REAL                   gha0_rad,
+        const REAL                   dec0_rad,
+        REAL4c*             RESTRICT vis)
+{
+#pragma omp parallel
+    {
+        // Baseline terms and accumulators for all channels in the batch.
+        ChannelTerms<REAL>* terms = (ChannelTerms<REAL>*)
+                malloc(num_channels * sizeof(ChannelTerms<REAL>));
+        REAL4c* sum = (REAL4c*) malloc(num_channels * sizeof(REAL4c));
+        REAL4c* guard = (REAL4c*) malloc(num_channels * sizeof(REAL4c));
+
+        // Loop over stations.
+#pragma omp for schedule(dynamic, 1)
+        for (int SQ = 0; SQ < num_stations; ++SQ)
+        {
+            // Pointers to source vectors for station q.
+            const REAL4c* const station_q = &jones[SQ * num_sources];
+            const REAL2* const inc_q = &jones_inc[SQ * num_sources];
+
+            // Loop over baselines for this station.
+            for (int SP = SQ + 1; SP < num_stations; ++SP)
+            {
+                // Get common baseline values for all channels,
+                // and apply the baseline length filter.
+                if (baseline_terms<TIME_SMEARING, REAL>(num_channels, SP, SQ,
+                        station_u, station_v, station_w, station_x, station_y,
+                        uv_min_lambda, uv_max_lambda, inv_wavelength,
+                        frac_bandwidth, time_int_sec, gha0_rad, dec0_rad,
+                        terms) == 0)
+                    continue;
+                for (int c = 0; c < num_channels; ++c)
+                {
+                    OSKAR_CLEAR_COMPLEX_MATRIX(REAL, sum[c])
+                    OSKAR_CLEAR_COMPLEX_MATRIX(REAL, guard[c])
+                }
+
+                // Pointers to source vectors for station p.
+                const REAL4c* const station_p = &jones[SP * num_sources];
+                const REAL2* const inc_p = &jones_inc[SP * num_sources];
+
+                // Loop over sources.
+                for (int i = 0; i < num_sources; ++i)
+                {
+                    REAL4c jp, jq, m1, m2;
+                    REAL2 phase, rot;
+                    const REAL l = source_l[i];
+                    const REAL m = source_m[i];
+                    const REAL n = source_n[i] - (REAL) 1;
+                    const REAL a = GAUSSIAN ? source_a[i] : (REAL) 0;
+                    const REAL b = GAUSSIAN ? source_b[i] : (REAL) 0;
+                    const REAL c = GAUSSIAN ? source_c[i] : (REAL) 0;
+
+                    // Load the Jones matrices once for all channels.
+                    OSKAR_LOAD_MATRIX(jp, station_p[i])
+                    OSKAR_LOAD_MATRIX(jq, station_q[i])
+
+                    // Phase rotation of this baseline between channels.
+                    OSKAR_MUL_COMPLEX_CONJUGATE(rot, inc_p[i], inc_q[i])
+                    phase.x = (REAL) 1; phase.y = (REAL) 0;
+
+                    // Loop over channels.
+                    for (int k = 0; k < num_channels; ++k)
+                    {
+                        if (k > 0) next_phase<REAL, REAL2>(phase, rot, k);
+                        if (!terms[k].active) continue;
+                        const REAL smearing = smearing_term<BANDWIDTH_SMEARING,
+                                TIME_SMEARING, GAUSSIAN, REAL>(
+                                        terms[k], l, m, n, a, b, c);
+
+                        // Construct source brightness matrix.
+                        const int j = k * num_sources + i;
+                        OSKAR_CONSTRUCT_B(REAL, m2, source_I[j], source_Q[j],
+                                source_U[j], source_V[j])
+
+                        // Multiply Jones matrices with brightness matrix.
+                        m1 = jp;
+                        OSKAR_MUL_COMPLEX_MATRIX_HERMITIAN_IN_PLACE(
+                                REAL2, m1, m2)
+                        m2 = jq;
+                        OSKAR_MUL_COMPLEX_MATRIX_CONJUGATE_TRANSPOSE_IN_PLACE(
+                                REAL2, m1, m2)
+
+                        // Apply phase and smearing terms and accumulate.
+                        OSKAR_MUL_COMPLEX_MATRIX_COMPLEX_SCALAR_IN_PLACE(
+                                REAL2, m1, phase)
+                        if (is_same<REAL, float>::value)
+                        {
+                            OSKAR_KAHAN_SUM_MULTIPLY_COMPLEX_MATRIX(
+                                    REAL, sum[k], m1, smearing, guard[k])
+                        }
+                        else
+                        {
+                            OSKAR_MUL_ADD_COMPLEX_MATRIX_SCALAR(
+                                    sum[k], m1, smearing)
+                        }
+                    }
+                }
+
+                // Add results to the baseline visibilities.
+                const int i_bl = OSKAR_BASELINE_INDEX(num_stations, SP, SQ) +
+                        offset_out;
+                for (int k = 0; k < num_channels; ++k)
+                {
+                    if (!terms[k].active) continue;
+                    OSKAR_ADD_COMPLEX_MATRIX_IN_PLACE(
+                            vis[i_bl + k * stride_out], sum[k]);
+                }
+            }
+        }
+        free(terms);
+        free(sum);
+        free(guard);
+    }
+}
+
+template
+<
+// Compile-time parameters.
+bool BANDWIDTH_SMEARING, bool TIME_SMEARING, bool GAUSSIAN,
+typename REAL, typename REAL2
+>
+void oskar_xcorr_scalar_channels_omp(
+        const int                   num_sources,
+        const int                   num_stations,
+        const int                   num_channels,
+        const int                   offset_out,
+        const int                   stride_out,
+        const REAL2* const RESTRICT jones,
+        const REAL2* const RESTRICT jones_inc,
+        const REAL*  const RESTRICT source_I,
+        const REAL*  const RESTRICT source_l,
+        const REAL*  const RESTRICT source_m,
+        const REAL*  const RESTRICT source_n,
+        const REAL*  const RESTRICT source_a,
+        const REAL*  const RESTRICT source_b,
+        const REAL*  const RESTRICT source_c,
+        const REAL*  const RESTRICT station_u,
+        const REAL*  const RESTRICT station_v,
+        const REAL*  const RESTRICT station_w,
+        const REAL*  const RESTRICT station_x,
+        const REAL*  const RESTRICT station_y,
+        const REAL*  const RESTRICT uv_min_lambda,
+        const REAL*  const RESTRICT uv_max_lambda,
+        const REAL*  const RESTRICT inv_wavelength,
+        const REAL*  const RESTRICT frac_bandwidth,
+        const REAL                  time_int_sec,
+        const REAL                  gha0_rad,
+        const REAL                  dec0_rad,
+        REAL2*             RESTRICT vis)
+{
+#pragma omp parallel
+    {
+        // Baseline terms and accumulators for all channels in the batch.
+        ChannelTerms<REAL>* terms = (ChannelTerms<REAL>*)
+                malloc(num_channels * sizeof(ChannelTerms<REAL>));
+        REAL2* sum = (REAL2*) malloc(num_channels * sizeof(REAL2));
+        REAL2* guard = (REAL2*) malloc(num_channels * sizeof(REAL2));
+
+        // Loop over stations.
+#pragma omp for schedule(dynamic, 1)
+        for (int SQ = 0; SQ < num_stations; ++SQ)
+        {
+            // Pointers to source vectors for station q.
+            const REAL2* const station_q = &jones[SQ * num_sources];
+            const REAL2* const inc_q = &jones_inc[SQ * num_sources];
+
+            // Loop over baselines for this station.
+            for (int SP = SQ + 1; SP < num_stations; ++SP)
+            {
+                // Get common baseline values for all channels,
+                // and apply the baseline length filter.
+                if (baseline_terms<TIME_SMEARING, REAL>(num_channels, SP, SQ,
+                        station_u, station_v, station_w, station_x, station_y,
+                        uv_min_lambda, uv_max_lambda, inv_wavelength,
+                        frac_bandwidth, time_int_sec, gha0_rad, dec0_rad,
+                        terms) == 0)
+                    continue;
+                for (int c = 0; c < num_channels; ++c)
+                {
+                    sum[c].x = sum[c].y = (REAL) 0;
+                    guard[c].x = guard[c].y = (REAL) 0;
+                }
+
+                // Pointers to source vectors for station p.
+                const REAL2* const station_p = &jones[SP * num_sources];
+                const REAL2* const inc_p = &jones_inc[SP * num_sources];
+
+                // Loop over sources.
+                for (int i = 0; i < num_sources; ++i)
+                {
+                    REAL2 t0, t1, phase, rot;
+                    const REAL l = source_l[i];
+                    const REAL m = source_m[i];
+                    const REAL n = source_n[i] - (REAL) 1;
+                    const REAL a = GAUSSIAN ? source_a[i] : (REAL) 0;
+                    const REAL b = GAUSSIAN ? source_b[i] : (REAL) 0;
+                    const REAL c = GAUSSIAN ? source_c[i] : (REAL) 0;
+
+                    // Multiply Jones scalars once for all channels.
+                    OSKAR_MUL_COMPLEX_CONJUGATE(t0, station_p[i], station_q[i])
+
+                    // Phase rotation of this baseline between channels.
+                    OSKAR_MUL_COMPLEX_CONJUGATE(rot, inc_p[i], inc_q[i])
+                    phase.x = (REAL) 1; phase.y = (REAL) 0;
+
+                    // Loop over channels.
+                    for (int k = 0; k < num_channels; ++k)
+                    {
+                        if (k > 0) next_phase<REAL, REAL2>(phase, rot, k);
+                        if (!terms[k].active) continue;
+                        OSKAR_MUL_COMPLEX(t1, t0, phase)
+                        const REAL smearing = source_I[k * num_sources + i] *
+                                smearing_term<BANDWIDTH_SMEARING,
+                                TIME_SMEARING, GAUSSIAN, REAL>(
+                                        terms[k], l, m, n, a, b, c);
+
+                        // Multiply result by smearing term and accumulate.
+                        if (is_same<REAL, float>::value)
+                        {
+                            OSKAR_KAHAN_SUM_MULTIPLY_COMPLEX(
+                                    REAL, sum[k], t1, smearing, guard[k])
+                        }
+                        else
+                        {
+                            sum[k].x += t1.x * smearing;
+                            sum[k].y += t1.y * smearing;
+                        }
+                    }
+                }
+
+                // Add results to the baseline visibilities.
+                const int i_bl = OSKAR_BASELINE_INDEX(num_stations, SP, SQ) +
+                        offset_out;
+                for (int k = 0; k < num_channels; ++k)
+                {
+                    if (!terms[k].active) continue;
+                    vis[i_bl + k * stride_out].x += sum[k].x;
+                    vis[i_bl + k * stride_out].y += sum[k].y;
+                }
+            }
+        }
+        free(terms);
+        free(sum);
+        free(guard);
+    }
+}
+
+#define XCORR_KERNEL(BS, TS, GAUSSIAN, REAL, REAL2, REAL4c)                 \
+        oskar_xcorr_channels_omp<BS, TS, GAUSSIAN, REAL, REAL2, REAL4c>     \
+        (num_sources, num_stations, num_channels, offset_out, stride_out,   \
+                d_jones, d_jones_inc, d_I, d_Q, d_U, d_V,                   \
+                d_l, d_m, d_n, d_a, d_b, d_c,                               \
+                d_station_u, d_station_v, d_station_w,                      \
+                d_station_x, d_station_y, d_uv_min_lambda, d_uv_max_lambda, \
+                d_inv_wavelength, d_frac_bandwidth, time_int_sec,           \
+                gha0_rad, dec0_rad, d_vis);
+
+#define XCORR_KERNEL_SCALAR(BS, TS, GAUSSIAN, REAL, REAL2, REAL4c)          \
+        oskar_xcorr_scalar_channels_omp<BS, TS, GAUSSIAN, REAL, REAL2>      \
+        (num_sources, num_stations, num_channels, offset_out, stride_out,   \
+                d_jones, d_jones_inc, d_I, d_l, d_m, d_n, d_a, d_b, d_c,    \
+                d_station_u, d_station_v, d_station_w,                      \
+                d_station_x, d_station_y, d_uv_min_lambda, d_uv_max_lambda, \
+                d_inv_wavelength, d_frac_bandwidth, time_int_sec,           \
+                gha0_rad, dec0_rad, d_vis);
+
+/* Bandwidth smearing is enabled if it is needed for any channel. */
+#define XCORR_SELECT(KERNEL, GAUSSIAN, REAL, REAL2, REAL4c)                 \
+        if (!bandwidth_smearing && time_int_sec == (REAL)0)                 \
+            KERNEL(false, false, GAUSSIAN, REAL, REAL2, REAL4c)             \
+        else if (bandwidth_smearing && time_int_sec == (REAL)0)             \
+            KERNEL(true, false, GAUSSIAN, REAL, REAL2, REAL4c)              \
+        else if (!bandwidth_smearing && time_int_sec != (REAL)0)            \
+            KERNEL(false, true, GAUSSIAN, REAL, REAL2, REAL4c)              \
+        else                                                                \
+            KERNEL(true, true, GAUSSIAN, REAL, REAL2, REAL4c)
+
+#define XCORR_SELECT_EXTENDED(KERNEL, REAL, REAL2, REAL4c)                  \
+        int bandwidth_smearing = 0;                                         \
+        for (int i = 0; i < num_channels; ++i)                              \
+            if (d_frac_bandwidth[i] != (REAL)0) bandwidth_smearing = 1;     \
+        if (use_extended)                                                   \
+        {                                                                   \
+            XCORR_SELECT(KERNEL, true, REAL, REAL2, REAL4c)                 \
+        }                                                                   \
+        else                                                                \
+        {                                                                   \
+            XCORR_SELECT(KERNEL, false, REAL, REAL2, REAL4c)                \
+        }
+
+void oskar_cross_correlate_channels_omp_f(int use_extended,
+        int num_sources, int num_stations, int num_channels,
+        int offset_out, int stride_out,
+        const float4c* d_jones, const float2* d_jones_inc,
+        const float* d_I, const float* d_Q, const float* d_U,
+        const float* d_V, const float* d_l, const float* d_m,
+        const float* d_n, const float* d_a, const float* d_b,
+        const float* d_c, const float* d_station_u,
+        const float* d_station_v, const float* d_station_w,
+        const float* d_station_x, const float* d_station_y,
+        const float* d_uv_min_lambda, const float* d_uv_max_lambda,
+        const float* d_inv_wavelength, const float* d_frac_bandwidth,
+        float time_int_sec, float gha0_rad, float dec0_rad, float4c* d_vis)
+{
+    XCORR_SELECT_EXTENDED(XCORR_KERNEL, float, float2, float4c)
+}
+
+void oskar_cross_correlate_channels_omp_d(int use_extended,
+        int num_sources, int num_stations, int num_channels,
+        int offset_out, int stride_out,
+        const double4c* d_jones, const double2* d_jones_inc,
+        const double* d_I, const double* d_Q, const double* d_U,
+        const double* d_V, const double* d_l, const double* d_m,
+        const double* d_n, const double* d_a, const double* d_b,
+        const double* d_c, const double* d_station_u,
+        const double* d_station_v, const double* d_station_w,
+        const double* d_station_x, const double* d_station_y,
+        const double* d_uv_min_lambda, const double* d_uv_max_lambda,
+        const double* d_inv_wavelength, const double* d_frac_bandwidth,
+        double time_int_sec, double gha0_rad, double dec0_rad,
+        double4c* d_vis)
+{
+    XCORR_SELECT_EXTENDED(XCORR_KERNEL, double, double2, double4c)
+}
+
+void oskar_cross_correlate_scalar_channels_omp_f(int use_extended,
+        int num_sources, int num_stations, int num_channels,
+        int offset_out, int stride_out,
+        const float2* d_jones, const float2* d_jones_inc, const float* d_I,
+        const float* d_l, const float* d_m, const float* d_n,
+        const float* d_a, const float* d_b, const float* d_c,
+        const float* d_station_u, const float* d_station_v,
+        const float* d_station_w, const float* d_station_x,
+        const float* d_station_y, const float* d_uv_min_lambda,
+        const float* d_uv_max_lambda, const float* d_inv_wavelength,
+        const float* d_frac_bandwidth, float time_int_sec,
+        float gha0_rad, float dec0_rad, float2* d_vis)
+{
+    XCORR_SELECT_EXTENDED(XCORR_KERNEL_SCALAR, float, float2, float4c)
+}
+
+void oskar_cross_correlate_scalar_channels_omp_d(int use_extended,
+        int num_sources, int num_stations, int num_channels,
+        int offset_out, int stride_out,
+        const double2* d_jones, const double2* d_jones_inc, const double* d_I,
+        const double* d_l, const double* d_m, const double* d_n,
+        const double* d_a, const double* d_b, const double* d_c,
+        const double* d_station_u, const double* d_station_v,
+        const double* d_station_w, const double* d_station_x,
+        const double* d_station_y, const double* d_uv_min_lambda,
+        const double* d_uv_max_lambda, const double* d_inv_wavelength,
+        const double* d_frac_bandwidth, double time_int_sec,
+        double gha0_rad, double dec0_rad, double2* d_vis)
+{
+    XCORR_SELECT_EXTENDED(XCORR_KERNEL_SCALAR, double, double2, double4c)
+}
@@ -34,6 +34,13 @@
 #include "utility/oskar_vector_types.h"
 #include <stdio.h>
 
+/*
+ * Baselines are processed in tiles of XCORR_TILE x XCORR_TILE stations,
+ * and sources in chunks of XCORR_CHUNK.
+ */
+#define XCORR_TILE 16
+#define XCORR_CHUNK 512
+
 template<typename T1, typename T2>
 struct is_same
 {
@@ -80,92 +87,157 @@ void oskar_xcorr_scalar_omp(
         const REAL                  dec0_rad,
         REAL2*             RESTRICT vis)
 {
-    // Loop over stations.
+    // Loop over tiles on and above the diagonal of the baseline matrix.
+    const int num_blocks = (num_stations + XCORR_TILE - 1) / XCORR_TILE;
+    const int num_tiles = num_blocks * (num_blocks + 1) / 2;
 #pragma omp parallel for schedule(dynamic, 1)
-    for (int SQ = 0; SQ < num_stations; ++SQ)
+    for (int t = 0; t < num_tiles; ++t)
     {
-        // Pointer to source vector for station q.
-        const REAL2* const station_q = &jones[SQ * num_sources];
+        REAL t_uu[XCORR_TILE][XCORR_TILE], t_vv[XCORR_TILE][XCORR_TILE];
+        REAL t_ww[XCORR_TILE][XCORR_TILE], t_uu2[XCORR_TILE][XCORR_TILE];
+        REAL t_vv2[XCORR_TILE][XCORR_TILE], t_uuvv[XCORR_TILE][XCORR_TILE];
+        REAL t_du[XCORR_TILE][XCORR_TILE], t_dv[XCORR_TILE][XCORR_TILE];
+        REAL t_dw[XCORR_TILE][XCORR_TILE];
+        REAL2 t_sum[XCORR_TILE][XCORR_TILE], t_guard[XCORR_TILE][XCORR_TILE];
+        char active[XCORR_TILE][XCORR_TILE];
+
+        // Row bq of the upper triangle holds (num_blocks - bq) tiles.
+        int bq = 0, bp = t;
+        while (bp >= num_blocks - bq)
+        {
+            bp -= num_blocks - bq;
+            bq++;
+        }
+        const int q0 = bq * XCORR_TILE, p0 = (bq + bp) * XCORR_TILE;
+        const int q1 = (q0 + XCORR_TILE < num_stations) ?
+                q0 + XCORR_TILE : num_stations;
+        const int p1 = (p0 + XCORR_TILE < num_stations) ?
+                p0 + XCORR_TILE : num_stations;
 
-        // Loop over baselines for this station.
-        for (int SP = SQ + 1; SP < num_stations; ++SP)
+        // Get common baseline values for all baselines in the tile.
+        for (int SQ = q0; SQ < q1; ++SQ)
         {
-            REAL uv_len, uu, vv, ww, uu2, vv2, uuvv, du, dv, dw;
-            REAL2 t1, t2, sum, guard;
-            sum.x = sum.y = (REAL) 0;
-            if (is_same<REAL, float>::value)
-                guard.x = guard.y = (REAL) 0;
-
-            // Pointer to source vector for station p.
-            const REAL2* const station_p = &jones[SP * num_sources];
-
-            // Get common baseline values.
-            OSKAR_BASELINE_TERMS(REAL, station_u[SP], station_u[SQ],
-                    station_v[SP], station_v[SQ], station_w[SP], station_w[SQ],
-                    uu, vv, ww, uu2, vv2, uuvv, uv_len);
-
-            // Apply the baseline length filter.
-            if (uv_len < uv_min_lambda || uv_len > uv_max_lambda) continue;
-
-            // Compute the deltas for time-average smearing.
-            if (TIME_SMEARING)
-                OSKAR_BASELINE_DELTAS(REAL, station_x[SP], station_x[SQ],
-                        station_y[SP], station_y[SQ], du, dv, dw);
-
-            // Loop over sources.
-            for (int i = 0; i < num_sources; ++i)
+            for (int SP = (p0 > SQ ? p0 : SQ + 1); SP < p1; ++SP)
             {
-                REAL smearing;
-                if (GAUSSIAN)
-                {
-                    const REAL t = source_a[i] * uu2 + source_b[i] * uuvv +
-                            source_c[i] * vv2;
-                    smearing = exp((REAL) -t);
-                }
-                else
-                {
-                    smearing = (REAL) 1;
-                }
-                smearing *= source_I[i];
-                if (BANDWIDTH_SMEARING || TIME_SMEARING)
+                const int iq = SQ - q0, ip = SP - p0;
+                REAL uv_len;
+                t_sum[iq][ip].x = t_sum[iq][ip].y = (REAL) 0;
+                t_guard[iq][ip].x = t_guard[iq][ip].y = (REAL) 0;
+                t_du[iq][ip] = t_dv[iq][ip] = t_dw[iq][ip] = (REAL) 0;
+                active[iq][ip] = 0;
+                OSKAR_BASELINE_TERMS(REAL, station_u[SP], station_u[SQ],
+                        station_v[SP], station_v[SQ],
+                        station_w[SP], station_w[SQ],
+                        t_uu[iq][ip], t_vv[iq][ip], t_ww[iq][ip],
+                        t_uu2[iq][ip], t_vv2[iq][ip], t_uuvv[iq][ip], uv_len);
+
+                // Apply the baseline length filter.
+                if (uv_len < uv_min_lambda || uv_len > uv_max_lambda)
+                    continue;
+                active[iq][ip] = 1;
+
+                // Compute the deltas for time-average smearing.
+                if (TIME_SMEARING)
+                    OSKAR_BASELINE_DELTAS(REAL, station_x[SP], station_x[SQ],
+                            station_y[SP], station_y[SQ],
+                            t_du[iq][ip], t_dv[iq][ip], t_dw[iq][ip]);
+            }
+        }
+
+        // Loop over chunks of sources, so that the Jones scalars for the
+        // chunk stay in cache while they are used by all baselines in the
+        // tile.
+        for (int i0 = 0; i0 < num_sources; i0 += XCORR_CHUNK)
+        {
+            const int i1 = (i0 + XCORR_CHUNK < num_sources) ?
+                    i0 + XCORR_CHUNK : num_sources;
+            for (int SQ = q0; SQ < q1; ++SQ)
+            {
+                // Pointer to source vector for station q.
+                const REAL2* const station_q = &jones[SQ * num_sources];
+
+                // Loop over baselines for this station in the tile.
+                for (int SP = (p0 > SQ ? p0 : SQ + 1); SP < p1; ++SP)
                 {
-                    const REAL l = source_l[i];
-                    const REAL m = source_m[i];
-                    const REAL n = source_n[i] - (REAL) 1;
-                    if (BANDWIDTH_SMEARING)
-                    {
-                        const REAL t = uu * l + vv * m + ww * n;
-                        smearing *= OSKAR_SINC(REAL, t);
-                    }
-                    if (TIME_SMEARING)
+                    const int iq = SQ - q0, ip = SP - p0;
+                    if (!active[iq][ip]) continue;
+                    const REAL uu = t_uu[iq][ip], vv = t_vv[iq][ip];
+                    const REAL ww = t_ww[iq][ip], uu2 = t_uu2[iq][ip];
+                    const REAL vv2 = t_vv2[iq][ip], uuvv = t_uuvv[iq][ip];
+                    const REAL du = t_du[iq][ip], dv = t_dv[iq][ip];
+                    const REAL dw = t_dw[iq][ip];
+                    REAL2 t1, t2, sum = t_sum[iq][ip], guard = t_guard[iq][ip];
+
+                    // Pointer to source vector for station p.
+                    const REAL2* const station_p = &jones[SP * num_sources];
+
+                    // Loop over sources in the chunk.
+                    for (int i = i0; i < i1; ++i)
                     {
-                        const REAL t = du * l + dv * m + dw * n;
-                        smearing *= OSKAR_SINC(REAL, t);
-                    }
-                }
+                        REAL smearing;
+                        if (GAUSSIAN)
+                        {
+                            const REAL t = source_a[i] * uu2 +
+                                    source_b[i] * uuvv + source_c[i] * vv2;
+                            smearing = exp((REAL) -t);
+                        }
+                        else
+                        {
+                            smearing = (REAL) 1;
+                        }
+                        smearing *= source_I[i];
+                        if (BANDWIDTH_SMEARING || TIME_SMEARING)
+                        {
+                            const REAL l = source_l[i];
+                            const REAL m = source_m[i];
+                            const REAL n = source_n[i] - (REAL) 1;
+                            if (BANDWIDTH_SMEARING)
+                            {
+                                const REAL t = uu * l + vv * m + ww * n;
+                                smearing *= OSKAR_SINC(REAL, t);
+                            }
+                            if (TIME_SMEARING)
+                            {
+                                const REAL t = du * l + dv * m + dw * n;
+                                smearing *= OSKAR_SINC(REAL, t);
+                            }
+                        }
 
-                // Multiply Jones scalars.
-                t1 = station_p[i];
-                t2 = station_q[i];
-                OSKAR_MUL_COMPLEX_CONJUGATE_IN_PLACE(REAL2, t1, t2)
+                        // Multiply Jones scalars.
+                        t1 = station_p[i];
+                        t2 = station_q[i];
+                        OSKAR_MUL_COMPLEX_CONJUGATE_IN_PLACE(REAL2, t1, t2)
 
-                // Multiply result by smearing term and accumulate.
-                if (is_same<REAL, float>::value)
-                {
-                    OSKAR_KAHAN_SUM_MULTIPLY_COMPLEX(
-                            REAL, sum, t1, smearing, guard)
-                }
-                else
-                {
-                    sum.x += t1.x * smearing;
-                    sum.y += t1.y * smearing;
+                        // Multiply result by smearing term and accumulate.
+                        if (is_same<REAL, float>::value)
+                        {
+                            OSKAR_KAHAN_SUM_MULTIPLY_COMPLEX(
+                                    REAL, sum, t1, smearing, guard)
+                        }
+                        else
+                        {
+                            sum.x += t1.x * smearing;
+                            sum.y += t1.y * smearing;
+                        }
+                    }
+                    t_sum[iq][ip] = sum;
+                    t_guard[iq][ip] = guard;
                 }
             }
+        }
 
-            // Add result to the baseline visibility.
-            int i = OSKAR_BASELINE_INDEX(num_stations, SP, SQ) + offset_out;
-            vis[i].x += sum.x;
-            vis[i].y += sum.y;
+        // Add results to the baseline visibilities.
+        for (int SQ = q0; SQ < q1; ++SQ)
+        {
+            for (int SP = (p0 > SQ ? p0 : SQ + 1); SP < p1; ++SP)
+            {
+                const int iq = SQ - q0, ip = SP - p0;
+                if (!active[iq][ip]) continue;
+                const int i = OSKAR_BASELINE_INDEX(num_stations, SP, SQ) +
+                        offset_out;
+                vis[i].x += t_sum[iq][ip].x;
+                vis[i].y += t_sum[iq][ip].y;
+            }
         }
     }
 }
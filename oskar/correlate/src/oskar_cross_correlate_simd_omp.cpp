@@ -0,0 +1,798 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "correlate/define_correlate_utils.h"
+#include "correlate/oskar_cross_correlate_simd_omp.h"
+#include "math/oskar_cmath.h"
+#include "utility/oskar_kernel_macros.h"
+#include "utility/oskar_vector_types.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+
+/*
+ * Baselines are processed in tiles of XCORR_TILE x XCORR_TILE stations,
+ * and sources in chunks of XCORR_CHUNK. The source dimension of the
+ * transposed Jones matrices is padded to a multiple of XCORR_PAD,
+ * which must be at least as wide as the widest SIMD vector.
+ */
+#define XCORR_TILE 16
+#define XCORR_CHUNK 256
+#define XCORR_PAD 16
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define XCORR_X86_DISPATCH 1
+#define XCORR_TARGET(X) __attribute__((target(X)))
+#define XCORR_INLINE inline __attribute__((always_inline))
+#else
+#define XCORR_INLINE inline
+#endif
+
+#if defined(_OPENMP) && _OPENMP >= 201307
+#define XCORR_SIMD DO_PRAGMA(omp simd)
+#else
+#define XCORR_SIMD
+#endif
+
+#ifndef M_LOG2E
+#define M_LOG2E 1.44269504088896340736
+#endif
+
+enum { XCORR_ISA_GENERIC, XCORR_ISA_AVX2, XCORR_ISA_AVX512 };
+
+/*
+ * Constants for the vectorised math functions.
+ *
+ * magic() is 1.5 * 2^MANT_BITS: adding and subtracting it rounds to the
+ * nearest integer, and leaves the integer in the low bits of the mantissa
+ * (magic_bits() is its bit pattern).
+ *
+ * pi and ln(2) are each split into a high and a low part (Cody & Waite,
+ * "Software Manual for the Elementary Functions", 1980). The high part has
+ * enough trailing zero bits that k * hi is exact for any k in range, so the
+ * reduced argument keeps its full precision.
+ *
+ * The polynomials are the plain Taylor series, using the inv_factorial
+ * table below, truncated after SIN_TERMS and EXP_TERMS terms. The first
+ * omitted term bounds the truncation error on the reduced range:
+ *   sin, |r| <= pi/2:      (pi/2)^15 / 15! = 6.7e-10 (float),
+ *                          (pi/2)^23 / 23! = 1.3e-18 (double);
+ *   exp, |r| <= ln(2)/2:   (ln(2)/2)^8 / 8!   = 5.2e-9 (float),
+ *                          (ln(2)/2)^14 / 14! = 4.1e-18 (double);
+ * which are below the machine epsilon of each type, so the results are
+ * limited by rounding rather than by the truncation.
+ *
+ * exp_min() is close to the smallest argument for which exp() is still
+ * a normal number.
+ */
+template<typename REAL> struct XcorrMath;
+
+template<> struct XcorrMath<float>
+{
+    typedef int32_t INT;
+    enum { MANT_BITS = 23, EXP_BIAS = 127, SIN_TERMS = 7, EXP_TERMS = 8 };
+    static float magic() { return 12582912.0f; }
+    static INT magic_bits() { return 0x4B400000; }
+    static float pi_hi() { return 3.140625f; }
+    static float pi_lo() { return 9.67653589793e-4f; }
+    static float ln2_hi() { return 0.693359375f; }
+    static float ln2_lo() { return -2.12194440e-4f; }
+    static float exp_min() { return -87.0f; }
+};
+
+template<> struct XcorrMath<double>
+{
+    typedef int64_t INT;
+    enum { MANT_BITS = 52, EXP_BIAS = 1023, SIN_TERMS = 11, EXP_TERMS = 14 };
+    static double magic() { return 6755399441055744.0; }
+    static INT magic_bits() { return INT64_C(0x4338000000000000); }
+    static double pi_hi() { return 3.1415926218032837; }
+    static double pi_lo() { return 3.1786509424591713e-8; }
+    static double ln2_hi() { return 0.693145751953125; }
+    static double ln2_lo() { return 1.42860682030941723212e-6; }
+    static double exp_min() { return -708.0; }
+};
+
+/* Inverse factorials, 1 / n!, for the Taylor series. */
+static const double inv_factorial[] = {
+        1.0, 1.0, 1.0 / 2.0, 1.0 / 6.0, 1.0 / 24.0, 1.0 / 120.0,
+        1.0 / 720.0, 1.0 / 5040.0, 1.0 / 40320.0, 1.0 / 362880.0,
+        1.0 / 3628800.0, 1.0 / 39916800.0, 1.0 / 479001600.0,
+        1.0 / 6227020800.0, 1.0 / 87178291200.0, 1.0 / 1307674368000.0,
+        1.0 / 20922789888000.0, 1.0 / 355687428096000.0,
+        1.0 / 6402373705728000.0, 1.0 / 121645100408832000.0,
+        1.0 / 2432902008176640000.0, 1.0 / 51090942171709440000.0
+};
+
+/* Returns sin(x) / x, using only operations that can be vectorised. */
+template<typename REAL>
+static XCORR_INLINE REAL xcorr_sinc(const REAL x)
+{
+    typedef XcorrMath<REAL> C;
+
+    // Reduce the argument to r in [-pi/2, pi/2], where x = r + k * pi.
+    const REAL k = (x * (REAL) (1.0 / M_PI) + C::magic()) - C::magic();
+    const REAL r = (x - k * C::pi_hi()) - k * C::pi_lo();
+    const REAL r2 = r * r;
+
+    // Evaluate the Taylor series for sin(r).
+    REAL s = (REAL) inv_factorial[2 * C::SIN_TERMS - 1];
+    for (int i = C::SIN_TERMS - 2; i >= 0; --i)
+    {
+        const REAL c = (REAL) inv_factorial[2 * i + 1];
+        s = s * r2 + ((i & 1) ? -c : c);
+    }
+    s *= r;
+
+    // Flip the sign if k is odd, and clamp in case |x| was too large.
+    const REAL h = k * (REAL) 0.5;
+    if (h != (h + C::magic()) - C::magic()) s = -s;
+    s = s > (REAL) 1 ? (REAL) 1 : (s < (REAL) -1 ? (REAL) -1 : s);
+
+    // Avoid division by zero.
+    const REAL d = (x == (REAL) 0) ? (REAL) 1 : x;
+    const REAL q = s / d;
+    return (x == (REAL) 0) ? (REAL) 1 : q;
+}
+
+/* Returns exp(x), using only operations that can be vectorised. */
+template<typename REAL>
+static XCORR_INLINE REAL xcorr_exp(REAL x)
+{
+    typedef XcorrMath<REAL> C;
+    typedef typename C::INT INT;
+    x = x < C::exp_min() ? C::exp_min() : x;
+    x = x > -C::exp_min() ? -C::exp_min() : x;
+
+    // Reduce the argument to r in [-ln(2)/2, ln(2)/2], where x = r + k ln(2).
+    const REAL y = x * (REAL) M_LOG2E + C::magic();
+    const REAL k = y - C::magic();
+    const REAL r = (x - k * C::ln2_hi()) - k * C::ln2_lo();
+
+    // Evaluate the Taylor series for exp(r).
+    REAL e = (REAL) inv_factorial[C::EXP_TERMS - 1];
+    for (int i = C::EXP_TERMS - 2; i >= 0; --i)
+        e = e * r + (REAL) inv_factorial[i];
+
+    // Multiply by 2^k, which is constructed directly from the bits of k.
+    INT bits;
+    REAL scale;
+    memcpy(&bits, &y, sizeof(REAL));
+    bits = (bits - C::magic_bits() + C::EXP_BIAS) << C::MANT_BITS;
+    memcpy(&scale, &bits, sizeof(REAL));
+    return e * scale;
+}
+
+/* Accumulates VAL into SUM, using Kahan summation in single precision. */
+template<typename REAL>
+static XCORR_INLINE void xcorr_add(REAL& sum, REAL& guard, const REAL val);
+
+template<>
+XCORR_INLINE void xcorr_add<float>(float& sum, float& guard, const float val)
+{
+    const float y = val - guard;
+    const float t = sum + y;
+    guard = (t - sum) - y;
+    sum = t;
+}
+
+template<>
+XCORR_INLINE void xcorr_add<double>(double& sum, double&, const double val)
+{
+    sum += val;
+}
+
+/*
+ * Interferometer phase (Jones K) to apply to station beams while
+ * transposing them, so that Jones K and the joined Jones matrices
+ * need not be stored.
+ */
+template<typename REAL>
+struct XcorrPhase
+{
+    int num_beams, ignore_w_components;
+    REAL wavenumber, source_filter_min, source_filter_max;
+};
+
+template<typename REAL, typename REAL4c>
+struct XcorrParams
+{
+    int num_sources, num_stations, offset_out, stride;
+    const REAL *jones, *brightness, *l, *m, *n, *a, *b, *c;
+    const REAL *station_u, *station_v, *station_w, *station_x, *station_y;
+    REAL uv_min_lambda, uv_max_lambda, inv_wavelength, frac_bandwidth;
+    REAL time_int_sec, gha0_rad, dec0_rad;
+    REAL4c* vis;
+};
+
+/*
+ * Correlates all baselines in a tile of XCORR_TILE x XCORR_TILE stations,
+ * starting at stations q0 and p0.
+ *
+ * The transposed Jones matrices hold eight planes per station, in the order
+ * a.x, a.y, b.x, b.y, c.x, c.y, d.x, d.y, and the brightness matrix is
+ * stored as four planes holding I + Q, I - Q, U and V. The inner loop
+ * evaluates W sources at once, and each of the W lanes keeps its own sum.
+ *
+ * All baselines in the tile are processed for one chunk of sources before
+ * moving on to the next, so the Jones matrices for the chunk stay in cache
+ * while they are reused by up to XCORR_TILE baselines.
+ */
+template
+<
+// Compile-time parameters.
+bool BANDWIDTH_SMEARING, bool TIME_SMEARING, bool GAUSSIAN,
+typename REAL, typename REAL4c, int W
+>
+static XCORR_INLINE void xcorr_tile(const XcorrParams<REAL, REAL4c>* p,
+        const int q0, const int p0)
+{
+    const int num_sources = p->num_sources;
+    const int num_stations = p->num_stations;
+    const size_t stride = p->stride;
+    const REAL inv_wavelength = p->inv_wavelength;
+    const REAL frac_bandwidth = p->frac_bandwidth;
+    const REAL time_int_sec = p->time_int_sec;
+    const REAL gha0_rad = p->gha0_rad;
+    const REAL dec0_rad = p->dec0_rad;
+    const REAL* const RESTRICT source_l = p->l;
+    const REAL* const RESTRICT source_m = p->m;
+    const REAL* const RESTRICT source_n = p->n;
+    const REAL* const RESTRICT source_a = p->a;
+    const REAL* const RESTRICT source_b = p->b;
+    const REAL* const RESTRICT source_c = p->c;
+    const REAL* const RESTRICT b_a = p->brightness;
+    const REAL* const RESTRICT b_d = b_a + stride;
+    const REAL* const RESTRICT b_bx = b_d + stride;
+    const REAL* const RESTRICT b_by = b_bx + stride;
+    const int q1 = (q0 + XCORR_TILE < num_stations) ?
+            q0 + XCORR_TILE : num_stations;
+    const int p1 = (p0 + XCORR_TILE < num_stations) ?
+            p0 + XCORR_TILE : num_stations;
+    REAL smearing[XCORR_CHUNK];
+    REAL uu[XCORR_TILE][XCORR_TILE], vv[XCORR_TILE][XCORR_TILE];
+    REAL ww[XCORR_TILE][XCORR_TILE], uu2[XCORR_TILE][XCORR_TILE];
+    REAL vv2[XCORR_TILE][XCORR_TILE], uuvv[XCORR_TILE][XCORR_TILE];
+    REAL du[XCORR_TILE][XCORR_TILE], dv[XCORR_TILE][XCORR_TILE];
+    REAL dw[XCORR_TILE][XCORR_TILE];
+    REAL acc[XCORR_TILE][XCORR_TILE][8], acc_guard[XCORR_TILE][XCORR_TILE][8];
+    char active[XCORR_TILE][XCORR_TILE];
+
+    // Get common baseline values.
+    memset(active, 0, sizeof(active));
+    memset(acc, 0, sizeof(acc));
+    memset(acc_guard, 0, sizeof(acc_guard));
+    for (int SQ = q0; SQ < q1; ++SQ)
+    {
+        for (int SP = (p0 > SQ ? p0 : SQ + 1); SP < p1; ++SP)
+        {
+            const int iq = SQ - q0, ip = SP - p0;
+            REAL uv_len;
+            OSKAR_BASELINE_TERMS(REAL,
+                    p->station_u[SP], p->station_u[SQ],
+                    p->station_v[SP], p->station_v[SQ],
+                    p->station_w[SP], p->station_w[SQ],
+                    uu[iq][ip], vv[iq][ip], ww[iq][ip],
+                    uu2[iq][ip], vv2[iq][ip], uuvv[iq][ip], uv_len);
+
+            // Apply the baseline length filter.
+            if (uv_len < p->uv_min_lambda || uv_len > p->uv_max_lambda)
+                continue;
+            active[iq][ip] = 1;
+
+            // Compute the deltas for time-average smearing.
+            if (TIME_SMEARING)
+                OSKAR_BASELINE_DELTAS(REAL,
+                        p->station_x[SP], p->station_x[SQ],
+                        p->station_y[SP], p->station_y[SQ],
+                        du[iq][ip], dv[iq][ip], dw[iq][ip]);
+        }
+    }
+
+    // Loop over chunks of sources.
+    for (int i0 = 0; i0 < num_sources; i0 += XCORR_CHUNK)
+    {
+        const int num = (num_sources - i0 < XCORR_CHUNK) ?
+                num_sources - i0 : XCORR_CHUNK;
+        const int num_padded = ((num + W - 1) / W) * W;
+
+        // Loop over baselines in the tile.
+        for (int SQ = q0; SQ < q1; ++SQ)
+        {
+            const REAL* const RESTRICT q = p->jones + 8 * stride * SQ;
+            for (int SP = (p0 > SQ ? p0 : SQ + 1); SP < p1; ++SP)
+            {
+                const int iq = SQ - q0, ip = SP - p0;
+                if (!active[iq][ip]) continue;
+                const REAL* const RESTRICT j = p->jones + 8 * stride * SP;
+                const REAL uu_ = uu[iq][ip], vv_ = vv[iq][ip];
+                const REAL ww_ = ww[iq][ip], uu2_ = uu2[iq][ip];
+                const REAL vv2_ = vv2[iq][ip], uuvv_ = uuvv[iq][ip];
+                const REAL du_ = du[iq][ip], dv_ = dv[iq][ip];
+                const REAL dw_ = dw[iq][ip];
+                REAL sum[8][W], guard[8][W];
+                memset(sum, 0, sizeof(sum));
+                memset(guard, 0, sizeof(guard));
+
+                // Evaluate the smearing terms for all sources in the chunk.
+                XCORR_SIMD
+                for (int k = 0; k < num; ++k)
+                {
+                    const int i = i0 + k;
+                    REAL s = (REAL) 1;
+                    if (GAUSSIAN)
+                        s = xcorr_exp<REAL>(-(source_a[i] * uu2_ +
+                                source_b[i] * uuvv_ + source_c[i] * vv2_));
+                    if (BANDWIDTH_SMEARING || TIME_SMEARING)
+                    {
+                        const REAL l = source_l[i];
+                        const REAL m = source_m[i];
+                        const REAL n = source_n[i] - (REAL) 1;
+                        if (BANDWIDTH_SMEARING)
+                            s *= xcorr_sinc<REAL>(uu_ * l + vv_ * m + ww_ * n);
+                        if (TIME_SMEARING)
+                            s *= xcorr_sinc<REAL>(du_ * l + dv_ * m + dw_ * n);
+                    }
+                    smearing[k] = s;
+                }
+                for (int k = num; k < num_padded; ++k) smearing[k] = (REAL) 0;
+
+                // Loop over sources in the chunk, W at a time.
+                for (int k0 = 0; k0 < num_padded; k0 += W)
+                {
+                    const int i0k0 = i0 + k0;
+                    XCORR_SIMD
+                    for (int k = 0; k < W; ++k)
+                    {
+                        const int i = i0k0 + k;
+                        const REAL s = smearing[k0 + k];
+
+                        // Source brightness matrix (Hermitian).
+                        const REAL ba = b_a[i], bd = b_d[i];
+                        const REAL bbx = b_bx[i], bby = b_by[i];
+
+                        // Jones matrices for stations p and q.
+                        const REAL pax = j[i], pay = j[stride + i];
+                        const REAL pbx = j[2 * stride + i];
+                        const REAL pby = j[3 * stride + i];
+                        const REAL pcx = j[4 * stride + i];
+                        const REAL pcy = j[5 * stride + i];
+                        const REAL pdx = j[6 * stride + i];
+                        const REAL pdy = j[7 * stride + i];
+                        const REAL qax = q[i], qay = q[stride + i];
+                        const REAL qbx = q[2 * stride + i];
+                        const REAL qby = q[3 * stride + i];
+                        const REAL qcx = q[4 * stride + i];
+                        const REAL qcy = q[5 * stride + i];
+                        const REAL qdx = q[6 * stride + i];
+                        const REAL qdy = q[7 * stride + i];
+
+                        // Multiply first Jones matrix with source brightness
+                        // matrix.
+                        const REAL tax = pax * ba + pbx * bbx + pby * bby;
+                        const REAL tay = pay * ba + pby * bbx - pbx * bby;
+                        const REAL tbx = pax * bbx - pay * bby + pbx * bd;
+                        const REAL tby = pax * bby + pay * bbx + pby * bd;
+                        const REAL tcx = pcx * ba + pdx * bbx + pdy * bby;
+                        const REAL tcy = pcy * ba + pdy * bbx - pdx * bby;
+                        const REAL tdx = pcx * bbx - pcy * bby + pdx * bd;
+                        const REAL tdy = pcx * bby + pcy * bbx + pdy * bd;
+
+                        // Multiply result with second (Hermitian transposed)
+                        // Jones matrix, multiply by smearing term and
+                        // accumulate.
+                        xcorr_add<REAL>(sum[0][k], guard[0][k], s * (
+                                tax * qax + tay * qay + tbx * qbx + tby * qby));
+                        xcorr_add<REAL>(sum[1][k], guard[1][k], s * (
+                                tay * qax - tax * qay + tby * qbx - tbx * qby));
+                        xcorr_add<REAL>(sum[2][k], guard[2][k], s * (
+                                tax * qcx + tay * qcy + tbx * qdx + tby * qdy));
+                        xcorr_add<REAL>(sum[3][k], guard[3][k], s * (
+                                tay * qcx - tax * qcy + tby * qdx - tbx * qdy));
+                        xcorr_add<REAL>(sum[4][k], guard[4][k], s * (
+                                tcx * qax + tcy * qay + tdx * qbx + tdy * qby));
+                        xcorr_add<REAL>(sum[5][k], guard[5][k], s * (
+                                tcy * qax - tcx * qay + tdy * qbx - tdx * qby));
+                        xcorr_add<REAL>(sum[6][k], guard[6][k], s * (
+                                tcx * qcx + tcy * qcy + tdx * qdx + tdy * qdy));
+                        xcorr_add<REAL>(sum[7][k], guard[7][k], s * (
+                                tcy * qcx - tcx * qcy + tdy * qdx - tdx * qdy));
+                    }
+                }
+
+                // Add the lanes together, and accumulate for the baseline.
+                for (int e = 0; e < 8; ++e)
+                {
+                    REAL t = (REAL) 0;
+                    for (int k = 0; k < W; ++k) t += (sum[e][k] - guard[e][k]);
+                    xcorr_add<REAL>(acc[iq][ip][e], acc_guard[iq][ip][e], t);
+                }
+            }
+        }
+    }
+
+    // Add results to the baseline visibilities.
+    // (Access the output as REAL, as it may not have the alignment
+    // required by REAL4c.)
+    for (int SQ = q0; SQ < q1; ++SQ)
+    {
+        for (int SP = (p0 > SQ ? p0 : SQ + 1); SP < p1; ++SP)
+        {
+            const int iq = SQ - q0, ip = SP - p0;
+            if (!active[iq][ip]) continue;
+            REAL* v = (REAL*) (p->vis +
+                    OSKAR_BASELINE_INDEX(num_stations, SP, SQ) +
+                    p->offset_out);
+            for (int e = 0; e < 8; ++e)
+                v[e] += (acc[iq][ip][e] - acc_guard[iq][ip][e]);
+        }
+    }
+}
+
+/* Tile functions for each instruction set, using the full vector width. */
+template
+<
+bool BANDWIDTH_SMEARING, bool TIME_SMEARING, bool GAUSSIAN,
+typename REAL, typename REAL4c
+>
+static void xcorr_tile_generic(const XcorrParams<REAL, REAL4c>* p,
+        int q0, int p0)
+{
+    xcorr_tile<BANDWIDTH_SMEARING, TIME_SMEARING, GAUSSIAN,
+            REAL, REAL4c, 16 / sizeof(REAL)>(p, q0, p0);
+}
+
+#ifdef XCORR_X86_DISPATCH
+template
+<
+bool BANDWIDTH_SMEARING, bool TIME_SMEARING, bool GAUSSIAN,
+typename REAL, typename REAL4c
+>
+XCORR_TARGET("avx2,fma")
+static void xcorr_tile_avx2(const XcorrParams<REAL, REAL4c>* p,
+        int q0, int p0)
+{
+    xcorr_tile<BANDWIDTH_SMEARING, TIME_SMEARING, GAUSSIAN,
+            REAL, REAL4c, 32 / sizeof(REAL)>(p, q0, p0);
+}
+
+template
+<
+bool BANDWIDTH_SMEARING, bool TIME_SMEARING, bool GAUSSIAN,
+typename REAL, typename REAL4c
+>
+XCORR_TARGET("avx512f,fma")
+static void xcorr_tile_avx512(const XcorrParams<REAL, REAL4c>* p,
+        int q0, int p0)
+{
+    xcorr_tile<BANDWIDTH_SMEARING, TIME_SMEARING, GAUSSIAN,
+            REAL, REAL4c, 64 / sizeof(REAL)>(p, q0, p0);
+}
+#endif
+
+static int xcorr_isa(void)
+{
+    static int isa = -1;
+    if (isa < 0)
+    {
+        int t = XCORR_ISA_GENERIC;
+#ifdef XCORR_X86_DISPATCH
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("fma"))
+        {
+            if (__builtin_cpu_supports("avx512f"))
+                t = XCORR_ISA_AVX512;
+            else if (__builtin_cpu_supports("avx2"))
+                t = XCORR_ISA_AVX2;
+        }
+#endif
+        isa = t;
+    }
+    return isa;
+}
+
+template
+<
+bool BANDWIDTH_SMEARING, bool TIME_SMEARING, bool GAUSSIAN,
+typename REAL, typename REAL4c
+>
+static void xcorr_simd(const XcorrParams<REAL, REAL4c>* p)
+{
+    void (*tile)(const XcorrParams<REAL, REAL4c>*, int, int) =
+            xcorr_tile_generic<
+            BANDWIDTH_SMEARING, TIME_SMEARING, GAUSSIAN, REAL, REAL4c>;
+#ifdef XCORR_X86_DISPATCH
+    const int isa = xcorr_isa();
+    if (isa == XCORR_ISA_AVX512)
+        tile = xcorr_tile_avx512<
+                BANDWIDTH_SMEARING, TIME_SMEARING, GAUSSIAN, REAL, REAL4c>;
+    else if (isa == XCORR_ISA_AVX2)
+        tile = xcorr_tile_avx2<
+                BANDWIDTH_SMEARING, TIME_SMEARING, GAUSSIAN, REAL, REAL4c>;
+#endif
+
+    // Loop over tiles on and above the diagonal of the baseline matrix.
+    const int num_blocks = (p->num_stations + XCORR_TILE - 1) / XCORR_TILE;
+    const int num_tiles = num_blocks * (num_blocks + 1) / 2;
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int t = 0; t < num_tiles; ++t)
+    {
+        // Row bq of the upper triangle holds (num_blocks - bq) tiles.
+        int bq = 0, bp = t;
+        while (bp >= num_blocks - bq)
+        {
+            bp -= num_blocks - bq;
+            bq++;
+        }
+        tile(p, bq * XCORR_TILE, (bq + bp) * XCORR_TILE);
+    }
+}
+
+#define XCORR_SIMD_SELECT(GAUSSIAN, REAL, REAL4c)                           \
+        if (frac_bandwidth == (REAL)0 && time_int_sec == (REAL)0)           \
+            xcorr_simd<false, false, GAUSSIAN, REAL, REAL4c>(&p);           \
+        else if (frac_bandwidth != (REAL)0 && time_int_sec == (REAL)0)      \
+            xcorr_simd<true, false, GAUSSIAN, REAL, REAL4c>(&p);            \
+        else if (frac_bandwidth == (REAL)0 && time_int_sec != (REAL)0)      \
+            xcorr_simd<false, true, GAUSSIAN, REAL, REAL4c>(&p);            \
+        else if (frac_bandwidth != (REAL)0 && time_int_sec != (REAL)0)      \
+            xcorr_simd<true, true, GAUSSIAN, REAL, REAL4c>(&p);
+
+/* Returns the padded length of the source dimension. */
+static int xcorr_stride(int num_sources)
+{
+    return ((num_sources + XCORR_PAD - 1) / XCORR_PAD) * XCORR_PAD;
+}
+
+template<typename REAL, typename REAL4c>
+static int xcorr_simd_run(const XcorrPhase<REAL>* phase, int use_extended,
+        int num_sources, int num_stations, int offset_out,
+        const REAL4c* jones, const REAL* I, const REAL* Q,
+        const REAL* U, const REAL* V,
+        const REAL* l, const REAL* m, const REAL* n,
+        const REAL* a, const REAL* b, const REAL* c,
+        const REAL* station_u, const REAL* station_v,
+        const REAL* station_w, const REAL* station_x,
+        const REAL* station_y, REAL uv_min_lambda, REAL uv_max_lambda,
+        REAL inv_wavelength, REAL frac_bandwidth, REAL time_int_sec,
+        REAL gha0_rad, REAL dec0_rad, REAL4c* vis, REAL* planes)
+{
+    if (!planes || num_sources <= 0 || num_stations <= 0) return 0;
+
+    // Transpose Jones matrices and source brightness into planes in the
+    // work buffer, padding the source dimension with zeros.
+    // If required, the Jones matrices are formed by multiplying the
+    // station beams by the interferometer phase as they are transposed.
+    const int stride = xcorr_stride(num_sources);
+    const size_t pad = (size_t) (stride - num_sources) * sizeof(REAL);
+    REAL* brightness = planes + 8 * (size_t) stride * num_stations;
+#pragma omp parallel for
+    for (int s = 0; s < num_stations; ++s)
+    {
+        REAL* out = planes + 8 * (size_t) stride * s;
+        if (!phase)
+        {
+            const REAL* in = (const REAL*) &jones[(size_t) s * num_sources];
+            for (int e = 0; e < 8; ++e)
+            {
+                for (int i = 0; i < num_sources; ++i)
+                    out[e * (size_t) stride + i] = in[8 * (size_t) i + e];
+                memset(out + e * (size_t) stride + num_sources, 0, pad);
+            }
+            continue;
+        }
+        const REAL* in = (const REAL*) &jones[(size_t)
+                (phase->num_beams == 1 ? 0 : s) * num_sources];
+        const REAL su = station_u[s], sv = station_v[s], sw = station_w[s];
+        for (int i = 0; i < num_sources; ++i)
+        {
+            REAL re = (REAL) 0, im = (REAL) 0;
+            if (I[i] > phase->source_filter_min &&
+                    I[i] <= phase->source_filter_max)
+            {
+                REAL t = su * l[i] + sv * m[i];
+                if (!phase->ignore_w_components)
+                    t += sw * (n[i] - (REAL) 1);
+                t *= phase->wavenumber;
+                SINCOS(t, im, re);
+            }
+            for (int e = 0; e < 8; e += 2)
+            {
+                const REAL x = in[8 * (size_t) i + e];
+                const REAL y = in[8 * (size_t) i + e + 1];
+                out[e * (size_t) stride + i] = x * re - y * im;
+                out[(e + 1) * (size_t) stride + i] = x * im + y * re;
+            }
+        }
+        for (int e = 0; e < 8; ++e)
+            memset(out + e * (size_t) stride + num_sources, 0, pad);
+    }
+    for (int i = 0; i < num_sources; ++i)
+    {
+        brightness[i]              = I[i] + Q[i];
+        brightness[stride + i]     = I[i] - Q[i];
+        brightness[2 * stride + i] = U[i];
+        brightness[3 * stride + i] = V[i];
+    }
+    for (int e = 0; e < 4; ++e)
+        memset(brightness + e * (size_t) stride + num_sources, 0, pad);
+
+    // Set up parameters and launch the kernel.
+    XcorrParams<REAL, REAL4c> p;
+    p.num_sources = num_sources;
+    p.num_stations = num_stations;
+    p.offset_out = offset_out;
+    p.stride = stride;
+    p.jones = planes;
+    p.brightness = brightness;
+    p.l = l; p.m = m; p.n = n;
+    p.a = a; p.b = b; p.c = c;
+    p.station_u = station_u;
+    p.station_v = station_v;
+    p.station_w = station_w;
+    p.station_x = station_x;
+    p.station_y = station_y;
+    p.uv_min_lambda = uv_min_lambda;
+    p.uv_max_lambda = uv_max_lambda;
+    p.inv_wavelength = inv_wavelength;
+    p.frac_bandwidth = frac_bandwidth;
+    p.time_int_sec = time_int_sec;
+    p.gha0_rad = gha0_rad;
+    p.dec0_rad = dec0_rad;
+    p.vis = vis;
+    if (use_extended)
+    {
+        XCORR_SIMD_SELECT(true, REAL, REAL4c)
+    }
+    else
+    {
+        XCORR_SIMD_SELECT(false, REAL, REAL4c)
+    }
+    return 1;
+}
+
+int oskar_cross_correlate_simd_omp_f(int use_extended,
+        int num_sources, int num_stations, int offset_out,
+        const float4c* d_jones, const float* d_I, const float* d_Q,
+        const float* d_U, const float* d_V,
+        const float* d_l, const float* d_m, const float* d_n,
+        const float* d_a, const float* d_b, const float* d_c,
+        const float* d_station_u, const float* d_station_v,
+        const float* d_station_w, const float* d_station_x,
+        const float* d_station_y, float uv_min_lambda, float uv_max_lambda,
+        float inv_wavelength, float frac_bandwidth, float time_int_sec,
+        float gha0_rad, float dec0_rad, float4c* d_vis, float* work)
+{
+    return xcorr_simd_run<float, float4c>(0, use_extended,
+            num_sources, num_stations, offset_out, d_jones,
+            d_I, d_Q, d_U, d_V, d_l, d_m, d_n, d_a, d_b, d_c,
+            d_station_u, d_station_v, d_station_w,
+            d_station_x, d_station_y, uv_min_lambda, uv_max_lambda,
+            inv_wavelength, frac_bandwidth, time_int_sec,
+            gha0_rad, dec0_rad, d_vis, work);
+}
+
+int oskar_cross_correlate_simd_omp_d(int use_extended,
+        int num_sources, int num_stations, int offset_out,
+        const double4c* d_jones, const double* d_I, const double* d_Q,
+        const double* d_U, const double* d_V,
+        const double* d_l, const double* d_m, const double* d_n,
+        const double* d_a, const double* d_b, const double* d_c,
+        const double* d_station_u, const double* d_station_v,
+        const double* d_station_w, const double* d_station_x,
+        const double* d_station_y, double uv_min_lambda, double uv_max_lambda,
+        double inv_wavelength, double frac_bandwidth, double time_int_sec,
+        double gha0_rad, double dec0_rad, double4c* d_vis, double* work)
+{
+    return xcorr_simd_run<double, double4c>(0, use_extended,
+            num_sources, num_stations, offset_out, d_jones,
+            d_I, d_Q, d_U, d_V, d_l, d_m, d_n, d_a, d_b, d_c,
+            d_station_u, d_station_v, d_station_w,
+            d_station_x, d_station_y, uv_min_lambda, uv_max_lambda,
+            inv_wavelength, frac_bandwidth, time_int_sec,
+            gha0_rad, dec0_rad, d_vis, work);
+}
+
+int oskar_cross_correlate_simd_beam_omp_f(int use_extended,
+        int num_sources, int num_stations, int num_beams, int offset_out,
+        const float4c* d_beam, const float* d_I, const float* d_Q,
+        const float* d_U, const float* d_V,
+        const float* d_l, const float* d_m, const float* d_n,
+        const float* d_a, const float* d_b, const float* d_c,
+        const float* d_station_u, const float* d_station_v,
+        const float* d_station_w, const float* d_station_x,
+        const float* d_station_y, float uv_min_lambda, float uv_max_lambda,
+        float inv_wavelength, float frac_bandwidth, float time_int_sec,
+        float gha0_rad, float dec0_rad, float source_filter_min,
+        float source_filter_max, int ignore_w_components, float4c* d_vis,
+        float* work)
+{
+    XcorrPhase<float> phase;
+    phase.num_beams = num_beams;
+    phase.ignore_w_components = ignore_w_components;
+    phase.wavenumber = (float) (2.0 * M_PI) * inv_wavelength;
+    phase.source_filter_min = source_filter_min;
+    phase.source_filter_max = source_filter_max;
+    return xcorr_simd_run<float, float4c>(&phase, use_extended,
+            num_sources, num_stations, offset_out, d_beam,
+            d_I, d_Q, d_U, d_V, d_l, d_m, d_n, d_a, d_b, d_c,
+            d_station_u, d_station_v, d_station_w,
+            d_station_x, d_station_y, uv_min_lambda, uv_max_lambda,
+            inv_wavelength, frac_bandwidth, time_int_sec,
+            gha0_rad, dec0_rad, d_vis, work);
+}
+
+int oskar_cross_correlate_simd_beam_omp_d(int use_extended,
+        int num_sources, int num_stations, int num_beams, int offset_out,
+        const double4c* d_beam, const double* d_I, const double* d_Q,
+        const double* d_U, const double* d_V,
+        const double* d_l, const double* d_m, const double* d_n,
+        const double* d_a, const double* d_b, const double* d_c,
+        const double* d_station_u, const double* d_station_v,
+        const double* d_station_w, const double* d_station_x,
+        const double* d_station_y, double uv_min_lambda, double uv_max_lambda,
+        double inv_wavelength, double frac_bandwidth, double time_int_sec,
+        double gha0_rad, double dec0_rad, double source_filter_min,
+        double source_filter_max, int ignore_w_components, double4c* d_vis,
+        double* work)
+{
+    XcorrPhase<double> phase;
+    phase.num_beams = num_beams;
+    phase.ignore_w_components = ignore_w_components;
+    phase.wavenumber = 2.0 * M_PI * inv_wavelength;
+    phase.source_filter_min = source_filter_min;
+    phase.source_filter_max = source_filter_max;
+    return xcorr_simd_run<double, double4c>(&phase, use_extended,
+            num_sources, num_stations, offset_out, d_beam,
+            d_I, d_Q, d_U, d_V, d_l, d_m, d_n, d_a, d_b, d_c,
+            d_station_u, d_station_v, d_station_w,
+            d_station_x, d_station_y, uv_min_lambda, uv_max_lambda,
+            inv_wavelength, frac_bandwidth, time_int_sec,
+            gha0_rad, dec0_rad, d_vis, work);
+}
+
+size_t oskar_cross_correlate_simd_omp_work_size(int num_sources,
+        int num_stations)
+{
+    if (num_sources <= 0 || num_stations <= 0) return 0;
+    return (8 * (size_t) num_stations + 4) * xcorr_stride(num_sources);
+}
+
+const char* oskar_cross_correlate_simd_omp_isa(void)
+{
+    switch (xcorr_isa())
+    {
+    case XCORR_ISA_AVX512:
+        return "AVX-512";
+    case XCORR_ISA_AVX2:
+        return "AVX2";
+    default:
+        return "generic";
+    }
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, The University of Oxford
+ * Copyright (c) 2013-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -31,8 +31,14 @@
 #include "utility/oskar_timer.h"
 
 #include "correlate/oskar_cross_correlate.h"
+#include "correlate/oskar_cross_correlate_beam.h"
+#include "correlate/oskar_cross_correlate_channels.h"
+#include "correlate/oskar_cross_correlate_simd_omp.h"
+#include "correlate/test/correlate_reference.h"
+#include "interferometer/oskar_evaluate_jones_K.h"
 #include "utility/oskar_get_error_string.h"
 #include "math/oskar_kahan_sum.h"
+#include <cfloat>
 #include <cstdlib>
 
 // Comment out this line to disable benchmark timer printing.
@@ -223,6 +229,248 @@ protected:
                 time2 * 1000.0);
 #endif
     }
+
+    void runSimdTest(int prec, int extended, double channel_bandwidth,
+            double time_average)
+    {
+        int num_baselines, status = 0, type;
+        oskar_Mem *vis1, *vis2, *vis3, *work;
+        double frequency = 100e6;
+
+        // Run the reference and vectorised CPU kernels on the same data,
+        // with and without a reusable workspace.
+        createTestData(prec, OSKAR_CPU, 1);
+        num_baselines = oskar_telescope_num_baselines(tel);
+        type = prec | OSKAR_COMPLEX | OSKAR_MATRIX;
+        vis1 = oskar_mem_create(type, OSKAR_CPU, num_baselines, &status);
+        vis2 = oskar_mem_create(type, OSKAR_CPU, num_baselines, &status);
+        vis3 = oskar_mem_create(type, OSKAR_CPU, num_baselines, &status);
+        oskar_mem_clear_contents(vis1, &status);
+        oskar_mem_clear_contents(vis2, &status);
+        oskar_mem_clear_contents(vis3, &status);
+        oskar_sky_set_use_extended(sky, extended);
+        oskar_telescope_set_channel_bandwidth(tel, channel_bandwidth);
+        oskar_telescope_set_time_average(tel, time_average);
+        work = oskar_mem_create(prec, OSKAR_CPU, 0, &status);
+        correlate_reference(jones, sky, tel, u_, v_, w_, 1.0, frequency,
+                vis1, &status);
+        oskar_cross_correlate(oskar_sky_num_sources(sky), jones, sky,
+                tel, u_, v_, w_, 1.0, frequency, 0, vis2, &status);
+        oskar_cross_correlate_ws(oskar_sky_num_sources(sky), jones, sky,
+                tel, u_, v_, w_, 1.0, frequency, 0, vis3, work, &status);
+        destroyTestData();
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        ASSERT_GE(oskar_mem_length(work),
+                oskar_cross_correlate_simd_omp_work_size(
+                        num_sources, num_stations));
+
+        // Compare results.
+        check_values(vis2, vis1);
+        check_values(vis3, vis1);
+        oskar_mem_free(vis1, &status);
+        oskar_mem_free(vis2, &status);
+        oskar_mem_free(vis3, &status);
+        oskar_mem_free(work, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    }
+
+    // Correlates channels one at a time, or all together, into vis.
+    void correlateChannels(int prec, int matrix, int extended,
+            double time_average, int num_channels, int batch, oskar_Mem* vis)
+    {
+        int num_baselines, status = 0, type;
+        oskar_Mem *flux[4];
+        oskar_Jones *jones_c, *K, *K_inc;
+        const double freq_start = 100e6, freq_inc = 1e6;
+
+        // Create test data, with longer baselines to give larger phases.
+        createTestData(prec, OSKAR_CPU, matrix);
+        oskar_mem_scale_real(u_, 1000.0, 0, num_stations, &status);
+        oskar_mem_scale_real(v_, 1000.0, 0, num_stations, &status);
+        oskar_mem_scale_real(w_, 1000.0, 0, num_stations, &status);
+        oskar_sky_set_use_extended(sky, extended);
+        oskar_telescope_set_channel_bandwidth(tel, bandwidth);
+        oskar_telescope_set_time_average(tel, time_average);
+        num_baselines = oskar_telescope_num_baselines(tel);
+        type = prec | OSKAR_COMPLEX;
+        if (matrix) type |= OSKAR_MATRIX;
+        oskar_mem_ensure(vis, num_channels * num_baselines, &status);
+        oskar_mem_clear_contents(vis, &status);
+        jones_c = oskar_jones_create(type, OSKAR_CPU, num_stations,
+                num_sources, &status);
+        K = oskar_jones_create(prec | OSKAR_COMPLEX, OSKAR_CPU,
+                num_stations, num_sources, &status);
+        K_inc = oskar_jones_create(prec | OSKAR_COMPLEX, OSKAR_CPU,
+                num_stations, num_sources, &status);
+        for (int i = 0; i < 4; ++i)
+        {
+            flux[i] = oskar_mem_create(prec, OSKAR_CPU,
+                    num_channels * num_sources, &status);
+            oskar_mem_random_range(flux[i], 0.1, 2.0, &status);
+        }
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+        if (!batch)
+        {
+            // Correlate each channel in turn, using its own Jones K.
+            for (int c = 0; c < num_channels; ++c)
+            {
+                const double frequency = freq_start + c * freq_inc;
+                oskar_evaluate_jones_K(K, num_sources,
+                        oskar_sky_l_const(sky), oskar_sky_m_const(sky),
+                        oskar_sky_n_const(sky), u_, v_, w_, c * freq_inc,
+                        oskar_sky_I_const(sky), -DBL_MAX, DBL_MAX, 0,
+                        &status);
+                oskar_jones_join(jones_c, K, jones, &status);
+                oskar_mem_copy_contents(oskar_sky_I(sky), flux[0], 0,
+                        c * num_sources, num_sources, &status);
+                oskar_mem_copy_contents(oskar_sky_Q(sky), flux[1], 0,
+                        c * num_sources, num_sources, &status);
+                oskar_mem_copy_contents(oskar_sky_U(sky), flux[2], 0,
+                        c * num_sources, num_sources, &status);
+                oskar_mem_copy_contents(oskar_sky_V(sky), flux[3], 0,
+                        c * num_sources, num_sources, &status);
+                oskar_cross_correlate(num_sources, jones_c, sky, tel,
+                        u_, v_, w_, 1.0, frequency, c * num_baselines,
+                        vis, &status);
+            }
+        }
+        else
+        {
+            // Correlate all channels together.
+            oskar_evaluate_jones_K(K_inc, num_sources,
+                    oskar_sky_l_const(sky), oskar_sky_m_const(sky),
+                    oskar_sky_n_const(sky), u_, v_, w_, freq_inc,
+                    oskar_sky_I_const(sky), -DBL_MAX, DBL_MAX, 0, &status);
+            oskar_cross_correlate_channels(num_sources, num_channels,
+                    jones, K_inc, sky, flux[0], flux[1], flux[2], flux[3],
+                    tel, u_, v_, w_, 1.0, freq_start, freq_inc,
+                    0, num_baselines, vis, &status);
+        }
+        destroyTestData();
+        oskar_jones_free(jones_c, &status);
+        oskar_jones_free(K, &status);
+        oskar_jones_free(K_inc, &status);
+        for (int i = 0; i < 4; ++i) oskar_mem_free(flux[i], &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    }
+
+    void runChannelsTest(int prec, int matrix, int extended,
+            double time_average)
+    {
+        int status = 0;
+        const int type = prec | OSKAR_COMPLEX | (matrix ? OSKAR_MATRIX : 0);
+        oskar_Mem *vis1, *vis2;
+        vis1 = oskar_mem_create(type, OSKAR_CPU, 0, &status);
+        vis2 = oskar_mem_create(type, OSKAR_CPU, 0, &status);
+        correlateChannels(prec, matrix, extended, time_average, 7, 0, vis1);
+        correlateChannels(prec, matrix, extended, time_average, 7, 1, vis2);
+
+        // Compare results.
+        check_values(vis2, vis1);
+        oskar_mem_free(vis1, &status);
+        oskar_mem_free(vis2, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    }
+
+    // Checks that correlating many single-precision channels together
+    // is no less accurate than correlating them one at a time.
+    void runChannelsPrecisionTest(int matrix, int num_channels)
+    {
+        int status = 0;
+        double error_single[4], error_batch[4];
+        const int type = OSKAR_COMPLEX | (matrix ? OSKAR_MATRIX : 0);
+        oskar_Mem *vis_ref, *vis_single, *vis_batch;
+        vis_ref = oskar_mem_create(OSKAR_DOUBLE | type, OSKAR_CPU, 0, &status);
+        vis_single = oskar_mem_create(OSKAR_SINGLE | type, OSKAR_CPU, 0,
+                &status);
+        vis_batch = oskar_mem_create(OSKAR_SINGLE | type, OSKAR_CPU, 0,
+                &status);
+        correlateChannels(OSKAR_DOUBLE, matrix, 0, 0.0, num_channels,
+                0, vis_ref);
+        correlateChannels(OSKAR_SINGLE, matrix, 0, 0.0, num_channels,
+                0, vis_single);
+        correlateChannels(OSKAR_SINGLE, matrix, 0, 0.0, num_channels,
+                1, vis_batch);
+        oskar_mem_evaluate_relative_error(vis_single, vis_ref,
+                &error_single[0], &error_single[1], &error_single[2],
+                &error_single[3], &status);
+        oskar_mem_evaluate_relative_error(vis_batch, vis_ref,
+                &error_batch[0], &error_batch[1], &error_batch[2],
+                &error_batch[3], &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        printf("Average relative error: %.3e (single), %.3e (batch)\n",
+                error_single[2], error_batch[2]);
+        EXPECT_LT(error_batch[2], 1.5 * error_single[2]);
+        oskar_mem_free(vis_ref, &status);
+        oskar_mem_free(vis_single, &status);
+        oskar_mem_free(vis_batch, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    }
+
+    void runBeamTest(int prec, int matrix, int extended,
+            double time_average, int shared_beam, int filter)
+    {
+        int num_baselines, status = 0, type;
+        oskar_Mem *vis1, *vis2, *vis3, *work;
+        oskar_Jones *beam, *K;
+        const double frequency = 100e6;
+        const double filter_min = filter ? 1.2 : -DBL_MAX;
+        const double filter_max = filter ? 1.8 : DBL_MAX;
+
+        // Create test data, with station beams that may be shared.
+        createTestData(prec, OSKAR_CPU, matrix);
+        oskar_sky_set_use_extended(sky, extended);
+        oskar_telescope_set_channel_bandwidth(tel, bandwidth);
+        oskar_telescope_set_time_average(tel, time_average);
+        num_baselines = oskar_telescope_num_baselines(tel);
+        type = prec | OSKAR_COMPLEX;
+        if (matrix) type |= OSKAR_MATRIX;
+        vis1 = oskar_mem_create(type, OSKAR_CPU, num_baselines, &status);
+        vis2 = oskar_mem_create(type, OSKAR_CPU, num_baselines, &status);
+        vis3 = oskar_mem_create(type, OSKAR_CPU, num_baselines, &status);
+        oskar_mem_clear_contents(vis1, &status);
+        oskar_mem_clear_contents(vis2, &status);
+        oskar_mem_clear_contents(vis3, &status);
+        work = oskar_mem_create(prec, OSKAR_CPU, 0, &status);
+        beam = oskar_jones_create(type, OSKAR_CPU,
+                shared_beam ? 1 : num_stations, num_sources, &status);
+        K = oskar_jones_create(prec | OSKAR_COMPLEX, OSKAR_CPU,
+                num_stations, num_sources, &status);
+        oskar_mem_random_range(oskar_jones_mem(beam), 1.0, 5.0, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+        // Evaluate Jones K, join with the beams and correlate.
+        oskar_evaluate_jones_K(K, num_sources, oskar_sky_l_const(sky),
+                oskar_sky_m_const(sky), oskar_sky_n_const(sky),
+                u_, v_, w_, frequency, oskar_sky_I_const(sky),
+                filter_min, filter_max, 0, &status);
+        oskar_jones_join(jones, K, beam, &status);
+        oskar_cross_correlate(num_sources, jones, sky, tel,
+                u_, v_, w_, 1.0, frequency, 0, vis1, &status);
+
+        // Correlate the beams directly, with and without a reusable
+        // workspace.
+        oskar_cross_correlate_beam(num_sources, beam, sky, tel,
+                u_, v_, w_, 1.0, frequency, filter_min, filter_max, 0,
+                0, vis2, 0, &status);
+        oskar_cross_correlate_beam(num_sources, beam, sky, tel,
+                u_, v_, w_, 1.0, frequency, filter_min, filter_max, 0,
+                0, vis3, work, &status);
+        destroyTestData();
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+        // Compare results.
+        check_values(vis2, vis1);
+        check_values(vis3, vis1);
+        oskar_mem_free(vis1, &status);
+        oskar_mem_free(vis2, &status);
+        oskar_mem_free(vis3, &status);
+        oskar_mem_free(work, &status);
+        oskar_jones_free(beam, &status);
+        oskar_jones_free(K, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    }
 };
 
 const double cross_correlate::bandwidth = 1e4;
@@ -383,6 +631,26 @@ TEST_F(cross_correlate, matrix_gaussian_timeSmearing_singleCPU_doubleGPU)
 }
 #endif
 
+// Vectorised CPU kernel against reference CPU kernel.
+TEST_F(cross_correlate, matrix_point_simd_single)
+{
+    runSimdTest(OSKAR_SINGLE, 0, 0.0, 0.0);
+}
+
+TEST_F(cross_correlate, matrix_point_simd_double)
+{
+    runSimdTest(OSKAR_DOUBLE, 0, 0.0, 0.0);
+}
+
+TEST_F(cross_correlate, matrix_gaussian_smearing_simd_single)
+{
+    runSimdTest(OSKAR_SINGLE, 1, bandwidth, 10.0);
+}
+
+TEST_F(cross_correlate, matrix_gaussian_smearing_simd_double)
+{
+    runSimdTest(OSKAR_DOUBLE, 1, bandwidth, 10.0);
+}
 
 // SCALAR VERSIONS ////////////////////////////////////////////////////////////
 
@@ -542,6 +810,67 @@ TEST_F(cross_correlate, scalar_gaussian_timeSmearing_singleCPU_doubleGPU)
 }
 #endif
 
+// Channel batches, CPU only.
+TEST_F(cross_correlate, channels_matrix_point_double)
+{
+    runChannelsTest(OSKAR_DOUBLE, 1, 0, 0.0);
+}
+
+TEST_F(cross_correlate, channels_matrix_gaussian_timeSmearing_double)
+{
+    runChannelsTest(OSKAR_DOUBLE, 1, 1, 10.0);
+}
+
+TEST_F(cross_correlate, channels_matrix_point_single)
+{
+    runChannelsTest(OSKAR_SINGLE, 1, 0, 0.0);
+}
+
+TEST_F(cross_correlate, channels_matrix_point_single_many)
+{
+    runChannelsPrecisionTest(1, 300);
+}
+
+TEST_F(cross_correlate, channels_scalar_point_single_many)
+{
+    runChannelsPrecisionTest(0, 300);
+}
+
+TEST_F(cross_correlate, channels_scalar_gaussian_double)
+{
+    runChannelsTest(OSKAR_DOUBLE, 0, 1, 0.0);
+}
+
+TEST_F(cross_correlate, channels_scalar_point_timeSmearing_double)
+{
+    runChannelsTest(OSKAR_DOUBLE, 0, 0, 10.0);
+}
+
+TEST_F(cross_correlate, beam_matrix_point_double)
+{
+    runBeamTest(OSKAR_DOUBLE, 1, 0, 0.0, 0, 0);
+}
+
+TEST_F(cross_correlate, beam_matrix_gaussian_timeSmearing_filter_double)
+{
+    runBeamTest(OSKAR_DOUBLE, 1, 1, 10.0, 0, 1);
+}
+
+TEST_F(cross_correlate, beam_matrix_point_shared_single)
+{
+    runBeamTest(OSKAR_SINGLE, 1, 0, 0.0, 1, 0);
+}
+
+TEST_F(cross_correlate, beam_scalar_gaussian_shared_filter_double)
+{
+    runBeamTest(OSKAR_DOUBLE, 0, 1, 0.0, 1, 1);
+}
+
+TEST_F(cross_correlate, beam_scalar_point_timeSmearing_single)
+{
+    runBeamTest(OSKAR_SINGLE, 0, 0, 10.0, 0, 0);
+}
+
 #if 0
 TEST(KahanSum, sum)
 {
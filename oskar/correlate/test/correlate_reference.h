@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_CORRELATE_REFERENCE_H_
+#define OSKAR_CORRELATE_REFERENCE_H_
+
+#include "correlate/oskar_cross_correlate.h"
+#include "correlate/oskar_cross_correlate_omp.h"
+#include "interferometer/oskar_jones.h"
+#include "sky/oskar_sky.h"
+#include "telescope/oskar_telescope.h"
+
+#include <cfloat>
+
+// Correlates using the reference CPU kernel for matrix data, bypassing the
+// vectorised kernel. Parameters are evaluated as in oskar_cross_correlate().
+static void correlate_reference(const oskar_Jones* J, const oskar_Sky* sky,
+        const oskar_Telescope* tel, const oskar_Mem* u, const oskar_Mem* v,
+        const oskar_Mem* w, double gast, double frequency_hz, oskar_Mem* vis,
+        int* status)
+{
+    const int num_sources = oskar_sky_num_sources(sky);
+    const int num_stations = oskar_telescope_num_stations(tel);
+    const double inv_wavelength = frequency_hz / 299792458.0;
+    const double frac_bandwidth =
+            oskar_telescope_channel_bandwidth_hz(tel) / frequency_hz;
+    const double time_avg = oskar_telescope_time_average_sec(tel);
+    const double gha0 = gast - oskar_telescope_phase_centre_ra_rad(tel);
+    const double dec0 = oskar_telescope_phase_centre_dec_rad(tel);
+    double uv_min = oskar_telescope_uv_filter_min(tel);
+    double uv_max = oskar_telescope_uv_filter_max(tel);
+    if (oskar_telescope_uv_filter_units(tel) == OSKAR_METRES)
+    {
+        uv_min *= inv_wavelength;
+        uv_max *= inv_wavelength;
+    }
+    if (uv_max < 0.0 || uv_max > FLT_MAX) uv_max = FLT_MAX;
+    const oskar_Mem* x =
+            oskar_telescope_station_true_x_offset_ecef_metres_const(tel);
+    const oskar_Mem* y =
+            oskar_telescope_station_true_y_offset_ecef_metres_const(tel);
+    const int extended = oskar_sky_use_extended(sky);
+    if (oskar_mem_location(vis) != OSKAR_CPU ||
+            !oskar_mem_is_matrix(vis))
+    {
+        // There is only one kernel for these.
+        oskar_cross_correlate(num_sources, J, sky, tel, u, v, w,
+                gast, frequency_hz, 0, vis, status);
+    }
+    else if (oskar_mem_is_double(vis) && extended)
+        oskar_cross_correlate_gaussian_omp_d(num_sources, num_stations, 0,
+                oskar_mem_double4c_const(oskar_jones_mem_const(J), status),
+                oskar_mem_double_const(oskar_sky_I_const(sky), status),
+                oskar_mem_double_const(oskar_sky_Q_const(sky), status),
+                oskar_mem_double_const(oskar_sky_U_const(sky), status),
+                oskar_mem_double_const(oskar_sky_V_const(sky), status),
+                oskar_mem_double_const(oskar_sky_l_const(sky), status),
+                oskar_mem_double_const(oskar_sky_m_const(sky), status),
+                oskar_mem_double_const(oskar_sky_n_const(sky), status),
+                oskar_mem_double_const(oskar_sky_gaussian_a_const(sky), status),
+                oskar_mem_double_const(oskar_sky_gaussian_b_const(sky), status),
+                oskar_mem_double_const(oskar_sky_gaussian_c_const(sky), status),
+                oskar_mem_double_const(u, status),
+                oskar_mem_double_const(v, status),
+                oskar_mem_double_const(w, status),
+                oskar_mem_double_const(x, status),
+                oskar_mem_double_const(y, status),
+                uv_min, uv_max, inv_wavelength, frac_bandwidth,
+                time_avg, gha0, dec0, oskar_mem_double4c(vis, status));
+    else if (oskar_mem_is_double(vis))
+        oskar_cross_correlate_point_omp_d(num_sources, num_stations, 0,
+                oskar_mem_double4c_const(oskar_jones_mem_const(J), status),
+                oskar_mem_double_const(oskar_sky_I_const(sky), status),
+                oskar_mem_double_const(oskar_sky_Q_const(sky), status),
+                oskar_mem_double_const(oskar_sky_U_const(sky), status),
+                oskar_mem_double_const(oskar_sky_V_const(sky), status),
+                oskar_mem_double_const(oskar_sky_l_const(sky), status),
+                oskar_mem_double_const(oskar_sky_m_const(sky), status),
+                oskar_mem_double_const(oskar_sky_n_const(sky), status),
+                oskar_mem_double_const(u, status),
+                oskar_mem_double_const(v, status),
+                oskar_mem_double_const(w, status),
+                oskar_mem_double_const(x, status),
+                oskar_mem_double_const(y, status),
+                uv_min, uv_max, inv_wavelength, frac_bandwidth,
+                time_avg, gha0, dec0, oskar_mem_double4c(vis, status));
+    else if (extended)
+        oskar_cross_correlate_gaussian_omp_f(num_sources, num_stations, 0,
+                oskar_mem_float4c_const(oskar_jones_mem_const(J), status),
+                oskar_mem_float_const(oskar_sky_I_const(sky), status),
+                oskar_mem_float_const(oskar_sky_Q_const(sky), status),
+                oskar_mem_float_const(oskar_sky_U_const(sky), status),
+                oskar_mem_float_const(oskar_sky_V_const(sky), status),
+                oskar_mem_float_const(oskar_sky_l_const(sky), status),
+                oskar_mem_float_const(oskar_sky_m_const(sky), status),
+                oskar_mem_float_const(oskar_sky_n_const(sky), status),
+                oskar_mem_float_const(oskar_sky_gaussian_a_const(sky), status),
+                oskar_mem_float_const(oskar_sky_gaussian_b_const(sky), status),
+                oskar_mem_float_const(oskar_sky_gaussian_c_const(sky), status),
+                oskar_mem_float_const(u, status),
+                oskar_mem_float_const(v, status),
+                oskar_mem_float_const(w, status),
+                oskar_mem_float_const(x, status),
+                oskar_mem_float_const(y, status),
+                uv_min, uv_max, inv_wavelength, frac_bandwidth,
+                time_avg, gha0, dec0, oskar_mem_float4c(vis, status));
+    else
+        oskar_cross_correlate_point_omp_f(num_sources, num_stations, 0,
+                oskar_mem_float4c_const(oskar_jones_mem_const(J), status),
+                oskar_mem_float_const(oskar_sky_I_const(sky), status),
+                oskar_mem_float_const(oskar_sky_Q_const(sky), status),
+                oskar_mem_float_const(oskar_sky_U_const(sky), status),
+                oskar_mem_float_const(oskar_sky_V_const(sky), status),
+                oskar_mem_float_const(oskar_sky_l_const(sky), status),
+                oskar_mem_float_const(oskar_sky_m_const(sky), status),
+                oskar_mem_float_const(oskar_sky_n_const(sky), status),
+                oskar_mem_float_const(u, status),
+                oskar_mem_float_const(v, status),
+                oskar_mem_float_const(w, status),
+                oskar_mem_float_const(x, status),
+                oskar_mem_float_const(y, status),
+                uv_min, uv_max, inv_wavelength, frac_bandwidth,
+                time_avg, gha0, dec0, oskar_mem_float4c(vis, status));
+}
+
+#endif /* OSKAR_CORRELATE_REFERENCE_H_ */
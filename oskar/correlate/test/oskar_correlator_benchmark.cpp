@@ -28,6 +28,8 @@
 
 #include "settings/oskar_option_parser.h"
 #include "correlate/oskar_cross_correlate.h"
+#include "correlate/oskar_cross_correlate_simd_omp.h"
+#include "correlate/test/correlate_reference.h"
 #include "interferometer/oskar_jones.h"
 #include "sky/oskar_sky.h"
 #include "telescope/oskar_telescope.h"
@@ -45,8 +47,8 @@
 static void benchmark(int num_stations, int num_sources, int type,
         int jones_type, int location, int use_extended,
         int use_bandwidth_smearing, int use_time_smearing,
-        int niter, std::vector<double>& times, const std::string& ascii_file,
-        int* status);
+        int use_reference, int niter, std::vector<double>& times,
+        const std::string& ascii_file, int* status);
 
 int main(int argc, char** argv)
 {
@@ -61,6 +63,7 @@ int main(int argc, char** argv)
     opt.add_flag("-e", "Use Gaussian sources (default: point sources).");
     opt.add_flag("-b", "Use bandwidth smearing (default: no bandwidth smearing).");
     opt.add_flag("-t", "Use time smearing (default: no time smearing).");
+    opt.add_flag("-ref", "Use the reference (non-vectorised) CPU kernel.");
     opt.add_flag("-r", "Dump raw iteration data to this file.", 1);
     opt.add_flag("-a", "Dump ASCII visibility data to this file.", 1);
     opt.add_flag("-std", "Discard values greater than this number of standard "
@@ -113,6 +116,9 @@ int main(int argc, char** argv)
                 "true" : "false");
         printf("- Time smearing: %s\n", (use_time_smearing) ?
                 "true" : "false");
+        if (location == OSKAR_CPU)
+            printf("- CPU kernel: %s\n", opt.is_set("-ref") ? "reference" :
+                    oskar_cross_correlate_simd_omp_isa());
         printf("- Number of iterations: %i\n", niter);
         if (max_std_dev > 0.0)
             printf("- Max standard deviations: %f\n", max_std_dev);
@@ -127,7 +133,7 @@ int main(int argc, char** argv)
     std::vector<double> times;
     benchmark(num_stations, num_sources, type, jones_type, location,
             use_extended, use_bandwidth_smearing, use_time_smearing,
-            niter, times, ascii_file, &status);
+            opt.is_set("-ref"), niter, times, ascii_file, &status);
 
     // Compute total time taken.
     for (int i = 0; i < niter; ++i)
@@ -192,11 +198,21 @@ int main(int argc, char** argv)
         average_time_sec = time_taken_sec / niter;
     }
 
+    // Compute the nominal rate of floating-point operations.
+    // This counts the Jones matrix products and the accumulation only,
+    // not the smearing terms: 114 flops per source per baseline for
+    // matrices, or 12 for scalars.
+    const double flops = (opt.is_set("-s") ? 12.0 : 114.0) *
+            num_sources * num_stations * (num_stations - 1) / 2.0;
+    const double gflops = average_time_sec > 0.0 ?
+            1e-9 * flops / average_time_sec : 0.0;
+
     // Print average.
     if (opt.is_set("-v"))
     {
         printf("==> Total time taken: %f seconds.\n", time_taken_sec);
         printf("==> Time taken per iteration: %f seconds.\n", average_time_sec);
+        printf("==> Nominal rate: %.2f GFLOP/s.\n", gflops);
         printf("==> Iteration values:\n");
         for (int i = 0; i < niter; ++i)
         {
@@ -216,8 +232,8 @@ int main(int argc, char** argv)
 void benchmark(int num_stations, int num_sources, int type,
         int jones_type, int location, int use_extended,
         int use_bandwidth_smearing, int use_time_smearing,
-        int niter, std::vector<double>& times, const std::string& ascii_file,
-        int* status)
+        int use_reference, int niter, std::vector<double>& times,
+        const std::string& ascii_file, int* status)
 {
     oskar_Timer* timer = oskar_timer_create(location);
 
@@ -275,8 +291,12 @@ void benchmark(int num_stations, int num_sources, int type,
     {
         oskar_mem_clear_contents(vis, status);
         oskar_timer_start(timer);
-        oskar_cross_correlate(oskar_sky_num_sources(sky), J, sky, tel,
-                u, v, w, 0.0, 100e6, 0, vis, status);
+        if (use_reference)
+            correlate_reference(J, sky, tel, u, v, w, 0.0, 100e6, vis,
+                    status);
+        else
+            oskar_cross_correlate(oskar_sky_num_sources(sky), J, sky, tel,
+                    u, v, w, 0.0, 100e6, 0, vis, status);
         times[i] = oskar_timer_elapsed(timer);
     }
 
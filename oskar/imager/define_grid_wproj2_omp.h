@@ -0,0 +1,227 @@
+/* Copyright (c) 2019, The University of Oxford. See LICENSE file. */
+
+#define GRID_W_PLANE(FP, W) M_CAT(GRID_W_PLANE_, FP)(W)
+#define GRID_W_PLANE_float(W) (size_t)roundf(sqrtf(fabsf(W)))
+#define GRID_W_PLANE_double(W) (size_t)round(sqrt(fabs(W)))
+
+/*
+ * Multi-threaded W-projection gridder, giving the same result as SERIAL.
+ * Visibilities are binned into square tiles of the grid, and each tile is
+ * gridded by one thread, in the original visibility order.
+ */
+#define OSKAR_GRID_WPROJ2_OMP(NAME, SERIAL, FP) void NAME(\
+        const size_t num_w_planes,\
+        const int* RESTRICT support,\
+        const int oversample,\
+        const int* wkernel_start,\
+        const FP* RESTRICT wkernel,\
+        const size_t num_points,\
+        const FP* RESTRICT uu,\
+        const FP* RESTRICT vv,\
+        const FP* RESTRICT ww,\
+        const FP* RESTRICT vis,\
+        const FP* RESTRICT weight,\
+        const FP cell_size_rad,\
+        const FP w_scale,\
+        const int grid_size,\
+        const int num_threads,\
+        size_t* RESTRICT num_skipped,\
+        double* RESTRICT norm,\
+        FP* RESTRICT grid,\
+        int* status)\
+{\
+    int i, tile_size, num_tiles_u, num_tiles, *box;\
+    size_t v, *tile_offsets, *tile_vis;\
+    double *vis_norm;\
+    const int grid_centre = grid_size / 2;\
+    const int oversample_h = oversample / 2;\
+    const FP grid_scale = grid_size * cell_size_rad;\
+    const int nt = GRID_NUM_THREADS(num_threads);\
+    if (*status) return;\
+    if (nt == 1 || num_points == 0)\
+    {\
+        SERIAL(num_w_planes, support, oversample,\
+                wkernel_start, wkernel, num_points, uu, vv, ww, vis, weight,\
+                cell_size_rad, w_scale, grid_size, num_skipped, norm, grid);\
+        return;\
+    }\
+    tile_size = get_tile_size(num_w_planes, support);\
+    num_tiles_u = (grid_size + tile_size - 1) / tile_size;\
+    num_tiles = num_tiles_u * num_tiles_u;\
+    box = (int*) malloc(4 * num_points * sizeof(int));\
+    vis_norm = (double*) malloc(num_points * sizeof(double));\
+    tile_offsets = (size_t*) calloc(num_tiles + 1, sizeof(size_t));\
+    if (!box || !vis_norm || !tile_offsets)\
+    {\
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;\
+        free(box);\
+        free(vis_norm);\
+        free(tile_offsets);\
+        return;\
+    }\
+    \
+    /* Find the grid tiles touched by each visibility,
+     * and the sum of its convolution kernel.
+     * (The range is split by hand, as OpenMP 2.0 needs a signed index.) */\
+    DO_PRAGMA(omp parallel num_threads(nt))\
+    {\
+        size_t i_vis;\
+        const size_t n = (size_t) omp_get_num_threads();\
+        const size_t chunk = (num_points + n - 1) / n;\
+        const size_t i_start = chunk * (size_t) omp_get_thread_num();\
+        const size_t i_end = MIN(i_start + chunk, num_points);\
+        for (i_vis = i_start; i_vis < i_end; ++i_vis)\
+        {\
+            double sum = 0.0;\
+            int j, k;\
+            \
+            /* Convert UV coordinates to grid coordinates. */\
+            const FP pos_u = -uu[i_vis] * grid_scale;\
+            const FP pos_v = vv[i_vis] * grid_scale;\
+            const size_t grid_w = GRID_W_PLANE(FP, ww[i_vis] * w_scale);\
+            const int grid_u = ROUND(FP, pos_u) + grid_centre;\
+            const int grid_v = ROUND(FP, pos_v) + grid_centre;\
+            \
+            /* Scaled distance from nearest grid point. */\
+            const int off_u = ROUND(FP, ((FP) ROUND(FP, pos_u) - pos_u) *\
+                    oversample);\
+            const int off_v = ROUND(FP, ((FP) ROUND(FP, pos_v) - pos_v) *\
+                    oversample);\
+            \
+            /* Get kernel support size and start offset. */\
+            const int w_support = grid_w < num_w_planes ?\
+                    support[grid_w] : support[num_w_planes - 1];\
+            const int kernel_start = grid_w < num_w_planes ?\
+                    wkernel_start[grid_w] : wkernel_start[num_w_planes - 1];\
+            \
+            /* Catch points that would lie outside the grid. */\
+            if (grid_u + w_support >= grid_size || grid_u - w_support < 0 ||\
+                    grid_v + w_support >= grid_size || grid_v - w_support < 0)\
+            {\
+                box[4 * i_vis] = -1;\
+                continue;\
+            }\
+            \
+            /* Store the range of tiles covered by the kernel. */\
+            box[4 * i_vis + 0] = (grid_u - w_support) / tile_size;\
+            box[4 * i_vis + 1] = (grid_u + w_support) / tile_size;\
+            box[4 * i_vis + 2] = (grid_v - w_support) / tile_size;\
+            box[4 * i_vis + 3] = (grid_v + w_support) / tile_size;\
+            \
+            /* Sum the kernel in the same order as the serial version. */\
+            const int conv_len = 2 * w_support + 1;\
+            const int width = (oversample_h * conv_len + 1) * conv_len;\
+            const int mid = kernel_start + (abs(off_u) + 1) * width -\
+                    1 - w_support;\
+            const int stride = (off_u >= 0) ? 1 : -1;\
+            for (j = -w_support; j <= w_support; ++j)\
+            {\
+                const int t = mid - abs(off_v + j * oversample) * conv_len;\
+                for (k = -w_support; k <= w_support; ++k)\
+                    sum += wkernel[(t + stride * k) << 1]; /* Real part. */\
+            }\
+            vis_norm[i_vis] = sum;\
+        }\
+    }\
+    \
+    /* Accumulate normalisation serially, to preserve the summation order. */\
+    *num_skipped = 0;\
+    for (v = 0; v < num_points; ++v)\
+    {\
+        if (box[4 * v] < 0)\
+            *num_skipped += 1;\
+        else\
+            *norm += vis_norm[v] * weight[v];\
+    }\
+    \
+    /* Bin visibility indices into tiles. */\
+    tile_vis = bin_into_tiles(num_points, box, num_tiles_u, num_tiles,\
+            tile_offsets);\
+    if (!tile_vis)\
+    {\
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;\
+        num_tiles = 0;\
+    }\
+    \
+    /* Grid each tile using one thread. */\
+    DO_PRAGMA(omp parallel for num_threads(nt) schedule(dynamic, 1)\
+            private(i))\
+    for (i = 0; i < num_tiles; ++i)\
+    {\
+        size_t t_idx;\
+        int j, k;\
+        const size_t t_start = tile_offsets[i], t_end = tile_offsets[i + 1];\
+        const int u_min = (i % num_tiles_u) * tile_size;\
+        const int v_min = (i / num_tiles_u) * tile_size;\
+        const int u_max = u_min + tile_size - 1;\
+        const int v_max = v_min + tile_size - 1;\
+        \
+        /* Loop over visibilities in this tile, in their original order. */\
+        for (t_idx = t_start; t_idx < t_end; ++t_idx)\
+        {\
+            const size_t v_idx = tile_vis[t_idx];\
+            \
+            /* Convert UV coordinates to grid coordinates. */\
+            const FP pos_u = -uu[v_idx] * grid_scale;\
+            const FP pos_v = vv[v_idx] * grid_scale;\
+            const FP ww_i = ww[v_idx];\
+            const FP conv_conj = (ww_i > (FP)0) ? (FP)-1 : (FP)1;\
+            const size_t grid_w = GRID_W_PLANE(FP, ww_i * w_scale);\
+            const int grid_u = ROUND(FP, pos_u) + grid_centre;\
+            const int grid_v = ROUND(FP, pos_v) + grid_centre;\
+            \
+            /* Get visibility data. */\
+            const FP weight_i = weight[v_idx];\
+            const FP v_re = weight_i * vis[2 * v_idx];\
+            const FP v_im = weight_i * vis[2 * v_idx + 1];\
+            \
+            /* Scaled distance from nearest grid point. */\
+            const int off_u = ROUND(FP, ((FP) ROUND(FP, pos_u) - pos_u) *\
+                    oversample);\
+            const int off_v = ROUND(FP, ((FP) ROUND(FP, pos_v) - pos_v) *\
+                    oversample);\
+            \
+            /* Get kernel support size and start offset. */\
+            const int w_support = grid_w < num_w_planes ?\
+                    support[grid_w] : support[num_w_planes - 1];\
+            const int kernel_start = grid_w < num_w_planes ?\
+                    wkernel_start[grid_w] : wkernel_start[num_w_planes - 1];\
+            \
+            /* Clip the kernel to the tile. */\
+            const int j_min = MAX(-w_support, v_min - grid_v);\
+            const int j_max = MIN(w_support, v_max - grid_v);\
+            const int k_min = MAX(-w_support, u_min - grid_u);\
+            const int k_max = MIN(w_support, u_max - grid_u);\
+            \
+            /* Convolve the part of this point in the tile onto the grid. */\
+            const int conv_len = 2 * w_support + 1;\
+            const int width = (oversample_h * conv_len + 1) * conv_len;\
+            const int mid = kernel_start + (abs(off_u) + 1) * width -\
+                    1 - w_support;\
+            const int stride = (off_u >= 0) ? 1 : -1;\
+            for (j = j_min; j <= j_max; ++j)\
+            {\
+                const int t = mid - abs(off_v + j * oversample) * conv_len;\
+                size_t p1 = grid_v + j;\
+                p1 *= grid_size; /* Tested to avoid int overflow. */\
+                p1 += grid_u;\
+                for (k = k_min; k <= k_max; ++k)\
+                {\
+                    const int p = (t + stride * k) << 1;\
+                    const FP c_re = wkernel[p];\
+                    const FP c_im = wkernel[p + 1] * conv_conj;\
+                    const size_t p2 = (p1 + k) << 1;\
+                    grid[p2]     += (v_re * c_re - v_im * c_im);\
+                    grid[p2 + 1] += (v_im * c_re + v_re * c_im);\
+                }\
+            }\
+        }\
+    }\
+    \
+    /* Free scratch memory. */\
+    free(box);\
+    free(vis_norm);\
+    free(tile_offsets);\
+    free(tile_vis);\
+}\
+
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_GRID_WPROJ_2_OMP_H_
+#define OSKAR_GRID_WPROJ_2_OMP_H_
+
+/**
+ * @file oskar_grid_wproj2_omp.h
+ */
+
+#include <oskar_global.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Multi-threaded gridding function for W-projection (double precision).
+ *
+ * @details
+ * Multi-threaded version of oskar_grid_wproj2_d().
+ *
+ * Visibilities are first binned into square tiles of the grid, and
+ * each tile is then gridded by a single thread, so that no two threads
+ * ever update the same grid cell. Within each tile, visibilities are
+ * processed in their input order, and the normalisation factor is
+ * accumulated serially, so the result is bit-for-bit identical to
+ * that of oskar_grid_wproj2_d().
+ *
+ * If \p num_threads is 1, or OpenMP is not available,
+ * the serial function is called instead.
+ *
+ * @param[in] num_w_planes   Number of W-projection planes.
+ * @param[in] support        GCF support size per W-plane.
+ * @param[in] oversample     GCF oversample factor.
+ * @param[in] wkernel_start  Start index of each convolution kernel.
+ * @param[in] wkernel        The rearranged convolution kernels.
+ * @param[in] num_points     Number of visibility points.
+ * @param[in] uu             Visibility baseline uu coordinates, in wavelengths.
+ * @param[in] vv             Visibility baseline vv coordinates, in wavelengths.
+ * @param[in] ww             Visibility baseline ww coordinates, in wavelengths.
+ * @param[in] vis            Complex visibilities for each baseline.
+ * @param[in] weight         Visibility weight for each baseline.
+ * @param[in] cell_size_rad  Cell size, in radians.
+ * @param[in] w_scale        Scaling factor used to find W-plane index.
+ * @param[in] grid_size      Side length of grid.
+ * @param[in] num_threads    Number of threads to use (<= 0 means all).
+ * @param[out] num_skipped   Number of visibilities that fell outside the grid.
+ * @param[in,out] norm       Updated grid normalisation factor.
+ * @param[in,out] grid       Updated complex visibility grid.
+ * @param[in,out] status     Status return code.
+ */
+OSKAR_EXPORT
+void oskar_grid_wproj2_omp_d(
+        const size_t num_w_planes,
+        const int* RESTRICT support,
+        const int oversample,
+        const int* wkernel_start,
+        const double* RESTRICT wkernel,
+        const size_t num_points,
+        const double* RESTRICT uu,
+        const double* RESTRICT vv,
+        const double* RESTRICT ww,
+        const double* RESTRICT vis,
+        const double* RESTRICT weight,
+        const double cell_size_rad,
+        const double w_scale,
+        const int grid_size,
+        const int num_threads,
+        size_t* RESTRICT num_skipped,
+        double* RESTRICT norm,
+        double* RESTRICT grid,
+        int* status);
+
+/**
+ * @brief
+ * Multi-threaded gridding function for W-projection (single precision).
+ *
+ * @details
+ * Multi-threaded version of oskar_grid_wproj2_f().
+ *
+ * Visibilities are first binned into square tiles of the grid, and
+ * each tile is then gridded by a single thread, so that no two threads
+ * ever update the same grid cell. As the order of operations on each grid
+ * cell is preserved, the result is bit-for-bit identical to that of
+ * oskar_grid_wproj2_f().
+ *
+ * If \p num_threads is 1, or OpenMP is not available,
+ * the serial function is called instead.
+ *
+ * @param[in] num_w_planes   Number of W-projection planes.
+ * @param[in] support        GCF support size per W-plane.
+ * @param[in] oversample     GCF oversample factor.
+ * @param[in] wkernel_start  Start index of each convolution kernel.
+ * @param[in] wkernel        The rearranged convolution kernels.
+ * @param[in] num_points     Number of visibility points.
+ * @param[in] uu             Visibility baseline uu coordinates, in wavelengths.
+ * @param[in] vv             Visibility baseline vv coordinates, in wavelengths.
+ * @param[in] ww             Visibility baseline ww coordinates, in wavelengths.
+ * @param[in] vis            Complex visibilities for each baseline.
+ * @param[in] weight         Visibility weight for each baseline.
+ * @param[in] cell_size_rad  Cell size, in radians.
+ * @param[in] w_scale        Scaling factor used to find W-plane index.
+ * @param[in] grid_size      Side length of grid.
+ * @param[in] num_threads    Number of threads to use (<= 0 means all).
+ * @param[out] num_skipped   Number of visibilities that fell outside the grid.
+ * @param[in,out] norm       Updated grid normalisation factor.
+ * @param[in,out] grid       Updated complex visibility grid.
+ * @param[in,out] status     Status return code.
+ */
+OSKAR_EXPORT
+void oskar_grid_wproj2_omp_f(
+        const size_t num_w_planes,
+        const int* RESTRICT support,
+        const int oversample,
+        const int* wkernel_start,
+        const float* RESTRICT wkernel,
+        const size_t num_points,
+        const float* RESTRICT uu,
+        const float* RESTRICT vv,
+        const float* RESTRICT ww,
+        const float* RESTRICT vis,
+        const float* RESTRICT weight,
+        const float cell_size_rad,
+        const float w_scale,
+        const int grid_size,
+        const int num_threads,
+        size_t* RESTRICT num_skipped,
+        double* RESTRICT norm,
+        float* RESTRICT grid,
+        int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* include guard */
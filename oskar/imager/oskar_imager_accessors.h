@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2017, The University of Oxford
+ * Copyright (c) 2016-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -75,6 +75,19 @@ double oskar_imager_cellsize(const oskar_Imager* h);
 OSKAR_EXPORT
 int oskar_imager_channel_snapshots(const oskar_Imager* h);
 
+/**
+ * @brief
+ * Returns the maximum size of the coordinate cache, in megabytes.
+ *
+ * @details
+ * Returns the maximum amount of memory used to cache baseline coordinates
+ * read from the input files, in megabytes.
+ *
+ * @param[in] h  Handle to imager.
+ */
+OSKAR_EXPORT
+double oskar_imager_coords_cache_size(const oskar_Imager* h);
+
 /**
  * @brief
  * Returns the flag specifying whether the imager is in coordinate-only mode.
@@ -221,6 +234,18 @@ int oskar_imager_num_image_planes(const oskar_Imager* h);
 OSKAR_EXPORT
 int oskar_imager_num_input_files(const oskar_Imager* h);
 
+/**
+ * @brief
+ * Returns the number of CPU threads used by the gridder.
+ *
+ * @details
+ * Returns the number of CPU threads used by the gridder.
+ *
+ * @param[in] h  Handle to imager.
+ */
+OSKAR_EXPORT
+int oskar_imager_num_threads(const oskar_Imager* h);
+
 /**
  * @brief
  * Returns the number of W-planes in use.
@@ -336,6 +361,25 @@ void oskar_imager_set_cellsize(oskar_Imager* h, double cellsize_arcsec);
 OSKAR_EXPORT
 void oskar_imager_set_channel_snapshots(oskar_Imager* h, int value);
 
+/**
+ * @brief
+ * Sets the maximum size of the coordinate cache, in megabytes.
+ *
+ * @details
+ * When using uniform weighting or W-projection, oskar_imager_run() reads
+ * the input files twice. Baseline coordinates (and weights, for Measurement
+ * Sets) read on the first pass are cached in memory, and reused on the
+ * second pass so that only the visibility amplitudes need to be read again.
+ *
+ * This sets the maximum amount of memory used for the cache.
+ * Files that do not fit in the cache are read in full on both passes.
+ *
+ * @param[in,out] h          Handle to imager.
+ * @param[in]     size_mb    Maximum cache size, in megabytes.
+ */
+OSKAR_EXPORT
+void oskar_imager_set_coords_cache_size(oskar_Imager* h, double size_mb);
+
 /**
  * @brief
  * Sets the imager to ignore visibility data and only update weights grids.
@@ -585,6 +629,21 @@ void oskar_imager_set_ms_column(oskar_Imager* h, const char* column,
 OSKAR_EXPORT
 void oskar_imager_set_num_devices(oskar_Imager* h, int value);
 
+/**
+ * @brief
+ * Sets the number of CPU threads used by the gridder.
+ *
+ * @details
+ * Sets the number of CPU threads used when gridding visibilities
+ * on the CPU. Currently this is only used by the W-projection imager.
+ * Values less than 1 mean use all available CPU cores.
+ *
+ * @param[in,out] h          Handle to imager.
+ * @param[in]     value      Number of CPU threads to use.
+ */
+OSKAR_EXPORT
+void oskar_imager_set_num_threads(oskar_Imager* h, int value);
+
 /**
  * @brief
  * Sets the root path of output images.
@@ -47,6 +47,15 @@ struct DeviceData
 };
 typedef struct DeviceData DeviceData;
 
+/* Coordinates read from one input file by the first pass over the data. */
+struct CoordsCache
+{
+    size_t num_rows, total_rows;
+    int num_pols, disabled;
+    oskar_Mem *uu, *vv, *ww, *weight, *time_centroid;
+};
+typedef struct CoordsCache CoordsCache;
+
 struct oskar_Imager
 {
     char* output_name[4];
@@ -56,6 +65,7 @@ struct oskar_Imager
 
     /* Settings parameters. */
     int imager_prec, num_devices, num_gpus_avail, dev_loc, num_gpus, *gpu_ids;
+    int num_threads;
     int chan_snaps, im_type, num_im_channels, num_im_pols, pol_offset;
     int algorithm, fft_on_gpu, image_size, use_stokes, support, oversample;
     int generate_w_kernels_on_gpu, set_cellsize, set_fov, weighting;
@@ -75,6 +85,12 @@ struct oskar_Imager
     int status, i_block;
     oskar_Mutex* mutex;
 
+    /* Coordinates cached by the first pass over the input files. */
+    int coords_cache_num_files;
+    double coords_cache_mb;
+    size_t coords_cache_bytes;
+    CoordsCache* coords_cache;
+
     /* Scratch data. */
     oskar_Mem *uu_im, *vv_im, *ww_im, *vis_im, *weight_im, *time_im;
     oskar_Mem *uu_tmp, *vv_tmp, *ww_tmp, *stokes, *weight_tmp;
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_IMAGER_COORDS_CACHE_H_
+#define OSKAR_IMAGER_COORDS_CACHE_H_
+
+#include <oskar_global.h>
+#include <mem/oskar_mem.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Appends baseline coordinates (and optionally weights and time centroids)
+ * read from input file i_file to the cache, if there is room for the
+ * whole file. The weight and time_centroid arrays may be NULL.
+ */
+OSKAR_EXPORT
+void oskar_imager_coords_cache_append(oskar_Imager* h, int i_file,
+        size_t total_rows, size_t num_rows, int num_pols,
+        const oskar_Mem* uu, const oskar_Mem* vv, const oskar_Mem* ww,
+        const oskar_Mem* weight, const oskar_Mem* time_centroid,
+        int* status);
+
+/*
+ * Returns true if all the coordinates for input file i_file are cached.
+ */
+OSKAR_EXPORT
+int oskar_imager_coords_cache_complete(const oskar_Imager* h, int i_file);
+
+/*
+ * Replaces the given arrays with aliases of the cached data for the
+ * specified rows of input file i_file. Any existing arrays are freed.
+ * Arrays that are not cached are left unchanged.
+ */
+OSKAR_EXPORT
+void oskar_imager_coords_cache_get(const oskar_Imager* h, int i_file,
+        size_t start_row, size_t num_rows, oskar_Mem** uu, oskar_Mem** vv,
+        oskar_Mem** ww, oskar_Mem** weight, oskar_Mem** time_centroid,
+        int* status);
+
+/*
+ * Frees the cache.
+ */
+OSKAR_EXPORT
+void oskar_imager_coords_cache_free(oskar_Imager* h, int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_IMAGER_COORDS_CACHE_H_ */
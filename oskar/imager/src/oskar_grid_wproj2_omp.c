@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "imager/define_grid_wproj2_omp.h"
+#include "imager/oskar_grid_wproj2.h"
+#include "imager/oskar_grid_wproj2_omp.h"
+#include "utility/oskar_kernel_macros.h"
+#include <math.h>
+#include <stdlib.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#define GRID_NUM_THREADS(N) ((N) > 0 ? (N) : omp_get_max_threads())
+#else
+#define GRID_NUM_THREADS(N) ((void)(N), 1)
+#define omp_get_num_threads() 1
+#define omp_get_thread_num() 0
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef MIN
+#define MIN(A, B) ((A) < (B) ? (A) : (B))
+#endif
+#ifndef MAX
+#define MAX(A, B) ((A) > (B) ? (A) : (B))
+#endif
+
+/* Minimum side length of a grid tile, in grid cells. */
+#define TILE_SIZE_MIN 64
+
+static int get_tile_size(const size_t num_w_planes, const int* support)
+{
+    size_t i;
+    int tile_size = TILE_SIZE_MIN;
+    for (i = 0; i < num_w_planes; ++i)
+    {
+        const int conv_len = 2 * support[i] + 1;
+        if (conv_len > tile_size) tile_size = conv_len;
+    }
+    return tile_size;
+}
+
+/*
+ * Returns an array of visibility indices, sorted by tile, or NULL if
+ * memory could not be allocated.
+ * Indices within each tile are in ascending order, and visibilities
+ * covering more than one tile are included in each of them.
+ */
+static size_t* bin_into_tiles(const size_t num_points, const int* box,
+        const int num_tiles_u, const int num_tiles, size_t* tile_offsets)
+{
+    int i, tu, tv;
+    size_t v, *fill, *tile_vis;
+
+    /* Count the visibilities in each tile. */
+    for (v = 0; v < num_points; ++v)
+    {
+        const int* b = &box[4 * v];
+        if (b[0] < 0) continue;
+        for (tv = b[2]; tv <= b[3]; ++tv)
+            for (tu = b[0]; tu <= b[1]; ++tu)
+                tile_offsets[1 + tu + tv * num_tiles_u]++;
+    }
+
+    /* Get the start offset of each tile. */
+    for (i = 0; i < num_tiles; ++i)
+        tile_offsets[i + 1] += tile_offsets[i];
+
+    /* Fill the tile lists, preserving the input order. */
+    tile_vis = (size_t*) malloc((tile_offsets[num_tiles] + 1) *
+            sizeof(size_t));
+    fill = (size_t*) malloc(num_tiles * sizeof(size_t));
+    if (!tile_vis || !fill)
+    {
+        free(tile_vis);
+        free(fill);
+        return 0;
+    }
+    for (i = 0; i < num_tiles; ++i) fill[i] = tile_offsets[i];
+    for (v = 0; v < num_points; ++v)
+    {
+        const int* b = &box[4 * v];
+        if (b[0] < 0) continue;
+        for (tv = b[2]; tv <= b[3]; ++tv)
+            for (tu = b[0]; tu <= b[1]; ++tu)
+                tile_vis[fill[tu + tv * num_tiles_u]++] = v;
+    }
+    free(fill);
+    return tile_vis;
+}
+
+OSKAR_GRID_WPROJ2_OMP(oskar_grid_wproj2_omp_f, oskar_grid_wproj2_f, float)
+OSKAR_GRID_WPROJ2_OMP(oskar_grid_wproj2_omp_d, oskar_grid_wproj2_d, double)
+
+#ifdef __cplusplus
+}
+#endif
@@ -74,6 +74,12 @@ int oskar_imager_channel_snapshots(const oskar_Imager* h)
 }
 
 
+double oskar_imager_coords_cache_size(const oskar_Imager* h)
+{
+    return h->coords_cache_mb;
+}
+
+
 int oskar_imager_coords_only(const oskar_Imager* h)
 {
     return h->coords_only;
@@ -160,6 +166,12 @@ int oskar_imager_num_input_files(const oskar_Imager* h)
 }
 
 
+int oskar_imager_num_threads(const oskar_Imager* h)
+{
+    return h->num_threads;
+}
+
+
 int oskar_imager_num_w_planes(const oskar_Imager* h)
 {
     return h->num_w_planes;
@@ -262,6 +274,12 @@ void oskar_imager_set_channel_snapshots(oskar_Imager* h, int value)
 }
 
 
+void oskar_imager_set_coords_cache_size(oskar_Imager* h, double size_mb)
+{
+    h->coords_cache_mb = size_mb;
+}
+
+
 void oskar_imager_set_coords_only(oskar_Imager* h, int flag)
 {
     h->coords_only = flag;
@@ -512,6 +530,14 @@ void oskar_imager_set_num_devices(oskar_Imager* h, int value)
 }
 
 
+void oskar_imager_set_num_threads(oskar_Imager* h, int value)
+{
+    if (value < 1) value = oskar_get_num_procs();
+    if (value < 1) value = 1;
+    h->num_threads = value;
+}
+
+
 void oskar_imager_set_output_root(oskar_Imager* h, const char* filename)
 {
     int len = 0;
@@ -81,6 +81,7 @@ oskar_Imager* oskar_imager_create(int imager_precision, int* status)
     /* Set sensible defaults. */
     oskar_imager_set_gpus(h, -1, 0, status);
     oskar_imager_set_num_devices(h, -1);
+    oskar_imager_set_num_threads(h, -1);
     oskar_imager_set_algorithm(h, "FFT", status);
     oskar_imager_set_image_type(h, "I", status);
     oskar_imager_set_weighting(h, "Natural", status);
@@ -90,6 +91,7 @@ oskar_Imager* oskar_imager_create(int imager_precision, int* status)
     oskar_imager_set_fov(h, 1.0);
     oskar_imager_set_size(h, 256, status);
     oskar_imager_set_uv_filter_max(h, DBL_MAX);
+    oskar_imager_set_coords_cache_size(h, 1024.0);
     return h;
 }
 
@@ -28,6 +28,7 @@
 
 #include "imager/private_imager.h"
 #include "imager/oskar_imager_reset_cache.h"
+#include "imager/private_imager_coords_cache.h"
 #include "imager/private_imager_free_device_data.h"
 #include "math/oskar_fft.h"
 #include <fitsio.h>
@@ -45,6 +46,9 @@ void oskar_imager_reset_cache(oskar_Imager* h, int* status)
     /* Clear all device data. */
     oskar_imager_free_device_data(h, status);
 
+    /* Clear cached coordinates. */
+    oskar_imager_coords_cache_free(h, status);
+
     /* Clear selected axes. */
     free(h->sel_freqs); h->sel_freqs = 0;
     free(h->im_freqs); h->im_freqs = 0;
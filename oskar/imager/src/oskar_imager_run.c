@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2017, The University of Oxford
+ * Copyright (c) 2016-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -27,6 +27,7 @@
  */
 
 #include "imager/private_imager.h"
+#include "imager/private_imager_coords_cache.h"
 #include "imager/private_imager_read_coords.h"
 #include "imager/private_imager_read_data.h"
 #include "imager/private_imager_read_dims.h"
@@ -161,6 +162,7 @@ void oskar_imager_run(oskar_Imager* h,
             oskar_imager_read_data_vis(h, filename, i, num_files,
                     &percent_done, &percent_next, status);
     }
+    oskar_imager_coords_cache_free(h, status);
 
     /* Check for errors. */
     if (*status)
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "imager/private_imager.h"
+#include "imager/private_imager_coords_cache.h"
+
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static void free_entry(oskar_Imager* h, CoordsCache* c, int* status)
+{
+    size_t bytes = 0;
+    if (c->uu)
+        bytes += 3 * c->total_rows *
+                oskar_mem_element_size(oskar_mem_type(c->uu));
+    if (c->weight)
+        bytes += c->total_rows * c->num_pols *
+                oskar_mem_element_size(oskar_mem_type(c->weight));
+    if (c->time_centroid)
+        bytes += c->total_rows *
+                oskar_mem_element_size(oskar_mem_type(c->time_centroid));
+    h->coords_cache_bytes -= bytes;
+    oskar_mem_free(c->uu, status);
+    oskar_mem_free(c->vv, status);
+    oskar_mem_free(c->ww, status);
+    oskar_mem_free(c->weight, status);
+    oskar_mem_free(c->time_centroid, status);
+    c->uu = c->vv = c->ww = c->weight = c->time_centroid = 0;
+    c->num_rows = c->total_rows = 0;
+}
+
+static void replace_with_alias(oskar_Mem** mem, const oskar_Mem* src,
+        size_t offset, size_t num_elements, int* status)
+{
+    oskar_mem_free(*mem, status);
+    *mem = oskar_mem_create_alias(src, offset, num_elements, status);
+}
+
+void oskar_imager_coords_cache_append(oskar_Imager* h, int i_file,
+        size_t total_rows, size_t num_rows, int num_pols,
+        const oskar_Mem* uu, const oskar_Mem* vv, const oskar_Mem* ww,
+        const oskar_Mem* weight, const oskar_Mem* time_centroid,
+        int* status)
+{
+    CoordsCache* c;
+    if (*status || i_file < 0) return;
+    if (!h->coords_cache)
+    {
+        h->coords_cache = (CoordsCache*) calloc(h->num_files,
+                sizeof(CoordsCache));
+        if (!h->coords_cache)
+        {
+            *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+            return;
+        }
+        h->coords_cache_num_files = h->num_files;
+    }
+    if (i_file >= h->coords_cache_num_files) return;
+    c = &h->coords_cache[i_file];
+    if (c->disabled) return;
+
+    /* Allocate space for the whole file on first use, if there is room. */
+    if (!c->uu)
+    {
+        size_t bytes;
+        bytes = 3 * oskar_mem_element_size(oskar_mem_type(uu));
+        if (weight)
+            bytes += num_pols * oskar_mem_element_size(oskar_mem_type(weight));
+        if (time_centroid)
+            bytes += oskar_mem_element_size(oskar_mem_type(time_centroid));
+        bytes *= total_rows;
+        if (total_rows == 0 || (double)(h->coords_cache_bytes + bytes) >
+                h->coords_cache_mb * 1024.0 * 1024.0)
+        {
+            c->disabled = 1;
+            return;
+        }
+        h->coords_cache_bytes += bytes;
+        c->total_rows = total_rows;
+        c->num_pols = num_pols;
+        c->uu = oskar_mem_create(oskar_mem_type(uu), OSKAR_CPU,
+                total_rows, status);
+        c->vv = oskar_mem_create(oskar_mem_type(vv), OSKAR_CPU,
+                total_rows, status);
+        c->ww = oskar_mem_create(oskar_mem_type(ww), OSKAR_CPU,
+                total_rows, status);
+        if (weight)
+            c->weight = oskar_mem_create(oskar_mem_type(weight), OSKAR_CPU,
+                    total_rows * num_pols, status);
+        if (time_centroid)
+            c->time_centroid = oskar_mem_create(
+                    oskar_mem_type(time_centroid), OSKAR_CPU,
+                    total_rows, status);
+    }
+
+    /* Stop caching this file if it has more rows than expected. */
+    if (c->num_rows + num_rows > c->total_rows)
+    {
+        free_entry(h, c, status);
+        c->disabled = 1;
+        return;
+    }
+
+    /* Copy the data into the cache. */
+    oskar_mem_copy_contents(c->uu, uu, c->num_rows, 0, num_rows, status);
+    oskar_mem_copy_contents(c->vv, vv, c->num_rows, 0, num_rows, status);
+    oskar_mem_copy_contents(c->ww, ww, c->num_rows, 0, num_rows, status);
+    if (c->weight)
+        oskar_mem_copy_contents(c->weight, weight,
+                c->num_rows * num_pols, 0, num_rows * num_pols, status);
+    if (c->time_centroid)
+        oskar_mem_copy_contents(c->time_centroid, time_centroid,
+                c->num_rows, 0, num_rows, status);
+    c->num_rows += num_rows;
+}
+
+
+int oskar_imager_coords_cache_complete(const oskar_Imager* h, int i_file)
+{
+    const CoordsCache* c;
+    if (!h->coords_cache || i_file < 0 ||
+            i_file >= h->coords_cache_num_files) return 0;
+    c = &h->coords_cache[i_file];
+    return (!c->disabled && c->uu && c->num_rows == c->total_rows);
+}
+
+
+void oskar_imager_coords_cache_get(const oskar_Imager* h, int i_file,
+        size_t start_row, size_t num_rows, oskar_Mem** uu, oskar_Mem** vv,
+        oskar_Mem** ww, oskar_Mem** weight, oskar_Mem** time_centroid,
+        int* status)
+{
+    const CoordsCache* c;
+    if (*status) return;
+    if (!oskar_imager_coords_cache_complete(h, i_file))
+    {
+        *status = OSKAR_ERR_MEMORY_NOT_ALLOCATED;
+        return;
+    }
+    c = &h->coords_cache[i_file];
+    if (start_row + num_rows > c->num_rows)
+    {
+        *status = OSKAR_ERR_OUT_OF_RANGE;
+        return;
+    }
+    replace_with_alias(uu, c->uu, start_row, num_rows, status);
+    replace_with_alias(vv, c->vv, start_row, num_rows, status);
+    replace_with_alias(ww, c->ww, start_row, num_rows, status);
+    if (c->weight)
+        replace_with_alias(weight, c->weight,
+                start_row * c->num_pols, num_rows * c->num_pols, status);
+    if (c->time_centroid)
+        replace_with_alias(time_centroid, c->time_centroid,
+                start_row, num_rows, status);
+}
+
+
+void oskar_imager_coords_cache_free(oskar_Imager* h, int* status)
+{
+    int i;
+    if (!h->coords_cache) return;
+    for (i = 0; i < h->coords_cache_num_files; ++i)
+        free_entry(h, &h->coords_cache[i], status);
+    free(h->coords_cache);
+    h->coords_cache = 0;
+    h->coords_cache_bytes = 0;
+    h->coords_cache_num_files = 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -27,6 +27,7 @@
  */
 
 #include "imager/private_imager.h"
+#include "imager/private_imager_coords_cache.h"
 #include "imager/private_imager_read_coords.h"
 #include "imager/oskar_imager.h"
 #include "binary/oskar_binary.h"
@@ -121,6 +122,10 @@ void oskar_imager_read_coords_ms(oskar_Imager* h, const char* filename,
             w_[i] = uvw_[3*i + 2];
         }
 
+        /* Cache the coordinates and weights for the second pass. */
+        oskar_imager_coords_cache_append(h, i_file, num_rows, block_size,
+                num_pols, u, v, w, weight, time_centroid, status);
+
         /* Update the imager with the data. */
         oskar_timer_pause(h->tmr_read);
         oskar_imager_update(h, block_size, 0, num_channels - 1,
@@ -182,6 +187,8 @@ void oskar_imager_read_coords_vis(oskar_Imager* h, const char* filename,
             oskar_type_is_matrix(oskar_vis_header_amp_type(hdr)) ? 4 : 1;
     const int num_weights = num_baselines * num_pols * max_times_per_block;
     const int num_blocks = oskar_vis_header_num_blocks(hdr);
+    const size_t total_rows = (size_t) num_baselines *
+            oskar_vis_header_num_times_total(hdr);
     time_start_mjd = oskar_vis_header_time_start_mjd_utc(hdr) * 86400.0;
     time_inc_sec = oskar_vis_header_time_inc_sec(hdr);
 
@@ -238,6 +245,10 @@ void oskar_imager_read_coords_vis(oskar_Imager* h, const char* filename,
         oskar_binary_read_mem(vis_file, ww, OSKAR_TAG_GROUP_VIS_BLOCK,
                 OSKAR_VIS_BLOCK_TAG_BASELINE_WW, i_block, status);
 
+        /* Cache the coordinates for the second pass. */
+        oskar_imager_coords_cache_append(h, i_file, total_rows, num_rows,
+                num_pols, uu, vv, ww, 0, 0, status);
+
         /* Update the imager with the data. */
         oskar_timer_pause(h->tmr_read);
         oskar_imager_update(h, num_rows, start_chan, end_chan,
@@ -27,6 +27,7 @@
  */
 
 #include "imager/private_imager.h"
+#include "imager/private_imager_coords_cache.h"
 #include "imager/private_imager_read_data.h"
 #include "imager/oskar_imager.h"
 #include "binary/oskar_binary.h"
@@ -45,116 +46,264 @@
 #ifdef __cplusplus
 extern "C" {
 #endif
+/* Data for one block of visibilities, ready to be passed to the imager. */
+struct ReadBuffer
+{
+    oskar_Mem *uu, *vv, *ww, *amp, *weight, *time_centroid;
+    oskar_Mem *scratch, *data;
+    size_t num_rows;
+    int start_chan, end_chan, num_pols;
+};
+typedef struct ReadBuffer ReadBuffer;
+
+typedef void (*ReadBlockFn)(void* reader, int i_block, ReadBuffer* buf,
+        int* status);
+
+struct ReadPipeline
+{
+    oskar_Imager* h;
+    oskar_Barrier* barrier;
+    ReadBlockFn read_block;
+    void* reader;
+    ReadBuffer buf[2];
+    int num_blocks, read_status, *status;
+};
+typedef struct ReadPipeline ReadPipeline;
+
+static void free_buffer(ReadBuffer* buf, int* status)
+{
+    oskar_mem_free(buf->uu, status);
+    oskar_mem_free(buf->vv, status);
+    oskar_mem_free(buf->ww, status);
+    oskar_mem_free(buf->amp, status);
+    oskar_mem_free(buf->weight, status);
+    oskar_mem_free(buf->time_centroid, status);
+    oskar_mem_free(buf->scratch, status);
+}
+
+static void* read_blocks(void* arg)
+{
+    int b, stop;
+    ReadPipeline* p = (ReadPipeline*) arg;
+
+    /* Read block b into one buffer while the previous block is being
+     * gridded from the other. */
+    for (b = 0; b < p->num_blocks; ++b)
+    {
+        oskar_timer_resume(p->h->tmr_read);
+        p->read_block(p->reader, b, &p->buf[b % 2], &p->read_status);
+        oskar_timer_pause(p->h->tmr_read);
+
+        /* Barrier 1: Block b is ready, and block b - 1 has been gridded. */
+        oskar_barrier_wait(p->barrier);
+        stop = p->read_status || *p->status;
+
+        /* Barrier 2: Synchronise before moving to the next block. */
+        oskar_barrier_wait(p->barrier);
+        if (stop) break;
+    }
+    return 0;
+}
+
+static void grid_block(ReadPipeline* p, int b, int i_file, int num_files,
+        int* percent_done, int* percent_next, int* status)
+{
+    const ReadBuffer* buf = &p->buf[b % 2];
+    oskar_imager_update(p->h, buf->num_rows, buf->start_chan, buf->end_chan,
+            buf->num_pols, buf->uu, buf->vv, buf->ww, buf->data, buf->weight,
+            buf->time_centroid, status);
+    *percent_done = (int) round(100.0 * (
+            (b + 1) / (double)(p->num_blocks * num_files) +
+            i_file / (double)num_files));
+    if (percent_next && *percent_done >= *percent_next)
+    {
+        oskar_log_message('S', -2, "%3d%% ...", *percent_done);
+        *percent_next = 10 + 10 * (*percent_done / 10);
+    }
+}
+
+static void run_pipeline(ReadPipeline* p, int i_file, int num_files,
+        int* percent_done, int* percent_next, int* status)
+{
+    int b, stop;
+    oskar_Thread* thread;
+
+    /* Blocks are read by a dedicated thread while the previous block is
+     * gridded by the caller, using double buffering.
+     *
+     * Note that nothing is gridded on the first loop counter (as no
+     * data are ready yet), and the last block is gridded after the
+     * reader thread has finished. */
+    p->status = status;
+    p->barrier = oskar_barrier_create(2);
+    thread = oskar_thread_create(read_blocks, (void*)p, 0);
+    for (b = 0; b < p->num_blocks; ++b)
+    {
+        if (b > 0)
+            grid_block(p, b - 1, i_file, num_files,
+                    percent_done, percent_next, status);
+
+        /* Barrier 1: Wait for the reader. */
+        oskar_barrier_wait(p->barrier);
+        stop = p->read_status || *status;
+
+        /* Barrier 2: Synchronise before moving to the next block. */
+        oskar_barrier_wait(p->barrier);
+        if (stop) break;
+    }
+    oskar_thread_join(thread);
+    oskar_thread_free(thread);
+    oskar_barrier_free(p->barrier);
+    if (!*status) *status = p->read_status;
+    if (!*status && p->num_blocks > 0)
+        grid_block(p, p->num_blocks - 1, i_file, num_files,
+                percent_done, percent_next, status);
+}
+
+#ifndef OSKAR_NO_MS
+struct MsReader
+{
+    const oskar_Imager* h;
+    oskar_MeasurementSet* ms;
+    const char* column;
+    size_t num_rows, num_baselines;
+    int i_file, use_cache, num_channels, num_pols;
+};
+typedef struct MsReader MsReader;
+
+static void read_block_ms(void* arg, int i_block, ReadBuffer* buf,
+        int* status)
+{
+    size_t allocated, required, block_size, start_row, i;
+    double *uvw_, *u_, *v_, *w_;
+    MsReader* r = (MsReader*) arg;
+    if (*status) return;
+
+    /* Read rows from Measurement Set. */
+    start_row = i_block * r->num_baselines;
+    block_size = r->num_rows - start_row;
+    if (block_size > r->num_baselines) block_size = r->num_baselines;
+    allocated = oskar_mem_length(buf->amp) *
+            oskar_mem_element_size(oskar_mem_type(buf->amp));
+    oskar_ms_read_column(r->ms, r->column, start_row, block_size,
+            allocated, oskar_mem_void(buf->amp), &required, status);
+    buf->data = buf->amp;
+    buf->num_rows = block_size;
+    buf->start_chan = 0;
+    buf->end_chan = r->num_channels - 1;
+    buf->num_pols = r->num_pols;
+
+    /* Use the coordinates and weights from the first pass, if cached. */
+    if (r->use_cache)
+    {
+        oskar_imager_coords_cache_get(r->h, r->i_file, start_row, block_size,
+                &buf->uu, &buf->vv, &buf->ww, &buf->weight,
+                &buf->time_centroid, status);
+        return;
+    }
+    allocated = oskar_mem_length(buf->scratch) *
+            oskar_mem_element_size(oskar_mem_type(buf->scratch));
+    oskar_ms_read_column(r->ms, "UVW", start_row, block_size,
+            allocated, oskar_mem_void(buf->scratch), &required, status);
+    allocated = oskar_mem_length(buf->weight) *
+            oskar_mem_element_size(oskar_mem_type(buf->weight));
+    oskar_ms_read_column(r->ms, "WEIGHT", start_row, block_size,
+            allocated, oskar_mem_void(buf->weight), &required, status);
+    allocated = oskar_mem_length(buf->time_centroid) *
+            oskar_mem_element_size(oskar_mem_type(buf->time_centroid));
+    oskar_ms_read_column(r->ms, "TIME_CENTROID", start_row, block_size,
+            allocated, oskar_mem_void(buf->time_centroid), &required, status);
+    if (*status) return;
+
+    /* Split up baseline coordinates. */
+    uvw_ = oskar_mem_double(buf->scratch, status);
+    u_ = oskar_mem_double(buf->uu, status);
+    v_ = oskar_mem_double(buf->vv, status);
+    w_ = oskar_mem_double(buf->ww, status);
+    for (i = 0; i < block_size; ++i)
+    {
+        u_[i] = uvw_[3*i + 0];
+        v_[i] = uvw_[3*i + 1];
+        w_[i] = uvw_[3*i + 2];
+    }
+}
+#endif
 
 void oskar_imager_read_data_ms(oskar_Imager* h, const char* filename,
         int i_file, int num_files, int* percent_done, int* percent_next,
         int* status)
 {
 #ifndef OSKAR_NO_MS
-    oskar_MeasurementSet* ms;
-    oskar_Mem *uvw, *u, *v, *w, *data, *weight, *time_centroid;
-    int type;
-    size_t start_row;
-    double *uvw_, *u_, *v_, *w_;
+    int i, type;
+    MsReader r;
+    ReadPipeline p;
     if (*status) return;
 
     /* Read the header. */
-    ms = oskar_ms_open(filename);
-    if (!ms)
+    memset(&r, 0, sizeof(MsReader));
+    memset(&p, 0, sizeof(ReadPipeline));
+    r.ms = oskar_ms_open(filename);
+    if (!r.ms)
     {
         *status = OSKAR_ERR_FILE_IO;
         return;
     }
-    const size_t num_rows = (size_t) oskar_ms_num_rows(ms);
-    const size_t num_stations = (size_t) oskar_ms_num_stations(ms);
-    const size_t num_baselines = num_stations * (num_stations - 1) / 2;
-    const int num_pols = (int) oskar_ms_num_pols(ms);
-    const int num_channels = (int) oskar_ms_num_channels(ms);
+    const size_t num_stations = (size_t) oskar_ms_num_stations(r.ms);
+    r.h = h;
+    r.i_file = i_file;
+    r.use_cache = oskar_imager_coords_cache_complete(h, i_file);
+    r.column = h->ms_column;
+    r.num_rows = (size_t) oskar_ms_num_rows(r.ms);
+    r.num_baselines = num_stations * (num_stations - 1) / 2;
+    r.num_pols = (int) oskar_ms_num_pols(r.ms);
+    r.num_channels = (int) oskar_ms_num_channels(r.ms);
 
     /* Set visibility meta-data. */
     oskar_imager_set_vis_frequency(h,
-            oskar_ms_freq_start_hz(ms),
-            oskar_ms_freq_inc_hz(ms), num_channels);
+            oskar_ms_freq_start_hz(r.ms),
+            oskar_ms_freq_inc_hz(r.ms), r.num_channels);
     oskar_imager_set_vis_phase_centre(h,
-            oskar_ms_phase_centre_ra_rad(ms) * 180/M_PI,
-            oskar_ms_phase_centre_dec_rad(ms) * 180/M_PI);
-
-    /* Create arrays. */
-    uvw = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, 3 * num_baselines, status);
-    u = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_baselines, status);
-    v = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_baselines, status);
-    w = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_baselines, status);
-    weight = oskar_mem_create(OSKAR_SINGLE, OSKAR_CPU,
-            num_baselines * num_pols, status);
-    time_centroid = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_baselines,
-            status);
-    uvw_ = oskar_mem_double(uvw, status);
-    u_ = oskar_mem_double(u, status);
-    v_ = oskar_mem_double(v, status);
-    w_ = oskar_mem_double(w, status);
-    type = OSKAR_SINGLE | OSKAR_COMPLEX;
-    if (num_pols == 4) type |= OSKAR_MATRIX;
-    data = oskar_mem_create(type, OSKAR_CPU,
-            num_baselines * num_channels, status);
+            oskar_ms_phase_centre_ra_rad(r.ms) * 180/M_PI,
+            oskar_ms_phase_centre_dec_rad(r.ms) * 180/M_PI);
 
-    /* Loop over visibility blocks. */
-    for (start_row = 0; start_row < num_rows; start_row += num_baselines)
+    /* Create a pair of buffers. */
+    type = OSKAR_SINGLE | OSKAR_COMPLEX;
+    if (r.num_pols == 4) type |= OSKAR_MATRIX;
+    for (i = 0; i < 2; ++i)
     {
-        size_t allocated, required, block_size, i;
-        if (*status) break;
-
-        /* Read rows from Measurement Set. */
-        oskar_timer_resume(h->tmr_read);
-        block_size = num_rows - start_row;
-        if (block_size > num_baselines) block_size = num_baselines;
-        allocated = oskar_mem_length(uvw) *
-                oskar_mem_element_size(oskar_mem_type(uvw));
-        oskar_ms_read_column(ms, "UVW", start_row, block_size,
-                allocated, oskar_mem_void(uvw), &required, status);
-        allocated = oskar_mem_length(weight) *
-                oskar_mem_element_size(oskar_mem_type(weight));
-        oskar_ms_read_column(ms, "WEIGHT", start_row, block_size,
-                allocated, oskar_mem_void(weight), &required, status);
-        allocated = oskar_mem_length(time_centroid) *
-                oskar_mem_element_size(oskar_mem_type(time_centroid));
-        oskar_ms_read_column(ms, "TIME_CENTROID", start_row, block_size,
-                allocated, oskar_mem_void(time_centroid), &required, status);
-        allocated = oskar_mem_length(data) *
-                oskar_mem_element_size(oskar_mem_type(data));
-        oskar_ms_read_column(ms, h->ms_column, start_row, block_size,
-                allocated, oskar_mem_void(data), &required, status);
-        if (*status) break;
-
-        /* Split up baseline coordinates. */
-        for (i = 0; i < block_size; ++i)
-        {
-            u_[i] = uvw_[3*i + 0];
-            v_[i] = uvw_[3*i + 1];
-            w_[i] = uvw_[3*i + 2];
-        }
-
-        /* Update the imager with the data. */
-        oskar_timer_pause(h->tmr_read);
-        oskar_imager_update(h, block_size, 0, num_channels - 1,
-                num_pols, u, v, w, data, weight, time_centroid, status);
-        *percent_done = (int) round(100.0 * (
-                (start_row + block_size) / (double)(num_rows * num_files) +
-                i_file / (double)num_files));
-        if (percent_next && *percent_done >= *percent_next)
-        {
-            oskar_log_message('S', -2, "%3d%% ...", *percent_done);
-            *percent_next = 10 + 10 * (*percent_done / 10);
-        }
+        ReadBuffer* buf = &p.buf[i];
+        buf->amp = oskar_mem_create(type, OSKAR_CPU,
+                r.num_baselines * r.num_channels, status);
+        if (r.use_cache) continue;
+        buf->scratch = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+                3 * r.num_baselines, status);
+        buf->uu = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+                r.num_baselines, status);
+        buf->vv = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+                r.num_baselines, status);
+        buf->ww = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+                r.num_baselines, status);
+        buf->weight = oskar_mem_create(OSKAR_SINGLE, OSKAR_CPU,
+                r.num_baselines * r.num_pols, status);
+        buf->time_centroid = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+                r.num_baselines, status);
     }
-    oskar_mem_free(uvw, status);
-    oskar_mem_free(u, status);
-    oskar_mem_free(v, status);
-    oskar_mem_free(w, status);
-    oskar_mem_free(data, status);
-    oskar_mem_free(weight, status);
-    oskar_mem_free(time_centroid, status);
-    oskar_ms_close(ms);
+
+    /* Read and grid the data. */
+    p.h = h;
+    p.read_block = read_block_ms;
+    p.reader = &r;
+    if (r.num_baselines > 0)
+        p.num_blocks = (int) ((r.num_rows + r.num_baselines - 1) /
+                r.num_baselines);
+    if (!*status)
+        run_pipeline(&p, i_file, num_files, percent_done, percent_next,
+                status);
+    for (i = 0; i < 2; ++i)
+        free_buffer(&p.buf[i], status);
+    oskar_ms_close(r.ms);
 #else
+    (void) h;
     (void) filename;
     (void) i_file;
     (void) num_files;
@@ -166,38 +315,154 @@ void oskar_imager_read_data_ms(oskar_Imager* h, const char* filename,
 }
 
 
+struct VisReader
+{
+    const oskar_Imager* h;
+    oskar_Binary* file;
+    int i_file, use_cache;
+    int amp_type, coord_type, tags_per_block, num_baselines, num_pols;
+    size_t cache_row;
+    double time_start_mjd, time_inc_sec;
+};
+typedef struct VisReader VisReader;
+
+static void read_block_vis(void* arg, int i_block, ReadBuffer* buf,
+        int* status)
+{
+    int t, dim_start_size[6];
+    VisReader* r = (VisReader*) arg;
+    if (*status) return;
+
+    /* Release the data previously held in this buffer. */
+    oskar_mem_free(buf->amp, status);
+    oskar_mem_free(buf->uu, status);
+    oskar_mem_free(buf->vv, status);
+    oskar_mem_free(buf->ww, status);
+    buf->amp = buf->uu = buf->vv = buf->ww = 0;
+
+    /* Read the visibility data.
+     * The data are not copied if the file can be memory-mapped. */
+    oskar_binary_set_query_search_start(r->file,
+            i_block * r->tags_per_block, status);
+    oskar_binary_read(r->file, OSKAR_INT, OSKAR_TAG_GROUP_VIS_BLOCK,
+            OSKAR_VIS_BLOCK_TAG_DIM_START_AND_SIZE, i_block,
+            sizeof(dim_start_size), dim_start_size, status);
+    buf->amp = oskar_binary_read_mem_alias(r->file, r->amp_type,
+            OSKAR_TAG_GROUP_VIS_BLOCK,
+            OSKAR_VIS_BLOCK_TAG_CROSS_CORRELATIONS, i_block, status);
+    if (*status) return;
+    const int num_baselines = r->num_baselines;
+    const int num_pols     = r->num_pols;
+    const int start_time   = dim_start_size[0];
+    const int start_chan   = dim_start_size[1];
+    const int num_times    = dim_start_size[2];
+    const int num_channels = dim_start_size[3];
+
+    /* Use the coordinates from the first pass, if cached. */
+    if (r->use_cache)
+    {
+        oskar_imager_coords_cache_get(r->h, r->i_file, r->cache_row,
+                num_times * num_baselines, &buf->uu, &buf->vv, &buf->ww,
+                &buf->weight, &buf->time_centroid, status);
+        r->cache_row += num_times * num_baselines;
+    }
+    else
+    {
+        buf->uu = oskar_binary_read_mem_alias(r->file, r->coord_type,
+                OSKAR_TAG_GROUP_VIS_BLOCK,
+                OSKAR_VIS_BLOCK_TAG_BASELINE_UU, i_block, status);
+        buf->vv = oskar_binary_read_mem_alias(r->file, r->coord_type,
+                OSKAR_TAG_GROUP_VIS_BLOCK,
+                OSKAR_VIS_BLOCK_TAG_BASELINE_VV, i_block, status);
+        buf->ww = oskar_binary_read_mem_alias(r->file, r->coord_type,
+                OSKAR_TAG_GROUP_VIS_BLOCK,
+                OSKAR_VIS_BLOCK_TAG_BASELINE_WW, i_block, status);
+    }
+    if (*status) return;
+
+    /* Fill in the time centroid values. */
+    for (t = 0; t < num_times; ++t)
+        oskar_mem_set_value_real(buf->time_centroid,
+                r->time_start_mjd + (start_time + t + 0.5) * r->time_inc_sec,
+                t * num_baselines, num_baselines, status);
+
+    /* Swap baseline and channel dimensions. */
+    buf->data = buf->amp;
+#define SWAP_LOOP \
+    for (t = 0; t < num_times; ++t)                                      \
+        for (c = 0; c < num_channels; ++c)                               \
+            for (b = 0; b < num_baselines; ++b)                          \
+                for (p = 0; p < num_pols; ++p)                           \
+                {                                                        \
+                    k = (num_pols * (num_baselines *                     \
+                            (num_channels * t + c) + b) + p) << 1;       \
+                    l = (num_pols * (num_channels *                      \
+                            (num_baselines * t + b) + c) + p) << 1;      \
+                    out[l] = in[k];                                      \
+                    out[l + 1] = in[k + 1];                              \
+                }
+    if (num_channels != 1)
+    {
+        int b, c, p;
+        size_t k, l;
+        if (oskar_mem_precision(buf->amp) == OSKAR_SINGLE)
+        {
+            float *in, *out;
+            in  = oskar_mem_float(buf->amp, status);
+            out = oskar_mem_float(buf->scratch, status);
+            SWAP_LOOP
+        }
+        else
+        {
+            double *in, *out;
+            in  = oskar_mem_double(buf->amp, status);
+            out = oskar_mem_double(buf->scratch, status);
+            SWAP_LOOP
+        }
+        buf->data = buf->scratch;
+    }
+#undef SWAP_LOOP
+    buf->num_rows = num_times * num_baselines;
+    buf->start_chan = start_chan;
+    buf->end_chan = start_chan + num_channels - 1;
+    buf->num_pols = num_pols;
+}
+
 void oskar_imager_read_data_vis(oskar_Imager* h, const char* filename,
         int i_file, int num_files, int* percent_done, int* percent_next,
         int* status)
 {
-    oskar_Binary* vis_file;
-    oskar_VisBlock* block;
+    int i;
+    VisReader r;
+    ReadPipeline p;
     oskar_VisHeader* hdr;
-    oskar_Mem *weight, *time_centroid, *scratch = 0, *ptr;
-    int i_block;
-    double time_start_mjd, time_inc_sec;
     if (*status) return;
 
     /* Read the header. */
-    vis_file = oskar_binary_create(filename, 'r', status);
-    hdr = oskar_vis_header_read(vis_file, status);
+    memset(&r, 0, sizeof(VisReader));
+    memset(&p, 0, sizeof(ReadPipeline));
+    r.file = oskar_binary_create(filename, 'r', status);
+    hdr = oskar_vis_header_read(r.file, status);
     if (*status)
     {
         oskar_vis_header_free(hdr, status);
-        oskar_binary_free(vis_file);
+        oskar_binary_free(r.file);
         return;
     }
     const int max_times_per_block = oskar_vis_header_max_times_per_block(hdr);
-    const int tags_per_block = oskar_vis_header_num_tags_per_block(hdr);
     const int num_channels_tot = oskar_vis_header_num_channels_total(hdr);
     const int num_stations = oskar_vis_header_num_stations(hdr);
-    const int num_baselines = num_stations * (num_stations - 1) / 2;
-    const int num_pols =
-            oskar_type_is_matrix(oskar_vis_header_amp_type(hdr)) ? 4 : 1;
-    const int num_weights = num_baselines * num_pols * max_times_per_block;
-    const int num_blocks = oskar_vis_header_num_blocks(hdr);
-    time_start_mjd = oskar_vis_header_time_start_mjd_utc(hdr) * 86400.0;
-    time_inc_sec = oskar_vis_header_time_inc_sec(hdr);
+    r.h = h;
+    r.i_file = i_file;
+    r.use_cache = oskar_imager_coords_cache_complete(h, i_file);
+    r.num_baselines = num_stations * (num_stations - 1) / 2;
+    r.amp_type = oskar_vis_header_amp_type(hdr);
+    r.coord_type = oskar_type_precision(r.amp_type);
+    r.num_pols = oskar_type_is_matrix(r.amp_type) ? 4 : 1;
+    r.tags_per_block = oskar_vis_header_num_tags_per_block(hdr);
+    r.time_start_mjd = oskar_vis_header_time_start_mjd_utc(hdr) * 86400.0;
+    r.time_inc_sec = oskar_vis_header_time_inc_sec(hdr);
+    const int num_weights = r.num_baselines * r.num_pols * max_times_per_block;
 
     /* Set visibility meta-data. */
     oskar_imager_set_vis_frequency(h,
@@ -207,99 +472,33 @@ void oskar_imager_read_data_vis(oskar_Imager* h, const char* filename,
             oskar_vis_header_phase_centre_ra_deg(hdr),
             oskar_vis_header_phase_centre_dec_deg(hdr));
 
-    /* Create scratch arrays. Weights are all 1. */
-    time_centroid = oskar_mem_create(OSKAR_DOUBLE,
-            OSKAR_CPU, num_baselines * max_times_per_block, status);
-    weight = oskar_mem_create(h->imager_prec, OSKAR_CPU, num_weights, status);
-    oskar_mem_set_value_real(weight, 1.0, 0, num_weights, status);
-    if (num_channels_tot > 1)
-        scratch = oskar_mem_create(oskar_vis_header_amp_type(hdr), OSKAR_CPU,
-                num_baselines * num_channels_tot * max_times_per_block, status);
-
-    /* Loop over visibility blocks. */
-    block = oskar_vis_block_create_from_header(OSKAR_CPU, hdr, status);
-    for (i_block = 0; i_block < num_blocks; ++i_block)
+    /* Create a pair of buffers. Weights are all 1. */
+    for (i = 0; i < 2; ++i)
     {
-        int t;
-        if (*status) break;
-
-        /* Read the visibility data. */
-        oskar_timer_resume(h->tmr_read);
-        oskar_binary_set_query_search_start(vis_file,
-                i_block * tags_per_block, status);
-        oskar_vis_block_read(block, hdr, vis_file, i_block, status);
-        const int start_time   = oskar_vis_block_start_time_index(block);
-        const int start_chan   = oskar_vis_block_start_channel_index(block);
-        const int num_times    = oskar_vis_block_num_times(block);
-        const int num_channels = oskar_vis_block_num_channels(block);
-        const int end_chan     = start_chan + num_channels - 1;
-        const size_t num_rows  = num_times * num_baselines;
-
-        /* Fill in the time centroid values. */
-        for (t = 0; t < num_times; ++t)
-            oskar_mem_set_value_real(time_centroid,
-                    time_start_mjd + (start_time + t + 0.5) * time_inc_sec,
-                    t * num_baselines, num_baselines, status);
-
-        /* Swap baseline and channel dimensions. */
-        ptr = oskar_vis_block_cross_correlations(block);
-#define SWAP_LOOP \
-        for (t = 0; t < num_times; ++t)                                  \
-            for (c = 0; c < num_channels; ++c)                           \
-                for (b = 0; b < num_baselines; ++b)                      \
-                    for (p = 0; p < num_pols; ++p)                       \
-                    {                                                    \
-                        k = (num_pols * (num_baselines *                 \
-                                (num_channels * t + c) + b) + p) << 1;   \
-                        l = (num_pols * (num_channels *                  \
-                                (num_baselines * t + b) + c) + p) << 1;  \
-                        out[l] = in[k];                                  \
-                        out[l + 1] = in[k + 1];                          \
-                    }
-        if (num_channels != 1)
-        {
-            int b, c, p;
-            size_t k, l;
-            if (oskar_mem_precision(ptr) == OSKAR_SINGLE)
-            {
-                float *in, *out;
-                in  = oskar_mem_float(ptr, status);
-                out = oskar_mem_float(scratch, status);
-                SWAP_LOOP
-            }
-            else
-            {
-                double *in, *out;
-                in  = oskar_mem_double(ptr, status);
-                out = oskar_mem_double(scratch, status);
-                SWAP_LOOP
-            }
-            ptr = scratch;
-        }
-#undef SWAP_LOOP
-
-        /* Update the imager with the data. */
-        oskar_timer_pause(h->tmr_read);
-        oskar_imager_update(h, num_rows, start_chan, end_chan, num_pols,
-                oskar_vis_block_baseline_uu_metres(block),
-                oskar_vis_block_baseline_vv_metres(block),
-                oskar_vis_block_baseline_ww_metres(block),
-                ptr, weight, time_centroid, status);
-        *percent_done = (int) round(100.0 * (
-                (i_block + 1) / (double)(num_blocks * num_files) +
-                i_file / (double)num_files));
-        if (percent_next && *percent_done >= *percent_next)
-        {
-            oskar_log_message('S', -2, "%3d%% ...", *percent_done);
-            *percent_next = 10 + 10 * (*percent_done / 10);
-        }
+        ReadBuffer* buf = &p.buf[i];
+        buf->time_centroid = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+                r.num_baselines * max_times_per_block, status);
+        buf->weight = oskar_mem_create(h->imager_prec, OSKAR_CPU,
+                num_weights, status);
+        oskar_mem_set_value_real(buf->weight, 1.0, 0, num_weights, status);
+        if (num_channels_tot > 1)
+            buf->scratch = oskar_mem_create(r.amp_type, OSKAR_CPU,
+                    r.num_baselines * num_channels_tot * max_times_per_block,
+                    status);
     }
-    oskar_mem_free(scratch, status);
-    oskar_mem_free(weight, status);
-    oskar_mem_free(time_centroid, status);
-    oskar_vis_block_free(block, status);
+
+    /* Read and grid the visibility blocks. */
+    p.h = h;
+    p.read_block = read_block_vis;
+    p.reader = &r;
+    p.num_blocks = oskar_vis_header_num_blocks(hdr);
+    if (!*status)
+        run_pipeline(&p, i_file, num_files, percent_done, percent_next,
+                status);
+    for (i = 0; i < 2; ++i)
+        free_buffer(&p.buf[i], status);
     oskar_vis_header_free(hdr, status);
-    oskar_binary_free(vis_file);
+    oskar_binary_free(r.file);
 }
 
 #ifdef __cplusplus
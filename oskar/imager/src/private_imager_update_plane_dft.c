@@ -34,6 +34,7 @@
 #include "math/oskar_cmath.h"
 #include "math/oskar_dft_c2r.h"
 #include "utility/oskar_device.h"
+#include "utility/oskar_get_thread_budget.h"
 #include "utility/oskar_thread.h"
 
 #ifdef _OPENMP
@@ -156,9 +157,10 @@ static void* run_blocks(void* arg)
         ww = oskar_mem_create_copy(((ThreadArgs*)arg)->ww, dev_loc, status);
 
 #ifdef _OPENMP
-    /* Disable nested parallelism. */
+    /* Disable any nested parallelism, and share the available OpenMP
+     * threads between the compute devices. */
     omp_set_nested(0);
-    omp_set_num_threads(1);
+    omp_set_num_threads(oskar_get_thread_budget(h->num_devices));
 #endif
 
     /* Calculate the maximum pixel block size, and number of blocks. */
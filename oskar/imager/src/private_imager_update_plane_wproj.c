@@ -33,6 +33,7 @@
 #include "imager/private_imager_update_plane_wproj.h"
 #include "imager/oskar_grid_wproj.h"
 #include "imager/oskar_grid_wproj2.h"
+#include "imager/oskar_grid_wproj2_omp.h"
 #include "math/oskar_prefix_sum.h"
 #include "utility/oskar_device.h"
 
@@ -67,7 +68,7 @@ void oskar_imager_update_plane_wproj(oskar_Imager* h, size_t num_vis,
     {
 #if NEW_VERSION
         if (type == OSKAR_DOUBLE)
-            oskar_grid_wproj2_d(h->num_w_planes,
+            oskar_grid_wproj2_omp_d(h->num_w_planes,
                     oskar_mem_int_const(h->w_support, status),
                     h->oversample,
                     oskar_mem_int_const(h->w_kernel_start, status),
@@ -78,10 +79,10 @@ void oskar_imager_update_plane_wproj(oskar_Imager* h, size_t num_vis,
                     oskar_mem_double_const(amps, status),
                     oskar_mem_double_const(weight, status),
                     h->cellsize_rad, h->w_scale,
-                    grid_size, num_skipped, plane_norm,
-                    oskar_mem_double(plane, status));
+                    grid_size, h->num_threads, num_skipped, plane_norm,
+                    oskar_mem_double(plane, status), status);
         else
-            oskar_grid_wproj2_f(h->num_w_planes,
+            oskar_grid_wproj2_omp_f(h->num_w_planes,
                     oskar_mem_int_const(h->w_support, status),
                     h->oversample,
                     oskar_mem_int_const(h->w_kernel_start, status),
@@ -92,8 +93,8 @@ void oskar_imager_update_plane_wproj(oskar_Imager* h, size_t num_vis,
                     oskar_mem_float_const(amps, status),
                     oskar_mem_float_const(weight, status),
                     h->cellsize_rad, h->w_scale,
-                    grid_size, num_skipped, plane_norm,
-                    oskar_mem_float(plane, status));
+                    grid_size, h->num_threads, num_skipped, plane_norm,
+                    oskar_mem_float(plane, status), status);
 #else
         if (type == OSKAR_DOUBLE)
             oskar_grid_wproj_d(h->num_w_planes,
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+#include "imager/oskar_grid_wproj2.h"
+#include "imager/oskar_grid_wproj2_omp.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+template<typename FP>
+static void run_grid_wproj2_test(
+        void (*grid_serial)(const size_t, const int*, const int, const int*,
+                const FP*, const size_t, const FP*, const FP*, const FP*,
+                const FP*, const FP*, const FP, const FP, const int,
+                size_t*, double*, FP*),
+        void (*grid_omp)(const size_t, const int*, const int, const int*,
+                const FP*, const size_t, const FP*, const FP*, const FP*,
+                const FP*, const FP*, const FP, const FP, const int,
+                const int, size_t*, double*, FP*, int*))
+{
+    const int grid_size = 512, oversample = 4, num_points = 20000;
+    const int num_w_planes = 3;
+    const FP cell_size_rad = (FP) 1e-4, w_scale = (FP) 0.05;
+    int support[num_w_planes] = {3, 6, 9}, wkernel_start[num_w_planes];
+
+    // Generate random convolution kernels with the expected layout.
+    int kernel_size = 0;
+    for (int i = 0; i < num_w_planes; ++i)
+    {
+        const int conv_len = 2 * support[i] + 1;
+        wkernel_start[i] = kernel_size;
+        kernel_size += (oversample / 2 + 1) *
+                (oversample / 2 * conv_len + 1) * conv_len;
+    }
+    srand(1);
+    std::vector<FP> wkernel(2 * kernel_size);
+    for (int i = 0; i < 2 * kernel_size; ++i)
+        wkernel[i] = (FP) rand() / RAND_MAX - (FP) 0.5;
+
+    // Generate random visibility data, some of which lies off the grid.
+    std::vector<FP> uu(num_points), vv(num_points), ww(num_points);
+    std::vector<FP> vis(2 * num_points), weight(num_points);
+    const FP uv_max = (FP) 0.55 / cell_size_rad;
+    for (int i = 0; i < num_points; ++i)
+    {
+        uu[i] = uv_max * ((FP) 2 * rand() / RAND_MAX - (FP) 1);
+        vv[i] = uv_max * ((FP) 2 * rand() / RAND_MAX - (FP) 1);
+        ww[i] = (FP) 2000 * ((FP) rand() / RAND_MAX - (FP) 0.5);
+        vis[2 * i]     = (FP) rand() / RAND_MAX;
+        vis[2 * i + 1] = (FP) rand() / RAND_MAX;
+        weight[i] = (FP) rand() / RAND_MAX;
+    }
+
+    // Grid using the serial and multi-threaded versions.
+    const size_t num_cells = 2 * (size_t) grid_size * grid_size;
+    std::vector<FP> grid_serial_data(num_cells, (FP) 0);
+    std::vector<FP> grid_omp_data(num_cells, (FP) 0);
+    size_t num_skipped_serial = 0, num_skipped_omp = 0;
+    int status = 0;
+    double norm_serial = 0.0, norm_omp = 0.0;
+    grid_serial(num_w_planes, support, oversample, wkernel_start,
+            &wkernel[0], num_points, &uu[0], &vv[0], &ww[0], &vis[0],
+            &weight[0], cell_size_rad, w_scale, grid_size,
+            &num_skipped_serial, &norm_serial, &grid_serial_data[0]);
+    grid_omp(num_w_planes, support, oversample, wkernel_start,
+            &wkernel[0], num_points, &uu[0], &vv[0], &ww[0], &vis[0],
+            &weight[0], cell_size_rad, w_scale, grid_size, 4,
+            &num_skipped_omp, &norm_omp, &grid_omp_data[0], &status);
+
+    // Check results are identical.
+    ASSERT_EQ(0, status);
+    EXPECT_GT(num_skipped_serial, 0u);
+    EXPECT_LT(num_skipped_serial, (size_t) num_points);
+    EXPECT_EQ(num_skipped_serial, num_skipped_omp);
+    EXPECT_EQ(0, memcmp(&norm_serial, &norm_omp, sizeof(double)));
+    EXPECT_EQ(0, memcmp(&grid_serial_data[0], &grid_omp_data[0],
+            num_cells * sizeof(FP)));
+}
+
+TEST(grid_wproj2, omp_matches_serial_double)
+{
+    run_grid_wproj2_test<double>(oskar_grid_wproj2_d, oskar_grid_wproj2_omp_d);
+}
+
+TEST(grid_wproj2, omp_matches_serial_single)
+{
+    run_grid_wproj2_test<float>(oskar_grid_wproj2_f, oskar_grid_wproj2_omp_f);
+}
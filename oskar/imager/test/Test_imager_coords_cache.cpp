@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "binary/oskar_binary.h"
+#include "convert/oskar_convert_date_time_to_mjd.h"
+#include "imager/oskar_imager.h"
+#include "imager/private_imager_coords_cache.h"
+#include "utility/oskar_get_error_string.h"
+#include "vis/oskar_vis_block.h"
+#include "vis/oskar_vis_header.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+static oskar_Imager* create_imager(double cache_mb, int* status)
+{
+    const char* files[] = {"temp_a.vis", "temp_b.vis"};
+    oskar_Imager* h = oskar_imager_create(OSKAR_DOUBLE, status);
+    oskar_imager_set_input_files(h, 2, files, status);
+    oskar_imager_set_coords_cache_size(h, cache_mb);
+    return h;
+}
+
+// Fills the arrays with values that depend on the row index.
+// (This assumes two polarisations per row for the weights.)
+static void fill_coords(oskar_Mem* uu, oskar_Mem* vv, oskar_Mem* ww,
+        oskar_Mem* weight, size_t start, int* status)
+{
+    double *u_ = oskar_mem_double(uu, status);
+    double *v_ = oskar_mem_double(vv, status);
+    double *w_ = oskar_mem_double(ww, status);
+    double *wt = oskar_mem_double(weight, status);
+    for (size_t i = 0; i < oskar_mem_length(uu); ++i)
+    {
+        u_[i] = (double)(start + i) + 0.1;
+        v_[i] = (double)(start + i) + 0.2;
+        w_[i] = (double)(start + i) + 0.3;
+    }
+    for (size_t i = 0; i < oskar_mem_length(weight); ++i)
+        wt[i] = (double)(2 * start + i) + 0.4;
+}
+
+TEST(imager_coords_cache, complete)
+{
+    int status = 0;
+    const size_t total_rows = 100, rows_per_block = 40;
+    const int num_pols = 2;
+    oskar_Imager* h = create_imager(1.0, &status);
+    oskar_Mem *uu, *vv, *ww, *weight;
+    uu = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, 0, &status);
+    vv = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, 0, &status);
+    ww = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, 0, &status);
+    weight = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, 0, &status);
+
+    // Append the rows of the second file in blocks.
+    for (size_t start = 0; start < total_rows; start += rows_per_block)
+    {
+        const size_t num_rows = (total_rows - start < rows_per_block) ?
+                total_rows - start : rows_per_block;
+        EXPECT_FALSE(oskar_imager_coords_cache_complete(h, 1));
+        oskar_mem_realloc(uu, num_rows, &status);
+        oskar_mem_realloc(vv, num_rows, &status);
+        oskar_mem_realloc(ww, num_rows, &status);
+        oskar_mem_realloc(weight, num_rows * num_pols, &status);
+        fill_coords(uu, vv, ww, weight, start, &status);
+        oskar_imager_coords_cache_append(h, 1, total_rows, num_rows,
+                num_pols, uu, vv, ww, weight, 0, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    }
+    EXPECT_TRUE(oskar_imager_coords_cache_complete(h, 1));
+    EXPECT_FALSE(oskar_imager_coords_cache_complete(h, 0));
+
+    // Get aliases to a range of rows and check the contents.
+    oskar_imager_coords_cache_get(h, 1, 30, 50,
+            &uu, &vv, &ww, &weight, 0, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    ASSERT_EQ(50u, oskar_mem_length(uu));
+    ASSERT_EQ(100u, oskar_mem_length(weight));
+    const double *u_ = oskar_mem_double_const(uu, &status);
+    const double *v_ = oskar_mem_double_const(vv, &status);
+    const double *w_ = oskar_mem_double_const(ww, &status);
+    const double *wt = oskar_mem_double_const(weight, &status);
+    for (size_t i = 0; i < 50; ++i)
+    {
+        EXPECT_DOUBLE_EQ((double)(30 + i) + 0.1, u_[i]);
+        EXPECT_DOUBLE_EQ((double)(30 + i) + 0.2, v_[i]);
+        EXPECT_DOUBLE_EQ((double)(30 + i) + 0.3, w_[i]);
+    }
+    for (size_t i = 0; i < 100; ++i)
+        EXPECT_DOUBLE_EQ((double)(30 * num_pols + i) + 0.4, wt[i]);
+
+    // Requests beyond the end of the file must fail.
+    oskar_imager_coords_cache_get(h, 1, 80, 40,
+            &uu, &vv, &ww, &weight, 0, &status);
+    EXPECT_EQ((int) OSKAR_ERR_OUT_OF_RANGE, status);
+    status = 0;
+
+    oskar_mem_free(uu, &status);
+    oskar_mem_free(vv, &status);
+    oskar_mem_free(ww, &status);
+    oskar_mem_free(weight, &status);
+    oskar_imager_free(h, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
+
+TEST(imager_coords_cache, size_limit)
+{
+    int status = 0;
+    const size_t num_rows = 1000;
+
+    // 1000 rows of (u, v, w) in double precision need 24000 bytes.
+    oskar_Imager* h = create_imager(20000.0 / (1024.0 * 1024.0), &status);
+    oskar_Mem *uu, *vv, *ww, *weight;
+    uu = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_rows, &status);
+    vv = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_rows, &status);
+    ww = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_rows, &status);
+    weight = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, 0, &status);
+    fill_coords(uu, vv, ww, weight, 0, &status);
+    oskar_imager_coords_cache_append(h, 0, num_rows, num_rows, 1,
+            uu, vv, ww, 0, 0, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_FALSE(oskar_imager_coords_cache_complete(h, 0));
+
+    // A file that fits is still cached.
+    oskar_mem_realloc(uu, num_rows / 2, &status);
+    oskar_mem_realloc(vv, num_rows / 2, &status);
+    oskar_mem_realloc(ww, num_rows / 2, &status);
+    oskar_imager_coords_cache_append(h, 1, num_rows / 2, num_rows / 2, 1,
+            uu, vv, ww, 0, 0, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_TRUE(oskar_imager_coords_cache_complete(h, 1));
+
+    // A cache size of zero disables the cache.
+    oskar_imager_free(h, &status);
+    h = create_imager(0.0, &status);
+    oskar_imager_coords_cache_append(h, 1, num_rows / 2, num_rows / 2, 1,
+            uu, vv, ww, 0, 0, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_FALSE(oskar_imager_coords_cache_complete(h, 1));
+
+    oskar_mem_free(uu, &status);
+    oskar_mem_free(vv, &status);
+    oskar_mem_free(ww, &status);
+    oskar_mem_free(weight, &status);
+    oskar_imager_free(h, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
+
+TEST(imager_coords_cache, too_many_rows)
+{
+    int status = 0;
+    const size_t num_rows = 60;
+    oskar_Imager* h = create_imager(1.0, &status);
+    oskar_Mem *uu, *vv, *ww, *weight;
+    uu = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_rows, &status);
+    vv = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_rows, &status);
+    ww = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_rows, &status);
+    weight = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, 0, &status);
+    fill_coords(uu, vv, ww, weight, 0, &status);
+
+    // Expect 100 rows, but supply 120.
+    oskar_imager_coords_cache_append(h, 0, 100, num_rows, 1,
+            uu, vv, ww, 0, 0, &status);
+    oskar_imager_coords_cache_append(h, 0, 100, num_rows, 1,
+            uu, vv, ww, 0, 0, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_FALSE(oskar_imager_coords_cache_complete(h, 0));
+
+    // The file must stay uncached, even if appended to again.
+    oskar_imager_coords_cache_append(h, 0, 100, 40, 1,
+            uu, vv, ww, 0, 0, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_FALSE(oskar_imager_coords_cache_complete(h, 0));
+    oskar_imager_coords_cache_get(h, 0, 0, 10,
+            &uu, &vv, &ww, 0, 0, &status);
+    EXPECT_EQ((int) OSKAR_ERR_MEMORY_NOT_ALLOCATED, status);
+    status = 0;
+
+    oskar_mem_free(uu, &status);
+    oskar_mem_free(vv, &status);
+    oskar_mem_free(ww, &status);
+    oskar_mem_free(weight, &status);
+    oskar_imager_free(h, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
+
+static void write_test_vis(const char* filename, int* status)
+{
+    const int num_stations = 12, num_times = 7, num_channels = 2;
+    const int max_times_per_block = 3;
+    const int num_baselines = num_stations * (num_stations - 1) / 2;
+    oskar_VisHeader* hdr = oskar_vis_header_create(
+            OSKAR_DOUBLE_COMPLEX_MATRIX, OSKAR_DOUBLE, max_times_per_block,
+            num_times, num_channels, num_channels, num_stations, 0, 1,
+            status);
+    oskar_vis_header_set_phase_centre(hdr, 0, 20.0, -30.0);
+    oskar_vis_header_set_freq_start_hz(hdr, 100e6);
+    oskar_vis_header_set_freq_inc_hz(hdr, 1e6);
+    oskar_vis_header_set_time_start_mjd_utc(hdr,
+            oskar_convert_date_time_to_mjd(2019, 1, 1, 0.0));
+    oskar_vis_header_set_time_inc_sec(hdr, 60.0);
+    oskar_VisBlock* blk = oskar_vis_block_create_from_header(OSKAR_CPU,
+            hdr, status);
+    oskar_Binary* file = oskar_vis_header_write(hdr, filename, status);
+    for (int b = 0, t0 = 0; t0 < num_times; ++b, t0 += max_times_per_block)
+    {
+        const int block_times = (num_times - t0 < max_times_per_block) ?
+                num_times - t0 : max_times_per_block;
+        oskar_vis_block_set_start_time_index(blk, t0);
+        oskar_vis_block_set_num_times(blk, block_times, status);
+        double* uu = oskar_mem_double(
+                oskar_vis_block_baseline_uu_metres(blk), status);
+        double* vv = oskar_mem_double(
+                oskar_vis_block_baseline_vv_metres(blk), status);
+        double* ww = oskar_mem_double(
+                oskar_vis_block_baseline_ww_metres(blk), status);
+        double4c* v = oskar_mem_double4c(
+                oskar_vis_block_cross_correlations(blk), status);
+        for (int i = 0; i < block_times * num_baselines; ++i)
+        {
+            uu[i] = 400.0 * (rand() / (double)RAND_MAX - 0.5);
+            vv[i] = 400.0 * (rand() / (double)RAND_MAX - 0.5);
+            ww[i] = 40.0 * (rand() / (double)RAND_MAX - 0.5);
+        }
+        for (int i = 0; i < block_times * num_channels * num_baselines; ++i)
+        {
+            v[i].a.x = v[i].d.x = rand() / (double)RAND_MAX;
+            v[i].a.y = v[i].d.y = rand() / (double)RAND_MAX - 0.5;
+            v[i].b.x = v[i].b.y = v[i].c.x = v[i].c.y = 0.0;
+        }
+        oskar_vis_block_write(blk, file, b, status);
+    }
+    oskar_binary_free(file);
+    oskar_vis_block_free(blk, status);
+    oskar_vis_header_free(hdr, status);
+}
+
+static oskar_Mem* make_image(const char* const* files, double cache_mb,
+        const char* algorithm, int* status)
+{
+    oskar_Mem* image = 0;
+    oskar_Imager* h = oskar_imager_create(OSKAR_DOUBLE, status);
+    oskar_imager_set_input_files(h, 2, files, status);
+    oskar_imager_set_coords_cache_size(h, cache_mb);
+    oskar_imager_set_algorithm(h, algorithm, status);
+    oskar_imager_set_weighting(h, "Uniform", status);
+    oskar_imager_set_fov(h, 4.0);
+    oskar_imager_set_size(h, 64, status);
+    oskar_imager_run(h, 1, &image, 0, 0, status);
+    oskar_imager_free(h, status);
+    return image;
+}
+
+TEST(imager_coords_cache, image_unchanged)
+{
+    int status = 0;
+    const char* files[] = {"temp_test_coords_cache_a.vis",
+            "temp_test_coords_cache_b.vis"};
+    const char* algorithms[] = {"FFT", "W-projection"};
+    srand(1);
+    write_test_vis(files[0], &status);
+    write_test_vis(files[1], &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    for (int a = 0; a < 2; ++a)
+    {
+        oskar_Mem* image_cached = make_image(files, 1024.0,
+                algorithms[a], &status);
+        oskar_Mem* image = make_image(files, 0.0, algorithms[a], &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        ASSERT_EQ(oskar_mem_length(image), oskar_mem_length(image_cached));
+        const double* p1 = oskar_mem_double_const(image, &status);
+        const double* p2 = oskar_mem_double_const(image_cached, &status);
+        double max_abs = 0.0;
+        for (size_t i = 0; i < oskar_mem_length(image); ++i)
+        {
+            EXPECT_EQ(p1[i], p2[i]) << algorithms[a] << " pixel " << i;
+            if (fabs(p1[i]) > max_abs) max_abs = fabs(p1[i]);
+        }
+        EXPECT_GT(max_abs, 0.0);
+        oskar_mem_free(image, &status);
+        oskar_mem_free(image_cached, &status);
+    }
+    remove(files[0]);
+    remove(files[1]);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
@@ -10,7 +10,7 @@
         const int        offset_out,\
         GLOBAL_OUT(FP4c, jones))\
 {\
-    KERNEL_LOOP_X(int, i, 0, num_sources)\
+    KERNEL_LOOP_PAR_SIMD_X(int, i, 0, num_sources)\
     FP cos_ha, sin_ha, cos_dec, sin_dec, cos_par_ang, sin_par_ang;\
     FP4c J;\
     const FP ha = lst_rad - ra_rad[i];\
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2014, The University of Oxford
+ * Copyright (c) 2013-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -43,22 +43,31 @@
  * Jones matrices (Z Jones).
  *
  * @details
+ * The pierce point and TEC arrays are cached on the host for all stations
+ * and sources, with the source dimension varying fastest, so that they can
+ * be reused for every frequency channel at the same time.
  */
 struct oskar_WorkJonesZ
 {
-    oskar_Mem* hor_x;        /* Pierce point horizontal x coordinate */
-    oskar_Mem* hor_y;        /* Pierce point horizontal y coordinate */
-    oskar_Mem* hor_z;        /* Pierce point horizontal z coordinate */
+    int num_stations;        /* Number of stations in the cache. */
+    int num_sources;         /* Number of sources in the cache. */
+
+    oskar_Mem* ra;           /* Source Right Ascension, in radians */
+    oskar_Mem* dec;          /* Source Declination, in radians */
+    oskar_Mem* temp;         /* Single precision staging buffer */
 
     oskar_Mem* pp_lon;       /* Pierce point longitude, in radians */
     oskar_Mem* pp_lat;       /* Pierce point latitude, in radians */
     oskar_Mem* pp_rel_path;  /* Pierce point relative path length.
                                 (the extra path, relative to the vertical for
                                 the ionospheric column defined by the pierce
-                                point) */
+                                point; zero below the minimum elevation) */
+
+    oskar_Mem* screen_lon;   /* TEC screen profile as a function of longitude */
+    oskar_Mem* screen_lat;   /* TEC screen profile as a function of latitude */
+    oskar_Mem* total_TEC;    /* Total TEC values for each pierce point */
 
-    oskar_Mem* screen_TEC;    /* TEC screen values for each pierce point */
-    oskar_Mem* total_TEC;     /* Total TEC values for each pierce point */
+    oskar_Mem* jones_cpu;    /* Host copy of Jones Z, if not in CPU memory */
 };
 
 typedef struct oskar_WorkJonesZ oskar_WorkJonesZ;
@@ -69,9 +78,25 @@ typedef struct oskar_WorkJonesZ oskar_WorkJonesZ;
 extern "C" {
 #endif
 
+/**
+ * @brief
+ * Creates the work buffers for Jones Z.
+ *
+ * @param[in] type         Precision of the Jones matrices (and sky model).
+ * @param[in] location     Memory location of the Jones matrices.
+ * @param[in,out] status   Status return code.
+ */
 OSKAR_EXPORT
 oskar_WorkJonesZ* oskar_work_jones_z_create(int type, int location, int* status);
 
+/**
+ * @brief
+ * Ensures the work buffers can hold the given number of pierce points.
+ *
+ * @param[in] work         Pointer to work buffers.
+ * @param[in] n            Number of pierce points (stations times sources).
+ * @param[in,out] status   Status return code.
+ */
 OSKAR_EXPORT
 void oskar_work_jones_z_resize(oskar_WorkJonesZ* work, int n, int* status);
 
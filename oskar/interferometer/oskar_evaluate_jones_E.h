@@ -51,7 +51,9 @@ extern "C" {
  * positions, storing the results in the Jones matrix data structure.
  *
  * If all stations are marked as identical, the results for the first station
- * are copied into the results for the others.
+ * are copied into the results for the others. If, in this case, \p E
+ * has been sized to hold only one station, the beam is evaluated only once
+ * and shared by all stations (see oskar_jones_join()).
  *
  * @param[out] E            Output set of Jones matrices.
  * @param[in]  num_points   Number of direction cosines given.
@@ -57,6 +57,10 @@ extern "C" {
  * ( cos(q)  -sin(q) )
  * ( sin(q)   cos(q) )
  *
+ * If station beam duplication is allowed by the telescope model,
+ * \p R may be sized to hold only one station, in which case the matrices
+ * are shared by all stations (see oskar_jones_join()).
+ *
  * @param[out] R          Output set of Jones matrices.
  * @param[in] num_sources Number of sources to use from coordinate arrays.
  * @param[in] ra_rad      Input Right Ascension values, in radians.
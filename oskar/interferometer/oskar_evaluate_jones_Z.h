@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013, The University of Oxford
+ * Copyright (c) 2013-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -36,7 +36,6 @@
 #include <oskar_global.h>
 #include <interferometer/oskar_jones.h>
 #include <telescope/oskar_telescope.h>
-#include <sky/oskar_sky.h>
 #include <interferometer/oskar_WorkJonesZ.h>
 #include <settings/old/oskar_Settings_old.h>
 
@@ -44,11 +43,58 @@
 extern "C" {
 #endif
 
+/**
+ * @brief
+ * Evaluates ionospheric TEC at the pierce points of all stations.
+ *
+ * @details
+ * This function evaluates the pierce points of every station through the
+ * TID screen in the direction of every source, and the total electron
+ * content (TEC) at each of them. The results are cached in the work
+ * buffers, as they depend only on time, so that oskar_evaluate_jones_Z()
+ * can be called for each frequency channel without repeating the work.
+ *
+ * Each TID component varies separately with pierce point longitude and
+ * latitude, so the screen is tabulated as two one-dimensional profiles
+ * spanning the range of the pierce points, and the TEC at each pierce
+ * point is obtained from them by linear interpolation. If the profiles
+ * would need more samples than there are pierce points, the screen is
+ * evaluated directly instead.
+ *
+ * The pierce points and TEC are evaluated on the host in parallel.
+ * Pierce points below the minimum elevation are given a TEC of zero.
+ *
+ * @param[in,out] work     Work buffers, holding the cached TEC values.
+ * @param[in] num_sources  Number of sources.
+ * @param[in] ra_rad       Source Right Ascension values, in radians.
+ * @param[in] dec_rad      Source Declination values, in radians.
+ * @param[in] telescope    Telescope model.
+ * @param[in] settings     Ionosphere settings (a single TID screen).
+ * @param[in] gast         Greenwich apparent sidereal time, in radians.
+ * @param[in,out] status   Status return code.
+ */
 OSKAR_EXPORT
-void oskar_evaluate_jones_Z(oskar_Jones* Z, const oskar_Sky* sky,
+void oskar_evaluate_jones_Z_tec(oskar_WorkJonesZ* work, int num_sources,
+        const oskar_Mem* ra_rad, const oskar_Mem* dec_rad,
         const oskar_Telescope* telescope,
-        const oskar_SettingsIonosphere* settings, double gast,
-        double frequency_hz, oskar_WorkJonesZ* work, int* status);
+        const oskar_SettingsIonosphere* settings, double gast, int* status);
+
+/**
+ * @brief
+ * Evaluates ionospheric phase (Jones Z) at the given frequency.
+ *
+ * @details
+ * This function fills the scalar Jones Z matrices from the TEC values
+ * cached by the last call to oskar_evaluate_jones_Z_tec().
+ *
+ * @param[out] Z            Jones Z, sized for all stations and sources.
+ * @param[in,out] work      Work buffers, holding the cached TEC values.
+ * @param[in] frequency_hz  Observing frequency, in Hz.
+ * @param[in,out] status    Status return code.
+ */
+OSKAR_EXPORT
+void oskar_evaluate_jones_Z(oskar_Jones* Z, oskar_WorkJonesZ* work,
+        double frequency_hz, int* status);
 
 #ifdef __cplusplus
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2012-2017, The University of Oxford
+ * Copyright (c) 2012-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -113,6 +113,15 @@ OSKAR_EXPORT
 void oskar_interferometer_set_ignore_w_components(oskar_Interferometer* h,
         int value);
 
+OSKAR_EXPORT
+void oskar_interferometer_set_ionosphere(oskar_Interferometer* h,
+        const char* tid_file, double TEC0, double min_elevation_rad,
+        int* status);
+
+OSKAR_EXPORT
+void oskar_interferometer_set_max_channels_per_beam(oskar_Interferometer* h,
+        int value);
+
 OSKAR_EXPORT
 void oskar_interferometer_set_max_sources_per_chunk(oskar_Interferometer* h,
         int value);
@@ -124,6 +133,10 @@ void oskar_interferometer_set_max_times_per_block(oskar_Interferometer* h,
 OSKAR_EXPORT
 void oskar_interferometer_set_num_devices(oskar_Interferometer* h, int value);
 
+OSKAR_EXPORT
+void oskar_interferometer_set_num_threads_per_device(oskar_Interferometer* h,
+        int value);
+
 OSKAR_EXPORT
 void oskar_interferometer_set_observation_frequency(oskar_Interferometer* h,
         double start_hz, double inc_hz, int num_channels);
@@ -148,6 +161,10 @@ OSKAR_EXPORT
 void oskar_interferometer_set_sky_model(oskar_Interferometer* h,
         const oskar_Sky* sky, int* status);
 
+OSKAR_EXPORT
+void oskar_interferometer_set_sky_model_file(oskar_Interferometer* h,
+        const char* filename, int* status);
+
 OSKAR_EXPORT
 void oskar_interferometer_set_telescope_model(oskar_Interferometer* h,
         const oskar_Telescope* model, int* status);
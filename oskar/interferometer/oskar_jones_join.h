@@ -54,6 +54,9 @@ extern "C" {
  * The input dimensions (number of sources, number of stations) must be the
  * same for J3, J1 and J2, and the data type (single precision or double
  * precision) must also be consistent.
+ * The only exception is that J1 or J2 may contain only a single station,
+ * in which case the same matrices are used for all stations in J3.
+ * This allows a station beam shared by identical stations to be stored once.
  *
  * The element size of J3 should be greater than or equal to the element
  * size of J2. For example, J3 could be a full 2x2 complex matrix and J2 a
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, The University of Oxford
+ * Copyright (c) 2013-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -29,6 +29,8 @@
 #include "interferometer/oskar_WorkJonesZ.h"
 #include "mem/oskar_mem.h"
 
+#include <stdlib.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -41,16 +43,21 @@ oskar_WorkJonesZ* oskar_work_jones_z_create(int type, int location, int* status)
     if (!(type == OSKAR_SINGLE || type == OSKAR_DOUBLE))
         *status = OSKAR_ERR_BAD_DATA_TYPE;
 
-    work = (oskar_WorkJonesZ*) malloc(sizeof(oskar_WorkJonesZ));
+    work = (oskar_WorkJonesZ*) calloc(1, sizeof(oskar_WorkJonesZ));
 
-    work->hor_x = oskar_mem_create(type, location, 0, status);
-    work->hor_y = oskar_mem_create(type, location, 0, status);
-    work->hor_z = oskar_mem_create(type, location, 0, status);
-    work->pp_lon = oskar_mem_create(type, location, 0, status);
-    work->pp_lat = oskar_mem_create(type, location, 0, status);
-    work->pp_rel_path = oskar_mem_create(type, location, 0, status);
-    work->screen_TEC = oskar_mem_create(type, location, 0, status);
-    work->total_TEC = oskar_mem_create(type, location, 0, status);
+    /* The pierce point cache is always held on the host. */
+    work->ra = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, 0, status);
+    work->dec = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, 0, status);
+    work->temp = oskar_mem_create(OSKAR_SINGLE, OSKAR_CPU, 0, status);
+    work->pp_lon = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, 0, status);
+    work->pp_lat = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, 0, status);
+    work->pp_rel_path = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, 0, status);
+    work->screen_lon = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, 0, status);
+    work->screen_lat = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, 0, status);
+    work->total_TEC = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, 0, status);
+    if (location != OSKAR_CPU)
+        work->jones_cpu = oskar_mem_create(type | OSKAR_COMPLEX,
+                OSKAR_CPU, 0, status);
 
     return work;
 }
@@ -58,27 +65,28 @@ oskar_WorkJonesZ* oskar_work_jones_z_create(int type, int location, int* status)
 
 void oskar_work_jones_z_free(oskar_WorkJonesZ* work, int* status)
 {
-    oskar_mem_free(work->hor_x, status);
-    oskar_mem_free(work->hor_y, status);
-    oskar_mem_free(work->hor_z, status);
+    if (!work) return;
+    oskar_mem_free(work->ra, status);
+    oskar_mem_free(work->dec, status);
+    oskar_mem_free(work->temp, status);
     oskar_mem_free(work->pp_lon, status);
     oskar_mem_free(work->pp_lat, status);
     oskar_mem_free(work->pp_rel_path, status);
-    oskar_mem_free(work->screen_TEC, status);
+    oskar_mem_free(work->screen_lon, status);
+    oskar_mem_free(work->screen_lat, status);
     oskar_mem_free(work->total_TEC, status);
+    oskar_mem_free(work->jones_cpu, status);
     free(work);
 }
 
 void oskar_work_jones_z_resize(oskar_WorkJonesZ* work, int n, int* status)
 {
-    oskar_mem_realloc(work->hor_x, n, status);
-    oskar_mem_realloc(work->hor_y, n, status);
-    oskar_mem_realloc(work->hor_z, n, status);
-    oskar_mem_realloc(work->pp_lon, n, status);
-    oskar_mem_realloc(work->pp_lat, n, status);
-    oskar_mem_realloc(work->pp_rel_path, n, status);
-    oskar_mem_realloc(work->screen_TEC, n, status);
-    oskar_mem_realloc(work->total_TEC, n, status);
+    oskar_mem_ensure(work->pp_lon, n, status);
+    oskar_mem_ensure(work->pp_lat, n, status);
+    oskar_mem_ensure(work->pp_rel_path, n, status);
+    oskar_mem_ensure(work->total_TEC, n, status);
+    if (work->jones_cpu)
+        oskar_mem_ensure(work->jones_cpu, n, status);
 }
 
 
@@ -48,24 +48,27 @@ void oskar_evaluate_jones_E(oskar_Jones* E, int num_points, int coord_type,
         *status = OSKAR_ERR_MEMORY_NOT_ALLOCATED;
         return;
     }
-    if (num_stations != oskar_jones_num_stations(E))
+    const int shared = oskar_telescope_allow_station_beam_duplication(tel) &&
+            oskar_telescope_identical_stations(tel);
+    const int num_stations_E = oskar_jones_num_stations(E);
+    if (num_stations != num_stations_E && !(shared && num_stations_E == 1))
     {
         *status = OSKAR_ERR_DIMENSION_MISMATCH;
         return;
     }
 
     /* Evaluate the station beams. */
-    if (oskar_telescope_allow_station_beam_duplication(tel) &&
-            oskar_telescope_identical_stations(tel))
+    if (shared)
     {
-        /* Identical stations: Evaluate beam for station 0 and copy it. */
+        /* Identical stations: Evaluate beam for station 0,
+         * and copy it only if E is not shared by all stations. */
         oskar_evaluate_station_beam(num_points, coord_type, x, y, z,
                 oskar_telescope_phase_centre_ra_rad(tel),
                 oskar_telescope_phase_centre_dec_rad(tel),
                 oskar_telescope_station_const(tel, 0),
                 work, time_index, frequency_hz, gast,
                 0, oskar_jones_mem(E), status);
-        for (i = 1; i < num_stations; ++i)
+        for (i = 1; i < num_stations_E; ++i)
             oskar_mem_copy_contents(
                     oskar_jones_mem(E), oskar_jones_mem(E),
                     (size_t)(i * num_sources), 0,
@@ -51,12 +51,13 @@ void oskar_evaluate_jones_R(oskar_Jones* R, int num_sources,
     const int location = oskar_jones_mem_location(R);
     const int num_stations = oskar_jones_num_stations(R);
     const int stride = oskar_jones_num_sources(R);
-    const int n = (oskar_telescope_allow_station_beam_duplication(telescope) ?
-            1 : num_stations);
+    const int shared = oskar_telescope_allow_station_beam_duplication(telescope);
+    const int n = shared ? 1 : num_stations;
     if (num_sources > (int)oskar_mem_length(ra_rad) ||
             num_sources > (int)oskar_mem_length(dec_rad) ||
             num_sources > oskar_jones_num_sources(R) ||
-            num_stations != oskar_telescope_num_stations(telescope))
+            (num_stations != oskar_telescope_num_stations(telescope) &&
+                    !(shared && num_stations == 1)))
     {
         *status = OSKAR_ERR_DIMENSION_MISMATCH;
         return;
@@ -143,7 +144,7 @@ void oskar_evaluate_jones_R(oskar_Jones* R, int num_sources,
     }
 
     /* Copy data for station 0 to stations 1 to n, if using a common sky. */
-    if (oskar_telescope_allow_station_beam_duplication(telescope))
+    if (shared)
         for (i = 1; i < num_stations; ++i)
             oskar_mem_copy_contents(
                     oskar_jones_mem(R), oskar_jones_mem(R),
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, The University of Oxford
+ * Copyright (c) 2013-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -25,253 +25,357 @@
  * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
  * POSSIBILITY OF SUCH DAMAGE.
  */
-
 #include "interferometer/oskar_evaluate_jones_Z.h"
 
-#include "convert/oskar_convert_relative_directions_to_enu_directions.h"
-#include "convert/oskar_convert_offset_ecef_to_ecef.h"
+#include "convert/oskar_convert_apparent_ra_dec_to_enu_directions.h"
+#include "convert/oskar_convert_geodetic_spherical_to_ecef.h"
+#include "math/oskar_cmath.h"
 #include "telescope/station/oskar_evaluate_pierce_points.h"
-#include "sky/oskar_evaluate_tec_tid.h"
 
-#include <math.h>
-#include <stdio.h>
+#include <float.h>
+#include <stdlib.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-static void oskar_evaluate_TEC(oskar_WorkJonesZ* work, int num_pp,
-        const oskar_SettingsIonosphere* settings,
-        double gast, int* status);
+/* Earth radius used by the TID model, in km. */
+#define EARTH_RADIUS_KM 6365.0
 
-static void evaluate_station_ECEF_coords(
-        double* station_x, double* station_y, double* station_z,
-        int stationID, const oskar_Telescope* telescope);
+/* Number of screen samples per wavelength of the shortest TID component. */
+#define SAMPLES_PER_WAVELENGTH 1024
 
-static void evaluate_jones_Z_station(double wavelength,
-        const oskar_Mem* TEC, const oskar_Mem* hor_z,
-        double min_elevation, int num_pp,
-        int offset_out, oskar_Mem* out, int* status);
+static void copy_to_host(oskar_Mem* dst, const oskar_Mem* src, int n,
+        oskar_Mem* temp, int* status);
+static double tid_component(const oskar_SettingsTIDscreen* TID, int i,
+        int dim, double coord, double time);
+static void evaluate_screen_profile(const oskar_SettingsTIDscreen* TID,
+        double TEC0, double time, int dim, int num_samples, double start,
+        double delta, double* profile);
+static double interpolate(const double* profile, int num_samples,
+        double start, double inv_delta, double coord);
 
-void oskar_evaluate_jones_Z(oskar_Jones* Z, const oskar_Sky* sky,
+void oskar_evaluate_jones_Z_tec(oskar_WorkJonesZ* work, int num_sources,
+        const oskar_Mem* ra_rad, const oskar_Mem* dec_rad,
         const oskar_Telescope* telescope,
-        const oskar_SettingsIonosphere* settings, double gast,
-        double frequency_hz, oskar_WorkJonesZ* work, int* status)
+        const oskar_SettingsIonosphere* settings, double gast, int* status)
 {
-    int i, num_sources, num_stations;
-    /* Station position in ECEF frame */
-    double station_x, station_y, station_z, wavelength;
-    oskar_Sky* sky_cpu; /* Copy of the sky model on the CPU */
+    int i, num_stations, num_pp, num_lon = 0, num_lat = 0, use_screen = 0;
+    double lon_range[2], lat_range[2], min_wavelength = DBL_MAX, delta = 0.0;
+    double *pp_lon, *pp_lat, *pp_sec, *tec, time, height_m, min_elevation;
+    const double *ra, *dec;
+    const oskar_SettingsTIDscreen* TID;
 
     /* Check if safe to proceed. */
     if (*status) return;
 
-    /* Check data types. */
-    const int type = oskar_sky_precision(sky);
-    if (oskar_telescope_precision(telescope) != type ||
-            oskar_jones_type(Z) != (type | OSKAR_COMPLEX))
+    /* FIXME(BM) For now limit number of screens to 1, this can be removed
+     * if a TEC model which is valid for multiple screens is implemented,
+     * as TEC0 would otherwise be added into every screen. */
+    if (settings->num_TID_screens != 1 || !settings->TID)
     {
-        *status = OSKAR_ERR_BAD_DATA_TYPE;
+        *status = OSKAR_ERR_INVALID_ARGUMENT;
         return;
     }
+    TID = &settings->TID[0];
+    time = gast * 86400.0; /* days->sec */
+    height_m = TID->height_km * 1000.0;
+    min_elevation = settings->min_elevation;
 
-    /* For now, this function requires data is on the CPU .. check this. */
-
-    /* Resize the work array (if needed) */
+    /* Resize the work arrays (if needed) and get source coordinates. */
     num_stations = oskar_telescope_num_stations(telescope);
-    num_sources = oskar_sky_num_sources(sky);
-    oskar_work_jones_z_resize(work, num_sources, status);
-
-    /* Copy the sky model to the CPU. */
-    sky_cpu = oskar_sky_create_copy(sky, OSKAR_CPU, status);
-
-    wavelength = 299792458.0 / frequency_hz;
+    num_pp = num_stations * num_sources;
+    work->num_stations = num_stations;
+    work->num_sources = num_sources;
+    oskar_work_jones_z_resize(work, num_pp, status);
+    copy_to_host(work->ra, ra_rad, num_sources, work->temp, status);
+    copy_to_host(work->dec, dec_rad, num_sources, work->temp, status);
+    ra = oskar_mem_double_const(work->ra, status);
+    dec = oskar_mem_double_const(work->dec, status);
+    pp_lon = oskar_mem_double(work->pp_lon, status);
+    pp_lat = oskar_mem_double(work->pp_lat, status);
+    pp_sec = oskar_mem_double(work->pp_rel_path, status);
+    tec = oskar_mem_double(work->total_TEC, status);
+    if (*status) return;
 
-    /* Evaluate the ionospheric phase screen for each station at each
-     * source pierce point. */
-    for (i = 0; i < num_stations; ++i)
+    /* Evaluate the pierce points of each station in parallel,
+     * and find the range of those above the minimum elevation. */
+    lon_range[0] = lat_range[0] = DBL_MAX;
+    lon_range[1] = lat_range[1] = -DBL_MAX;
+#pragma omp parallel
     {
-        double last, lon, lat;
-        const oskar_Station* station;
-        station = oskar_telescope_station_const(telescope, i);
-        lon = oskar_station_lon_rad(station);
-        lat = oskar_station_lat_rad(station);
-        last = gast + lon;
-
-        /* Evaluate horizontal x,y,z source positions (for which to evaluate
-         * pierce points) */
-        oskar_convert_relative_directions_to_enu_directions(0, 0, 0, num_sources,
-                oskar_sky_l_const(sky_cpu), oskar_sky_m_const(sky_cpu),
-                oskar_sky_n_const(sky_cpu), last - oskar_sky_reference_ra_rad(sky_cpu),
-                oskar_sky_reference_dec_rad(sky_cpu), lat,
-                0, work->hor_x, work->hor_y, work->hor_z, status);
-
-        /* Obtain station coordinates in the ECEF frame. */
-        evaluate_station_ECEF_coords(&station_x, &station_y, &station_z, i,
-                telescope);
-
-        /* Obtain the pierce points. */
-        /* FIXME(BM) this is current hard-coded to TID height screen 0
-         * this fix is only needed to support multiple screen heights. */
-        oskar_evaluate_pierce_points(work->pp_lon, work->pp_lat,
-                work->pp_rel_path, station_x, station_y,
-                station_z, settings->TID[0].height_km * 1000., num_sources,
-                work->hor_x, work->hor_y, work->hor_z, status);
-
-        /* Evaluate TEC values for the pierce points */
-        oskar_evaluate_TEC(work, num_sources, settings, gast, status);
-
-        /* Populate the Jones matrix with ionospheric phase */
-        const int offset_out = i * oskar_jones_num_sources(Z);
-        evaluate_jones_Z_station(wavelength,
-                work->total_TEC, work->hor_z, settings->min_elevation,
-                num_sources, offset_out, oskar_jones_mem(Z), status);
+        int s, j;
+        double lon_min = DBL_MAX, lon_max = -DBL_MAX;
+        double lat_min = DBL_MAX, lat_max = -DBL_MAX;
+        double *hor_x, *hor_y, *hor_z;
+        hor_x = (double*) malloc(3 * (num_sources + 1) * sizeof(double));
+        hor_y = hor_x + num_sources + 1;
+        hor_z = hor_y + num_sources + 1;
+#pragma omp for schedule(dynamic)
+        for (s = 0; s < num_stations; ++s)
+        {
+            double lon, lat, alt, x, y, z;
+            const int offset = s * num_sources;
+            const oskar_Station* station =
+                    oskar_telescope_station_const(telescope, s);
+            lon = oskar_station_lon_rad(station);
+            lat = oskar_station_lat_rad(station);
+            alt = oskar_station_alt_metres(station);
+            oskar_convert_geodetic_spherical_to_ecef(1, &lon, &lat, &alt,
+                    &x, &y, &z);
+
+            /* Evaluate horizontal x,y,z source positions (for which to
+             * evaluate pierce points) and the pierce points themselves. */
+            oskar_convert_apparent_ra_dec_to_enu_directions_d(num_sources,
+                    ra, dec, gast + lon, lat, hor_x, hor_y, hor_z);
+            oskar_evaluate_pierce_points_d(num_sources, hor_x, hor_y, hor_z,
+                    pp_lon + offset, pp_lat + offset, pp_sec + offset,
+                    height_m, x, y, z);
+
+            /* Mark pierce points below the minimum elevation with a zero
+             * relative path length, as they do not get a phase. */
+            for (j = 0; j < num_sources; ++j)
+            {
+                const int k = offset + j;
+                if (asin(hor_z[j]) < min_elevation)
+                {
+                    pp_sec[k] = 0.0;
+                    continue;
+                }
+                if (pp_lon[k] < lon_min) lon_min = pp_lon[k];
+                if (pp_lon[k] > lon_max) lon_max = pp_lon[k];
+                if (pp_lat[k] < lat_min) lat_min = pp_lat[k];
+                if (pp_lat[k] > lat_max) lat_max = pp_lat[k];
+            }
+        }
+#pragma omp critical
+        {
+            if (lon_min < lon_range[0]) lon_range[0] = lon_min;
+            if (lon_max > lon_range[1]) lon_range[1] = lon_max;
+            if (lat_min < lat_range[0]) lat_range[0] = lat_min;
+            if (lat_max > lat_range[1]) lat_range[1] = lat_max;
+        }
+        free(hor_x);
     }
 
-    oskar_sky_free(sky_cpu, status);
-}
-
-
-/* Evaluate the TEC value for each pierce point - note: at the moment this is
- * just the accumulation of one or more TID screens.
- * TODO convert this to a stand-alone function.
- */
-static void oskar_evaluate_TEC(oskar_WorkJonesZ* work, int num_pp,
-        const oskar_SettingsIonosphere* settings,
-        double gast, int* status)
-{
-    int i;
-
-    /* FIXME(BM) For now limit number of screens to 1, this can be removed
-     * if a TEC model which is valid for multiple screens is implemented
-     */
-    if (settings->num_TID_screens > 1)
-        *status = OSKAR_ERR_INVALID_ARGUMENT;
-
-    oskar_mem_clear_contents(work->total_TEC, status);
-
-    /* Loop over TID screens to evaluate TEC values */
-    for (i = 0; i < settings->num_TID_screens; ++i)
+    /* Choose the screen sample spacing from the shortest TID wavelength,
+     * and tabulate the screen only if it would save work. */
+    for (i = 0; i < TID->num_components; ++i)
     {
-        oskar_mem_clear_contents(work->screen_TEC, status);
-
-        /* Evaluate TEC values for the screen */
-        oskar_evaluate_tec_tid(work->screen_TEC, num_pp, work->pp_lon,
-                work->pp_lat, work->pp_rel_path, settings->TEC0,
-                &settings->TID[i], gast);
-
-        /* Accumulate into total TEC */
-        /* FIXME(BM) addition is not physical for more than one TEC screen in
-         * the way TIDs are currently evaluated as TEC0 is added into both
-         * screens.
-         */
-        oskar_mem_add(work->total_TEC, work->total_TEC, work->screen_TEC,
-                0, 0, 0, oskar_mem_length(work->total_TEC), status);
+        const double w = TID->wavelength[i] /
+                (EARTH_RADIUS_KM + TID->height_km); /* km to radians */
+        if (w < min_wavelength) min_wavelength = w;
+    }
+    if (lon_range[0] <= lon_range[1] && min_wavelength > 0.0 &&
+            min_wavelength < DBL_MAX)
+    {
+        double size_lon, size_lat;
+        delta = min_wavelength / SAMPLES_PER_WAVELENGTH;
+        size_lon = ceil((lon_range[1] - lon_range[0]) / delta) + 2.0;
+        size_lat = ceil((lat_range[1] - lat_range[0]) / delta) + 2.0;
+        if (size_lon + size_lat < (double) num_pp)
+        {
+            use_screen = 1;
+            num_lon = (int) size_lon;
+            num_lat = (int) size_lat;
+        }
     }
-}
-
-
-static void evaluate_station_ECEF_coords(
-        double* station_x, double* station_y, double* station_z,
-        int stationID, const oskar_Telescope* telescope)
-{
-    double st_x, st_y, st_z;
-    double lon, lat, alt;
-    const oskar_Station* station;
-    const void *x_, *y_, *z_;
-
-    x_ = oskar_mem_void_const(
-            oskar_telescope_station_true_x_offset_ecef_metres_const(telescope));
-    y_ = oskar_mem_void_const(
-            oskar_telescope_station_true_y_offset_ecef_metres_const(telescope));
-    z_ = oskar_mem_void_const(
-            oskar_telescope_station_true_z_offset_ecef_metres_const(telescope));
-    station = oskar_telescope_station_const(telescope, stationID);
-    lon = oskar_station_lon_rad(station);
-    lat = oskar_station_lat_rad(station);
-    alt = oskar_station_alt_metres(station);
 
-    if (oskar_mem_type(
-            oskar_telescope_station_true_x_offset_ecef_metres_const(telescope)) ==
-            OSKAR_DOUBLE)
+    /* Evaluate TEC values for the pierce points. */
+    if (use_screen)
     {
-        st_x = ((const double*)x_)[stationID];
-        st_y = ((const double*)y_)[stationID];
-        st_z = ((const double*)z_)[stationID];
+        double *screen_lon, *screen_lat;
+        const double inv_delta = 1.0 / delta;
+        const double TEC0_total = TID->num_components * settings->TEC0;
+        oskar_mem_ensure(work->screen_lon, num_lon, status);
+        oskar_mem_ensure(work->screen_lat, num_lat, status);
+        screen_lon = oskar_mem_double(work->screen_lon, status);
+        screen_lat = oskar_mem_double(work->screen_lat, status);
+        if (*status) return;
+        evaluate_screen_profile(TID, settings->TEC0, time, 0,
+                num_lon, lon_range[0], delta, screen_lon);
+        evaluate_screen_profile(TID, settings->TEC0, time, 1,
+                num_lat, lat_range[0], delta, screen_lat);
+#pragma omp parallel for private(i)
+        for (i = 0; i < num_pp; ++i)
+        {
+            if (pp_sec[i] == 0.0)
+            {
+                tec[i] = 0.0;
+                continue;
+            }
+            tec[i] = pp_sec[i] * (
+                    interpolate(screen_lon, num_lon, lon_range[0],
+                            inv_delta, pp_lon[i]) +
+                    interpolate(screen_lat, num_lat, lat_range[0],
+                            inv_delta, pp_lat[i])) + TEC0_total;
+        }
     }
     else
     {
-        st_x = (double)((const float*)x_)[stationID];
-        st_y = (double)((const float*)y_)[stationID];
-        st_z = (double)((const float*)z_)[stationID];
+#pragma omp parallel for private(i)
+        for (i = 0; i < num_pp; ++i)
+        {
+            int c;
+            double sum = 0.0;
+            if (pp_sec[i] == 0.0)
+            {
+                tec[i] = 0.0;
+                continue;
+            }
+            for (c = 0; c < TID->num_components; ++c)
+            {
+                sum += pp_sec[i] * TID->amp[c] * settings->TEC0 * (
+                        tid_component(TID, c, 0, pp_lon[i], time) +
+                        tid_component(TID, c, 1, pp_lat[i], time));
+                sum += settings->TEC0;
+            }
+            tec[i] = sum;
+        }
     }
-
-    oskar_convert_offset_ecef_to_ecef(1, &st_x, &st_y, &st_z, lon, lat, alt,
-            station_x, station_y, station_z);
 }
 
-static void evaluate_jones_Z_station(double wavelength,
-        const oskar_Mem* TEC, const oskar_Mem* hor_z,
-        double min_elevation, int num_pp,
-        int offset_out, oskar_Mem* out, int* status)
+
+void oskar_evaluate_jones_Z(oskar_Jones* Z, oskar_WorkJonesZ* work,
+        double frequency_hz, int* status)
 {
-    int i, type;
-    double arg;
+    int i, num_pp, type;
+    double wavelength;
+    const double* tec;
+    oskar_Mem* out;
 
     /* Check if safe to proceed. */
     if (*status) return;
 
+    /* Check dimensions. */
+    if (oskar_jones_num_stations(Z) != work->num_stations ||
+            oskar_jones_num_sources(Z) != work->num_sources)
+    {
+        *status = OSKAR_ERR_DIMENSION_MISMATCH;
+        return;
+    }
+
+    /* Fill a copy on the host if the Jones matrices are elsewhere. */
+    out = oskar_jones_mem(Z);
+    if (oskar_jones_mem_location(Z) != OSKAR_CPU)
+    {
+        out = work->jones_cpu;
+        if (!out)
+        {
+            *status = OSKAR_ERR_BAD_LOCATION;
+            return;
+        }
+    }
+    num_pp = work->num_stations * work->num_sources;
+    oskar_mem_ensure(out, num_pp, status);
+    tec = oskar_mem_double_const(work->total_TEC, status);
+    wavelength = 299792458.0 / frequency_hz;
     type = oskar_mem_type(out);
+    if (*status) return;
+
+    /* Z phase == exp(i * lambda * 25 * tec). This is unity where the TEC
+     * is zero, i.e. for pierce points below the minimum elevation. */
     if (type == OSKAR_DOUBLE_COMPLEX)
     {
-        double2* Z_ = oskar_mem_double2(out, status) + offset_out;
+        double2* Z_ = oskar_mem_double2(out, status);
+#pragma omp parallel for private(i)
         for (i = 0; i < num_pp; ++i)
         {
-            /* Initialise as an unit scalar Z = (1 + 0i) i.e. no phase change */
-            Z_[i].x = 1.0;
-            Z_[i].y = 0.0;
-
-            /* If the pierce point is below the minimum specified elevation
-             * don't evaluate a phase */
-            if (asin((oskar_mem_double_const(hor_z, status))[i]) <
-                    min_elevation)
-                continue;
-
-            arg = wavelength * 25. * oskar_mem_double_const(TEC, status)[i];
-
-            /* Z phase == exp(i * lambda * 25 * tec) */
+            const double arg = wavelength * 25. * tec[i];
             Z_[i].x = cos(arg);
             Z_[i].y = sin(arg);
         }
     }
     else if (type == OSKAR_SINGLE_COMPLEX)
     {
-        float2* Z_ = oskar_mem_float2(out, status) + offset_out;
+        float2* Z_ = oskar_mem_float2(out, status);
+#pragma omp parallel for private(i)
         for (i = 0; i < num_pp; ++i)
         {
-            /* Initialise as an unit scalar Z = (1 + 0i) i.e. no phase change */
-            Z_[i].x = 1.0;
-            Z_[i].y = 0.0;
+            const double arg = wavelength * 25. * tec[i];
+            Z_[i].x = (float) cos(arg);
+            Z_[i].y = (float) sin(arg);
+        }
+    }
+    else
+    {
+        *status = OSKAR_ERR_BAD_DATA_TYPE;
+        return;
+    }
 
-            /* If the pierce point is below the minimum specified elevation
-             * don't evaluate a phase */
-            if (asin((oskar_mem_float_const(hor_z, status))[i]) <
-                    min_elevation)
-                continue;
+    /* Copy to the device if required. */
+    if (out != oskar_jones_mem(Z))
+        oskar_mem_copy_contents(oskar_jones_mem(Z), out, 0, 0,
+                num_pp, status);
+}
 
-            arg = wavelength * 25. * oskar_mem_float_const(TEC, status)[i];
 
-            /* Z phase == exp(i * lambda * 25 * tec) */
-            Z_[i].x = cos(arg);
-            Z_[i].y = sin(arg);
-        }
+static void copy_to_host(oskar_Mem* dst, const oskar_Mem* src, int n,
+        oskar_Mem* temp, int* status)
+{
+    int i;
+    oskar_mem_ensure(dst, n, status);
+    if (oskar_mem_precision(src) == OSKAR_DOUBLE)
+    {
+        oskar_mem_copy_contents(dst, src, 0, 0, n, status);
     }
     else
     {
-        *status = OSKAR_ERR_BAD_DATA_TYPE;
+        double* dst_;
+        const float* temp_;
+        oskar_mem_ensure(temp, n, status);
+        oskar_mem_copy_contents(temp, src, 0, 0, n, status);
+        dst_ = oskar_mem_double(dst, status);
+        temp_ = oskar_mem_float_const(temp, status);
+        if (*status) return;
+        for (i = 0; i < n; ++i) dst_[i] = temp_[i];
+    }
+}
+
+
+/* Evaluates the variation of one TID component with pierce point longitude
+ * (dim = 0) or latitude (dim = 1), as in oskar_evaluate_tec_tid(). */
+static double tid_component(const oskar_SettingsTIDscreen* TID, int i,
+        int dim, double coord, double time)
+{
+    double w, th, v;
+    const double radius = EARTH_RADIUS_KM + TID->height_km;
+    w = TID->wavelength[i] / radius; /* km to radians */
+    th = TID->theta[i] * M_PI/180.;
+    v = (TID->speed[i] / radius) / 3600; /* km/h to rad/s */
+    return cos((2.0*M_PI/w) * ((dim ? sin(th) : cos(th)) * coord - v*time));
+}
+
+
+static void evaluate_screen_profile(const oskar_SettingsTIDscreen* TID,
+        double TEC0, double time, int dim, int num_samples, double start,
+        double delta, double* profile)
+{
+    int i;
+#pragma omp parallel for private(i)
+    for (i = 0; i < num_samples; ++i)
+    {
+        int c;
+        double sum = 0.0;
+        const double coord = start + i * delta;
+        for (c = 0; c < TID->num_components; ++c)
+            sum += TID->amp[c] * TEC0 *
+                    tid_component(TID, c, dim, coord, time);
+        profile[i] = sum;
     }
 }
 
+
+static double interpolate(const double* profile, int num_samples,
+        double start, double inv_delta, double coord)
+{
+    const double t = (coord - start) * inv_delta;
+    int j = (int) t;
+    if (j > num_samples - 2) j = num_samples - 2;
+    if (j < 0) j = 0;
+    return profile[j] + (t - j) * (profile[j + 1] - profile[j]);
+}
+
 #ifdef __cplusplus
 }
 #endif
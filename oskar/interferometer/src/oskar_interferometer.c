@@ -32,6 +32,8 @@
 #include "convert/oskar_convert_mjd_to_gast_fast.h"
 #include "correlate/oskar_auto_correlate.h"
 #include "correlate/oskar_cross_correlate.h"
+#include "correlate/oskar_cross_correlate_beam.h"
+#include "correlate/oskar_cross_correlate_channels.h"
 #include "interferometer/oskar_evaluate_jones_R.h"
 #include "interferometer/oskar_evaluate_jones_Z.h"
 #include "interferometer/oskar_evaluate_jones_E.h"
@@ -39,10 +41,12 @@
 #include "interferometer/oskar_jones.h"
 #include "interferometer/oskar_interferometer.h"
 #include "log/oskar_log.h"
+#include "sky/oskar_load_tid_parameter_file.h"
 #include "sky/oskar_sky.h"
 #include "telescope/oskar_telescope.h"
 #include "utility/oskar_device.h"
 #include "utility/oskar_get_memory_usage.h"
+#include "utility/oskar_get_thread_budget.h"
 #include "utility/oskar_get_num_procs.h"
 #include "utility/oskar_thread.h"
 #include "utility/oskar_timer.h"
@@ -64,11 +68,19 @@
 extern "C" {
 #endif
 
+/* Number of visibility blocks that can be in flight at once. */
+#define NUM_VIS_BUFFERS 3
+
+/* Maximum number of channels for which source fluxes are evaluated and
+ * correlated together, to limit the size of the flux scratch arrays. */
+#define MAX_CHANNEL_BATCH 32
+
 /* Memory allocated per compute device (may be either CPU or GPU). */
 struct DeviceData
 {
     /* Host memory. */
-    oskar_VisBlock* vis_block_cpu[2]; /* On host, for copy back & write. */
+    oskar_VisBlock* vis_block_cpu[NUM_VIS_BUFFERS]; /* For copy back. */
+    int reduce_count[NUM_VIS_BUFFERS]; /* Subtrees ready to add into left. */
 
     /* Device memory. */
     int previous_chunk_index;
@@ -76,9 +88,14 @@ struct DeviceData
     oskar_Mem *u, *v, *w;
     oskar_Sky* chunk;           /* The unmodified sky chunk being processed. */
     oskar_Sky* chunk_clip;      /* Copy of the chunk after horizon clipping. */
+    oskar_Mem *flux_I, *flux_Q, *flux_U, *flux_V; /* Fluxes per channel. */
     oskar_Telescope* tel;       /* Telescope model, created as a copy. */
     oskar_Jones *J, *R, *E, *K, *Z;
+    oskar_Jones* K_inc;         /* Jones K phase increment per channel. */
+    int fuse_K;                 /* Evaluate Jones K in the correlator. */
+    oskar_Mem* xcorr_work;      /* Work buffer for the CPU correlator. */
     oskar_StationWork* station_work;
+    oskar_WorkJonesZ* workJonesZ;
 
     /* Timers. */
     oskar_Timer* tmr_compute;   /* Total time spent filling vis blocks. */
@@ -88,6 +105,7 @@ struct DeviceData
     oskar_Timer* tmr_join;      /* Time spent combining Jones matrices. */
     oskar_Timer* tmr_E;         /* Time spent evaluating E-Jones. */
     oskar_Timer* tmr_K;         /* Time spent evaluating K-Jones. */
+    oskar_Timer* tmr_Z;         /* Time spent evaluating Z-Jones. */
 };
 typedef struct DeviceData DeviceData;
 
@@ -96,22 +114,26 @@ struct oskar_Interferometer
 {
     /* Settings. */
     int prec, num_devices, num_gpus_avail, dev_loc, num_gpus, *gpu_ids;
-    int num_channels, num_time_steps;
-    int max_sources_per_chunk, max_times_per_block;
+    int num_threads_per_device, num_channels, num_time_steps;
+    int max_sources_per_chunk, max_times_per_block, max_channels_per_beam;
     int apply_horizon_clip, force_polarised_ms, zero_failed_gaussians;
     int coords_only, ignore_w_components;
     double freq_start_hz, freq_inc_hz, time_start_mjd_utc, time_inc_sec;
     double source_min_jy, source_max_jy;
     char correlation_type, *vis_name, *ms_name, *settings_path;
+    oskar_SettingsIonosphere ionosphere;
 
     /* State. */
-    int init_sky, work_unit_index;
+    int init_sky, work_unit_index[NUM_VIS_BUFFERS];
+    int blocks_written, devices_done[NUM_VIS_BUFFERS], reduce_on_devices;
     oskar_Mutex* mutex;
-    oskar_Barrier* barrier;
+    oskar_ConditionVar* block_done;
 
     /* Sky model and telescope model. */
     int num_sources_total, num_sky_chunks;
     oskar_Sky** sky_chunks;
+    double* sky_chunk_caps; /* Bounding cap (lon, lat, radius) of chunks. */
+    oskar_Binary* sky_file;
     oskar_Telescope* tel;
 
     /* Output data and file handles. */
@@ -134,12 +156,23 @@ typedef struct oskar_Interferometer oskar_Interferometer;
 /* Private method prototypes. */
 
 static void sim_baselines(oskar_Interferometer* h, DeviceData* d,
-        oskar_Sky* sky, int channel_index_block, int time_index_block,
-        int time_index_simulation, int* status);
+        oskar_Sky* sky, int channel_index_block, int num_channels_batch,
+        int time_index_block, int time_index_simulation, int* status);
+static void add_vis_block(oskar_VisBlock* dst, const oskar_VisBlock* src,
+        int* status);
+static void reduce_vis_block(oskar_Interferometer* h, int device_id,
+        int i_active, int* status);
 static void free_device_data(oskar_Interferometer* h, int* status);
+static void free_sky_chunks(oskar_Interferometer* h, int* status);
+static void free_ionosphere(oskar_SettingsIonosphere* ionosphere);
 static void set_up_device_data(oskar_Interferometer* h, int* status);
 static void set_up_vis_header(oskar_Interferometer* h, int* status);
 static void record_timing(oskar_Interferometer* h);
+static int num_beam_stations(const oskar_Telescope* tel);
+static int batch_channels(const oskar_Interferometer* h, int location,
+        const char** reason);
+static int fuse_jones_K(const oskar_Interferometer* h, int location);
+static int flat_spectrum(const oskar_Sky* sky, int* status);
 static unsigned int disp_width(unsigned int value);
 static void system_mem_log(void);
 
@@ -217,7 +250,8 @@ oskar_Interferometer* oskar_interferometer_create(int precision, int* status)
     h->t_v       = oskar_mem_create(precision, OSKAR_CPU, 0, status);
     h->t_w       = oskar_mem_create(precision, OSKAR_CPU, 0, status);
     h->mutex     = oskar_mutex_create();
-    h->barrier   = oskar_barrier_create(0);
+    h->block_done = oskar_condition_create();
+    if (!h->block_done) *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
 
     /* Get number of devices available, and device location. */
     oskar_device_set_require_double_precision(precision == OSKAR_DOUBLE);
@@ -239,30 +273,20 @@ oskar_VisBlock* oskar_interferometer_finalise_block(oskar_Interferometer* h,
         int block_index, int* status)
 {
     int i, i_active;
-    oskar_VisBlock *b0 = 0, *b = 0;
+    oskar_VisBlock *b0 = 0;
     if (*status) return 0;
 
     /* The visibilities must be copied back
      * at the end of the block simulation. */
 
-    /* Combine all vis blocks into the first one. */
-    i_active = (block_index + 1) % 2;
-    b0 = h->d[0].vis_block_cpu[!i_active];
-    if (!h->coords_only)
+    /* Combine all vis blocks into the first one, unless the devices
+     * have already done so as they finished (see reduce_vis_block()). */
+    i_active = block_index % NUM_VIS_BUFFERS;
+    b0 = h->d[0].vis_block_cpu[i_active];
+    if (!h->coords_only && !h->reduce_on_devices)
     {
-        oskar_Mem *xc0 = 0, *ac0 = 0;
-        xc0 = oskar_vis_block_cross_correlations(b0);
-        ac0 = oskar_vis_block_auto_correlations(b0);
         for (i = 1; i < h->num_devices; ++i)
-        {
-            b = h->d[i].vis_block_cpu[!i_active];
-            if (oskar_vis_block_has_cross_correlations(b))
-                oskar_mem_add(xc0, xc0, oskar_vis_block_cross_correlations(b),
-                        0, 0, 0, oskar_mem_length(xc0), status);
-            if (oskar_vis_block_has_auto_correlations(b))
-                oskar_mem_add(ac0, ac0, oskar_vis_block_auto_correlations(b),
-                        0, 0, 0, oskar_mem_length(ac0), status);
-        }
+            add_vis_block(b0, h->d[i].vis_block_cpu[i_active], status);
     }
 
     /* Calculate baseline uvw coordinates for the block. */
@@ -304,12 +328,11 @@ void oskar_interferometer_finalise(oskar_Interferometer* h, int* status)
 
 void oskar_interferometer_free(oskar_Interferometer* h, int* status)
 {
-    int i;
     if (!h) return;
     oskar_interferometer_reset_cache(h, status);
-    for (i = 0; i < h->num_sky_chunks; ++i)
-        oskar_sky_free(h->sky_chunks[i], status);
+    free_sky_chunks(h, status);
     oskar_telescope_free(h->tel, status);
+    free_ionosphere(&h->ionosphere);
     oskar_mem_free(h->temp, status);
     oskar_mem_free(h->t_u, status);
     oskar_mem_free(h->t_v, status);
@@ -317,8 +340,7 @@ void oskar_interferometer_free(oskar_Interferometer* h, int* status)
     oskar_timer_free(h->tmr_sim);
     oskar_timer_free(h->tmr_write);
     oskar_mutex_free(h->mutex);
-    oskar_barrier_free(h->barrier);
-    free(h->sky_chunks);
+    oskar_condition_free(h->block_done);
     free(h->gpu_ids);
     free(h->vis_name);
     free(h->ms_name);
@@ -363,7 +385,8 @@ void oskar_interferometer_reset_cache(oskar_Interferometer* h, int* status)
 
 void oskar_interferometer_reset_work_unit_index(oskar_Interferometer* h)
 {
-    h->work_unit_index = 0;
+    int i;
+    for (i = 0; i < NUM_VIS_BUFFERS; ++i) h->work_unit_index[i] = 0;
 }
 
 
@@ -373,6 +396,7 @@ void oskar_interferometer_run_block(oskar_Interferometer* h, int block_index,
     double obs_start_mjd, dt_dump_days;
     int i_active, time_index_start, time_index_end;
     int num_channels, num_times_block, total_chunks, total_times;
+    int num_units, num_groups, group_size;
     DeviceData* d;
     if (*status) return;
 
@@ -390,8 +414,16 @@ void oskar_interferometer_run_block(oskar_Interferometer* h, int block_index,
     if (device_id >= 0 && device_id < h->num_gpus)
         oskar_device_set(h->dev_loc, h->gpu_ids[device_id], status);
 
+#ifdef _OPENMP
+    /* Set the size of the OpenMP team used by this device.
+     * (This is per-thread, and cheap to set for every block.) */
+    omp_set_num_threads(h->num_threads_per_device > 0 ?
+            h->num_threads_per_device :
+            oskar_get_thread_budget(h->num_devices));
+#endif
+
     /* Clear the visibility block. */
-    i_active = block_index % 2; /* Index of the active buffer. */
+    i_active = block_index % NUM_VIS_BUFFERS; /* Index of active buffer. */
     d = &(h->d[device_id]);
     oskar_timer_resume(d->tmr_compute);
     oskar_vis_block_clear(d->vis_block, status);
@@ -412,22 +444,56 @@ void oskar_interferometer_run_block(oskar_Interferometer* h, int block_index,
     oskar_vis_block_set_num_times(d->vis_block, num_times_block, status);
     oskar_vis_block_set_start_time_index(d->vis_block, time_index_start);
 
+    /* Split the channels into groups if there are too few sky chunks and
+     * times in the block to give each device at least two work units. */
+    num_units = num_times_block * total_chunks;
+    num_groups = 1;
+    if (num_units < 2 * h->num_devices)
+        num_groups = (2 * h->num_devices + num_units - 1) / num_units;
+    if (num_groups > num_channels) num_groups = num_channels;
+    group_size = (num_channels + num_groups - 1) / num_groups;
+    num_groups = (num_channels + group_size - 1) / group_size;
+
     /* Go though all possible work units in the block. A work unit is defined
-     * as the simulation for one time and one sky chunk. */
+     * as the simulation for one time, one sky chunk and one group of
+     * channels. */
     while (!h->coords_only)
     {
-        oskar_Sky* sky;
-        int i_work_unit, i_chunk, i_time, i_channel, sim_time_idx;
-
-        oskar_mutex_lock(h->mutex);
-        i_work_unit = (h->work_unit_index)++;
-        oskar_mutex_unlock(h->mutex);
-        if ((i_work_unit >= num_times_block * total_chunks) || *status) break;
+        oskar_Sky *sky, *sky_channel = 0;
+        int i_work_unit, i_chunk, i_time, i_channel, sim_time_idx, clip;
+        int i_group, channel_start, channel_end;
+        int channel_batch, correlate_batch;
+        double gast, mjd;
+
+        i_work_unit = oskar_atomic_fetch_add_int(
+                &h->work_unit_index[i_active], 1);
+        if ((i_work_unit >= num_units * num_groups) || *status) break;
+
+        /* Convert work unit index to chunk/time/channel group index. */
+        i_group       = i_work_unit % num_groups;
+        i_work_unit  /= num_groups;
+        channel_start = i_group * group_size;
+        channel_end   = channel_start + group_size;
+        if (channel_end > num_channels) channel_end = num_channels;
 
         /* Convert slice index to chunk/time index. */
         i_chunk      = i_work_unit / num_times_block;
         i_time       = i_work_unit - i_chunk * num_times_block;
         sim_time_idx = time_index_start + i_time;
+        mjd = obs_start_mjd + dt_dump_days * (sim_time_idx + 0.5);
+        gast = oskar_convert_mjd_to_gast_fast(mjd);
+
+        /* Skip the whole chunk if it is below the horizon of all stations,
+         * or skip the horizon clip if it is above the horizon. */
+        clip = h->apply_horizon_clip;
+        if (clip)
+        {
+            const double* cap = &h->sky_chunk_caps[3 * i_chunk];
+            const int cap_horizon = oskar_sky_horizon_cap(
+                    cap[0], cap[1], cap[2], h->tel, gast);
+            if (cap_horizon == OSKAR_SKY_CAP_BELOW_HORIZON) continue;
+            if (cap_horizon == OSKAR_SKY_CAP_ABOVE_HORIZON) clip = 0;
+        }
 
         /* Copy sky chunk to device only if different from the previous one. */
         if (i_chunk != d->previous_chunk_index)
@@ -436,34 +502,88 @@ void oskar_interferometer_run_block(oskar_Interferometer* h, int block_index,
             oskar_sky_copy(d->chunk, h->sky_chunks[i_chunk], status);
             oskar_timer_pause(d->tmr_copy);
         }
-        sky = h->apply_horizon_clip ? d->chunk_clip : d->chunk;
+        sky = clip ? d->chunk_clip : d->chunk;
 
         /* Apply horizon clip if required. */
-        if (h->apply_horizon_clip)
+        if (clip)
         {
-            double gast, mjd;
-            mjd = obs_start_mjd + dt_dump_days * (sim_time_idx + 0.5);
-            gast = oskar_convert_mjd_to_gast_fast(mjd);
             oskar_timer_resume(d->tmr_clip);
             oskar_sky_horizon_clip(d->chunk_clip, d->chunk, d->tel, gast,
                     d->station_work, status);
             oskar_timer_pause(d->tmr_clip);
         }
 
-        /* Simulate all baselines for all channels for this time and chunk. */
-        for (i_channel = 0; i_channel < num_channels; ++i_channel)
+        /* Evaluate ionospheric TEC at the pierce points if required.
+         * This depends only on time, so is shared by all channels. */
+        if (d->Z)
         {
+            oskar_timer_resume(d->tmr_Z);
+            oskar_evaluate_jones_Z_tec(d->workJonesZ,
+                    oskar_sky_num_sources(sky), oskar_sky_ra_rad_const(sky),
+                    oskar_sky_dec_rad_const(sky), h->tel, &h->ionosphere,
+                    gast, status);
+            oskar_timer_pause(d->tmr_Z);
+        }
+
+        /* Simulate all baselines for the channels in the group for this
+         * time and chunk. Source fluxes are evaluated for a batch of
+         * channels at once, without modifying the chunk. (OpenCL
+         * sub-buffers must be aligned, so there the batch is a single
+         * channel.) If only Jones K varies with frequency, all channels in
+         * the group are correlated together in one pass over the Jones
+         * matrices. If the station beam is shared by a batch of channels,
+         * fluxes are evaluated for each batch so they start together. */
+        channel_batch = (oskar_sky_mem_location(sky) & OSKAR_CL) ?
+                1 : channel_end - channel_start;
+        if (channel_batch > MAX_CHANNEL_BATCH)
+            channel_batch = MAX_CHANNEL_BATCH;
+        correlate_batch = batch_channels(h,
+                oskar_telescope_mem_location(d->tel), 0);
+        if (correlate_batch > channel_batch)
+            correlate_batch = channel_batch;
+        else if (correlate_batch > 1)
+            channel_batch = correlate_batch;
+        for (i_channel = channel_start; i_channel < channel_end;
+                i_channel += correlate_batch)
+        {
+            const int num_src = oskar_sky_num_sources(sky);
+            const int i_batch = (i_channel - channel_start) % channel_batch;
+            const int num_batch = channel_end - i_channel < correlate_batch ?
+                    channel_end - i_channel : correlate_batch;
             if (*status) break;
-            oskar_mutex_lock(h->mutex);
-            oskar_log_message('S', 1, "Time %*i/%i, "
-                    "Chunk %*i/%i, Channel %*i/%i [Device %i, %i sources]",
-                    disp_width(total_times), sim_time_idx + 1, total_times,
-                    disp_width(total_chunks), i_chunk + 1, total_chunks,
-                    disp_width(num_channels), i_channel + 1, num_channels,
-                    device_id, oskar_sky_num_sources(sky));
-            oskar_mutex_unlock(h->mutex);
-            sim_baselines(h, d, sky, i_channel, i_time, sim_time_idx, status);
+            if (num_batch > 1)
+                oskar_log_message('S', 1, "Time %*i/%i, "
+                        "Chunk %*i/%i, Channels %i-%i [Device %i, %i sources]",
+                        disp_width(total_times), sim_time_idx + 1, total_times,
+                        disp_width(total_chunks), i_chunk + 1, total_chunks,
+                        i_channel + 1, i_channel + num_batch,
+                        device_id, num_src);
+            else
+                oskar_log_message('S', 1, "Time %*i/%i, "
+                        "Chunk %*i/%i, Channel %*i/%i [Device %i, %i sources]",
+                        disp_width(total_times), sim_time_idx + 1, total_times,
+                        disp_width(total_chunks), i_chunk + 1, total_chunks,
+                        disp_width(num_channels), i_channel + 1, num_channels,
+                        device_id, num_src);
+            if (i_batch == 0)
+                oskar_sky_evaluate_flux(sky,
+                        channel_end - i_channel < channel_batch ?
+                                channel_end - i_channel : channel_batch,
+                        h->freq_start_hz + i_channel * h->freq_inc_hz,
+                        h->freq_inc_hz, d->flux_I, d->flux_Q, d->flux_U,
+                        d->flux_V, status);
+            if (!sky_channel)
+                sky_channel = oskar_sky_create_flux_alias(sky,
+                        d->flux_I, d->flux_Q, d->flux_U, d->flux_V,
+                        (size_t) i_batch * (size_t) num_src, status);
+            else
+                oskar_sky_set_flux_alias(sky_channel,
+                        d->flux_I, d->flux_Q, d->flux_U, d->flux_V,
+                        (size_t) i_batch * (size_t) num_src, status);
+            sim_baselines(h, d, sky_channel, i_channel, num_batch,
+                    i_time, sim_time_idx, status);
         }
+        oskar_sky_free(sky_channel, status);
         d->previous_chunk_index = i_chunk;
     }
 
@@ -486,11 +606,10 @@ typedef struct ThreadArgs ThreadArgs;
 static void* run_blocks(void* arg)
 {
     oskar_Interferometer* h;
-    int b, thread_id, device_id, num_blocks, num_threads, *status;
+    int b, i, thread_id, device_id, num_blocks, *status;
 
     /* Get thread function arguments. */
     h = ((ThreadArgs*)arg)->h;
-    num_threads = ((ThreadArgs*)arg)->num_threads;
     thread_id = ((ThreadArgs*)arg)->thread_id;
     device_id = thread_id - 1;
     status = ((ThreadArgs*)arg)->status;
@@ -498,56 +617,80 @@ static void* run_blocks(void* arg)
 #ifdef _OPENMP
     /* Disable any nested parallelism. */
     omp_set_nested(0);
-    omp_set_num_threads(1);
 #endif
 
     /* Loop over blocks of observation time, running simulation and file
-     * writing one block at a time. Simulation and file output are overlapped
-     * by using double buffering, and a dedicated thread is used for file
-     * output.
+     * writing as a pipeline. Up to NUM_VIS_BUFFERS blocks can be in flight
+     * at once, so a device can start on the next block as soon as it runs
+     * out of work units in the current one, while the writer thread is
+     * still writing earlier blocks.
      *
      * Thread 0 is used for file writes.
      * Threads 1 to n (mapped to compute devices) do the simulation.
      *
-     * Note that no write is launched on the first loop counter (as no
-     * data are ready yet) and no simulation is performed for the last loop
-     * counter (which corresponds to the last block + 1) as this iteration
-     * simply writes the last block.
+     * Each block keeps a count of the devices that have finished with it.
+     * The writer waits for this to reach the number of devices, and a device
+     * waits for the block that last used its host buffer to be written.
+     * Before it is counted, each device adds its block into the first one
+     * as part of a tree reduction, so the writer only has to write it.
      */
     num_blocks = oskar_interferometer_num_vis_blocks(h);
-    for (b = 0; b < num_blocks + 1; ++b)
+    for (b = 0; b < num_blocks; ++b)
     {
-        if ((thread_id > 0 || num_threads == 1) && b < num_blocks)
-            oskar_interferometer_run_block(h, b, device_id, status);
-        if (thread_id == 0 && b > 0)
+        const int i_active = b % NUM_VIS_BUFFERS;
+        if (thread_id == 0)
         {
             oskar_VisBlock* block;
-            block = oskar_interferometer_finalise_block(h, b - 1, status);
-            oskar_interferometer_write_block(h, block, b - 1, status);
-        }
 
-        /* Barrier 1: Reset work unit index and print status. */
-        oskar_barrier_wait(h->barrier);
-        if (thread_id == 0)
-        {
-            oskar_interferometer_reset_work_unit_index(h);
-            if (b < num_blocks && !*status)
+            /* Wait for all devices to finish the block, and print status. */
+            oskar_condition_lock(h->block_done);
+            while (h->devices_done[i_active] < h->num_devices)
+                oskar_condition_wait(h->block_done);
+            oskar_condition_unlock(h->block_done);
+            if (!*status)
                 oskar_log_message('S', 0, "Block %*i/%i (%3.0f%%) "
                         "complete. Simulation time elapsed: %.3f s",
                         disp_width(num_blocks), b+1, num_blocks,
                         100.0 * (b+1) / (double)num_blocks,
                         oskar_timer_elapsed(h->tmr_sim));
+
+            /* Finalise and write the block. */
+            block = oskar_interferometer_finalise_block(h, b, status);
+            oskar_interferometer_write_block(h, block, b, status);
+
+            /* Release the buffers for re-use. */
+            oskar_condition_lock(h->block_done);
+            h->devices_done[i_active] = 0;
+            h->work_unit_index[i_active] = 0;
+            for (i = 0; i < h->num_devices; ++i)
+                h->d[i].reduce_count[i_active] = 0;
+            h->blocks_written = b + 1;
+            oskar_condition_notify_all(h->block_done);
+            oskar_condition_unlock(h->block_done);
         }
+        else
+        {
+            /* Wait until the host buffers for the block are free. */
+            oskar_condition_lock(h->block_done);
+            while (h->blocks_written + NUM_VIS_BUFFERS <= b)
+                oskar_condition_wait(h->block_done);
+            oskar_condition_unlock(h->block_done);
 
-        /* Barrier 2: Synchronise before moving to the next block. */
-        oskar_barrier_wait(h->barrier);
+            /* Simulate and combine the block, and signal when done. */
+            oskar_interferometer_run_block(h, b, device_id, status);
+            reduce_vis_block(h, device_id, i_active, status);
+            oskar_condition_lock(h->block_done);
+            h->devices_done[i_active]++;
+            oskar_condition_notify_all(h->block_done);
+            oskar_condition_unlock(h->block_done);
+        }
     }
     return 0;
 }
 
 void oskar_interferometer_run(oskar_Interferometer* h, int* status)
 {
-    int i, num_threads;
+    int i, num_threads, log_async;
     oskar_Thread** threads = 0;
     ThreadArgs* args = 0;
     if (*status || !h) return;
@@ -572,9 +715,23 @@ void oskar_interferometer_run(oskar_Interferometer* h, int* status)
     /* Initialise if required. */
     oskar_interferometer_check_init(h, status);
 
+    /* Report whether channels can be correlated together, and why. */
+    if (!*status && h->num_channels > 1 && !h->coords_only)
+    {
+        const char* reason = 0;
+        const int n = batch_channels(h, h->d[0].tel ?
+                oskar_telescope_mem_location(h->d[0].tel) : OSKAR_CPU,
+                &reason);
+        if (n > 1)
+            oskar_log_message('M', 0, "Correlating up to %d channels "
+                    "together: %s.", n, reason);
+        else
+            oskar_log_message('M', 0, "Correlating channels separately: "
+                    "%s.", reason);
+    }
+
     /* Set up worker threads. */
     num_threads = h->num_devices + 1;
-    oskar_barrier_set_num_threads(h->barrier, num_threads);
     threads = (oskar_Thread**) calloc(num_threads, sizeof(oskar_Thread*));
     args = (ThreadArgs*) calloc(num_threads, sizeof(ThreadArgs));
     for (i = 0; i < num_threads; ++i)
@@ -598,8 +755,18 @@ void oskar_interferometer_run(oskar_Interferometer* h, int* status)
     /* Start simulation timer. */
     oskar_timer_start(h->tmr_sim);
 
-    /* Start the worker threads. */
+    /* Start the worker threads, logging asynchronously while they run. */
+    log_async = oskar_log_async();
+    oskar_log_set_async(1);
     oskar_interferometer_reset_work_unit_index(h);
+    h->blocks_written = 0;
+    h->reduce_on_devices = 1;
+    for (i = 0; i < NUM_VIS_BUFFERS; ++i)
+    {
+        int j;
+        h->devices_done[i] = 0;
+        for (j = 0; j < h->num_devices; ++j) h->d[j].reduce_count[i] = 0;
+    }
     for (i = 0; i < num_threads; ++i)
         threads[i] = oskar_thread_create(run_blocks, (void*)&args[i], 0);
 
@@ -609,6 +776,8 @@ void oskar_interferometer_run(oskar_Interferometer* h, int* status)
         oskar_thread_join(threads[i]);
         oskar_thread_free(threads[i]);
     }
+    oskar_log_set_async(log_async);
+    h->reduce_on_devices = 0;
     free(threads);
     free(args);
 
@@ -761,6 +930,41 @@ void oskar_interferometer_set_ignore_w_components(oskar_Interferometer* h,
 }
 
 
+void oskar_interferometer_set_ionosphere(oskar_Interferometer* h,
+        const char* tid_file, double TEC0, double min_elevation_rad,
+        int* status)
+{
+    oskar_SettingsIonosphere* ion;
+    if (*status || !h) return;
+    free_device_data(h, status);
+    ion = &h->ionosphere;
+    free_ionosphere(ion);
+    if (!tid_file || strlen(tid_file) == 0) return;
+
+    /* Load the TID screen. */
+    ion->TID = (oskar_SettingsTIDscreen*)
+            calloc(1, sizeof(oskar_SettingsTIDscreen));
+    oskar_load_tid_parameter_file(ion->TID, tid_file, status);
+    if (*status)
+    {
+        oskar_log_error("Unable to load TID parameter file '%s'.", tid_file);
+        free_ionosphere(ion);
+        return;
+    }
+    ion->num_TID_screens = 1;
+    ion->TEC0 = TEC0;
+    ion->min_elevation = min_elevation_rad;
+    ion->enable = 1;
+}
+
+
+void oskar_interferometer_set_max_channels_per_beam(oskar_Interferometer* h,
+        int value)
+{
+    h->max_channels_per_beam = value;
+}
+
+
 void oskar_interferometer_set_max_sources_per_chunk(oskar_Interferometer* h,
         int value)
 {
@@ -788,6 +992,13 @@ void oskar_interferometer_set_num_devices(oskar_Interferometer* h, int value)
 }
 
 
+void oskar_interferometer_set_num_threads_per_device(oskar_Interferometer* h,
+        int value)
+{
+    h->num_threads_per_device = value;
+}
+
+
 void oskar_interferometer_set_observation_frequency(oskar_Interferometer* h,
         double start_hz, double inc_hz, int num_channels)
 {
@@ -821,21 +1032,34 @@ void oskar_interferometer_set_settings_path(oskar_Interferometer* h,
 void oskar_interferometer_set_sky_model(oskar_Interferometer* h,
         const oskar_Sky* sky, int* status)
 {
-    int i;
     if (*status || !h || !sky) return;
 
     /* Clear the old chunk set. */
-    for (i = 0; i < h->num_sky_chunks; ++i)
-        oskar_sky_free(h->sky_chunks[i], status);
-    free(h->sky_chunks);
-    h->sky_chunks = 0;
-    h->num_sky_chunks = 0;
+    free_sky_chunks(h, status);
 
-    /* Split up the sky model into chunks and store them. */
+    /* Sort the sources spatially, so that each chunk covers a compact
+     * region of sky, then split them up into chunks and store them. */
     h->num_sources_total = oskar_sky_num_sources(sky);
     if (h->num_sources_total > 0)
+    {
+        int i;
+        oskar_Sky* sorted = oskar_sky_create_copy(sky, OSKAR_CPU, status);
+        oskar_sky_sort_spatial(sorted, status);
         oskar_sky_append_to_set(&h->num_sky_chunks, &h->sky_chunks,
-                h->max_sources_per_chunk, sky, status);
+                h->max_sources_per_chunk, sorted, status);
+        oskar_sky_free(sorted, status);
+
+        /* Find the bounding cap of each chunk, for horizon culling. */
+        h->sky_chunk_caps = (double*) calloc(3 * (size_t) h->num_sky_chunks,
+                sizeof(double));
+        for (i = 0; i < h->num_sky_chunks; ++i)
+        {
+            double* cap = &h->sky_chunk_caps[3 * i];
+            oskar_sky_bounding_cap(h->sky_chunks[i], 0,
+                    oskar_sky_num_sources(h->sky_chunks[i]),
+                    &cap[0], &cap[1], &cap[2], status);
+        }
+    }
     h->init_sky = 0;
 
     /* Print summary data. */
@@ -845,6 +1069,83 @@ void oskar_interferometer_set_sky_model(oskar_Interferometer* h,
 }
 
 
+void oskar_interferometer_set_sky_model_file(oskar_Interferometer* h,
+        const char* filename, int* status)
+{
+    int i, num_chunks, chunk_size = 0, num_skipped = 0;
+    if (*status || !h || !filename) return;
+
+    /* Clear the old chunk set, and open the file. */
+    free_sky_chunks(h, status);
+    h->sky_file = oskar_binary_create(filename, 'r', status);
+    num_chunks = oskar_sky_read_num_chunks(h->sky_file, status);
+    if (num_chunks > 0)
+        oskar_binary_read_int(h->sky_file, OSKAR_TAG_GROUP_SKY_MODEL,
+                OSKAR_SKY_TAG_CHUNK_SIZE, 0, &chunk_size, status);
+
+    /* If the file is not chunked, or if the chunks are too big,
+     * read it all and split it up in memory instead. */
+    if (*status || num_chunks <= 0 || chunk_size > h->max_sources_per_chunk)
+    {
+        oskar_Sky* sky;
+        oskar_binary_free(h->sky_file);
+        h->sky_file = 0;
+        sky = oskar_sky_read(filename, OSKAR_CPU, status);
+        oskar_interferometer_set_sky_model(h, sky, status);
+        oskar_sky_free(sky, status);
+        return;
+    }
+
+    /* Use the chunks in the file directly, skipping any that do not
+     * contain any sources in the required flux range.
+     * The stored flux range applies at the reference frequency, so chunks
+     * can only be skipped if their fluxes do not change with frequency. */
+    h->sky_chunks = (oskar_Sky**) calloc((size_t) num_chunks,
+            sizeof(oskar_Sky*));
+    h->sky_chunk_caps = (double*) calloc(3 * (size_t) num_chunks,
+            sizeof(double));
+    h->num_sources_total = 0;
+    for (i = 0; i < num_chunks; ++i)
+    {
+        int num_sources = 0;
+        double cap[3], flux_range[2];
+        oskar_Sky* chunk;
+        oskar_sky_read_chunk_info(h->sky_file, i, &num_sources, cap,
+                flux_range, 0, status);
+        if (*status) break;
+        if (num_sources == 0)
+        {
+            num_skipped++;
+            continue;
+        }
+        chunk = oskar_sky_read_chunk(h->sky_file, i, status);
+        if (*status) break;
+        if ((flux_range[1] <= h->source_min_jy ||
+                flux_range[0] > h->source_max_jy) &&
+                flat_spectrum(chunk, status))
+        {
+            oskar_sky_free(chunk, status);
+            num_skipped++;
+            continue;
+        }
+        h->sky_chunks[h->num_sky_chunks] = chunk;
+        h->sky_chunk_caps[3 * h->num_sky_chunks + 0] = cap[0];
+        h->sky_chunk_caps[3 * h->num_sky_chunks + 1] = cap[1];
+        h->sky_chunk_caps[3 * h->num_sky_chunks + 2] = cap[2];
+        h->num_sky_chunks++;
+        h->num_sources_total += num_sources;
+    }
+    h->init_sky = 0;
+
+    /* Print summary data. */
+    oskar_log_section('M', "Sky model summary");
+    oskar_log_value('M', 0, "Num. sources", "%d", h->num_sources_total);
+    oskar_log_value('M', 0, "Num. chunks", "%d", h->num_sky_chunks);
+    if (num_skipped > 0)
+        oskar_log_value('M', 0, "Num. chunks skipped", "%d", num_skipped);
+}
+
+
 void oskar_interferometer_set_telescope_model(oskar_Interferometer* h,
         const oskar_Telescope* model, int* status)
 {
@@ -943,13 +1244,17 @@ void oskar_interferometer_write_block(oskar_Interferometer* h,
 /* Private methods. */
 
 static void sim_baselines(oskar_Interferometer* h, DeviceData* d,
-        oskar_Sky* sky, int channel_index_block, int time_index_block,
-        int time_index_simulation, int* status)
+        oskar_Sky* sky, int channel_index_block, int num_channels_batch,
+        int time_index_block, int time_index_simulation, int* status)
 {
     int num_baselines, num_stations, num_src, num_times_block, num_channels;
     double dt_dump_days, t_start, t_dump, gast, frequency, ra0, dec0;
     const oskar_Mem *x, *y, *z;
 
+    /* Check if safe to proceed.
+     * (The sky model may be NULL if an error was raised by another thread.) */
+    if (*status) return;
+
     /* Get dimensions. */
     num_baselines   = oskar_telescope_num_baselines(d->tel);
     num_stations    = oskar_telescope_num_stations(d->tel);
@@ -968,9 +1273,6 @@ static void sim_baselines(oskar_Interferometer* h, DeviceData* d,
     gast = oskar_convert_mjd_to_gast_fast(t_dump);
     frequency = h->freq_start_hz + channel_index_block * h->freq_inc_hz;
 
-    /* Scale source fluxes with spectral index and rotation measure. */
-    oskar_sky_scale_flux_with_frequency(sky, frequency, status);
-
     /* Evaluate station u,v,w coordinates. */
     ra0 = oskar_telescope_phase_centre_ra_rad(d->tel);
     dec0 = oskar_telescope_phase_centre_dec_rad(d->tel);
@@ -980,14 +1282,20 @@ static void sim_baselines(oskar_Interferometer* h, DeviceData* d,
     oskar_convert_ecef_to_station_uvw(num_stations, x, y, z, ra0, dec0, gast,
             0, 0, d->u, d->v, d->w, status);
 
-    /* Set dimensions of Jones matrices. */
+    /* Set dimensions of Jones matrices.
+     * E and R are shared by all stations if the beams are identical.
+     * J and K are not needed if Jones K is evaluated in the correlator. */
+    const int fuse_K = d->fuse_K && num_channels_batch == 1;
     if (d->R)
-        oskar_jones_set_size(d->R, num_stations, num_src, status);
+        oskar_jones_set_size(d->R, num_beam_stations(d->tel), num_src, status);
     if (d->Z)
         oskar_jones_set_size(d->Z, num_stations, num_src, status);
-    oskar_jones_set_size(d->J, num_stations, num_src, status);
-    oskar_jones_set_size(d->E, num_stations, num_src, status);
-    oskar_jones_set_size(d->K, num_stations, num_src, status);
+    if (!fuse_K)
+    {
+        oskar_jones_set_size(d->J, num_stations, num_src, status);
+        oskar_jones_set_size(d->K, num_stations, num_src, status);
+    }
+    oskar_jones_set_size(d->E, num_beam_stations(d->tel), num_src, status);
 
     /* Evaluate station beam (Jones E: may be matrix). */
     oskar_timer_resume(d->tmr_E);
@@ -996,21 +1304,7 @@ static void sim_baselines(oskar_Interferometer* h, DeviceData* d,
             gast, frequency, d->station_work, time_index_simulation, status);
     oskar_timer_pause(d->tmr_E);
 
-#if 0
-    /* Evaluate ionospheric phase (Jones Z: scalar) and join with Jones E.
-     * NOTE this is currently only a CPU implementation. */
-    if (d->Z)
-    {
-        oskar_evaluate_jones_Z(d->Z, num_src, sky, d->tel,
-                &settings->ionosphere, gast, frequency, &(d->workJonesZ),
-                status);
-        oskar_timer_resume(d->tmr_join);
-        oskar_jones_join(d->E, d->Z, d->E, status);
-        oskar_timer_pause(d->tmr_join);
-    }
-#endif
-
-    /* Evaluate parallactic angle (Jones R: matrix), and join with Jones Z*E.
+    /* Evaluate parallactic angle (Jones R: matrix), and join with Jones E.
      * TODO Move this into station beam evaluation instead. */
     if (d->R)
     {
@@ -1023,6 +1317,22 @@ static void sim_baselines(oskar_Interferometer* h, DeviceData* d,
         oskar_timer_pause(d->tmr_join);
     }
 
+    /* Correlate the station beams directly, evaluating Jones K for blocks
+     * of stations and sources inside the correlator. */
+    if (fuse_K)
+    {
+        oskar_timer_resume(d->tmr_correlate);
+        oskar_cross_correlate_beam(num_src, d->R ? d->R : d->E, sky, d->tel,
+                d->u, d->v, d->w, gast, frequency, h->source_min_jy,
+                h->source_max_jy, h->ignore_w_components,
+                num_baselines * (num_channels * time_index_block +
+                        channel_index_block),
+                oskar_vis_block_cross_correlations(d->vis_block),
+                d->xcorr_work, status);
+        oskar_timer_pause(d->tmr_correlate);
+        return;
+    }
+
     /* Evaluate interferometer phase (Jones K: scalar). */
     oskar_timer_resume(d->tmr_K);
     oskar_evaluate_jones_K(d->K, num_src, oskar_sky_l_const(sky),
@@ -1030,9 +1340,33 @@ static void sim_baselines(oskar_Interferometer* h, DeviceData* d,
             frequency, oskar_sky_I_const(sky),
             h->source_min_jy, h->source_max_jy, h->ignore_w_components,
             status);
+    if (num_channels_batch > 1)
+    {
+        /* Phase increment between channels, for the correlator. */
+        oskar_jones_set_size(d->K_inc, num_stations, num_src, status);
+        oskar_evaluate_jones_K(d->K_inc, num_src, oskar_sky_l_const(sky),
+                oskar_sky_m_const(sky), oskar_sky_n_const(sky),
+                d->u, d->v, d->w, h->freq_inc_hz, oskar_sky_I_const(sky),
+                h->source_min_jy, h->source_max_jy, h->ignore_w_components,
+                status);
+    }
     oskar_timer_pause(d->tmr_K);
 
-    /* Join Jones K with Jones Z*E. */
+    /* Evaluate ionospheric phase (Jones Z: scalar) from the TEC values
+     * cached for this time, and join with Jones K.
+     * (Jones E may be shared by all stations, so Z is joined with K
+     * instead: both are scalars, so the order does not matter.) */
+    if (d->Z)
+    {
+        oskar_timer_resume(d->tmr_Z);
+        oskar_evaluate_jones_Z(d->Z, d->workJonesZ, frequency, status);
+        oskar_timer_pause(d->tmr_Z);
+        oskar_timer_resume(d->tmr_join);
+        oskar_jones_join(d->K, d->K, d->Z, status);
+        oskar_timer_pause(d->tmr_join);
+    }
+
+    /* Join Jones Z*K with Jones E. */
     oskar_timer_resume(d->tmr_join);
     oskar_jones_join(d->J, d->K, d->R ? d->R : d->E, status);
     oskar_timer_pause(d->tmr_join);
@@ -1041,16 +1375,42 @@ static void sim_baselines(oskar_Interferometer* h, DeviceData* d,
     const int offset = num_channels * time_index_block + channel_index_block;
     oskar_timer_resume(d->tmr_correlate);
 
-    /* Auto-correlate for this time and channel. */
+    /* Auto-correlate for this time and channel.
+     * Jones K cancels here, so the Jones matrices are the same for all
+     * channels in a batch: only the source fluxes differ. */
     if (oskar_vis_block_has_auto_correlations(d->vis_block))
-        oskar_auto_correlate(num_src, d->J, sky, num_stations * offset,
-                oskar_vis_block_auto_correlations(d->vis_block), status);
+    {
+        int c;
+        for (c = 0; c < num_channels_batch; ++c)
+        {
+            if (c > 0)
+                oskar_sky_set_flux_alias(sky, d->flux_I, d->flux_Q,
+                        d->flux_U, d->flux_V, (size_t) c * num_src, status);
+            oskar_auto_correlate(num_src, d->J, sky,
+                    num_stations * (offset + c),
+                    oskar_vis_block_auto_correlations(d->vis_block), status);
+        }
+        if (num_channels_batch > 1)
+            oskar_sky_set_flux_alias(sky, d->flux_I, d->flux_Q,
+                    d->flux_U, d->flux_V, 0, status);
+    }
 
-    /* Cross-correlate for this time and channel. */
+    /* Cross-correlate for this time and channel, or for all channels in
+     * the batch using the fluxes evaluated for them. */
     if (oskar_vis_block_has_cross_correlations(d->vis_block))
-        oskar_cross_correlate(num_src, d->J, sky, d->tel, d->u, d->v, d->w,
-                gast, frequency, num_baselines * offset,
-                oskar_vis_block_cross_correlations(d->vis_block), status);
+    {
+        if (num_channels_batch > 1)
+            oskar_cross_correlate_channels(num_src, num_channels_batch,
+                    d->J, d->K_inc, sky, d->flux_I, d->flux_Q, d->flux_U,
+                    d->flux_V, d->tel, d->u, d->v, d->w, gast, frequency,
+                    h->freq_inc_hz, num_baselines * offset, num_baselines,
+                    oskar_vis_block_cross_correlations(d->vis_block), status);
+        else
+            oskar_cross_correlate_ws(num_src, d->J, sky, d->tel,
+                    d->u, d->v, d->w, gast, frequency, num_baselines * offset,
+                    oskar_vis_block_cross_correlations(d->vis_block),
+                    d->xcorr_work, status);
+    }
     oskar_timer_pause(d->tmr_correlate);
 }
 
@@ -1125,7 +1485,7 @@ static void set_up_vis_header(oskar_Interferometer* h, int* status)
 
 static void* init_device(void* arg)
 {
-    int dev_loc, vistype, *status;
+    int j, dev_loc, vistype, *status;
     ThreadArgs* a = (ThreadArgs*)arg;
     oskar_Interferometer* h = a->h;
     DeviceData* d = a->d;
@@ -1159,6 +1519,7 @@ static void* init_device(void* arg)
         d->tmr_clip      = oskar_timer_create(dev_loc);
         d->tmr_E         = oskar_timer_create(dev_loc);
         d->tmr_K         = oskar_timer_create(dev_loc);
+        d->tmr_Z         = oskar_timer_create(dev_loc);
         d->tmr_join      = oskar_timer_create(dev_loc);
         d->tmr_correlate = oskar_timer_create(dev_loc);
     }
@@ -1168,14 +1529,13 @@ static void* init_device(void* arg)
     {
         d->vis_block = oskar_vis_block_create_from_header(dev_loc,
                 h->header, status);
-        d->vis_block_cpu[0] = oskar_vis_block_create_from_header(OSKAR_CPU,
-                h->header, status);
-        d->vis_block_cpu[1] = oskar_vis_block_create_from_header(OSKAR_CPU,
-                h->header, status);
+        for (j = 0; j < NUM_VIS_BUFFERS; ++j)
+            d->vis_block_cpu[j] = oskar_vis_block_create_from_header(
+                    OSKAR_CPU, h->header, status);
     }
     oskar_vis_block_clear(d->vis_block, status);
-    oskar_vis_block_clear(d->vis_block_cpu[0], status);
-    oskar_vis_block_clear(d->vis_block_cpu[1], status);
+    for (j = 0; j < NUM_VIS_BUFFERS; ++j)
+        oskar_vis_block_clear(d->vis_block_cpu[j], status);
 
     /* Device scratch memory. */
     if (!d->tel)
@@ -1185,17 +1545,34 @@ static void* init_device(void* arg)
         d->w = oskar_mem_create(h->prec, dev_loc, num_stations, status);
         d->chunk = oskar_sky_create(h->prec, dev_loc, num_src, status);
         d->chunk_clip = oskar_sky_create(h->prec, dev_loc, num_src, status);
+        d->flux_I = oskar_mem_create(h->prec, dev_loc, 0, status);
+        d->flux_Q = oskar_mem_create(h->prec, dev_loc, 0, status);
+        d->flux_U = oskar_mem_create(h->prec, dev_loc, 0, status);
+        d->flux_V = oskar_mem_create(h->prec, dev_loc, 0, status);
         d->tel = oskar_telescope_create_copy(h->tel, dev_loc, status);
-        d->J = oskar_jones_create(vistype, dev_loc, num_stations, num_src,
-                status);
+        d->fuse_K = fuse_jones_K(h, dev_loc);
+        d->J = oskar_jones_create(vistype, dev_loc, num_stations,
+                d->fuse_K ? 0 : num_src, status);
         d->R = oskar_type_is_matrix(vistype) ? oskar_jones_create(vistype,
-                dev_loc, num_stations, num_src, status) : 0;
-        d->E = oskar_jones_create(vistype, dev_loc, num_stations, num_src,
-                status);
-        d->K = oskar_jones_create(complx, dev_loc, num_stations, num_src,
-                status);
-        d->Z = 0;
+                dev_loc, num_beam_stations(h->tel), num_src, status) : 0;
+        d->E = oskar_jones_create(vistype, dev_loc, num_beam_stations(h->tel),
+                num_src, status);
+        d->K = oskar_jones_create(complx, dev_loc, num_stations,
+                d->fuse_K ? 0 : num_src, status);
+        d->K_inc = batch_channels(h, dev_loc, 0) > 1 ?
+                oskar_jones_create(complx, dev_loc, num_stations, num_src,
+                        status) : 0;
         d->station_work = oskar_station_work_create(h->prec, dev_loc, status);
+        if (dev_loc == OSKAR_CPU)
+            d->xcorr_work = oskar_mem_create(h->prec, dev_loc, 0, status);
+    }
+
+    /* Ionospheric phase (Jones Z), if required. */
+    if (h->ionosphere.enable && !d->Z)
+    {
+        d->Z = oskar_jones_create(complx, dev_loc, num_stations, num_src,
+                status);
+        d->workJonesZ = oskar_work_jones_z_create(h->prec, dev_loc, status);
     }
     return 0;
 }
@@ -1236,9 +1613,50 @@ static void set_up_device_data(oskar_Interferometer* h, int* status)
 }
 
 
+static void add_vis_block(oskar_VisBlock* dst, const oskar_VisBlock* src,
+        int* status)
+{
+    oskar_Mem *xc, *ac;
+    xc = oskar_vis_block_cross_correlations(dst);
+    ac = oskar_vis_block_auto_correlations(dst);
+    if (oskar_vis_block_has_cross_correlations(src))
+        oskar_mem_add(xc, xc, oskar_vis_block_cross_correlations_const(src),
+                0, 0, 0, oskar_mem_length(xc), status);
+    if (oskar_vis_block_has_auto_correlations(src))
+        oskar_mem_add(ac, ac, oskar_vis_block_auto_correlations_const(src),
+                0, 0, 0, oskar_mem_length(ac), status);
+}
+
+
+static void reduce_vis_block(oskar_Interferometer* h, int device_id,
+        int i_active, int* status)
+{
+    int i = device_id, step;
+    if (h->coords_only) return;
+
+    /* Blocks are summed pairwise in a tree, with the result in device 0.
+     * At each level, the subtree rooted at i + step is added into the one
+     * rooted at i, by whichever of the two devices finishes last.
+     * The count for the pair is kept by the device at the right of it. */
+    for (step = 1; step < h->num_devices; step *= 2)
+    {
+        int arrived;
+        const int left = i - i % (2 * step), right = left + step;
+        if (right >= h->num_devices) continue;
+        oskar_condition_lock(h->block_done);
+        arrived = (h->d[right].reduce_count[i_active])++;
+        oskar_condition_unlock(h->block_done);
+        if (arrived == 0) return;
+        add_vis_block(h->d[left].vis_block_cpu[i_active],
+                h->d[right].vis_block_cpu[i_active], status);
+        i = left;
+    }
+}
+
+
 static void free_device_data(oskar_Interferometer* h, int* status)
 {
-    int i;
+    int i, j;
     if (!h->d) return;
     for (i = 0; i < h->num_devices; ++i)
     {
@@ -1251,22 +1669,31 @@ static void free_device_data(oskar_Interferometer* h, int* status)
         oskar_timer_free(d->tmr_clip);
         oskar_timer_free(d->tmr_E);
         oskar_timer_free(d->tmr_K);
+        oskar_timer_free(d->tmr_Z);
         oskar_timer_free(d->tmr_join);
         oskar_timer_free(d->tmr_correlate);
-        oskar_vis_block_free(d->vis_block_cpu[0], status);
-        oskar_vis_block_free(d->vis_block_cpu[1], status);
+        for (j = 0; j < NUM_VIS_BUFFERS; ++j)
+            oskar_vis_block_free(d->vis_block_cpu[j], status);
         oskar_vis_block_free(d->vis_block, status);
         oskar_mem_free(d->u, status);
         oskar_mem_free(d->v, status);
         oskar_mem_free(d->w, status);
         oskar_sky_free(d->chunk, status);
         oskar_sky_free(d->chunk_clip, status);
+        oskar_mem_free(d->flux_I, status);
+        oskar_mem_free(d->flux_Q, status);
+        oskar_mem_free(d->flux_U, status);
+        oskar_mem_free(d->flux_V, status);
         oskar_telescope_free(d->tel, status);
         oskar_station_work_free(d->station_work, status);
+        oskar_mem_free(d->xcorr_work, status);
         oskar_jones_free(d->J, status);
         oskar_jones_free(d->E, status);
         oskar_jones_free(d->K, status);
+        oskar_jones_free(d->K_inc, status);
         oskar_jones_free(d->R, status);
+        oskar_jones_free(d->Z, status);
+        oskar_work_jones_z_free(d->workJonesZ, status);
         memset(d, 0, sizeof(DeviceData));
     }
 }
@@ -1276,7 +1703,8 @@ static void record_timing(oskar_Interferometer* h)
 {
     /* Obtain component times. */
     int i;
-    double t_copy = 0., t_clip = 0., t_E = 0., t_K = 0., t_join = 0.;
+    double t_copy = 0., t_clip = 0., t_E = 0., t_K = 0., t_Z = 0.;
+    double t_join = 0.;
     double t_correlate = 0., t_compute = 0., t_components = 0.;
     double *compute_times;
     compute_times = (double*) calloc(h->num_devices, sizeof(double));
@@ -1288,10 +1716,11 @@ static void record_timing(oskar_Interferometer* h)
         t_join += oskar_timer_elapsed(h->d[i].tmr_join);
         t_E += oskar_timer_elapsed(h->d[i].tmr_E);
         t_K += oskar_timer_elapsed(h->d[i].tmr_K);
+        t_Z += oskar_timer_elapsed(h->d[i].tmr_Z);
         t_correlate += oskar_timer_elapsed(h->d[i].tmr_correlate);
         t_compute += compute_times[i];
     }
-    t_components = t_copy + t_clip + t_E + t_K + t_join + t_correlate;
+    t_components = t_copy + t_clip + t_E + t_K + t_Z + t_join + t_correlate;
 
     /* Record time taken. */
     oskar_log_section('M', "Simulation timing");
@@ -1311,6 +1740,9 @@ static void record_timing(oskar_Interferometer* h)
             (t_E / t_compute) * 100.0);
     oskar_log_value('M', 1, "Jones K", "%4.1f%%",
             (t_K / t_compute) * 100.0);
+    if (h->ionosphere.enable)
+        oskar_log_value('M', 1, "Jones Z", "%4.1f%%",
+                (t_Z / t_compute) * 100.0);
     oskar_log_value('M', 1, "Jones join", "%4.1f%%",
             (t_join / t_compute) * 100.0);
     oskar_log_value('M', 1, "Jones correlate", "%4.1f%%",
@@ -1321,6 +1753,133 @@ static void record_timing(oskar_Interferometer* h)
 }
 
 
+static void free_sky_chunks(oskar_Interferometer* h, int* status)
+{
+    int i;
+    for (i = 0; i < h->num_sky_chunks; ++i)
+        oskar_sky_free(h->sky_chunks[i], status);
+    free(h->sky_chunks);
+    free(h->sky_chunk_caps);
+    h->sky_chunks = 0;
+    h->sky_chunk_caps = 0;
+    h->num_sky_chunks = 0;
+    h->num_sources_total = 0;
+
+    /* Chunks may alias the file, so it must be closed after them. */
+    oskar_binary_free(h->sky_file);
+    h->sky_file = 0;
+}
+
+
+static void free_ionosphere(oskar_SettingsIonosphere* ionosphere)
+{
+    int i;
+    for (i = 0; i < ionosphere->num_TID_screens; ++i)
+    {
+        free(ionosphere->TID[i].amp);
+        free(ionosphere->TID[i].speed);
+        free(ionosphere->TID[i].theta);
+        free(ionosphere->TID[i].wavelength);
+    }
+    free(ionosphere->TID);
+    memset(ionosphere, 0, sizeof(oskar_SettingsIonosphere));
+}
+
+
+static int num_beam_stations(const oskar_Telescope* tel)
+{
+    /* A single station beam is shared if all stations are identical. */
+    return (oskar_telescope_allow_station_beam_duplication(tel) &&
+            oskar_telescope_identical_stations(tel)) ?
+                    1 : oskar_telescope_num_stations(tel);
+}
+
+
+static int batch_channels(const oskar_Interferometer* h, int location,
+        const char** reason)
+{
+    int i;
+    const char* r = 0;
+    const oskar_Telescope* tel = h->tel;
+
+    /* Returns the number of channels that can be correlated together in
+     * one pass over the Jones matrices, or 1 if each channel must be done
+     * separately. This is possible only on the CPU, and only if Jones K is
+     * the only term that depends on frequency: no ionosphere, and no source
+     * flux filter (which could select different sources in each channel).
+     * Station beams must be isotropic, unless the beam evaluated for the
+     * first channel of a batch is allowed to be used for the rest. */
+    if (h->num_channels < 2)
+        r = "there is only one channel";
+    else if (location != OSKAR_CPU)
+        r = "batches of channels are only correlated on the CPU";
+    else if (h->correlation_type == 'A')
+        r = "no cross-correlations are required";
+    else if (h->ionosphere.enable)
+        r = "the ionospheric phase depends on frequency";
+    else if (h->source_min_jy > -DBL_MAX || h->source_max_jy < DBL_MAX)
+        r = "a source flux filter is set";
+    if (r)
+    {
+        if (reason) *reason = r;
+        return 1;
+    }
+    for (i = 0; i < oskar_telescope_num_stations(tel); ++i)
+    {
+        if (oskar_station_type(oskar_telescope_station_const(tel, i)) !=
+                OSKAR_STATION_TYPE_ISOTROPIC)
+        {
+            if (h->max_channels_per_beam > 1)
+            {
+                if (reason) *reason = "station beams are shared by "
+                        "neighbouring channels";
+                return h->max_channels_per_beam < MAX_CHANNEL_BATCH ?
+                        h->max_channels_per_beam : MAX_CHANNEL_BATCH;
+            }
+            if (reason) *reason = "station beams depend on frequency";
+            return 1;
+        }
+    }
+    if (reason) *reason = "only the interferometer phase depends on frequency";
+    return MAX_CHANNEL_BATCH;
+}
+
+
+static int fuse_jones_K(const oskar_Interferometer* h, int location)
+{
+    /* Jones K can be evaluated inside the correlator only on the CPU,
+     * if it does not need to be joined with the ionospheric phase,
+     * and if the joined Jones matrices are not needed for
+     * auto-correlations or for correlating batches of channels. */
+    return location == OSKAR_CPU && !h->ionosphere.enable &&
+            h->correlation_type == 'C' && batch_channels(h, location, 0) < 2;
+}
+
+
+/* Returns true if no source has a spectral index or rotation measure. */
+static int flat_spectrum(const oskar_Sky* sky, int* status)
+{
+    int i;
+    const int num_sources = oskar_sky_num_sources(sky);
+    const oskar_Mem* spix = oskar_sky_spectral_index_const(sky);
+    const oskar_Mem* rm = oskar_sky_rotation_measure_rad_const(sky);
+    if (oskar_sky_precision(sky) == OSKAR_DOUBLE)
+    {
+        const double *spix_ = oskar_mem_double_const(spix, status);
+        const double *rm_ = oskar_mem_double_const(rm, status);
+        for (i = 0; i < num_sources; ++i)
+            if (spix_[i] != 0.0 || rm_[i] != 0.0) return 0;
+    }
+    else
+    {
+        const float *spix_ = oskar_mem_float_const(spix, status);
+        const float *rm_ = oskar_mem_float_const(rm, status);
+        for (i = 0; i < num_sources; ++i)
+            if (spix_[i] != 0.0f || rm_[i] != 0.0f) return 0;
+    }
+    return 1;
+}
+
 static unsigned int disp_width(unsigned int v)
 {
     return (v >= 100000u) ? 6 : (v >= 10000u) ? 5 : (v >= 1000u) ? 4 :
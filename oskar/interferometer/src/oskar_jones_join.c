@@ -47,16 +47,34 @@ void oskar_jones_join(oskar_Jones* j3, oskar_Jones* j1, const oskar_Jones* j2,
     const int n_stations2 = j2->num_stations;
     const int n_stations3 = j3->num_stations;
 
-    /* Check the data dimensions. */
+    /* Check the data dimensions.
+     * Inputs with only one station are shared by all stations. */
     if (n_sources1 != n_sources2 || n_sources1 != n_sources3)
         *status = OSKAR_ERR_DIMENSION_MISMATCH;
-    if (n_stations1 != n_stations2 || n_stations1 != n_stations3)
+    if ((n_stations1 != n_stations3 && n_stations1 != 1) ||
+            (n_stations2 != n_stations3 && n_stations2 != 1))
         *status = OSKAR_ERR_DIMENSION_MISMATCH;
+    if (*status) return;
 
     /* Multiply the array elements. */
-    const size_t num_elements = n_sources1 * n_stations1;
-    oskar_mem_multiply(j3->data, j1->data, j2->data,
-            0, 0, 0, num_elements, status);
+    if (n_stations1 == n_stations3 && n_stations2 == n_stations3)
+    {
+        const size_t num_elements = n_sources1 * n_stations1;
+        oskar_mem_multiply(j3->data, j1->data, j2->data,
+                0, 0, 0, num_elements, status);
+    }
+    else
+    {
+        int i;
+        for (i = 0; i < n_stations3; ++i)
+        {
+            const size_t offset = (size_t)i * n_sources1;
+            oskar_mem_multiply(j3->data, j1->data, j2->data, offset,
+                    n_stations1 == 1 ? 0 : offset,
+                    n_stations2 == 1 ? 0 : offset,
+                    (size_t)n_sources1, status);
+        }
+    }
 }
 
 #ifdef __cplusplus
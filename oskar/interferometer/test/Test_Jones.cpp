@@ -195,6 +195,55 @@ void t_join_in_place(int in_type1A, int in_type2A, int in_loc1A, int in_loc2A,
     ASSERT_EQ(0, status) << oskar_get_error_string(status);
 }
 
+static void t_join_shared(int out_type, int in_type1, int in_type2,
+        int location)
+{
+    int status = 0;
+    oskar_Jones *in1, *in2_shared, *in2_full, *outA, *outB;
+
+    // Create inputs, with the second one shared by all stations.
+    in1 = oskar_jones_create(in_type1, location, stations, sources, &status);
+    in2_shared = oskar_jones_create(in_type2, location, 1, sources, &status);
+    in2_full = oskar_jones_create(in_type2, location, stations, sources,
+            &status);
+    srand(2);
+    oskar_mem_random_range(oskar_jones_mem(in1), 1.0, 2.0, &status);
+    oskar_mem_random_range(oskar_jones_mem(in2_shared), 1.0, 2.0, &status);
+    for (int i = 0; i < stations; ++i)
+        oskar_mem_copy_contents(oskar_jones_mem(in2_full),
+                oskar_jones_mem(in2_shared), (size_t)(i * sources), 0,
+                (size_t)sources, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Join using shared and full inputs, in both orders.
+    outA = oskar_jones_create(out_type, location, stations, sources, &status);
+    outB = oskar_jones_create(out_type, location, stations, sources, &status);
+    oskar_jones_join(outA, in1, in2_shared, &status);
+    oskar_jones_join(outB, in1, in2_full, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    check_values(oskar_jones_mem(outA), oskar_jones_mem(outB));
+    if (in_type1 == in_type2)
+    {
+        oskar_jones_join(outA, in2_shared, in1, &status);
+        oskar_jones_join(outB, in2_full, in1, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        check_values(oskar_jones_mem(outA), oskar_jones_mem(outB));
+    }
+
+    // Check that a shared output is rejected.
+    oskar_jones_join(in2_shared, in2_shared, in1, &status);
+    EXPECT_EQ((int)OSKAR_ERR_DIMENSION_MISMATCH, status);
+    status = 0;
+
+    // Free memory.
+    oskar_jones_free(in1, &status);
+    oskar_jones_free(in2_shared, &status);
+    oskar_jones_free(in2_full, &status);
+    oskar_jones_free(outA, &status);
+    oskar_jones_free(outB, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
+
 static void test_ones(int precision, int location)
 {
     oskar_Jones *jones, *temp = 0, *j_ptr;
@@ -914,3 +963,17 @@ TEST(Jones, set_ones_doubleCPU)
     test_ones(OSKAR_DOUBLE, OSKAR_CPU);
 }
 
+TEST(Jones, join_shared_scal_scal_scal_singleCPU)
+{
+    t_join_shared(SC, SC, SC, CPU);
+}
+
+TEST(Jones, join_shared_matx_matx_matx_doubleCPU)
+{
+    t_join_shared(DCM, DCM, DCM, CPU);
+}
+
+TEST(Jones, join_shared_matx_scal_matx_doubleCPU)
+{
+    t_join_shared(DCM, DC, DCM, CPU);
+}
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "interferometer/oskar_evaluate_jones_Z.h"
+#include "math/oskar_cmath.h"
+#include "sky/oskar_evaluate_tec_tid.h"
+#include "utility/oskar_get_error_string.h"
+
+#include <cstdlib>
+#include <cstring>
+
+TEST(evaluate_jones_Z, tec_screen)
+{
+    int status = 0, type = OSKAR_DOUBLE;
+    int num_stations = 30, num_sources = 2000;
+    const double deg2rad = M_PI / 180.0;
+    const double lon0 = 116.7 * deg2rad, lat0 = -26.7 * deg2rad;
+    const double gast = 2.0 * M_PI - lon0; // Zenith at RA = 0.
+
+    // Create a telescope model.
+    oskar_Telescope* tel = oskar_telescope_create(type, OSKAR_CPU, 0, &status);
+    oskar_telescope_resize(tel, num_stations, &status);
+    for (int i = 0; i < num_stations; ++i)
+        oskar_station_set_position(oskar_telescope_station(tel, i),
+                lon0 + 0.002 * (i % 6) * deg2rad,
+                lat0 + 0.002 * (i / 6) * deg2rad, 0.0);
+
+    // Create source positions around the zenith.
+    oskar_Mem* ra = oskar_mem_create(type, OSKAR_CPU, num_sources, &status);
+    oskar_Mem* dec = oskar_mem_create(type, OSKAR_CPU, num_sources, &status);
+    srand(1);
+    for (int i = 0; i < num_sources; ++i)
+    {
+        oskar_mem_double(ra, &status)[i] =
+                (40.0 * rand() / RAND_MAX - 20.0) * deg2rad;
+        oskar_mem_double(dec, &status)[i] = lat0 +
+                (40.0 * rand() / RAND_MAX - 20.0) * deg2rad;
+    }
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Set up a TID screen with two components.
+    double amp[] = {0.2, 0.1}, speed[] = {200.0, 300.0};
+    double theta[] = {30.0, 120.0}, wavelength[] = {50.0, 80.0};
+    oskar_SettingsTIDscreen TID;
+    TID.height_km = 300.0;
+    TID.num_components = 2;
+    TID.amp = amp;
+    TID.speed = speed;
+    TID.theta = theta;
+    TID.wavelength = wavelength;
+    oskar_SettingsIonosphere settings;
+    memset(&settings, 0, sizeof(oskar_SettingsIonosphere));
+    settings.enable = 1;
+    settings.min_elevation = 75.0 * deg2rad;
+    settings.TEC0 = 1.0;
+    settings.num_TID_screens = 1;
+    settings.TID = &TID;
+
+    // Evaluate TEC at the pierce points using the tabulated screen.
+    oskar_WorkJonesZ* work = oskar_work_jones_z_create(type, OSKAR_CPU,
+            &status);
+    oskar_evaluate_jones_Z_tec(work, num_sources, ra, dec, tel, &settings,
+            gast, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    ASSERT_EQ(num_stations, work->num_stations);
+    ASSERT_EQ(num_sources, work->num_sources);
+
+    // Evaluate TEC directly at the same pierce points.
+    const int num_pp = num_stations * num_sources;
+    oskar_Mem* tec = oskar_mem_create(type, OSKAR_CPU, num_pp, &status);
+    oskar_evaluate_tec_tid(tec, num_pp, work->pp_lon, work->pp_lat,
+            work->pp_rel_path, settings.TEC0, &TID, gast);
+
+    // Evaluate Jones Z and compare.
+    const double freq_hz = 100e6, wavelength_m = 299792458.0 / freq_hz;
+    oskar_Jones* Z = oskar_jones_create(type | OSKAR_COMPLEX, OSKAR_CPU,
+            num_stations, num_sources, &status);
+    oskar_evaluate_jones_Z(Z, work, freq_hz, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    const double* sec = oskar_mem_double_const(work->pp_rel_path, &status);
+    const double* tec_screen = oskar_mem_double_const(work->total_TEC, &status);
+    const double* tec_direct = oskar_mem_double_const(tec, &status);
+    const double2* z = oskar_mem_double2_const(oskar_jones_mem(Z), &status);
+    int num_below = 0;
+    for (int i = 0; i < num_pp; ++i)
+    {
+        if (sec[i] == 0.0)
+        {
+            ++num_below;
+            EXPECT_DOUBLE_EQ(1.0, z[i].x);
+            EXPECT_DOUBLE_EQ(0.0, z[i].y);
+            continue;
+        }
+        EXPECT_NEAR(tec_direct[i], tec_screen[i], 1e-5);
+        const double arg = wavelength_m * 25.0 * tec_direct[i];
+        EXPECT_NEAR(cos(arg), z[i].x, 1e-3);
+        EXPECT_NEAR(sin(arg), z[i].y, 1e-3);
+    }
+    EXPECT_GT(num_below, 0);
+    EXPECT_LT(num_below, num_pp);
+
+    // Clean up.
+    oskar_telescope_free(tel, &status);
+    oskar_mem_free(ra, &status);
+    oskar_mem_free(dec, &status);
+    oskar_mem_free(tec, &status);
+    oskar_jones_free(Z, &status);
+    oskar_work_jones_z_free(work, &status);
+}
@@ -194,9 +194,50 @@ void oskar_log_value(char priority, int depth,
 OSKAR_EXPORT
 void oskar_log_warning(const char* format, ...);
 
+/**
+ * @brief Returns true if log entries are written asynchronously.
+ *
+ * @details
+ * Returns true if log entries are written asynchronously.
+ */
+OSKAR_EXPORT
+int oskar_log_async(void);
+
+/**
+ * @brief Waits until all queued log entries have been written.
+ *
+ * @details
+ * If log entries are being written asynchronously, this function
+ * blocks until all entries queued so far have been written.
+ * Otherwise, it returns immediately.
+ */
+OSKAR_EXPORT
+void oskar_log_flush(void);
+
 OSKAR_EXPORT
 oskar_Log* oskar_log_handle(void);
 
+/**
+ * @brief Sets whether log entries are written asynchronously.
+ *
+ * @details
+ * If enabled, log entries are formatted by the calling thread and
+ * placed in a queue, which is drained by a background writer thread.
+ * Log functions may then be called from multiple threads without
+ * further locking, and do not wait for terminal or file output,
+ * except for error messages, which are always written before the
+ * call returns. Nested status messages (with priority 'S' and
+ * depth > 0) are written to the terminal at most a few times per second.
+ *
+ * Disabling asynchronous output writes any queued entries and stops
+ * the writer thread. This function must not be called while other
+ * threads are writing to the log.
+ *
+ * @param[in] value If true, write log entries asynchronously.
+ */
+OSKAR_EXPORT
+void oskar_log_set_async(int value);
+
 OSKAR_EXPORT
 void oskar_log_set_keep_file(int value);
 
@@ -31,6 +31,9 @@
 
 #include <stdio.h>
 
+struct oskar_LogQueue;
+typedef struct oskar_LogQueue oskar_LogQueue;
+
 struct oskar_Log
 {
     int keep_file;                    /* If true, log file will be kept. */
@@ -39,6 +42,7 @@ struct oskar_Log
     FILE* file;                       /* Log file handle. */
     char* name;                       /* Log file pathname. */
     double timestamp_start;           /* Timestamp of log creation. */
+    oskar_LogQueue* queue;            /* Entry queue, if asynchronous. */
 };
 
 #ifndef OSKAR_LOG_TYPEDEF_
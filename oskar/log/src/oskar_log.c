@@ -28,6 +28,7 @@
 
 #include "log/private_log.h"
 #include "log/oskar_log.h"
+#include "utility/oskar_thread.h"
 
 #include <string.h>
 #include <stdlib.h>
@@ -46,8 +47,38 @@ extern "C" {
 
 #define WRITE_TIMESTAMP 0
 
-static void print_entry(FILE* stream, char priority, char code, int depth,
-        const char* prefix, int width, const char* format, va_list args);
+/* Number of entries in the asynchronous queue (must be a power of 2). */
+#define QUEUE_LENGTH 1024
+
+/* Size of the buffer for each entry. Longer entries are allocated. */
+#define ENTRY_SIZE 256
+
+/* Minimum interval between nested status lines in asynchronous mode. */
+#define STATUS_INTERVAL_SEC 0.25
+
+typedef struct
+{
+    FILE* stream;
+    char* text; /* Points to buffer, unless the entry was too long. */
+    char buffer[ENTRY_SIZE];
+} LogEntry;
+
+/* Entries are added at the head of the ring buffer by the logging threads,
+ * and written from the tail by the writer thread. The counters only ever
+ * increase, so (head - tail) is the number of entries in the queue. */
+struct oskar_LogQueue
+{
+    oskar_ConditionVar* var;
+    oskar_Thread* writer;
+    unsigned int head, tail;
+    int stop;
+    double last_status;
+    LogEntry entries[QUEUE_LENGTH];
+};
+
+static int format_entry(char* buf, size_t size, char priority, char code,
+        int depth, const char* prefix, int width, const char* format,
+        va_list args);
 static int log_priority_level(char code);
 static int should_print_term_entry(char priority);
 static int should_print_file_entry(char priority);
@@ -55,7 +86,7 @@ static char get_entry_code(char priority);
 static void write_log(oskar_Log* log, FILE* stream, char priority, char code,
         int depth, const char* prefix, const char* format, va_list args);
 
-static oskar_Log log_ = {0, OSKAR_LOG_NONE, OSKAR_LOG_WARNING, 40, 0, 0, 0.0};
+static oskar_Log log_ = {0, OSKAR_LOG_NONE, OSKAR_LOG_WARNING, 40, 0, 0, 0.0, 0};
 
 
 double oskar_log_timestamp()
@@ -218,11 +249,90 @@ void oskar_log_warning(const char* format, ...)
 }
 
 
+int oskar_log_async(void)
+{
+    return log_.queue ? 1 : 0;
+}
+
+void oskar_log_flush(void)
+{
+    oskar_LogQueue* q = log_.queue;
+    if (!q) return;
+    oskar_condition_lock(q->var);
+    while (q->tail != q->head) oskar_condition_wait(q->var);
+    oskar_condition_unlock(q->var);
+}
+
 oskar_Log* oskar_log_handle(void)
 {
     return &log_;
 }
 
+static void* write_entries(void* arg)
+{
+    oskar_LogQueue* q = (oskar_LogQueue*) arg;
+    oskar_condition_lock(q->var);
+    for (;;)
+    {
+        unsigned int i, end;
+        int term = 0;
+        while (q->tail == q->head && !q->stop) oskar_condition_wait(q->var);
+        if (q->tail == q->head) break;
+
+        /* Write all entries queued so far without holding the lock.
+         * Their slots are not reused until the tail is moved past them. */
+        end = q->head;
+        oskar_condition_unlock(q->var);
+        for (i = q->tail; i != end; ++i)
+        {
+            LogEntry* e = &q->entries[i & (QUEUE_LENGTH - 1)];
+            fputs(e->text, e->stream);
+            if (e->stream == stdout || e->stream == stderr) term = 1;
+            if (e->text != e->buffer) free(e->text);
+        }
+        if (term)
+        {
+            fflush(stdout);
+            fflush(stderr);
+        }
+        oskar_condition_lock(q->var);
+        q->tail = end;
+        oskar_condition_notify_all(q->var);
+    }
+    oskar_condition_unlock(q->var);
+    return 0;
+}
+
+void oskar_log_set_async(int value)
+{
+    oskar_LogQueue* q = log_.queue;
+    if (value && !q)
+    {
+        q = (oskar_LogQueue*) calloc(1, sizeof(oskar_LogQueue));
+        if (!q) return;
+        q->var = oskar_condition_create();
+        if (!q->var)
+        {
+            free(q);
+            return;
+        }
+        q->writer = oskar_thread_create(write_entries, (void*)q, 0);
+        log_.queue = q;
+    }
+    else if (!value && q)
+    {
+        oskar_condition_lock(q->var);
+        q->stop = 1;
+        oskar_condition_notify_all(q->var);
+        oskar_condition_unlock(q->var);
+        oskar_thread_join(q->writer);
+        oskar_thread_free(q->writer);
+        oskar_condition_free(q->var);
+        free(q);
+        log_.queue = 0;
+    }
+}
+
 void oskar_log_set_keep_file(int value)
 {
     log_.keep_file = value;
@@ -244,27 +354,98 @@ void oskar_log_set_value_width(int value)
 }
 
 
+static int skip_status_entry(oskar_LogQueue* q)
+{
+    int skip = 0;
+    const double now = oskar_log_timestamp();
+    oskar_condition_lock(q->var);
+    if (now - q->last_status < STATUS_INTERVAL_SEC)
+        skip = 1;
+    else
+        q->last_status = now;
+    oskar_condition_unlock(q->var);
+    return skip;
+}
+
+/* Adds an entry to the queue, waiting if it is full.
+ * If the text was allocated, the writer thread takes ownership of it. */
+static void queue_entry(oskar_LogQueue* q, FILE* stream, char* text,
+        int allocated)
+{
+    LogEntry* e;
+    oskar_condition_lock(q->var);
+    while (q->head - q->tail == QUEUE_LENGTH) oskar_condition_wait(q->var);
+    e = &q->entries[q->head & (QUEUE_LENGTH - 1)];
+    e->stream = stream;
+    if (allocated)
+        e->text = text;
+    else
+    {
+        strcpy(e->buffer, text);
+        e->text = e->buffer;
+    }
+    q->head++;
+    oskar_condition_notify_all(q->var);
+    oskar_condition_unlock(q->var);
+}
+
 static void write_log(oskar_Log* log, FILE* stream, char priority, char code,
         int depth, const char* prefix, const char* format, va_list args)
 {
+    char buffer[ENTRY_SIZE], *text = buffer;
+    va_list args_copy;
+    FILE* out = 0;
+    int n;
+
     /* If both strings are NULL and not printing a line the entry is invalid */
     if (!format && !prefix && depth != OSKAR_LOG_LINE) return;
 
     const int width = log->value_width;
     const int is_file = (stream == stdout || stream == stderr) ? 0 : 1;
 
-    /* Write the entry to the terminal */
+    /* Check whether to write the entry to the terminal or the log file. */
     if (!is_file && should_print_term_entry(priority))
+        out = stream;
+    else if (is_file && log->file && should_print_file_entry(priority))
+        out = log->file;
+    if (!out) return;
+
+    /* Limit the rate of nested status updates on the terminal. */
+    if (log->queue && !is_file && depth > 0 &&
+            log_priority_level(priority) == OSKAR_LOG_STATUS &&
+            skip_status_entry(log->queue))
+        return;
+
+    /* Format the entry, allocating space for it if it is too long. */
+    if (depth != OSKAR_LOG_LINE) va_copy(args_copy, args);
+    n = format_entry(buffer, sizeof(buffer), priority, code, depth,
+            prefix, width, format, args);
+    if (n >= (int) sizeof(buffer))
     {
-        print_entry(stream, priority, code, depth, prefix, width, format, args);
-        fflush(stream);
+        text = (char*) malloc(n + 1);
+        if (text)
+            format_entry(text, n + 1, priority, code, depth,
+                    prefix, width, format, args_copy);
+        else
+        {
+            /* Write the truncated entry instead, keeping the newline. */
+            text = buffer;
+            buffer[sizeof(buffer) - 2] = '\n';
+        }
     }
+    if (depth != OSKAR_LOG_LINE) va_end(args_copy);
 
-    /* Write the entry to the log file */
-    else if (is_file && log->file && should_print_file_entry(priority))
+    /* Write the entry now, or queue it for the writer thread. */
+    if (log->queue)
     {
-        print_entry(log->file, priority, code, depth, prefix, width, format, args);
+        queue_entry(log->queue, out, text, text != buffer);
+        if (log_priority_level(priority) == OSKAR_LOG_ERROR)
+            oskar_log_flush();
+        return;
     }
+    fputs(text, out);
+    if (!is_file) fflush(out);
+    if (text != buffer) free(text);
 }
 
 static char get_entry_code(char priority)
@@ -285,9 +466,35 @@ static char get_entry_code(char priority)
     return ' ';
 }
 
-static void print_entry(FILE* stream, char priority, char code, int depth,
-        const char* prefix, int width, const char* format, va_list args)
+static void put_char(char* buf, size_t size, size_t* n, char c)
+{
+    if (*n + 1 < size) buf[*n] = c;
+    (*n)++;
+}
+
+static void put_vstr(char* buf, size_t size, size_t* n,
+        const char* format, va_list args)
+{
+    const int len = vsnprintf(*n < size ? buf + *n : 0,
+            *n < size ? size - *n : 0, format, args);
+    if (len > 0) *n += (size_t) len;
+}
+
+static void put_str(char* buf, size_t size, size_t* n, const char* format, ...)
 {
+    va_list args;
+    va_start(args, format);
+    put_vstr(buf, size, n, format, args);
+    va_end(args);
+}
+
+/* Formats the entry into the buffer, and returns the length of the entry.
+ * If the entry was truncated, the return value is at least the buffer size. */
+static int format_entry(char* buf, size_t size, char priority, char code,
+        int depth, const char* prefix, int width, const char* format,
+        va_list args)
+{
+    size_t n = 0;
     int i;
 
     /* Ensure code is a printable character. */
@@ -296,25 +503,29 @@ static void print_entry(FILE* stream, char priority, char code, int depth,
     /* Check if depth signifies a line. */
     if (depth == OSKAR_LOG_LINE)
     {
-        fprintf(stream, "%c|", get_entry_code(priority));
-        for (i = 0; i < 67; ++i) fprintf(stream, "%c", code);
-        fprintf(stream, "\n");
-        return;
+        put_char(buf, size, &n, get_entry_code(priority));
+        put_char(buf, size, &n, '|');
+        for (i = 0; i < 67; ++i) put_char(buf, size, &n, code);
+        put_char(buf, size, &n, '\n');
+        buf[n < size ? n : size - 1] = 0;
+        return (int) n;
     }
 
     /* Print the message code. */
-    fprintf(stream, "%c|", code);
+    put_char(buf, size, &n, code);
+    put_char(buf, size, &n, '|');
 
 #if WRITE_TIMESTAMP
     /* Print the timestamp. */
-    fprintf(stream, "%6.1f ", oskar_log_timestamp() - log_.timestamp_start);
+    put_str(buf, size, &n, "%6.1f ",
+            oskar_log_timestamp() - log_.timestamp_start);
 #endif
 
     /* Print leading whitespace and symbol for this depth. */
     if (depth >= 0) {
         char list_symbols[3] = {'+', '-', '*'};
-        for (i = 0; i < depth; ++i) fprintf(stream, "  ");
-        fprintf(stream, " %c ", list_symbols[depth % 3]);
+        for (i = 0; i < depth; ++i) put_str(buf, size, &n, "  ");
+        put_str(buf, size, &n, " %c ", list_symbols[depth % 3]);
     }
     else {
         /* Negative depth codes with special meaning */
@@ -324,8 +535,8 @@ static void print_entry(FILE* stream, char priority, char code, int depth,
         case OSKAR_LOG_SECTION:
             break;
         default: /* Negative depth means no symbol. */
-            fprintf(stream, " ");
-            for (i = 0; i < abs(depth); ++i) fprintf(stream, "  ");
+            put_char(buf, size, &n, ' ');
+            for (i = 0; i < abs(depth); ++i) put_str(buf, size, &n, "  ");
             break;
         }
     }
@@ -334,20 +545,22 @@ static void print_entry(FILE* stream, char priority, char code, int depth,
     if (prefix && *prefix > 0)
     {
         /* Print prefix. */
-        fprintf(stream, "%s", prefix);
+        put_str(buf, size, &n, "%s", prefix);
 
         /* Print trailing whitespace if format string is present. */
         if (format && *format > 0)
         {
-            const int n = abs(2 * depth + 4 + (int)strlen(prefix));
-            for (i = 0; i < width - n; ++i) fprintf(stream, " ");
-            if (depth != OSKAR_LOG_SECTION) fprintf(stream, ": ");
+            const int len = abs(2 * depth + 4 + (int)strlen(prefix));
+            for (i = 0; i < width - len; ++i) put_char(buf, size, &n, ' ');
+            if (depth != OSKAR_LOG_SECTION) put_str(buf, size, &n, ": ");
         }
     }
 
     /* Print main message from format string and arguments. */
-    if (format && *format > 0) vfprintf(stream, format, args);
-    fprintf(stream, "\n");
+    if (format && *format > 0) put_vstr(buf, size, &n, format, args);
+    put_char(buf, size, &n, '\n');
+    buf[n < size ? n : size - 1] = 0;
+    return (int) n;
 }
 
 /* Returns the enumerated priority level for the given message code.
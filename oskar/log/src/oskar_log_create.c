@@ -67,8 +67,9 @@ void oskar_log_create(int file_priority, int term_priority)
     char fname1[64], fname2[64], time_str[80], *current_dir = 0;
     int i = 0, n = 0;
 
-    /* Get handle to log. */
+    /* Get handle to log, and write anything still queued for the old file. */
     log = oskar_log_handle();
+    oskar_log_flush();
     if (log->file)
     {
         fclose(log->file);
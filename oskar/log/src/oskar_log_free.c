@@ -48,6 +48,7 @@ void oskar_log_free(void)
     strftime(time_str, sizeof(time_str), "%Y-%m-%d, %H:%M:%S (%Z)", timeinfo);
     oskar_log_section('M', "OSKAR-%s ending at %s.",
             OSKAR_VERSION_STR, time_str);
+    oskar_log_set_async(0);
     log = oskar_log_handle();
     if (log->file) fclose(log->file);
     log->file = 0;
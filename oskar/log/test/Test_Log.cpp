@@ -29,6 +29,7 @@
 #include <gtest/gtest.h>
 
 #include "log/oskar_log.h"
+#include "utility/oskar_thread.h"
 #include <cstdio>
 
 TEST(Log, oskar_log_message)
@@ -120,3 +121,38 @@ TEST(Log, special_methods)
     oskar_log_section('W', "This is a warning section");
     oskar_log_section('D', "This is a debug section");
 }
+
+static void* log_from_thread(void* arg)
+{
+    const int id = *((int*) arg);
+    for (int i = 0; i < 300; ++i)
+        oskar_log_message('D', 1, "Thread %d, entry %d", id, i);
+    for (int i = 0; i < 100; ++i)
+        oskar_log_message('S', 1, "Thread %d, status %d", id, i);
+    return 0;
+}
+
+TEST(Log, async)
+{
+    const int num_threads = 4;
+    int ids[num_threads];
+    oskar_Thread* threads[num_threads];
+    oskar_log_set_term_priority(OSKAR_LOG_DEBUG);
+    oskar_log_set_async(1);
+    ASSERT_EQ(1, oskar_log_async());
+    for (int i = 0; i < num_threads; ++i)
+    {
+        ids[i] = i;
+        threads[i] = oskar_thread_create(log_from_thread, (void*)&ids[i], 0);
+    }
+    for (int i = 0; i < num_threads; ++i)
+    {
+        oskar_thread_join(threads[i]);
+        oskar_thread_free(threads[i]);
+    }
+    oskar_log_warning("This is a warning");
+    oskar_log_flush();
+    oskar_log_set_async(0);
+    oskar_log_set_term_priority(OSKAR_LOG_WARNING);
+    ASSERT_EQ(0, oskar_log_async());
+}
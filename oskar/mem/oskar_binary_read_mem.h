@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2012-2014, The University of Oxford
+ * Copyright (c) 2012-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -83,6 +83,37 @@ void oskar_binary_read_mem_ext(oskar_Binary* handle, oskar_Mem* mem,
         const char* name_group, const char* name_tag, int user_index,
         int* status);
 
+/**
+ * @brief
+ * Returns an OSKAR memory block holding data from an OSKAR binary file.
+ *
+ * @details
+ * This function returns a memory block in CPU memory holding the payload
+ * of the specified tag.
+ *
+ * Where possible, the returned block is an alias of the payload in the
+ * memory-mapped file, so that no data are copied: this requires the
+ * platform to support memory-mapping, and the payload to be suitably aligned
+ * for the data type. Otherwise, a new block is allocated and the data are
+ * read into it. The CRC code of the chunk is checked in either case.
+ *
+ * The returned block must be freed using oskar_mem_free() before the binary
+ * file handle is freed.
+ *
+ * @param[in,out] handle   Binary file handle.
+ * @param[in] type         Type of the data (as in oskar_Mem).
+ * @param[in] id_group     Tag group identifier.
+ * @param[in] id_tag       Tag identifier.
+ * @param[in] user_index   User-defined index.
+ * @param[in,out] status   Status return code.
+ *
+ * @return A handle to the memory block.
+ */
+OSKAR_EXPORT
+oskar_Mem* oskar_binary_read_mem_alias(oskar_Binary* handle, int type,
+        unsigned char id_group, unsigned char id_tag, int user_index,
+        int* status);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2012-2015, The University of Oxford
+ * Copyright (c) 2012-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -116,6 +116,49 @@ void oskar_binary_read_mem_ext(oskar_Binary* handle, oskar_Mem* mem,
     oskar_mem_free(temp, status);
 }
 
+oskar_Mem* oskar_binary_read_mem_alias(oskar_Binary* handle, int type,
+        unsigned char id_group, unsigned char id_tag, int user_index,
+        int* status)
+{
+    oskar_Mem* mem = 0;
+    void* ptr = 0;
+    size_t size_bytes = 0, element_size = 0, alignment = 0;
+    int chunk_index;
+
+    /* Check if safe to proceed. */
+    if (*status) return 0;
+
+    /* Get the element size, and the alignment needed for the type. */
+    element_size = oskar_mem_element_size(type);
+    if (element_size == 0)
+    {
+        *status = OSKAR_ERR_BAD_DATA_TYPE;
+        return 0;
+    }
+    alignment = element_size;
+    if (oskar_type_is_complex(type)) alignment /= 2;
+    if (oskar_type_is_matrix(type)) alignment /= 4;
+
+    /* Query the tag index to find out where the block is. */
+    chunk_index = oskar_binary_query(handle, (unsigned char)type,
+            id_group, id_tag, user_index, &size_bytes, status);
+    if (*status) return 0;
+
+    /* Return an alias of the memory-mapped payload, if possible. */
+    ptr = oskar_binary_map_block(handle, chunk_index, 1, status);
+    if (*status) return 0;
+    if (ptr && ((size_t) ptr) % alignment == 0)
+        return oskar_mem_create_alias_from_raw(ptr, type, OSKAR_CPU,
+                size_bytes / element_size, status);
+
+    /* Otherwise, read a copy of the data. */
+    mem = oskar_mem_create(type, OSKAR_CPU, size_bytes / element_size,
+            status);
+    oskar_binary_read_block(handle, chunk_index, size_bytes,
+            oskar_mem_void(mem), status);
+    return mem;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -26,14 +26,19 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include "mem/define_mem_add.h"
 #include "mem/oskar_mem.h"
 #include "utility/oskar_device.h"
+#include "utility/oskar_kernel_macros.h"
 #include <stdlib.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+OSKAR_MEM_ADD(mem_add_float, float)
+OSKAR_MEM_ADD(mem_add_double, double)
+
 void oskar_mem_add(
         oskar_Mem* out,
         const oskar_Mem* in1,
@@ -74,35 +79,28 @@ void oskar_mem_add(
     if (oskar_mem_is_complex(in1))   offset_in1 *= 2;
     if (oskar_mem_is_matrix(in2))    offset_in2 *= 4;
     if (oskar_mem_is_complex(in2))   offset_in2 *= 2;
+    const unsigned int off_a = (unsigned int) offset_in1;
+    const unsigned int off_b = (unsigned int) offset_in2;
+    const unsigned int off_c = (unsigned int) offset_out;
+    const unsigned int n = (unsigned int) num_elements;
     if (location == OSKAR_CPU)
     {
-        size_t i;
         if (precision == OSKAR_DOUBLE)
-        {
-            double *c = oskar_mem_double(out, status);
-            const double *a = oskar_mem_double_const(a_, status);
-            const double *b = oskar_mem_double_const(b_, status);
-            for (i = 0; i < num_elements; ++i)
-                c[i + offset_out] = a[i + offset_in1] + b[i + offset_in2];
-        }
+            mem_add_double(off_a, off_b, off_c, n,
+                    oskar_mem_double_const(a_, status),
+                    oskar_mem_double_const(b_, status),
+                    oskar_mem_double(out, status));
         else if (precision == OSKAR_SINGLE)
-        {
-            float *c = oskar_mem_float(out, status);
-            const float *a = oskar_mem_float_const(a_, status);
-            const float *b = oskar_mem_float_const(b_, status);
-            for (i = 0; i < num_elements; ++i)
-                c[i + offset_out] = a[i + offset_in1] + b[i + offset_in2];
-        }
+            mem_add_float(off_a, off_b, off_c, n,
+                    oskar_mem_float_const(a_, status),
+                    oskar_mem_float_const(b_, status),
+                    oskar_mem_float(out, status));
         else
             *status = OSKAR_ERR_BAD_DATA_TYPE;
     }
     else
     {
         size_t local_size[] = {256, 1, 1}, global_size[] = {1, 1, 1};
-        const unsigned int off_a = (unsigned int) offset_in1;
-        const unsigned int off_b = (unsigned int) offset_in2;
-        const unsigned int off_c = (unsigned int) offset_out;
-        const unsigned int n = (unsigned int) num_elements;
         const char* k = 0;
         if (precision == OSKAR_DOUBLE)      k = "mem_add_double";
         else if (precision == OSKAR_SINGLE) k = "mem_add_float";
@@ -284,3 +284,57 @@ TEST(binary_file, binary_read_write_mem)
     ASSERT_EQ(0, status) << oskar_get_error_string(status);
 }
 
+
+TEST(binary_file, binary_read_mem_alias)
+{
+    const char filename[] = "temp_test_mem_binary_alias.dat";
+    int num_elements = 1000, status = 0;
+    const int types[] = {OSKAR_SINGLE_COMPLEX, OSKAR_DOUBLE, OSKAR_INT};
+    const int num_types = sizeof(types) / sizeof(int);
+    oskar_Mem* data[3];
+
+    // Write some data.
+    oskar_Binary* h = oskar_binary_create(filename, 'w', &status);
+    for (int i = 0; i < num_types; ++i)
+    {
+        data[i] = oskar_mem_create(types[i], OSKAR_CPU, num_elements, &status);
+        if (types[i] == OSKAR_INT)
+        {
+            int* t = oskar_mem_int(data[i], &status);
+            for (int j = 0; j < num_elements; ++j) t[j] = 3 * j - 100;
+        }
+        else
+            oskar_mem_random_uniform(data[i], i, 2, 3, 4, &status);
+        oskar_binary_write_mem(h, data[i], 1, (unsigned char) i, 0,
+                0, &status);
+    }
+    oskar_binary_free(h);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Read the data back, and check it is the same.
+    h = oskar_binary_create(filename, 'r', &status);
+    for (int i = 0; i < num_types; ++i)
+    {
+        oskar_Mem* mem = oskar_binary_read_mem_alias(h, types[i],
+                1, (unsigned char) i, 0, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        ASSERT_EQ(types[i], oskar_mem_type(mem));
+        ASSERT_EQ(num_elements, (int)oskar_mem_length(mem));
+        EXPECT_FALSE(oskar_mem_different(data[i], mem, 0, &status));
+        oskar_mem_free(mem, &status);
+    }
+
+    // Try to read data that isn't present.
+    oskar_Mem* mem = oskar_binary_read_mem_alias(h, OSKAR_DOUBLE,
+            1, 10, 0, &status);
+    EXPECT_EQ((int)OSKAR_ERR_BINARY_TAG_NOT_FOUND, status);
+    EXPECT_TRUE(mem == 0);
+    status = 0;
+
+    // Release the handle and clean up.
+    oskar_binary_free(h);
+    for (int i = 0; i < num_types; ++i)
+        oskar_mem_free(data[i], &status);
+    remove(filename);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
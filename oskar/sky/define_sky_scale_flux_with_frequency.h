@@ -8,25 +8,61 @@
         GLOBAL_IN(FP, sp_index),\
         GLOBAL_IN(FP, rm))\
 {\
-    KERNEL_LOOP_X(int, i, 0, num_sources)\
-    FP sin_b, cos_b;\
+    KERNEL_LOOP_PAR_SIMD_X(int, i, 0, num_sources)\
     const FP freq0 = ref_freq[i];\
-    if (freq0 == (FP) 0) return;\
-    const FP lambda  = ((FP) 299792458) / frequency;\
-    const FP lambda0 = ((FP) 299792458) / freq0;\
-    const FP delta_lambda_sq = (lambda - lambda0) * (lambda + lambda0);\
-    const FP b = ((FP) 2) * rm[i] * delta_lambda_sq;\
-    SINCOS(b, sin_b, cos_b);\
-    const FP freq_ratio = frequency / freq0;\
-    const FP spix = sp_index[i];\
-    const FP scale = pow(freq_ratio, spix);\
-    const FP Q_ = scale * src_Q[i];\
-    const FP U_ = scale * src_U[i];\
-    src_I[i] *= scale;\
-    src_V[i] *= scale;\
-    src_Q[i] = Q_ * cos_b - U_ * sin_b;\
-    src_U[i] = Q_ * sin_b + U_ * cos_b;\
-    ref_freq[i] = frequency;\
+    if (freq0 != (FP) 0) {\
+        FP sin_b, cos_b;\
+        const FP lambda  = ((FP) 299792458) / frequency;\
+        const FP lambda0 = ((FP) 299792458) / freq0;\
+        const FP delta_lambda_sq = (lambda - lambda0) * (lambda + lambda0);\
+        const FP b = ((FP) 2) * rm[i] * delta_lambda_sq;\
+        SINCOS(b, sin_b, cos_b);\
+        const FP freq_ratio = frequency / freq0;\
+        const FP spix = sp_index[i];\
+        const FP scale = pow(freq_ratio, spix);\
+        const FP Q_ = scale * src_Q[i];\
+        const FP U_ = scale * src_U[i];\
+        src_I[i] *= scale;\
+        src_V[i] *= scale;\
+        src_Q[i] = Q_ * cos_b - U_ * sin_b;\
+        src_U[i] = Q_ * sin_b + U_ * cos_b;\
+        ref_freq[i] = frequency;\
+    }\
+    KERNEL_LOOP_END\
+}\
+OSKAR_REGISTER_KERNEL(NAME)
+
+#define OSKAR_SKY_EVALUATE_FLUX(NAME, FP) KERNEL(NAME) (\
+        const int num_sources, const int num_channels,\
+        const FP freq_start_hz, const FP freq_inc_hz,\
+        GLOBAL_IN(FP, src_I), GLOBAL_IN(FP, src_Q),\
+        GLOBAL_IN(FP, src_U), GLOBAL_IN(FP, src_V),\
+        GLOBAL_IN(FP, ref_freq), GLOBAL_IN(FP, sp_index), GLOBAL_IN(FP, rm),\
+        GLOBAL_OUT(FP, out_I), GLOBAL_OUT(FP, out_Q),\
+        GLOBAL_OUT(FP, out_U), GLOBAL_OUT(FP, out_V))\
+{\
+    KERNEL_LOOP_PAR_SIMD_X(int, i, 0, num_sources)\
+    int c;\
+    const FP freq0 = ref_freq[i], spix = sp_index[i], rm_ = rm[i];\
+    const FP lambda0 = (freq0 == (FP) 0) ? (FP) 0 : ((FP) 299792458) / freq0;\
+    for (c = 0; c < num_channels; ++c) {\
+        FP sin_b = (FP) 0, cos_b = (FP) 1, scale = (FP) 1;\
+        const int j = c * num_sources + i;\
+        if (freq0 != (FP) 0) {\
+            const FP frequency = freq_start_hz + c * freq_inc_hz;\
+            const FP lambda  = ((FP) 299792458) / frequency;\
+            const FP delta_lambda_sq = (lambda - lambda0) * (lambda + lambda0);\
+            const FP b = ((FP) 2) * rm_ * delta_lambda_sq;\
+            SINCOS(b, sin_b, cos_b);\
+            scale = pow(frequency / freq0, spix);\
+        }\
+        const FP Q_ = scale * src_Q[i];\
+        const FP U_ = scale * src_U[i];\
+        out_I[j] = scale * src_I[i];\
+        out_V[j] = scale * src_V[i];\
+        out_Q[j] = Q_ * cos_b - U_ * sin_b;\
+        out_U[j] = Q_ * sin_b + U_ * cos_b;\
+    }\
     KERNEL_LOOP_END\
 }\
 OSKAR_REGISTER_KERNEL(NAME)
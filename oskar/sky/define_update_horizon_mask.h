@@ -5,7 +5,7 @@
         const FP l_mul, const FP m_mul, const FP n_mul,\
         GLOBAL_OUT(int, mask))\
 {\
-    KERNEL_LOOP_X(int, i, 0, num)\
+    KERNEL_LOOP_PAR_SIMD_X(int, i, 0, num)\
     mask[i] |= ((l[i] * l_mul + m[i] * m_mul + n[i] * n_mul) > (FP) 0);\
     KERNEL_LOOP_END\
 }\
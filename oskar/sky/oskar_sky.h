@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2012-2016, The University of Oxford
+ * Copyright (c) 2012-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -62,7 +62,13 @@ enum OSKAR_SKY_TAGS
     OSKAR_SKY_TAG_FWHM_MAJOR = 11,
     OSKAR_SKY_TAG_FWHM_MINOR = 12,
     OSKAR_SKY_TAG_POSITION_ANGLE = 13,
-    OSKAR_SKY_TAG_ROTATION_MEASURE = 14
+    OSKAR_SKY_TAG_ROTATION_MEASURE = 14,
+    OSKAR_SKY_TAG_CHUNK_SIZE = 15,
+    OSKAR_SKY_TAG_NUM_CHUNKS = 16,
+    OSKAR_SKY_TAG_CHUNK_NUM_SOURCES = 17,
+    OSKAR_SKY_TAG_CHUNK_CAP = 18,
+    OSKAR_SKY_TAG_CHUNK_FLUX_RANGE = 19,
+    OSKAR_SKY_TAG_CHUNK_HAS_EXTENDED = 20
 };
 
 #ifdef __cplusplus
@@ -72,10 +78,13 @@ enum OSKAR_SKY_TAGS
 #include <sky/oskar_sky_accessors.h>
 #include <sky/oskar_sky_append_to_set.h>
 #include <sky/oskar_sky_append.h>
+#include <sky/oskar_sky_bounding_cap.h>
 #include <sky/oskar_sky_copy.h>
 #include <sky/oskar_sky_copy_contents.h>
 #include <sky/oskar_sky_create.h>
 #include <sky/oskar_sky_create_copy.h>
+#include <sky/oskar_sky_create_flux_alias.h>
+#include <sky/oskar_sky_evaluate_flux.h>
 #include <sky/oskar_sky_evaluate_gaussian_source_parameters.h>
 #include <sky/oskar_sky_evaluate_relative_directions.h>
 #include <sky/oskar_sky_filter_by_flux.h>
@@ -86,18 +95,23 @@ enum OSKAR_SKY_TAGS
 #include <sky/oskar_sky_from_image.h>
 #include <sky/oskar_sky_generate_grid.h>
 #include <sky/oskar_sky_generate_random_power_law.h>
+#include <sky/oskar_sky_horizon_cap.h>
 #include <sky/oskar_sky_horizon_clip.h>
 #include <sky/oskar_sky_load.h>
 #include <sky/oskar_sky_override_polarisation.h>
 #include <sky/oskar_sky_read.h>
+#include <sky/oskar_sky_read_chunk.h>
 #include <sky/oskar_sky_resize.h>
 #include <sky/oskar_sky_rotate_to_position.h>
 #include <sky/oskar_sky_save.h>
 #include <sky/oskar_sky_scale_flux_with_frequency.h>
+#include <sky/oskar_sky_set_flux_alias.h>
 #include <sky/oskar_sky_set_gaussian_parameters.h>
 #include <sky/oskar_sky_set_source.h>
 #include <sky/oskar_sky_set_spectral_index.h>
+#include <sky/oskar_sky_sort_spatial.h>
 #include <sky/oskar_sky_write.h>
+#include <sky/oskar_sky_write_chunked.h>
 
 
 #endif /* OSKAR_SKY_H_ */
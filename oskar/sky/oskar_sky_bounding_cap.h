@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_SKY_BOUNDING_CAP_H_
+#define OSKAR_SKY_BOUNDING_CAP_H_
+
+/**
+ * @file oskar_sky_bounding_cap.h
+ */
+
+#include <oskar_global.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Returns a spherical cap enclosing a range of sources in a sky model.
+ *
+ * @details
+ * This function returns the centre and angular radius of a spherical cap
+ * that encloses all sources in the given range of the sky model.
+ *
+ * The centre of the cap is the normalised mean of the source direction
+ * vectors, and the radius is the largest angular distance of any source
+ * from the centre, increased by the largest FWHM of any extended source.
+ * The cap is therefore not necessarily the smallest possible, but it is
+ * cheap to compute and is guaranteed to contain every source.
+ *
+ * If there are no sources in the range, the radius is returned as -1.
+ *
+ * The sky model must be in CPU memory.
+ *
+ * @param[in] sky          Pointer to sky model.
+ * @param[in] offset       Index of the first source in the range.
+ * @param[in] num_sources  Number of sources in the range.
+ * @param[out] lon_rad     Longitude of the cap centre, in radians.
+ * @param[out] lat_rad     Latitude of the cap centre, in radians.
+ * @param[out] radius_rad  Angular radius of the cap, in radians.
+ * @param[in,out] status   Status return code.
+ */
+OSKAR_EXPORT
+void oskar_sky_bounding_cap(const oskar_Sky* sky, int offset,
+        int num_sources, double* lon_rad, double* lat_rad,
+        double* radius_rad, int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_SKY_BOUNDING_CAP_H_ */
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_SKY_CREATE_FLUX_ALIAS_H_
+#define OSKAR_SKY_CREATE_FLUX_ALIAS_H_
+
+/**
+ * @file oskar_sky_create_flux_alias.h
+ */
+
+#include <oskar_global.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Creates a sky model that aliases another, with different Stokes values.
+ *
+ * @details
+ * This function returns a new sky model handle in which every array
+ * is an alias of the corresponding array in \p sky, except the Stokes
+ * parameters, which are aliases of the given arrays starting at element
+ * \p offset. No source data are copied.
+ *
+ * This is used with oskar_sky_evaluate_flux() to present the source
+ * brightnesses in one frequency channel to functions that take a sky model,
+ * without modifying the original.
+ *
+ * The returned sky model must not be resized, and must be freed using
+ * oskar_sky_free() before \p sky or any of the Stokes arrays.
+ * Use oskar_sky_set_flux_alias() to present a different channel.
+ *
+ * @param[in] sky          The sky model to alias.
+ * @param[in] stokes_I     Stokes I values to use.
+ * @param[in] stokes_Q     Stokes Q values to use.
+ * @param[in] stokes_U     Stokes U values to use.
+ * @param[in] stokes_V     Stokes V values to use.
+ * @param[in] offset       Offset into the Stokes arrays.
+ * @param[in,out] status   Status return code.
+ *
+ * @return A handle to the new sky model.
+ */
+OSKAR_EXPORT
+oskar_Sky* oskar_sky_create_flux_alias(const oskar_Sky* sky,
+        const oskar_Mem* stokes_I, const oskar_Mem* stokes_Q,
+        const oskar_Mem* stokes_U, const oskar_Mem* stokes_V, size_t offset,
+        int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_SKY_CREATE_FLUX_ALIAS_H_ */
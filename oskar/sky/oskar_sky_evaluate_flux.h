@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_SKY_EVALUATE_FLUX_H_
+#define OSKAR_SKY_EVALUATE_FLUX_H_
+
+/**
+ * @file oskar_sky_evaluate_flux.h
+ */
+
+#include <oskar_global.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Evaluates source Stokes parameters at a set of frequency channels.
+ *
+ * @details
+ * This function evaluates the Stokes parameters of all sources at each
+ * of the given frequency channels, using the spectral index and
+ * rotation measure of each source, as in
+ * oskar_sky_scale_flux_with_frequency().
+ *
+ * Unlike oskar_sky_scale_flux_with_frequency(), the sky model is not
+ * modified: the values are always computed from the reference values,
+ * and are written to the output arrays, which are resized if necessary to
+ * hold \p num_channels * \p num_sources elements. The value for source
+ * \p i in channel \p c is at index (\p c * \p num_sources + \p i).
+ *
+ * Sources with a reference frequency of zero are not scaled.
+ *
+ * @param[in] sky            The sky model.
+ * @param[in] num_channels   Number of frequency channels.
+ * @param[in] freq_start_hz  Frequency of the first channel, in Hz.
+ * @param[in] freq_inc_hz    Frequency increment between channels, in Hz.
+ * @param[out] stokes_I      Output Stokes I values.
+ * @param[out] stokes_Q      Output Stokes Q values.
+ * @param[out] stokes_U      Output Stokes U values.
+ * @param[out] stokes_V      Output Stokes V values.
+ * @param[in,out] status     Status return code.
+ */
+OSKAR_EXPORT
+void oskar_sky_evaluate_flux(const oskar_Sky* sky, int num_channels,
+        double freq_start_hz, double freq_inc_hz, oskar_Mem* stokes_I,
+        oskar_Mem* stokes_Q, oskar_Mem* stokes_U, oskar_Mem* stokes_V,
+        int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_SKY_EVALUATE_FLUX_H_ */
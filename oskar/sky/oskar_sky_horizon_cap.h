@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_SKY_HORIZON_CAP_H_
+#define OSKAR_SKY_HORIZON_CAP_H_
+
+/**
+ * @file oskar_sky_horizon_cap.h
+ */
+
+#include <oskar_global.h>
+#include <telescope/oskar_telescope.h>
+
+enum OSKAR_SKY_CAP_HORIZON
+{
+    OSKAR_SKY_CAP_BELOW_HORIZON = -1,
+    OSKAR_SKY_CAP_CROSSES_HORIZON = 0,
+    OSKAR_SKY_CAP_ABOVE_HORIZON = 1
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Returns the position of a spherical cap relative to the station horizons.
+ *
+ * @details
+ * This function compares a spherical cap (for example, the bounding cap
+ * of a sky chunk, from oskar_sky_bounding_cap()) with the horizons of all
+ * stations in the telescope model at the given sidereal time.
+ *
+ * It returns:
+ * - OSKAR_SKY_CAP_BELOW_HORIZON if the whole cap is below the horizon of
+ *   every station, so none of the sources in it would pass
+ *   oskar_sky_horizon_clip();
+ * - OSKAR_SKY_CAP_ABOVE_HORIZON if the whole cap is above the horizon of
+ *   at least one station, so all of the sources in it would pass
+ *   oskar_sky_horizon_clip();
+ * - OSKAR_SKY_CAP_CROSSES_HORIZON otherwise.
+ *
+ * A small margin is used, so that sources very close to a horizon are
+ * always left to oskar_sky_horizon_clip(). An empty cap (with a negative
+ * radius) is below the horizon.
+ *
+ * @param[in] lon_rad     Longitude of the cap centre, in radians.
+ * @param[in] lat_rad     Latitude of the cap centre, in radians.
+ * @param[in] radius_rad  Angular radius of the cap, in radians.
+ * @param[in] telescope   The telescope model.
+ * @param[in] gast        Greenwich apparent sidereal time, in radians.
+ *
+ * @return The position of the cap relative to the horizon.
+ */
+OSKAR_EXPORT
+int oskar_sky_horizon_cap(double lon_rad, double lat_rad, double radius_rad,
+        const oskar_Telescope* telescope, double gast);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_SKY_HORIZON_CAP_H_ */
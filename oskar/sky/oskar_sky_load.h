@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011-2014, The University of Oxford
+ * Copyright (c) 2011-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -84,6 +84,10 @@ extern "C" {
  * - Lines containing 10 or 13 or more columns set the status flag to
  *   indicate an error, and abort the load.
  *
+ * The file is memory-mapped if possible, and large files are split on
+ * line boundaries into slices that are parsed in parallel. Sources are
+ * stored in the same order as they appear in the file.
+ *
  * @param[in]  filename  Path to a source list text file.
  * @param[in]  type      Required data type (OSKAR_SINGLE or OSKAR_DOUBLE).
  * @param[in,out] status Status return code.
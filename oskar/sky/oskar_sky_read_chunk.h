@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_SKY_READ_CHUNK_H_
+#define OSKAR_SKY_READ_CHUNK_H_
+
+/**
+ * @file oskar_sky_read_chunk.h
+ */
+
+#include <oskar_global.h>
+#include <binary/oskar_binary.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Returns the number of chunks in a sky model binary file.
+ *
+ * @details
+ * Returns the number of chunks in a sky model binary file written by
+ * oskar_sky_write_chunked().
+ *
+ * If the file was written by oskar_sky_write(), 0 is returned and the
+ * status code is not set.
+ *
+ * @param[in,out] h       Handle to an open binary file.
+ * @param[in,out] status  Status return code.
+ *
+ * @return The number of chunks in the file.
+ */
+OSKAR_EXPORT
+int oskar_sky_read_num_chunks(oskar_Binary* h, int* status);
+
+/**
+ * @brief
+ * Returns the statistics of a chunk in a sky model binary file.
+ *
+ * @details
+ * Returns the statistics of the specified chunk in a sky model binary file
+ * written by oskar_sky_write_chunked(), without reading any source data.
+ *
+ * Any of the output pointers may be NULL if the value is not required.
+ *
+ * @param[in,out] h          Handle to an open binary file.
+ * @param[in] chunk_index    Index of the chunk.
+ * @param[out] num_sources   Number of sources in the chunk.
+ * @param[out] cap           Bounding cap as (longitude, latitude, radius),
+ *                           all in radians.
+ * @param[out] flux_range    Minimum and maximum Stokes I value.
+ * @param[out] has_extended  True if any source in the chunk is extended.
+ * @param[in,out] status     Status return code.
+ */
+OSKAR_EXPORT
+void oskar_sky_read_chunk_info(oskar_Binary* h, int chunk_index,
+        int* num_sources, double cap[3], double flux_range[2],
+        int* has_extended, int* status);
+
+/**
+ * @brief
+ * Reads a single chunk from a sky model binary file.
+ *
+ * @details
+ * Returns a new sky model in CPU memory holding the sources in the
+ * specified chunk of a file written by oskar_sky_write_chunked().
+ *
+ * Where possible, the source parameters are not copied: the arrays in the
+ * returned sky model alias the data in the memory-mapped file (see
+ * oskar_binary_read_mem_alias()). The sky model may be modified in place,
+ * but it cannot be resized, and it must be freed before the file handle.
+ *
+ * @param[in,out] h        Handle to an open binary file.
+ * @param[in] chunk_index  Index of the chunk.
+ * @param[in,out] status   Status return code.
+ *
+ * @return A handle to the new sky model.
+ */
+OSKAR_EXPORT
+oskar_Sky* oskar_sky_read_chunk(oskar_Binary* h, int chunk_index,
+        int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_SKY_READ_CHUNK_H_ */
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_SKY_SET_FLUX_ALIAS_H_
+#define OSKAR_SKY_SET_FLUX_ALIAS_H_
+
+/**
+ * @file oskar_sky_set_flux_alias.h
+ */
+
+#include <oskar_global.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief
+ * Changes the Stokes arrays aliased by a sky model.
+ *
+ * @details
+ * This function updates a sky model created by oskar_sky_create_flux_alias()
+ * so that its Stokes parameters are aliases of the given arrays starting
+ * at element \p offset, without allocating a new sky model.
+ *
+ * It must be called again if any of the Stokes arrays are resized.
+ *
+ * @param[in,out] model    Sky model created by oskar_sky_create_flux_alias().
+ * @param[in] stokes_I     Stokes I values to use.
+ * @param[in] stokes_Q     Stokes Q values to use.
+ * @param[in] stokes_U     Stokes U values to use.
+ * @param[in] stokes_V     Stokes V values to use.
+ * @param[in] offset       Offset into the Stokes arrays.
+ * @param[in,out] status   Status return code.
+ */
+OSKAR_EXPORT
+void oskar_sky_set_flux_alias(oskar_Sky* model,
+        const oskar_Mem* stokes_I, const oskar_Mem* stokes_Q,
+        const oskar_Mem* stokes_U, const oskar_Mem* stokes_V, size_t offset,
+        int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_SKY_SET_FLUX_ALIAS_H_ */
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_SKY_WRITE_CHUNKED_H_
+#define OSKAR_SKY_WRITE_CHUNKED_H_
+
+/**
+ * @file oskar_sky_write_chunked.h
+ */
+
+#include <oskar_global.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Writes an OSKAR sky model to a chunked binary file.
+ *
+ * @details
+ * Writes the specified OSKAR sky model to a binary file as a sequence of
+ * chunks, each holding at most \p chunk_size sources.
+ *
+ * Each chunk is written as a set of columns (one per source parameter),
+ * using the same tags as oskar_sky_write() but with the chunk index as the
+ * user index. The payload of each column is aligned so that it can be used
+ * directly when the file is memory-mapped.
+ *
+ * Each chunk is preceded by a small set of statistics that can be used to
+ * decide whether it needs to be loaded at all: the number of sources,
+ * a spherical cap that encloses all the sources (see
+ * oskar_sky_bounding_cap()), the range of Stokes I values, and a flag to
+ * indicate whether any source is extended.
+ *
+ * The caps are most useful if the sources have first been sorted using
+ * oskar_sky_sort_spatial(), so that each chunk covers a compact region.
+ *
+ * Use oskar_sky_read_chunk() to read a single chunk from the file, or
+ * oskar_sky_read() to read all of them into a single sky model.
+ *
+ * @param[in] filename    Output filename.
+ * @param[in] sky         Sky model to write.
+ * @param[in] chunk_size  Maximum number of sources in each chunk.
+ * @param[in,out] status  Status return code.
+ */
+OSKAR_EXPORT
+void oskar_sky_write_chunked(const char* filename, const oskar_Sky* sky,
+        int chunk_size, int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_SKY_WRITE_CHUNKED_H_ */
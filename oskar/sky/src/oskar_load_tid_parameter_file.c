@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, The University of Oxford
+ * Copyright (c) 2013-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -27,7 +27,7 @@
  */
 
 
-#include "oskar_settings_load_tid_parameter_file.h"
+#include "sky/oskar_load_tid_parameter_file.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -45,9 +45,9 @@ char* strtok_r(char*, const char*, char**);
 #endif
 
 static size_t string_to_array(char* str, size_t n, double* data);
-static int oskar_settings_getline(char** lineptr, size_t* n, FILE* stream);
+static int tid_file_getline(char** lineptr, size_t* n, FILE* stream);
 
-void oskar_settings_load_tid_parameter_file(oskar_SettingsTIDscreen* TID,
+void oskar_load_tid_parameter_file(oskar_SettingsTIDscreen* TID,
         const char* filename, int* status)
 {
     char* line = NULL;
@@ -74,7 +74,7 @@ void oskar_settings_load_tid_parameter_file(oskar_SettingsTIDscreen* TID,
     }
 
     /* Loop over each line in the file. */
-    while (oskar_settings_getline(&line, &bufsize, file) != OSKAR_ERR_EOF)
+    while (tid_file_getline(&line, &bufsize, file) != OSKAR_ERR_EOF)
     {
         size_t read = 0;
 
@@ -119,7 +119,7 @@ void oskar_settings_load_tid_parameter_file(oskar_SettingsTIDscreen* TID,
 }
 
 
-size_t string_to_array(char* str, size_t n, double* data)
+static size_t string_to_array(char* str, size_t n, double* data)
 {
     size_t i = 0;
     char *save_ptr, *token;
@@ -136,7 +136,7 @@ size_t string_to_array(char* str, size_t n, double* data)
 }
 
 
-int oskar_settings_getline(char** lineptr, size_t* n, FILE* stream)
+static int tid_file_getline(char** lineptr, size_t* n, FILE* stream)
 {
     /* Initialise the byte counter. */
     size_t size = 0;
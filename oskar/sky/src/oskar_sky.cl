@@ -1,5 +1,6 @@
-/* Copyright (c) 2018, The University of Oxford. See LICENSE file. */
+/* Copyright (c) 2018-2019, The University of Oxford. See LICENSE file. */
 
 OSKAR_UPDATE_HORIZON_MASK( M_CAT(update_horizon_mask_, Real), Real)
 OSKAR_SKY_SCALE_FLUX_WITH_FREQUENCY( M_CAT(scale_flux_with_frequency_, Real), Real)
+OSKAR_SKY_EVALUATE_FLUX( M_CAT(evaluate_flux_, Real), Real)
 OSKAR_SKY_COPY_SOURCE_DATA( M_CAT(copy_source_data_, Real), Real)
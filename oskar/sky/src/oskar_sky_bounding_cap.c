@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sky/private_sky.h"
+#include "sky/oskar_sky.h"
+
+#include "math/oskar_cmath.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BOUNDING_CAP(FP) {\
+        const FP *ra_, *dec_, *maj_;\
+        ra_  = (const FP*) oskar_mem_void_const(sky->ra_rad) + offset;\
+        dec_ = (const FP*) oskar_mem_void_const(sky->dec_rad) + offset;\
+        maj_ = (const FP*) oskar_mem_void_const(sky->fwhm_major_rad) + offset;\
+        for (i = 0; i < num_sources; ++i) {\
+            const double cos_dec = cos(dec_[i]);\
+            x += cos_dec * cos(ra_[i]);\
+            y += cos_dec * sin(ra_[i]);\
+            z += sin(dec_[i]);\
+            if (maj_[i] > max_fwhm) max_fwhm = maj_[i];\
+        }\
+        norm = sqrt(x*x + y*y + z*z);\
+        if (norm > 0.0) { x /= norm; y /= norm; z /= norm; }\
+        else { x = 1.0; y = 0.0; z = 0.0; }\
+        for (i = 0; i < num_sources; ++i) {\
+            const double cos_dec = cos(dec_[i]);\
+            const double dot = x * cos_dec * cos(ra_[i]) +\
+                    y * cos_dec * sin(ra_[i]) + z * sin(dec_[i]);\
+            if (dot < min_dot) min_dot = dot;\
+        }\
+    }
+
+void oskar_sky_bounding_cap(const oskar_Sky* sky, int offset,
+        int num_sources, double* lon_rad, double* lat_rad,
+        double* radius_rad, int* status)
+{
+    int i;
+    double x = 0.0, y = 0.0, z = 0.0, norm, min_dot = 1.0, max_fwhm = 0.0;
+
+    /* Check if safe to proceed. */
+    *lon_rad = 0.0;
+    *lat_rad = 0.0;
+    *radius_rad = -1.0;
+    if (*status) return;
+    if (sky->mem_location != OSKAR_CPU)
+    {
+        *status = OSKAR_ERR_BAD_LOCATION;
+        return;
+    }
+    if (offset < 0 || num_sources < 0 ||
+            offset + num_sources > sky->num_sources)
+    {
+        *status = OSKAR_ERR_OUT_OF_RANGE;
+        return;
+    }
+    if (num_sources == 0) return;
+
+    /* Find the mean direction and the largest distance from it. */
+    if (sky->precision == OSKAR_DOUBLE)
+        BOUNDING_CAP(double)
+    else
+        BOUNDING_CAP(float)
+
+    /* Return the cap. Clamp the dot product to guard against rounding. */
+    if (min_dot > 1.0) min_dot = 1.0;
+    if (min_dot < -1.0) min_dot = -1.0;
+    *lon_rad = atan2(y, x);
+    *lat_rad = atan2(z, sqrt(x*x + y*y));
+    *radius_rad = acos(min_dot) + max_fwhm;
+    if (*radius_rad > M_PI) *radius_rad = M_PI;
+}
+
+#ifdef __cplusplus
+}
+#endif
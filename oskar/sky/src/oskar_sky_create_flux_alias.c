@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sky/private_sky.h"
+#include "sky/oskar_sky.h"
+
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static oskar_Mem* alias_all(const oskar_Mem* mem, int* status)
+{
+    return oskar_mem_create_alias(mem, 0, oskar_mem_length(mem), status);
+}
+
+oskar_Sky* oskar_sky_create_flux_alias(const oskar_Sky* sky,
+        const oskar_Mem* stokes_I, const oskar_Mem* stokes_Q,
+        const oskar_Mem* stokes_U, const oskar_Mem* stokes_V, size_t offset,
+        int* status)
+{
+    oskar_Sky* model = 0;
+    const size_t n = (size_t) sky->num_sources;
+
+    /* Check if safe to proceed. */
+    if (*status) return 0;
+
+    /* Allocate the structure and copy the meta-data. */
+    model = (oskar_Sky*) calloc(1, sizeof(oskar_Sky));
+    if (!model)
+    {
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        return 0;
+    }
+    model->precision = sky->precision;
+    model->mem_location = sky->mem_location;
+    model->capacity = sky->num_sources;
+    model->num_sources = sky->num_sources;
+    model->use_extended = sky->use_extended;
+    model->reference_ra_rad = sky->reference_ra_rad;
+    model->reference_dec_rad = sky->reference_dec_rad;
+
+    /* Alias the memory.
+     * Arrays owned by the sky model are aliased in full, to keep the spare
+     * element at the end used for station beam normalisation. */
+    model->ra_rad = alias_all(sky->ra_rad, status);
+    model->dec_rad = alias_all(sky->dec_rad, status);
+    model->I = oskar_mem_create_alias(stokes_I, offset, n, status);
+    model->Q = oskar_mem_create_alias(stokes_Q, offset, n, status);
+    model->U = oskar_mem_create_alias(stokes_U, offset, n, status);
+    model->V = oskar_mem_create_alias(stokes_V, offset, n, status);
+    model->reference_freq_hz = alias_all(sky->reference_freq_hz, status);
+    model->spectral_index = alias_all(sky->spectral_index, status);
+    model->rm_rad = alias_all(sky->rm_rad, status);
+    model->l = alias_all(sky->l, status);
+    model->m = alias_all(sky->m, status);
+    model->n = alias_all(sky->n, status);
+    model->fwhm_major_rad = alias_all(sky->fwhm_major_rad, status);
+    model->fwhm_minor_rad = alias_all(sky->fwhm_minor_rad, status);
+    model->pa_rad = alias_all(sky->pa_rad, status);
+    model->gaussian_a = alias_all(sky->gaussian_a, status);
+    model->gaussian_b = alias_all(sky->gaussian_b, status);
+    model->gaussian_c = alias_all(sky->gaussian_c, status);
+
+    /* Return a handle to the sky model, or NULL if an error occurred. */
+    if (*status)
+    {
+        oskar_sky_free(model, status);
+        model = 0;
+    }
+    return model;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sky/oskar_sky.h"
+#include "sky/define_sky_scale_flux_with_frequency.h"
+#include "utility/oskar_kernel_macros.h"
+#include "utility/oskar_device.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+OSKAR_SKY_EVALUATE_FLUX(evaluate_flux_float, float)
+OSKAR_SKY_EVALUATE_FLUX(evaluate_flux_double, double)
+
+void oskar_sky_evaluate_flux(const oskar_Sky* sky, int num_channels,
+        double freq_start_hz, double freq_inc_hz, oskar_Mem* stokes_I,
+        oskar_Mem* stokes_Q, oskar_Mem* stokes_U, oskar_Mem* stokes_V,
+        int* status)
+{
+    if (*status) return;
+    const int type = oskar_sky_precision(sky);
+    const int location = oskar_sky_mem_location(sky);
+    const int num_sources = oskar_sky_num_sources(sky);
+    const size_t num_out = (size_t) num_channels * (size_t) num_sources;
+    if (oskar_mem_location(stokes_I) != location ||
+            oskar_mem_location(stokes_Q) != location ||
+            oskar_mem_location(stokes_U) != location ||
+            oskar_mem_location(stokes_V) != location)
+    {
+        *status = OSKAR_ERR_LOCATION_MISMATCH;
+        return;
+    }
+    if (oskar_mem_type(stokes_I) != type ||
+            oskar_mem_type(stokes_Q) != type ||
+            oskar_mem_type(stokes_U) != type ||
+            oskar_mem_type(stokes_V) != type)
+    {
+        *status = OSKAR_ERR_TYPE_MISMATCH;
+        return;
+    }
+    oskar_mem_ensure(stokes_I, num_out, status);
+    oskar_mem_ensure(stokes_Q, num_out, status);
+    oskar_mem_ensure(stokes_U, num_out, status);
+    oskar_mem_ensure(stokes_V, num_out, status);
+    if (*status || num_out == 0) return;
+    if (location == OSKAR_CPU)
+    {
+        if (type == OSKAR_SINGLE)
+            evaluate_flux_float(num_sources, num_channels,
+                    (float) freq_start_hz, (float) freq_inc_hz,
+                    oskar_mem_float_const(oskar_sky_I_const(sky), status),
+                    oskar_mem_float_const(oskar_sky_Q_const(sky), status),
+                    oskar_mem_float_const(oskar_sky_U_const(sky), status),
+                    oskar_mem_float_const(oskar_sky_V_const(sky), status),
+                    oskar_mem_float_const(
+                            oskar_sky_reference_freq_hz_const(sky), status),
+                    oskar_mem_float_const(
+                            oskar_sky_spectral_index_const(sky), status),
+                    oskar_mem_float_const(
+                            oskar_sky_rotation_measure_rad_const(sky), status),
+                    oskar_mem_float(stokes_I, status),
+                    oskar_mem_float(stokes_Q, status),
+                    oskar_mem_float(stokes_U, status),
+                    oskar_mem_float(stokes_V, status));
+        else if (type == OSKAR_DOUBLE)
+            evaluate_flux_double(num_sources, num_channels,
+                    freq_start_hz, freq_inc_hz,
+                    oskar_mem_double_const(oskar_sky_I_const(sky), status),
+                    oskar_mem_double_const(oskar_sky_Q_const(sky), status),
+                    oskar_mem_double_const(oskar_sky_U_const(sky), status),
+                    oskar_mem_double_const(oskar_sky_V_const(sky), status),
+                    oskar_mem_double_const(
+                            oskar_sky_reference_freq_hz_const(sky), status),
+                    oskar_mem_double_const(
+                            oskar_sky_spectral_index_const(sky), status),
+                    oskar_mem_double_const(
+                            oskar_sky_rotation_measure_rad_const(sky), status),
+                    oskar_mem_double(stokes_I, status),
+                    oskar_mem_double(stokes_Q, status),
+                    oskar_mem_double(stokes_U, status),
+                    oskar_mem_double(stokes_V, status));
+        else
+            *status = OSKAR_ERR_BAD_DATA_TYPE;
+    }
+    else
+    {
+        size_t local_size[] = {256, 1, 1}, global_size[] = {1, 1, 1};
+        const float freq_start_f = (float) freq_start_hz;
+        const float freq_inc_f = (float) freq_inc_hz;
+        const char* k = 0;
+        const int is_dbl = (type == OSKAR_DOUBLE);
+        if (is_dbl)
+            k = "evaluate_flux_double";
+        else if (type == OSKAR_SINGLE)
+            k = "evaluate_flux_float";
+        else
+        {
+            *status = OSKAR_ERR_BAD_DATA_TYPE;
+            return;
+        }
+        oskar_device_check_local_size(location, 0, local_size);
+        global_size[0] = oskar_device_global_size(
+                (size_t) num_sources, local_size[0]);
+        const oskar_Arg args[] = {
+                {INT_SZ, &num_sources},
+                {INT_SZ, &num_channels},
+                {is_dbl ? DBL_SZ : FLT_SZ, is_dbl ?
+                        (const void*)&freq_start_hz :
+                        (const void*)&freq_start_f},
+                {is_dbl ? DBL_SZ : FLT_SZ, is_dbl ?
+                        (const void*)&freq_inc_hz :
+                        (const void*)&freq_inc_f},
+                {PTR_SZ, oskar_mem_buffer_const(oskar_sky_I_const(sky))},
+                {PTR_SZ, oskar_mem_buffer_const(oskar_sky_Q_const(sky))},
+                {PTR_SZ, oskar_mem_buffer_const(oskar_sky_U_const(sky))},
+                {PTR_SZ, oskar_mem_buffer_const(oskar_sky_V_const(sky))},
+                {PTR_SZ, oskar_mem_buffer_const(
+                        oskar_sky_reference_freq_hz_const(sky))},
+                {PTR_SZ, oskar_mem_buffer_const(
+                        oskar_sky_spectral_index_const(sky))},
+                {PTR_SZ, oskar_mem_buffer_const(
+                        oskar_sky_rotation_measure_rad_const(sky))},
+                {PTR_SZ, oskar_mem_buffer(stokes_I)},
+                {PTR_SZ, oskar_mem_buffer(stokes_Q)},
+                {PTR_SZ, oskar_mem_buffer(stokes_U)},
+                {PTR_SZ, oskar_mem_buffer(stokes_V)}
+        };
+        oskar_device_launch_kernel(k, location, 1, local_size, global_size,
+                sizeof(args) / sizeof(oskar_Arg), args, 0, 0, status);
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
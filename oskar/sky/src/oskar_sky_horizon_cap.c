@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sky/oskar_sky_horizon_cap.h"
+#include "math/oskar_cmath.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Margin, in radians, to allow for rounding in the horizon mask. */
+#define HORIZON_MARGIN 1e-4
+
+int oskar_sky_horizon_cap(double lon_rad, double lat_rad, double radius_rad,
+        const oskar_Telescope* telescope, double gast)
+{
+    int i;
+    const double sin_lat = sin(lat_rad), cos_lat = cos(lat_rad);
+    const double r = radius_rad + HORIZON_MARGIN;
+    int result = OSKAR_SKY_CAP_BELOW_HORIZON;
+    if (radius_rad < 0.0) return result;
+    const int num_stations = oskar_telescope_num_stations(telescope);
+    for (i = 0; i < num_stations; ++i)
+    {
+        const oskar_Station* s = oskar_telescope_station_const(telescope, i);
+        const double phi = oskar_station_lat_rad(s);
+        const double ha = gast + oskar_station_lon_rad(s) - lon_rad;
+        double sin_el = sin(phi) * sin_lat + cos(phi) * cos_lat * cos(ha);
+        double el;
+        if (sin_el > 1.0) sin_el = 1.0;
+        if (sin_el < -1.0) sin_el = -1.0;
+        el = asin(sin_el);
+        if (el - r > 0.0) return OSKAR_SKY_CAP_ABOVE_HORIZON;
+        if (el + r >= 0.0) result = OSKAR_SKY_CAP_CROSSES_HORIZON;
+    }
+    return result;
+}
+
+#ifdef __cplusplus
+}
+#endif
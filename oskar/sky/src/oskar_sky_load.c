@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011-2015, The University of Oxford
+ * Copyright (c) 2011-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -26,27 +26,61 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "sky/private_sky.h"
 #include "sky/oskar_sky.h"
-#include "utility/oskar_getline.h"
 #include "utility/oskar_string_to_array.h"
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* RA, Dec, I, Q, U, V, freq0, spix, RM, FWHM maj, FWHM min, PA */
+#define NUM_PAR 12
+
+/* Minimum number of bytes in each slice parsed by a thread. */
+#define MIN_SLICE_BYTES 1048576
+
 static const double deg2rad = 1.74532925199432957692369e-2;
 static const double arcsec2rad = 4.84813681109535993589914e-6;
 
+/* Source parameters parsed from one slice of the file. */
+struct Slice
+{
+    size_t start, end, num_sources, capacity;
+    double* par;
+    int status;
+};
+typedef struct Slice Slice;
+
+static void parse_slice(const char* data, Slice* slice);
+static void copy_slice(const Slice* slice, size_t offset, oskar_Sky* sky);
+
 oskar_Sky* oskar_sky_load(const char* filename, int type, int* status)
 {
-    int n = 0;
+    int i, num_slices = 1;
     FILE* file;
-    char* line = 0;
-    size_t bufsize = 0;
+    char* data = 0;
+    size_t size = 0, offset = 0;
+    Slice* slices = 0;
     oskar_Sky* sky;
+    int mapped = 0;
 
     /* Check if safe to proceed. */
     if (*status) return 0;
@@ -59,88 +93,251 @@ oskar_Sky* oskar_sky_load(const char* filename, int type, int* status)
     }
 
     /* Open the file. */
-    file = fopen(filename, "r");
+    file = fopen(filename, "rb");
     if (!file)
     {
         *status = OSKAR_ERR_FILE_IO;
         return 0;
     }
 
-    /* Initialise the sky model. */
-    sky = oskar_sky_create(type, OSKAR_CPU, 0, status);
+    /* Map the whole file into memory if possible, otherwise read it. */
+#ifndef _WIN32
+    {
+        struct stat st;
+        const int fd = fileno(file);
+        if (fd >= 0 && fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            void* p = mmap(0, (size_t) st.st_size, PROT_READ, MAP_PRIVATE,
+                    fd, 0);
+            if (p != MAP_FAILED)
+            {
+                data = (char*) p;
+                size = (size_t) st.st_size;
+                mapped = 1;
+            }
+        }
+    }
+#endif
+    if (!mapped)
+    {
+        size_t capacity = 0, bytes_read;
+        do
+        {
+            if (size == capacity)
+            {
+                char* t;
+                capacity = capacity ? 2 * capacity : 65536;
+                t = (char*) realloc(data, capacity);
+                if (!t)
+                {
+                    *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+                    break;
+                }
+                data = t;
+            }
+            bytes_read = fread(data + size, 1, capacity - size, file);
+            size += bytes_read;
+        }
+        while (bytes_read > 0);
+    }
+    fclose(file);
 
-    /* Loop over lines in file. */
-    while (oskar_getline(&line, &bufsize, file) != OSKAR_ERR_EOF)
+    /* Split the file into slices on line boundaries. */
+#ifdef _OPENMP
+    num_slices = omp_get_max_threads();
+    if ((size_t) num_slices > size / MIN_SLICE_BYTES + 1)
+        num_slices = (int) (size / MIN_SLICE_BYTES + 1);
+#endif
+    slices = (Slice*) calloc(num_slices, sizeof(Slice));
+    for (i = 0; i < num_slices; ++i)
     {
+        size_t start = (i == 0) ? 0 : (size / num_slices) * i;
+        while (start > 0 && start < size && data[start - 1] != '\n')
+            start++;
+        slices[i].start = (i == 0) ? 0 : start;
+        if (i > 0) slices[i - 1].end = slices[i].start;
+    }
+    slices[num_slices - 1].end = size;
+
+    /* Parse each slice, in parallel if possible. */
+    if (!*status)
+    {
+#pragma omp parallel for schedule(static, 1) private(i)
+        for (i = 0; i < num_slices; ++i)
+            parse_slice(data, &slices[i]);
+    }
+
+    /* Release the file data. */
+#ifndef _WIN32
+    if (mapped)
+        munmap(data, size);
+    else
+#endif
+        free(data);
+
+    /* Check for errors, and count the sources. */
+    for (i = 0; i < num_slices; ++i)
+    {
+        if (!*status) *status = slices[i].status;
+        offset += slices[i].num_sources;
+    }
+
+    /* Create the sky model at its final size, and copy the sources. */
+    sky = oskar_sky_create(type, OSKAR_CPU, (int) offset, status);
+    if (!*status)
+    {
+        size_t* offsets = (size_t*) calloc(num_slices, sizeof(size_t));
+        for (i = 1; i < num_slices; ++i)
+            offsets[i] = offsets[i - 1] + slices[i - 1].num_sources;
+#pragma omp parallel for schedule(static, 1) private(i)
+        for (i = 0; i < num_slices; ++i)
+            copy_slice(&slices[i], offsets[i], sky);
+        free(offsets);
+    }
+
+    /* Free the parsed data. */
+    for (i = 0; i < num_slices; ++i) free(slices[i].par);
+    free(slices);
+
+    /* Check if an error occurred. */
+    if (*status)
+    {
+        oskar_sky_free(sky, status);
+        sky = 0;
+    }
+
+    /* Return a handle to the sky model. */
+    return sky;
+}
+
+static void parse_slice(const char* data, Slice* slice)
+{
+    char* line = 0;
+    size_t line_capacity = 0, pos = slice->start;
+
+    /* Loop over lines in the slice. */
+    while (pos < slice->end)
+    {
+        double* out;
+        const char* start = data + pos;
+        const char* eol = (const char*) memchr(start, '\n', slice->end - pos);
+        const size_t len = eol ? (size_t) (eol - start) : slice->end - pos;
+
         /* Set defaults. */
         /* RA, Dec, I, Q, U, V, freq0, spix, RM, FWHM maj, FWHM min, PA */
         double par[] = {0., 0., 0., 0., 0., 0., 0., 0., 0., 0., 0., 0.};
-        size_t num_param = sizeof(par) / sizeof(double);
         size_t num_required = 3, num_read = 0;
+        pos += len + 1;
+
+        /* Copy the line so that it can be tokenised. */
+        if (len + 1 > line_capacity)
+        {
+            char* t;
+            line_capacity = 2 * (len + 1);
+            t = (char*) realloc(line, line_capacity);
+            if (!t)
+            {
+                slice->status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+                break;
+            }
+            line = t;
+        }
+        memcpy(line, start, len);
+        line[len] = '\0';
 
         /* Load source parameters (require at least RA, Dec, Stokes I). */
-        num_read = oskar_string_to_array_d(line, num_param, par);
+        num_read = oskar_string_to_array_d(line, NUM_PAR, par);
         if (num_read < num_required)
             continue;
 
-        /* Ensure enough space in arrays. */
-        if (oskar_sky_num_sources(sky) <= n)
+        /* Ensure enough space in the slice buffer, growing geometrically. */
+        if (slice->num_sources == slice->capacity)
         {
-            oskar_sky_resize(sky, n + 100, status);
-            if (*status)
+            double* t;
+            slice->capacity = slice->capacity ? 2 * slice->capacity : 1024;
+            t = (double*) realloc(slice->par,
+                    slice->capacity * NUM_PAR * sizeof(double));
+            if (!t)
+            {
+                slice->status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
                 break;
+            }
+            slice->par = t;
         }
+        out = slice->par + NUM_PAR * slice->num_sources;
 
         if (num_read <= 9)
         {
             /* RA, Dec, I, Q, U, V, freq0, spix, RM */
-            oskar_sky_set_source(sky, n, par[0] * deg2rad,
-                    par[1] * deg2rad, par[2], par[3], par[4], par[5],
-                    par[6], par[7], par[8], 0.0, 0.0, 0.0, status);
+            memcpy(out, par, 9 * sizeof(double));
+            out[9] = out[10] = out[11] = 0.0;
         }
         else if (num_read == 11)
         {
             /* Old format, with no rotation measure. */
             /* RA, Dec, I, Q, U, V, freq0, spix, FWHM maj, FWHM min, PA */
-            oskar_sky_set_source(sky, n, par[0] * deg2rad,
-                    par[1] * deg2rad, par[2], par[3], par[4], par[5],
-                    par[6], par[7], 0.0, par[8] * arcsec2rad,
-                    par[9] * arcsec2rad, par[10] * deg2rad, status);
+            memcpy(out, par, 8 * sizeof(double));
+            out[8] = 0.0;
+            out[9] = par[8] * arcsec2rad;
+            out[10] = par[9] * arcsec2rad;
+            out[11] = par[10] * deg2rad;
         }
         else if (num_read == 12)
         {
             /* New format. */
             /* RA, Dec, I, Q, U, V, freq0, spix, RM, FWHM maj, FWHM min, PA */
-            oskar_sky_set_source(sky, n, par[0] * deg2rad,
-                    par[1] * deg2rad, par[2], par[3], par[4], par[5],
-                    par[6], par[7], par[8], par[9] * arcsec2rad,
-                    par[10] * arcsec2rad, par[11] * deg2rad, status);
+            memcpy(out, par, 9 * sizeof(double));
+            out[9] = par[9] * arcsec2rad;
+            out[10] = par[10] * arcsec2rad;
+            out[11] = par[11] * deg2rad;
         }
         else
         {
             /* Error. */
-            *status = OSKAR_ERR_BAD_SKY_FILE;
+            slice->status = OSKAR_ERR_BAD_SKY_FILE;
             break;
         }
-        ++n;
+        out[0] *= deg2rad;
+        out[1] *= deg2rad;
+        slice->num_sources++;
     }
+    free(line);
+}
 
-    /* Set the size to be the actual number of elements loaded. */
-    oskar_sky_resize(sky, n, status);
-
-    /* Free the line buffer and close the file. */
-    if (line) free(line);
-    fclose(file);
-
-    /* Check if an error occurred. */
-    if (*status)
-    {
-        oskar_sky_free(sky, status);
-        sky = 0;
+#define COPY_SLICE(FP) \
+    { \
+        FP *ra, *dec, *I, *Q, *U, *V, *ref, *spix, *rm, *maj, *mn, *pa; \
+        ra = (FP*) oskar_mem_void(sky->ra_rad) + offset; \
+        dec = (FP*) oskar_mem_void(sky->dec_rad) + offset; \
+        I = (FP*) oskar_mem_void(sky->I) + offset; \
+        Q = (FP*) oskar_mem_void(sky->Q) + offset; \
+        U = (FP*) oskar_mem_void(sky->U) + offset; \
+        V = (FP*) oskar_mem_void(sky->V) + offset; \
+        ref = (FP*) oskar_mem_void(sky->reference_freq_hz) + offset; \
+        spix = (FP*) oskar_mem_void(sky->spectral_index) + offset; \
+        rm = (FP*) oskar_mem_void(sky->rm_rad) + offset; \
+        maj = (FP*) oskar_mem_void(sky->fwhm_major_rad) + offset; \
+        mn = (FP*) oskar_mem_void(sky->fwhm_minor_rad) + offset; \
+        pa = (FP*) oskar_mem_void(sky->pa_rad) + offset; \
+        for (i = 0; i < slice->num_sources; ++i) \
+        { \
+            const double* p = slice->par + NUM_PAR * i; \
+            ra[i] = (FP) p[0]; dec[i] = (FP) p[1]; \
+            I[i] = (FP) p[2]; Q[i] = (FP) p[3]; \
+            U[i] = (FP) p[4]; V[i] = (FP) p[5]; \
+            ref[i] = (FP) p[6]; spix[i] = (FP) p[7]; \
+            rm[i] = (FP) p[8]; maj[i] = (FP) p[9]; \
+            mn[i] = (FP) p[10]; pa[i] = (FP) p[11]; \
+        } \
     }
 
-    /* Return a handle to the sky model. */
-    return sky;
+static void copy_slice(const Slice* slice, size_t offset, oskar_Sky* sky)
+{
+    size_t i;
+    if (sky->precision == OSKAR_DOUBLE)
+        COPY_SLICE(double)
+    else
+        COPY_SLICE(float)
 }
 
 #ifdef __cplusplus
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2012-2015, The University of Oxford
+ * Copyright (c) 2012-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -36,7 +36,7 @@ extern "C" {
 
 oskar_Sky* oskar_sky_read(const char* filename, int location, int* status)
 {
-    int type = 0, num_sources = 0, idx = 0;
+    int type = 0, num_sources = 0, num_chunks = 0, idx = 0;
     oskar_Binary* h = 0;
     unsigned char group = OSKAR_TAG_GROUP_SKY_MODEL;
     oskar_Sky* sky = 0;
@@ -61,6 +61,30 @@ oskar_Sky* oskar_sky_read(const char* filename, int location, int* status)
         return 0;
     }
 
+    /* Concatenate the chunks if the file was written in chunks. */
+    num_chunks = oskar_sky_read_num_chunks(h, status);
+    if (num_chunks > 0)
+    {
+        int c, offset = 0;
+        oskar_Sky* temp = oskar_sky_create(type, OSKAR_CPU, num_sources,
+                status);
+        for (c = 0; c < num_chunks; ++c)
+        {
+            oskar_Sky* chunk = oskar_sky_read_chunk(h, c, status);
+            if (*status) break;
+            oskar_sky_copy_contents(temp, chunk, offset, 0,
+                    oskar_sky_num_sources(chunk), status);
+            offset += oskar_sky_num_sources(chunk);
+            oskar_sky_free(chunk, status);
+        }
+        oskar_binary_free(h);
+        if (location == OSKAR_CPU && !*status) return temp;
+        if (!*status)
+            sky = oskar_sky_create_copy(temp, location, status);
+        oskar_sky_free(temp, status);
+        return sky;
+    }
+
     /* Create the sky model structure. */
     sky = oskar_sky_create(type, location, num_sources, status);
 
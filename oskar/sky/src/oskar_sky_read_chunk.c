@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sky/private_sky.h"
+#include "sky/oskar_sky.h"
+#include "binary/oskar_binary.h"
+#include "mem/oskar_binary_read_mem.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static void read_column(oskar_Binary* h, int type, unsigned char tag,
+        int chunk_index, int num_sources, oskar_Mem** column, int* status);
+
+int oskar_sky_read_num_chunks(oskar_Binary* h, int* status)
+{
+    int num_chunks = 0, tag_error = 0;
+    if (*status) return 0;
+    oskar_binary_read_int(h, OSKAR_TAG_GROUP_SKY_MODEL,
+            OSKAR_SKY_TAG_NUM_CHUNKS, 0, &num_chunks, &tag_error);
+    return tag_error ? 0 : num_chunks;
+}
+
+void oskar_sky_read_chunk_info(oskar_Binary* h, int chunk_index,
+        int* num_sources, double cap[3], double flux_range[2],
+        int* has_extended, int* status)
+{
+    const unsigned char group = OSKAR_TAG_GROUP_SKY_MODEL;
+    if (*status) return;
+    if (num_sources)
+        oskar_binary_read_int(h, group, OSKAR_SKY_TAG_CHUNK_NUM_SOURCES,
+                chunk_index, num_sources, status);
+    if (cap)
+        oskar_binary_read(h, OSKAR_DOUBLE, group, OSKAR_SKY_TAG_CHUNK_CAP,
+                chunk_index, 3 * sizeof(double), cap, status);
+    if (flux_range)
+        oskar_binary_read(h, OSKAR_DOUBLE, group,
+                OSKAR_SKY_TAG_CHUNK_FLUX_RANGE, chunk_index,
+                2 * sizeof(double), flux_range, status);
+    if (has_extended)
+        oskar_binary_read_int(h, group, OSKAR_SKY_TAG_CHUNK_HAS_EXTENDED,
+                chunk_index, has_extended, status);
+}
+
+oskar_Sky* oskar_sky_read_chunk(oskar_Binary* h, int chunk_index,
+        int* status)
+{
+    int type = 0, num_sources = 0, has_extended = 0;
+    oskar_Sky* sky = 0;
+
+    /* Check if safe to proceed. */
+    if (*status) return 0;
+
+    /* Read the chunk parameters. */
+    oskar_binary_read_int(h, OSKAR_TAG_GROUP_SKY_MODEL,
+            OSKAR_SKY_TAG_DATA_TYPE, 0, &type, status);
+    oskar_sky_read_chunk_info(h, chunk_index, &num_sources, 0, 0,
+            &has_extended, status);
+    if (*status) return 0;
+
+    /* Create an empty sky model, and replace its columns with the data
+     * from the file. Work arrays are allocated as normal. */
+    sky = oskar_sky_create(type, OSKAR_CPU, 0, status);
+    read_column(h, type, OSKAR_SKY_TAG_RA,
+            chunk_index, num_sources, &sky->ra_rad, status);
+    read_column(h, type, OSKAR_SKY_TAG_DEC,
+            chunk_index, num_sources, &sky->dec_rad, status);
+    read_column(h, type, OSKAR_SKY_TAG_STOKES_I,
+            chunk_index, num_sources, &sky->I, status);
+    read_column(h, type, OSKAR_SKY_TAG_STOKES_Q,
+            chunk_index, num_sources, &sky->Q, status);
+    read_column(h, type, OSKAR_SKY_TAG_STOKES_U,
+            chunk_index, num_sources, &sky->U, status);
+    read_column(h, type, OSKAR_SKY_TAG_STOKES_V,
+            chunk_index, num_sources, &sky->V, status);
+    read_column(h, type, OSKAR_SKY_TAG_REF_FREQ,
+            chunk_index, num_sources, &sky->reference_freq_hz, status);
+    read_column(h, type, OSKAR_SKY_TAG_SPECTRAL_INDEX,
+            chunk_index, num_sources, &sky->spectral_index, status);
+    read_column(h, type, OSKAR_SKY_TAG_FWHM_MAJOR,
+            chunk_index, num_sources, &sky->fwhm_major_rad, status);
+    read_column(h, type, OSKAR_SKY_TAG_FWHM_MINOR,
+            chunk_index, num_sources, &sky->fwhm_minor_rad, status);
+    read_column(h, type, OSKAR_SKY_TAG_POSITION_ANGLE,
+            chunk_index, num_sources, &sky->pa_rad, status);
+    read_column(h, type, OSKAR_SKY_TAG_ROTATION_MEASURE,
+            chunk_index, num_sources, &sky->rm_rad, status);
+    oskar_mem_realloc(sky->l, num_sources + 1, status);
+    oskar_mem_realloc(sky->m, num_sources + 1, status);
+    oskar_mem_realloc(sky->n, num_sources + 1, status);
+    oskar_mem_realloc(sky->gaussian_a, num_sources + 1, status);
+    oskar_mem_realloc(sky->gaussian_b, num_sources + 1, status);
+    oskar_mem_realloc(sky->gaussian_c, num_sources + 1, status);
+    sky->num_sources = num_sources;
+    sky->capacity = num_sources;
+    sky->use_extended = has_extended ? OSKAR_TRUE : OSKAR_FALSE;
+
+    /* Return a handle to the sky model, or NULL if an error occurred. */
+    if (*status)
+    {
+        oskar_sky_free(sky, status);
+        sky = 0;
+    }
+    return sky;
+}
+
+static void read_column(oskar_Binary* h, int type, unsigned char tag,
+        int chunk_index, int num_sources, oskar_Mem** column, int* status)
+{
+    oskar_Mem* mem;
+    if (*status) return;
+    mem = oskar_binary_read_mem_alias(h, type, OSKAR_TAG_GROUP_SKY_MODEL,
+            tag, chunk_index, status);
+    if (*status) return;
+    if ((int) oskar_mem_length(mem) != num_sources)
+    {
+        oskar_mem_free(mem, status);
+        *status = OSKAR_ERR_BINARY_FORMAT_BAD;
+        return;
+    }
+    oskar_mem_free(*column, status);
+    *column = mem;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sky/private_sky.h"
+#include "sky/oskar_sky.h"
+#include "math/oskar_cmath.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct SortKey
+{
+    uint64_t code;
+    int index;
+};
+typedef struct SortKey SortKey;
+
+static uint64_t curve_index(double ra, double dec);
+static int compare_keys(const void* a, const void* b);
+static void permute(oskar_Mem* mem, const SortKey* keys, int num_sources,
+        void* temp, int* status);
+
+/* Number of subdivisions of each HEALPix base face is 2^ORDER. */
+#define ORDER 20
+
+#define SORT_KEYS(FP) {\
+        const FP *ra_ = oskar_mem_ ## FP ## _const(sky->ra_rad, status);\
+        const FP *dec_ = oskar_mem_ ## FP ## _const(sky->dec_rad, status);\
+        for (i = 0; i < num_sources; ++i) {\
+            keys[i].code = curve_index(ra_[i], dec_[i]);\
+            keys[i].index = i;\
+        }\
+    }
+
+void oskar_sky_sort_spatial(oskar_Sky* sky, int* status)
+{
+    int i;
+    SortKey* keys;
+    void* temp;
+    if (*status) return;
+    if (sky->mem_location != OSKAR_CPU)
+    {
+        *status = OSKAR_ERR_BAD_LOCATION;
+        return;
+    }
+    const int num_sources = sky->num_sources;
+    if (num_sources < 2) return;
+
+    /* Get the position of each source along the curve, and sort them. */
+    keys = (SortKey*) malloc(num_sources * sizeof(SortKey));
+    temp = malloc(num_sources * oskar_mem_element_size(sky->precision));
+    if (!keys || !temp)
+    {
+        free(keys);
+        free(temp);
+        *status = OSKAR_ERR_MEMORY_ALLOC_FAILURE;
+        return;
+    }
+    if (sky->precision == OSKAR_DOUBLE)
+        SORT_KEYS(double)
+    else
+        SORT_KEYS(float)
+    qsort(keys, num_sources, sizeof(SortKey), compare_keys);
+
+    /* Reorder all the source parameters. */
+    permute(sky->ra_rad, keys, num_sources, temp, status);
+    permute(sky->dec_rad, keys, num_sources, temp, status);
+    permute(sky->I, keys, num_sources, temp, status);
+    permute(sky->Q, keys, num_sources, temp, status);
+    permute(sky->U, keys, num_sources, temp, status);
+    permute(sky->V, keys, num_sources, temp, status);
+    permute(sky->reference_freq_hz, keys, num_sources, temp, status);
+    permute(sky->spectral_index, keys, num_sources, temp, status);
+    permute(sky->rm_rad, keys, num_sources, temp, status);
+    permute(sky->l, keys, num_sources, temp, status);
+    permute(sky->m, keys, num_sources, temp, status);
+    permute(sky->n, keys, num_sources, temp, status);
+    permute(sky->fwhm_major_rad, keys, num_sources, temp, status);
+    permute(sky->fwhm_minor_rad, keys, num_sources, temp, status);
+    permute(sky->pa_rad, keys, num_sources, temp, status);
+    permute(sky->gaussian_a, keys, num_sources, temp, status);
+    permute(sky->gaussian_b, keys, num_sources, temp, status);
+    permute(sky->gaussian_c, keys, num_sources, temp, status);
+    free(keys);
+    free(temp);
+}
+
+/*
+ * Returns the index of the HEALPix base face containing the direction,
+ * followed by the distance along a Hilbert curve through the face.
+ * The face and pixel coordinates follow the HEALPix nested scheme
+ * (Gorski et al. 2005), which has no problems at the poles.
+ */
+static uint64_t curve_index(double ra, double dec)
+{
+    int face, ix, iy, s;
+    uint64_t d = 0;
+    const int nside = 1 << ORDER;
+    const double z = sin(dec), za = fabs(z);
+    double tt = fmod(ra, 2.0 * M_PI);
+    if (tt < 0.0) tt += 2.0 * M_PI;
+    tt *= 2.0 / M_PI; /* In range [0, 4). */
+    if (za <= 2.0 / 3.0)
+    {
+        /* Equatorial region. */
+        const double t1 = nside * (0.5 + tt), t2 = nside * z * 0.75;
+        const int jp = (int)(t1 - t2), jm = (int)(t1 + t2);
+        const int ifp = jp >> ORDER, ifm = jm >> ORDER;
+        face = (ifp == ifm) ? (ifp | 4) : ((ifp < ifm) ? ifp : (ifm + 8));
+        ix = jm & (nside - 1);
+        iy = nside - (jp & (nside - 1)) - 1;
+    }
+    else
+    {
+        /* Polar caps. */
+        int ntt = (int) tt, jp, jm;
+        double tp, tmp;
+        if (ntt >= 4) ntt = 3;
+        tp = tt - ntt;
+        tmp = nside * sqrt(3.0 * (1.0 - za));
+        jp = (int)(tp * tmp);
+        jm = (int)((1.0 - tp) * tmp);
+        if (jp >= nside) jp = nside - 1;
+        if (jm >= nside) jm = nside - 1;
+        if (z >= 0.0)
+        {
+            face = ntt;
+            ix = nside - jm - 1;
+            iy = nside - jp - 1;
+        }
+        else
+        {
+            face = ntt + 8;
+            ix = jp;
+            iy = jm;
+        }
+    }
+
+    /* Get the distance along the Hilbert curve through the face. */
+    for (s = nside / 2; s > 0; s /= 2)
+    {
+        const int rx = (ix & s) > 0, ry = (iy & s) > 0;
+        d += (uint64_t) s * (uint64_t) s * (uint64_t) ((3 * rx) ^ ry);
+        if (ry == 0)
+        {
+            const int t = ix;
+            if (rx == 1)
+            {
+                ix = nside - 1 - iy;
+                iy = nside - 1 - t;
+            }
+            else
+            {
+                ix = iy;
+                iy = t;
+            }
+        }
+    }
+    return ((uint64_t) face << (2 * ORDER)) | d;
+}
+
+static int compare_keys(const void* a, const void* b)
+{
+    const SortKey *x = (const SortKey*) a, *y = (const SortKey*) b;
+    if (x->code != y->code) return (x->code < y->code) ? -1 : 1;
+    return (x->index > y->index) - (x->index < y->index);
+}
+
+static void permute(oskar_Mem* mem, const SortKey* keys, int num_sources,
+        void* temp, int* status)
+{
+    int i;
+    if (*status) return;
+    if (oskar_mem_precision(mem) == OSKAR_DOUBLE)
+    {
+        double *p = oskar_mem_double(mem, status), *t = (double*) temp;
+        for (i = 0; i < num_sources; ++i) t[i] = p[keys[i].index];
+    }
+    else
+    {
+        float *p = oskar_mem_float(mem, status), *t = (float*) temp;
+        for (i = 0; i < num_sources; ++i) t[i] = p[keys[i].index];
+    }
+    memcpy(oskar_mem_void(mem), temp,
+            num_sources * oskar_mem_element_size(oskar_mem_type(mem)));
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sky/private_sky.h"
+#include "sky/oskar_sky.h"
+#include "binary/oskar_binary.h"
+#include "mem/oskar_binary_write_mem.h"
+
+#include <float.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static void write_column(oskar_Binary* h, const oskar_Mem* src,
+        unsigned char tag, int chunk, int offset, int num_sources,
+        int* status);
+
+void oskar_sky_write_chunked(const char* filename, const oskar_Sky* sky,
+        int chunk_size, int* status)
+{
+    int c, i, num_chunks;
+    const int type = oskar_sky_precision(sky);
+    const int num_sources = oskar_sky_num_sources(sky);
+    const unsigned char group = OSKAR_TAG_GROUP_SKY_MODEL;
+    oskar_Binary* h = 0;
+    if (*status) return;
+
+    /* Check the chunk size and the data location. */
+    if (chunk_size <= 0)
+    {
+        *status = OSKAR_ERR_INVALID_ARGUMENT;
+        return;
+    }
+    if (oskar_sky_mem_location(sky) != OSKAR_CPU)
+    {
+        *status = OSKAR_ERR_BAD_LOCATION;
+        return;
+    }
+    num_chunks = (num_sources + chunk_size - 1) / chunk_size;
+
+    /* Create the file handle. */
+    h = oskar_binary_create(filename, 'w', status);
+
+    /* Write the sky model data parameters. */
+    oskar_binary_write_int(h, group,
+            OSKAR_SKY_TAG_NUM_SOURCES, 0, num_sources, status);
+    oskar_binary_write_int(h, group,
+            OSKAR_SKY_TAG_DATA_TYPE, 0, type, status);
+    oskar_binary_write_int(h, group,
+            OSKAR_SKY_TAG_CHUNK_SIZE, 0, chunk_size, status);
+    oskar_binary_write_int(h, group,
+            OSKAR_SKY_TAG_NUM_CHUNKS, 0, num_chunks, status);
+
+    /* Write each chunk. */
+    for (c = 0; c < num_chunks; ++c)
+    {
+        int n, has_extended = 0;
+        const int offset = c * chunk_size;
+        double cap[3], flux_range[2] = {DBL_MAX, -DBL_MAX};
+        if (*status) break;
+        n = num_sources - offset;
+        if (n > chunk_size) n = chunk_size;
+
+        /* Find the statistics for the chunk. */
+        oskar_sky_bounding_cap(sky, offset, n,
+                &cap[0], &cap[1], &cap[2], status);
+        if (type == OSKAR_DOUBLE)
+        {
+            const double *I_, *maj_, *min_;
+            I_ = oskar_mem_double_const(sky->I, status) + offset;
+            maj_ = oskar_mem_double_const(sky->fwhm_major_rad, status) + offset;
+            min_ = oskar_mem_double_const(sky->fwhm_minor_rad, status) + offset;
+            for (i = 0; i < n; ++i)
+            {
+                if (I_[i] < flux_range[0]) flux_range[0] = I_[i];
+                if (I_[i] > flux_range[1]) flux_range[1] = I_[i];
+                if (maj_[i] > 0.0 || min_[i] > 0.0) has_extended = 1;
+            }
+        }
+        else
+        {
+            const float *I_, *maj_, *min_;
+            I_ = oskar_mem_float_const(sky->I, status) + offset;
+            maj_ = oskar_mem_float_const(sky->fwhm_major_rad, status) + offset;
+            min_ = oskar_mem_float_const(sky->fwhm_minor_rad, status) + offset;
+            for (i = 0; i < n; ++i)
+            {
+                if (I_[i] < flux_range[0]) flux_range[0] = I_[i];
+                if (I_[i] > flux_range[1]) flux_range[1] = I_[i];
+                if (maj_[i] > 0.0 || min_[i] > 0.0) has_extended = 1;
+            }
+        }
+
+        /* Write the statistics. */
+        oskar_binary_write_int(h, group,
+                OSKAR_SKY_TAG_CHUNK_NUM_SOURCES, c, n, status);
+        oskar_binary_write(h, OSKAR_DOUBLE, group,
+                OSKAR_SKY_TAG_CHUNK_CAP, c, sizeof(cap), cap, status);
+        oskar_binary_write(h, OSKAR_DOUBLE, group,
+                OSKAR_SKY_TAG_CHUNK_FLUX_RANGE, c, sizeof(flux_range),
+                flux_range, status);
+        oskar_binary_write_int(h, group,
+                OSKAR_SKY_TAG_CHUNK_HAS_EXTENDED, c, has_extended, status);
+
+        /* Write the columns. */
+        write_column(h, sky->ra_rad,
+                OSKAR_SKY_TAG_RA, c, offset, n, status);
+        write_column(h, sky->dec_rad,
+                OSKAR_SKY_TAG_DEC, c, offset, n, status);
+        write_column(h, sky->I,
+                OSKAR_SKY_TAG_STOKES_I, c, offset, n, status);
+        write_column(h, sky->Q,
+                OSKAR_SKY_TAG_STOKES_Q, c, offset, n, status);
+        write_column(h, sky->U,
+                OSKAR_SKY_TAG_STOKES_U, c, offset, n, status);
+        write_column(h, sky->V,
+                OSKAR_SKY_TAG_STOKES_V, c, offset, n, status);
+        write_column(h, sky->reference_freq_hz,
+                OSKAR_SKY_TAG_REF_FREQ, c, offset, n, status);
+        write_column(h, sky->spectral_index,
+                OSKAR_SKY_TAG_SPECTRAL_INDEX, c, offset, n, status);
+        write_column(h, sky->fwhm_major_rad,
+                OSKAR_SKY_TAG_FWHM_MAJOR, c, offset, n, status);
+        write_column(h, sky->fwhm_minor_rad,
+                OSKAR_SKY_TAG_FWHM_MINOR, c, offset, n, status);
+        write_column(h, sky->pa_rad,
+                OSKAR_SKY_TAG_POSITION_ANGLE, c, offset, n, status);
+        write_column(h, sky->rm_rad,
+                OSKAR_SKY_TAG_ROTATION_MEASURE, c, offset, n, status);
+    }
+
+    /* Release the handle. */
+    oskar_binary_free(h);
+}
+
+static void write_column(oskar_Binary* h, const oskar_Mem* src,
+        unsigned char tag, int chunk, int offset, int num_sources,
+        int* status)
+{
+    oskar_Mem* alias;
+    if (*status) return;
+    alias = oskar_mem_create_alias(src, (size_t) offset,
+            (size_t) num_sources, status);
+    oskar_binary_write_align(h, 8, status);
+    oskar_binary_write_mem(h, alias, OSKAR_TAG_GROUP_SKY_MODEL,
+            tag, chunk, num_sources, status);
+    oskar_mem_free(alias, status);
+}
+
+#ifdef __cplusplus
+}
+#endif
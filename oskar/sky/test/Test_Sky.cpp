@@ -36,6 +36,7 @@
 #include "utility/oskar_device.h"
 
 #include <cstdlib>
+#include <vector>
 #include "math/oskar_cmath.h"
 
 #ifdef OSKAR_HAVE_CUDA
@@ -571,6 +572,116 @@ TEST(SkyModel, horizon_clip)
 }
 
 
+TEST(SkyModel, sort_spatial_horizon_cap)
+{
+    int status = 0, num_sources = 20000, chunk_size = 100;
+    const double deg2rad = M_PI / 180.0;
+
+    // Generate random sources over the whole sky, with I set to the index.
+    oskar_Sky* sky = oskar_sky_generate_random_power_law(OSKAR_DOUBLE,
+            num_sources, 1.0, 2.0, -2.0, 1, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    double* I = oskar_mem_double(oskar_sky_I(sky), &status);
+    for (int i = 0; i < num_sources; ++i) I[i] = (double) i;
+
+    // Sort the sources, and check they have only been reordered.
+    oskar_Sky* sorted = oskar_sky_create_copy(sky, OSKAR_CPU, &status);
+    oskar_sky_sort_spatial(sorted, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    const double* ra = oskar_mem_double_const(
+            oskar_sky_ra_rad_const(sky), &status);
+    const double* ra_sorted = oskar_mem_double_const(
+            oskar_sky_ra_rad_const(sorted), &status);
+    const double* I_sorted = oskar_mem_double_const(
+            oskar_sky_I_const(sorted), &status);
+    std::vector<int> seen(num_sources, 0);
+    for (int i = 0; i < num_sources; ++i)
+    {
+        const int j = (int) I_sorted[i];
+        ASSERT_GE(j, 0);
+        ASSERT_LT(j, num_sources);
+        seen[j]++;
+        EXPECT_EQ(ra[j], ra_sorted[i]);
+    }
+    for (int i = 0; i < num_sources; ++i) EXPECT_EQ(1, seen[i]);
+
+    // Chunks of sorted sources should have much smaller caps.
+    double mean_radius = 0.0, mean_radius_sorted = 0.0;
+    const int num_chunks = num_sources / chunk_size;
+    for (int c = 0; c < num_chunks; ++c)
+    {
+        double lon, lat, radius;
+        oskar_sky_bounding_cap(sky, c * chunk_size, chunk_size,
+                &lon, &lat, &radius, &status);
+        mean_radius += radius / num_chunks;
+        oskar_sky_bounding_cap(sorted, c * chunk_size, chunk_size,
+                &lon, &lat, &radius, &status);
+        mean_radius_sorted += radius / num_chunks;
+    }
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    EXPECT_LT(mean_radius_sorted, 0.25 * mean_radius);
+
+    // Create a telescope model with stations at two latitudes.
+    oskar_Telescope* telescope = oskar_telescope_create(OSKAR_DOUBLE,
+            OSKAR_CPU, 0, &status);
+    oskar_telescope_resize(telescope, 2, &status);
+    oskar_station_set_position(oskar_telescope_station(telescope, 0),
+            0.1, -30.0 * deg2rad, 0.0);
+    oskar_station_set_position(oskar_telescope_station(telescope, 1),
+            0.2, -26.0 * deg2rad, 0.0);
+    oskar_StationWork* work = oskar_station_work_create(OSKAR_DOUBLE,
+            OSKAR_CPU, &status);
+    oskar_Sky* chunk = oskar_sky_create(OSKAR_DOUBLE, OSKAR_CPU,
+            chunk_size, &status);
+    oskar_Sky* chunk_clip = oskar_sky_create(OSKAR_DOUBLE, OSKAR_CPU,
+            chunk_size, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Check the cap tests agree with the horizon clip.
+    int num_below = 0, num_above = 0;
+    for (int t = 0; t < 4; ++t)
+    {
+        const double gast = t * M_PI / 2.0;
+        for (int c = 0; c < num_chunks; ++c)
+        {
+            double lon, lat, radius;
+            oskar_sky_bounding_cap(sorted, c * chunk_size, chunk_size,
+                    &lon, &lat, &radius, &status);
+            oskar_sky_copy_contents(chunk, sorted, 0, c * chunk_size,
+                    chunk_size, &status);
+            oskar_sky_evaluate_relative_directions(chunk, 0.0, 0.0, &status);
+            oskar_sky_horizon_clip(chunk_clip, chunk, telescope, gast,
+                    work, &status);
+            ASSERT_EQ(0, status) << oskar_get_error_string(status);
+            const int n = oskar_sky_num_sources(chunk_clip);
+            switch (oskar_sky_horizon_cap(lon, lat, radius, telescope, gast))
+            {
+            case OSKAR_SKY_CAP_BELOW_HORIZON:
+                EXPECT_EQ(0, n);
+                num_below++;
+                break;
+            case OSKAR_SKY_CAP_ABOVE_HORIZON:
+                EXPECT_EQ(chunk_size, n);
+                num_above++;
+                break;
+            default:
+                break;
+            }
+        }
+    }
+    EXPECT_GT(num_below, num_chunks);
+    EXPECT_GT(num_above, num_chunks);
+
+    // Clean up.
+    oskar_sky_free(chunk, &status);
+    oskar_sky_free(chunk_clip, &status);
+    oskar_sky_free(sorted, &status);
+    oskar_sky_free(sky, &status);
+    oskar_station_work_free(work, &status);
+    oskar_telescope_free(telescope, &status);
+}
+
+
 TEST(SkyModel, resize)
 {
     int status = 0;
@@ -843,6 +954,96 @@ TEST(SkyModel, rotation_measure)
 }
 
 
+TEST(SkyModel, evaluate_flux)
+{
+    int status = 0, num_sources = 1000, num_channels = 5;
+    double freq_start = 100e6, freq_inc = 20e6;
+
+    // Create a sky model with varied spectral indices and rotation measures.
+    // The last source has no reference frequency, so is not scaled.
+    oskar_Sky* sky = oskar_sky_create(OSKAR_DOUBLE, OSKAR_CPU,
+            num_sources, &status);
+    for (int i = 0; i < num_sources; ++i)
+    {
+        oskar_sky_set_source(sky, i, 0.0, 0.0, 10.0 + i, 1.0, 0.5, 0.1,
+                (i == num_sources - 1) ? 0.0 : 150e6, -0.7 + 0.001 * i,
+                0.01 * i, 0.0, 0.0, 0.0, &status);
+    }
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Evaluate the fluxes in all channels at once, on the device.
+    oskar_Sky* sky_dev = oskar_sky_create_copy(sky, device_loc, &status);
+    oskar_Mem* flux[4];
+    for (int k = 0; k < 4; ++k)
+        flux[k] = oskar_mem_create(OSKAR_DOUBLE, device_loc, 0, &status);
+    oskar_sky_evaluate_flux(sky_dev, num_channels, freq_start, freq_inc,
+            flux[0], flux[1], flux[2], flux[3], &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    ASSERT_EQ((size_t) (num_channels * num_sources),
+            oskar_mem_length(flux[0]));
+
+    // The sky model must not have been modified.
+    double max_, avg_;
+    oskar_Sky* sky_check = oskar_sky_create_copy(sky_dev, OSKAR_CPU, &status);
+    oskar_mem_evaluate_relative_error(oskar_sky_I_const(sky_check),
+            oskar_sky_I_const(sky), 0, &max_, &avg_, 0, &status);
+    EXPECT_EQ(0.0, max_);
+    oskar_mem_evaluate_relative_error(
+            oskar_sky_reference_freq_hz_const(sky_check),
+            oskar_sky_reference_freq_hz_const(sky), 0, &max_, &avg_, 0,
+            &status);
+    EXPECT_EQ(0.0, max_);
+
+    // Compare with scaling a copy of the sky model for each channel.
+    for (int c = 0; c < num_channels; ++c)
+    {
+        oskar_Sky* sky_scaled = oskar_sky_create_copy(sky, OSKAR_CPU, &status);
+        oskar_sky_scale_flux_with_frequency(sky_scaled,
+                freq_start + c * freq_inc, &status);
+        const oskar_Mem* expected[] = {
+                oskar_sky_I_const(sky_scaled), oskar_sky_Q_const(sky_scaled),
+                oskar_sky_U_const(sky_scaled), oskar_sky_V_const(sky_scaled)
+        };
+        for (int k = 0; k < 4; ++k)
+        {
+            oskar_Mem* flux_cpu = oskar_mem_create_copy(flux[k],
+                    OSKAR_CPU, &status);
+            const double* f = oskar_mem_double_const(flux_cpu, &status);
+            const double* e = oskar_mem_double_const(expected[k], &status);
+            for (int i = 0; i < num_sources - 1; ++i)
+                EXPECT_NEAR(e[i], f[c * num_sources + i], 1e-12);
+            oskar_mem_free(flux_cpu, &status);
+        }
+        oskar_sky_free(sky_scaled, &status);
+    }
+
+    // Check the unscaled source, and an alias of the last channel.
+    oskar_Sky* sky_alias = oskar_sky_create_flux_alias(sky_check,
+            flux[0], flux[1], flux[2], flux[3],
+            (num_channels - 1) * num_sources, &status);
+    oskar_Sky* sky_alias_cpu = oskar_sky_create_copy(sky_alias,
+            OSKAR_CPU, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    ASSERT_EQ(num_sources, oskar_sky_num_sources(sky_alias_cpu));
+    const double* I = oskar_mem_double_const(
+            oskar_sky_I_const(sky_alias_cpu), &status);
+    const double* V = oskar_mem_double_const(
+            oskar_sky_V_const(sky_alias_cpu), &status);
+    EXPECT_DOUBLE_EQ(10.0 + num_sources - 1, I[num_sources - 1]);
+    EXPECT_DOUBLE_EQ(0.1, V[num_sources - 1]);
+    EXPECT_DOUBLE_EQ(10.0 * pow((freq_start + (num_channels - 1) * freq_inc) /
+            150e6, -0.7), I[0]);
+
+    // Clean up.
+    oskar_sky_free(sky_alias, &status);
+    oskar_sky_free(sky_alias_cpu, &status);
+    oskar_sky_free(sky_check, &status);
+    oskar_sky_free(sky_dev, &status);
+    oskar_sky_free(sky, &status);
+    for (int k = 0; k < 4; ++k) oskar_mem_free(flux[k], &status);
+}
+
+
 TEST(SkyModel, set_source)
 {
     int status = 0;
@@ -1152,6 +1353,73 @@ TEST(SkyModel, load_ascii)
 }
 
 
+TEST(SkyModel, load_ascii_large)
+{
+    int status = 0;
+    const double deg2rad = 0.0174532925199432957692;
+    const double arcsec2rad = 4.84813681109535993589914e-6;
+    const char* filename = "temp_sources_large.osm";
+
+    // Write a file large enough to be split between threads,
+    // using a mixture of line formats.
+    FILE* file = fopen(filename, "w");
+    if (!file) FAIL() << "Unable to create test file";
+    int num_sources = 200000;
+    for (int i = 0; i < num_sources; ++i)
+    {
+        if (i % 1000 == 0) fprintf(file, "# some comment!\n\n");
+        switch (i % 3)
+        {
+        case 0:
+            fprintf(file, "%.6f %.6f %d\n", i * 1e-3, -i * 1e-4, i);
+            break;
+        case 1:
+            fprintf(file, "%.6f,%.6f,%d,1,2,3,1e8,-0.7,5,10,20,30\n",
+                    i * 1e-3, -i * 1e-4, i);
+            break;
+        default:
+            fprintf(file, "%.6f %.6f %d 1 2 3 1e8 -0.7 10 20 30 # old\n",
+                    i * 1e-3, -i * 1e-4, i);
+            break;
+        }
+    }
+    fclose(file);
+
+    // Load the file, and check the sources are in order.
+    oskar_Sky* sky = oskar_sky_load(filename, OSKAR_DOUBLE, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    ASSERT_EQ(num_sources, oskar_sky_num_sources(sky));
+    const double* ra = oskar_mem_double(oskar_sky_ra_rad(sky), &status);
+    const double* dec = oskar_mem_double(oskar_sky_dec_rad(sky), &status);
+    const double* I = oskar_mem_double(oskar_sky_I(sky), &status);
+    const double* rm = oskar_mem_double(
+            oskar_sky_rotation_measure_rad(sky), &status);
+    const double* maj = oskar_mem_double(
+            oskar_sky_fwhm_major_rad(sky), &status);
+    const double* pa = oskar_mem_double(
+            oskar_sky_position_angle_rad(sky), &status);
+    for (int i = 0; i < num_sources; ++i)
+    {
+        ASSERT_DOUBLE_EQ(i * 1e-3 * deg2rad, ra[i]);
+        ASSERT_DOUBLE_EQ(-i * 1e-4 * deg2rad, dec[i]);
+        ASSERT_DOUBLE_EQ((double)i, I[i]);
+        ASSERT_DOUBLE_EQ(i % 3 == 1 ? 5.0 : 0.0, rm[i]);
+        ASSERT_DOUBLE_EQ(i % 3 == 0 ? 0.0 : 10.0 * arcsec2rad, maj[i]);
+        ASSERT_DOUBLE_EQ(i % 3 == 0 ? 0.0 : 30.0 * deg2rad, pa[i]);
+    }
+    oskar_sky_free(sky, &status);
+
+    // Check that a line with the wrong number of columns is an error.
+    file = fopen(filename, "a");
+    fprintf(file, "1 2 3 4 5 6 7 8 9 10\n");
+    fclose(file);
+    sky = oskar_sky_load(filename, OSKAR_SINGLE, &status);
+    EXPECT_EQ((int)OSKAR_ERR_BAD_SKY_FILE, status);
+    EXPECT_TRUE(sky == 0);
+    remove(filename);
+}
+
+
 TEST(SkyModel, read_write)
 {
     oskar_Sky *sky, *sky2;
@@ -1252,3 +1520,94 @@ TEST(SkyModel, read_write)
     remove(filename);
 }
 
+
+TEST(SkyModel, read_write_chunked)
+{
+    int status = 0, num_sources = 1000, chunk_size = 300;
+    const char* filename = "test_sky_model_write_chunked.osm";
+    oskar_Sky* sky = oskar_sky_create(OSKAR_DOUBLE, OSKAR_CPU,
+            num_sources, &status);
+
+    // Fill sky model with some test data, near (RA, Dec) = (10, 20) deg.
+    // Only sources in the last chunk are extended.
+    for (int i = 0; i < num_sources; ++i)
+    {
+        double ra = (10.0 + 0.001 * i) * M_PI / 180.0;
+        double dec = (20.0 - 0.002 * i) * M_PI / 180.0;
+        double maj = (i >= 900) ? 1e-5 : 0.0;
+        oskar_sky_set_source(sky, i, ra, dec, 1.0 + i, 0.1 * i, 0.2 * i,
+                0.3 * i, 100e6, -0.7, 0.0, maj, maj, 0.0, &status);
+    }
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Write it to a file in chunks.
+    oskar_sky_write_chunked(filename, sky, chunk_size, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Check the chunk statistics, and the contents of each chunk.
+    oskar_Binary* h = oskar_binary_create(filename, 'r', &status);
+    ASSERT_EQ(4, oskar_sky_read_num_chunks(h, &status));
+    for (int c = 0, offset = 0; c < 4; ++c)
+    {
+        int n = 0, has_extended = 0;
+        double cap[3], flux_range[2];
+        oskar_sky_read_chunk_info(h, c, &n, cap, flux_range,
+                &has_extended, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        ASSERT_EQ(c < 3 ? chunk_size : 100, n);
+        EXPECT_DOUBLE_EQ(1.0 + offset, flux_range[0]);
+        EXPECT_DOUBLE_EQ(1.0 + offset + n - 1, flux_range[1]);
+        EXPECT_EQ(c == 3 ? 1 : 0, has_extended);
+        EXPECT_LT(cap[2], 1.0 * M_PI / 180.0);
+
+        // Every source must be inside the bounding cap.
+        for (int i = offset; i < offset + n; ++i)
+        {
+            double ra = oskar_mem_double(oskar_sky_ra_rad(sky), &status)[i];
+            double dec = oskar_mem_double(oskar_sky_dec_rad(sky), &status)[i];
+            double d = acos(sin(cap[1]) * sin(dec) +
+                    cos(cap[1]) * cos(dec) * cos(ra - cap[0]));
+            EXPECT_LE(d, cap[2] + 1e-12);
+        }
+
+        oskar_Sky* chunk = oskar_sky_read_chunk(h, c, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        ASSERT_EQ(n, oskar_sky_num_sources(chunk));
+        EXPECT_EQ(c == 3 ? 1 : 0, oskar_sky_use_extended(chunk));
+        const double* I = oskar_mem_double_const(oskar_sky_I_const(chunk),
+                &status);
+        const double* V = oskar_mem_double_const(oskar_sky_V_const(chunk),
+                &status);
+        for (int i = 0; i < n; ++i)
+        {
+            EXPECT_DOUBLE_EQ(1.0 + offset + i, I[i]);
+            EXPECT_DOUBLE_EQ(0.3 * (offset + i), V[i]);
+        }
+
+        // The chunk must be usable by the simulator.
+        oskar_sky_evaluate_relative_directions(chunk,
+                10.0 * M_PI / 180.0, 20.0 * M_PI / 180.0, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        oskar_sky_free(chunk, &status);
+        offset += n;
+    }
+    oskar_binary_free(h);
+
+    // Read the whole file back as a single sky model.
+    oskar_Sky* sky2 = oskar_sky_read(filename, OSKAR_CPU, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    ASSERT_EQ(num_sources, oskar_sky_num_sources(sky2));
+    double max_, avg_;
+    oskar_mem_evaluate_relative_error(oskar_sky_ra_rad_const(sky),
+            oskar_sky_ra_rad_const(sky2), 0, &max_, &avg_, 0, &status);
+    EXPECT_EQ(0.0, max_);
+    oskar_mem_evaluate_relative_error(oskar_sky_fwhm_major_rad_const(sky),
+            oskar_sky_fwhm_major_rad_const(sky2), 0, &max_, &avg_, 0,
+            &status);
+    EXPECT_EQ(0.0, max_);
+
+    // Clean up.
+    oskar_sky_free(sky2, &status);
+    oskar_sky_free(sky, &status);
+    remove(filename);
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2014, The University of Oxford
+ * Copyright (c) 2013-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -28,8 +28,7 @@
 
 #include <gtest/gtest.h>
 
-#include "oskar_settings_load_tid_parameter_file.h"
-#include "oskar_Settings_old.h"
+#include "sky/oskar_load_tid_parameter_file.h"
 
 #include "utility/oskar_get_error_string.h"
 
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sky/oskar_sky.h"
+#include "utility/oskar_get_error_string.h"
+#include "utility/oskar_timer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Writes a sky model text file with the given number of lines,
+ * then times loading it.
+ */
+int main(int argc, char** argv)
+{
+    const char filename[] = "temp_test_sky_load_benchmark.osm";
+    int i, num_sources = 10000000, status = 0;
+    double t_load;
+    oskar_Sky* sky;
+    oskar_Timer* timer;
+    FILE* file;
+
+    if (argc > 1) num_sources = atoi(argv[1]);
+    if (num_sources < 1)
+    {
+        fprintf(stderr, "Usage: %s [number of sources]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    /* Write the file. */
+    file = fopen(filename, "w");
+    if (!file)
+    {
+        fprintf(stderr, "Unable to create test file.\n");
+        return EXIT_FAILURE;
+    }
+    for (i = 0; i < num_sources; ++i)
+        fprintf(file, "%.6f %.6f %.3f 0 0 0 1.5e8 -0.7\n",
+                (i % 36000) * 0.01, (i % 18000) * 0.01 - 90.0,
+                1.0 + (i % 1000) * 0.001);
+    fclose(file);
+
+    /* Load the file. */
+    timer = oskar_timer_create(OSKAR_TIMER_NATIVE);
+    oskar_timer_start(timer);
+    sky = oskar_sky_load(filename, OSKAR_DOUBLE, &status);
+    t_load = oskar_timer_elapsed(timer);
+    oskar_timer_free(timer);
+    remove(filename);
+    if (status || oskar_sky_num_sources(sky) != num_sources)
+    {
+        fprintf(stderr, "Error loading file: %s\n",
+                oskar_get_error_string(status));
+        oskar_sky_free(sky, &status);
+        return EXIT_FAILURE;
+    }
+    oskar_sky_free(sky, &status);
+
+    printf("Sources: %d\n", num_sources);
+    printf("Load: %.3f sec\n", t_load);
+    return 0;
+}
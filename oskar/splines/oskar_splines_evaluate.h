@@ -59,6 +59,37 @@ void oskar_splines_evaluate(const oskar_Splines* spline,
         int num_points, const oskar_Mem* x, const oskar_Mem* y,
         int stride_out, int offset_out, oskar_Mem* output, int* status);
 
+/**
+ * @brief
+ * Evaluates several surfaces fitted by splines at the same positions.
+ *
+ * @details
+ * This function evaluates a set of surfaces fitted by splines at the
+ * given positions, writing each surface to its own offset in the
+ * output array.
+ *
+ * In CPU memory, the knot span and B-spline basis at each position are
+ * computed only once for all surfaces that share the same knot vectors,
+ * and positions are processed in parallel. The results are identical to
+ * calling oskar_splines_evaluate() for each surface in turn, which is
+ * what is done in device memory.
+ *
+ * @param[in] num_surfaces Number of surfaces to evaluate.
+ * @param[in] splines     Array of pointers to spline data structures.
+ * @param[in] num_points  Number of positions.
+ * @param[in] x           List of x coordinates.
+ * @param[in] y           List of y coordinates.
+ * @param[in] stride_out  Stride between output values for each surface.
+ * @param[in] offset_out  Array of output offsets, one for each surface.
+ * @param[out] output     Output values.
+ * @param[in,out] status  Status return code.
+ */
+OSKAR_EXPORT
+void oskar_splines_evaluate_multi(int num_surfaces,
+        const oskar_Splines* const* splines, int num_points,
+        const oskar_Mem* x, const oskar_Mem* y, int stride_out,
+        const int* offset_out, oskar_Mem* output, int* status);
+
 #ifdef __cplusplus
 }
 #endif
@@ -27,6 +27,7 @@
  */
 
 #include "splines/oskar_dierckx_bispev.h"
+#include "splines/oskar_dierckx_fpbspl.h"
 #include "splines/oskar_splines.h"
 #include "utility/oskar_device.h"
 
@@ -34,6 +35,154 @@
 extern "C" {
 #endif
 
+/* Maximum number of surfaces handled in one pass over the points. */
+#define MAX_SURFACES 8
+
+/*
+ * These evaluate bicubic surfaces one point at a time, exactly as
+ * oskar_dierckx_fpbisp() does when called with a single point, but with
+ * the knot span and basis functions of each point computed only once for
+ * each group of surfaces with identical knots.
+ * Surface s uses the basis computed for surface group[s] (<= s),
+ * and a negative group index marks a surface with no spline data.
+ */
+
+static void evaluate_multi_f(int num_surfaces,
+        const oskar_Splines* const* splines, const int* group,
+        int num_points, const oskar_Mem* x, const oskar_Mem* y,
+        int stride_out, const int* offset_out, oskar_Mem* output,
+        int* status)
+{
+    int i, s, nx[MAX_SURFACES], ny[MAX_SURFACES];
+    const float *tx[MAX_SURFACES], *ty[MAX_SURFACES], *c[MAX_SURFACES];
+    for (s = 0; s < num_surfaces; ++s)
+    {
+        nx[s] = oskar_splines_num_knots_x_theta(splines[s]);
+        ny[s] = oskar_splines_num_knots_y_phi(splines[s]);
+        tx[s] = oskar_mem_float_const(
+                oskar_splines_knots_x_theta_const(splines[s]), status);
+        ty[s] = oskar_mem_float_const(
+                oskar_splines_knots_y_phi_const(splines[s]), status);
+        c[s] = oskar_mem_float_const(
+                oskar_splines_coeff_const(splines[s]), status);
+    }
+    const float *x_ = oskar_mem_float_const(x, status);
+    const float *y_ = oskar_mem_float_const(y, status);
+    float *out = oskar_mem_float(output, status);
+    if (*status) return;
+#pragma omp parallel for private(i, s)
+    for (i = 0; i < num_points; ++i)
+    {
+        int i1, j1, l, l1, lx[MAX_SURFACES], ly[MAX_SURFACES];
+        float hx[MAX_SURFACES][6], hy[MAX_SURFACES][6], arg, sp;
+        for (s = 0; s < num_surfaces; ++s)
+        {
+            const int g = group[s];
+            if (g < 0)
+            {
+                out[offset_out[s] + i * stride_out] = 0.0f;
+                continue;
+            }
+            if (g == s)
+            {
+                /* Knot span and basis in x. */
+                arg = x_[i];
+                if (arg < tx[s][3]) arg = tx[s][3];
+                if (arg > tx[s][nx[s] - 4]) arg = tx[s][nx[s] - 4];
+                l = 4;
+                while (!(arg < tx[s][l] || l == nx[s] - 4)) l++;
+                oskar_dierckx_fpbspl_f(tx[s], 3, arg, l, hx[s]);
+                lx[s] = l - 4;
+
+                /* Knot span and basis in y. */
+                arg = y_[i];
+                if (arg < ty[s][3]) arg = ty[s][3];
+                if (arg > ty[s][ny[s] - 4]) arg = ty[s][ny[s] - 4];
+                l = 4;
+                while (!(arg < ty[s][l] || l == ny[s] - 4)) l++;
+                oskar_dierckx_fpbspl_f(ty[s], 3, arg, l, hy[s]);
+                ly[s] = l - 4;
+            }
+
+            /* Sum the coefficients in the same order as fpbisp. */
+            l1 = lx[g] * (ny[s] - 4) + ly[g];
+            sp = 0.0f;
+            for (i1 = 0; i1 < 4; ++i1, l1 += (ny[s] - 4))
+                for (j1 = 0; j1 < 4; ++j1)
+                    sp += c[s][l1 + j1] * hx[g][i1] * hy[g][j1];
+            out[offset_out[s] + i * stride_out] = sp;
+        }
+    }
+}
+
+static void evaluate_multi_d(int num_surfaces,
+        const oskar_Splines* const* splines, const int* group,
+        int num_points, const oskar_Mem* x, const oskar_Mem* y,
+        int stride_out, const int* offset_out, oskar_Mem* output,
+        int* status)
+{
+    int i, s, nx[MAX_SURFACES], ny[MAX_SURFACES];
+    const double *tx[MAX_SURFACES], *ty[MAX_SURFACES], *c[MAX_SURFACES];
+    for (s = 0; s < num_surfaces; ++s)
+    {
+        nx[s] = oskar_splines_num_knots_x_theta(splines[s]);
+        ny[s] = oskar_splines_num_knots_y_phi(splines[s]);
+        tx[s] = oskar_mem_double_const(
+                oskar_splines_knots_x_theta_const(splines[s]), status);
+        ty[s] = oskar_mem_double_const(
+                oskar_splines_knots_y_phi_const(splines[s]), status);
+        c[s] = oskar_mem_double_const(
+                oskar_splines_coeff_const(splines[s]), status);
+    }
+    const double *x_ = oskar_mem_double_const(x, status);
+    const double *y_ = oskar_mem_double_const(y, status);
+    double *out = oskar_mem_double(output, status);
+    if (*status) return;
+#pragma omp parallel for private(i, s)
+    for (i = 0; i < num_points; ++i)
+    {
+        int i1, j1, l, l1, lx[MAX_SURFACES], ly[MAX_SURFACES];
+        double hx[MAX_SURFACES][6], hy[MAX_SURFACES][6], arg, sp;
+        for (s = 0; s < num_surfaces; ++s)
+        {
+            const int g = group[s];
+            if (g < 0)
+            {
+                out[offset_out[s] + i * stride_out] = 0.0;
+                continue;
+            }
+            if (g == s)
+            {
+                /* Knot span and basis in x. */
+                arg = x_[i];
+                if (arg < tx[s][3]) arg = tx[s][3];
+                if (arg > tx[s][nx[s] - 4]) arg = tx[s][nx[s] - 4];
+                l = 4;
+                while (!(arg < tx[s][l] || l == nx[s] - 4)) l++;
+                oskar_dierckx_fpbspl_d(tx[s], 3, arg, l, hx[s]);
+                lx[s] = l - 4;
+
+                /* Knot span and basis in y. */
+                arg = y_[i];
+                if (arg < ty[s][3]) arg = ty[s][3];
+                if (arg > ty[s][ny[s] - 4]) arg = ty[s][ny[s] - 4];
+                l = 4;
+                while (!(arg < ty[s][l] || l == ny[s] - 4)) l++;
+                oskar_dierckx_fpbspl_d(ty[s], 3, arg, l, hy[s]);
+                ly[s] = l - 4;
+            }
+
+            /* Sum the coefficients in the same order as fpbisp. */
+            l1 = lx[g] * (ny[s] - 4) + ly[g];
+            sp = 0.0;
+            for (i1 = 0; i1 < 4; ++i1, l1 += (ny[s] - 4))
+                for (j1 = 0; j1 < 4; ++j1)
+                    sp += c[s][l1 + j1] * hx[g][i1] * hy[g][j1];
+            out[offset_out[s] + i * stride_out] = sp;
+        }
+    }
+}
+
 void oskar_splines_evaluate(const oskar_Splines* spline,
         int num_points, const oskar_Mem* x, const oskar_Mem* y,
         int stride_out, int offset_out, oskar_Mem* output, int* status)
@@ -182,6 +331,100 @@ void oskar_splines_evaluate(const oskar_Splines* spline,
     }
 }
 
+void oskar_splines_evaluate_multi(int num_surfaces,
+        const oskar_Splines* const* splines, int num_points,
+        const oskar_Mem* x, const oskar_Mem* y, int stride_out,
+        const int* offset_out, oskar_Mem* output, int* status)
+{
+    int s, t, nx[MAX_SURFACES], ny[MAX_SURFACES], group[MAX_SURFACES];
+    if (*status || num_surfaces <= 0) return;
+
+    /* Process large sets of surfaces in batches. */
+    if (num_surfaces > MAX_SURFACES)
+    {
+        for (s = 0; s < num_surfaces; s += MAX_SURFACES)
+        {
+            t = num_surfaces - s;
+            oskar_splines_evaluate_multi(t < MAX_SURFACES ? t : MAX_SURFACES,
+                    splines + s, num_points, x, y, stride_out,
+                    offset_out + s, output, status);
+        }
+        return;
+    }
+
+    /* Device memory, or mixed surfaces: evaluate each surface in turn. */
+    const int type = oskar_splines_precision(splines[0]);
+    const int location = oskar_splines_mem_location(splines[0]);
+    for (s = 1; s < num_surfaces; ++s)
+    {
+        if (oskar_splines_precision(splines[s]) != type ||
+                oskar_splines_mem_location(splines[s]) != location)
+            break;
+    }
+    if (location != OSKAR_CPU || s < num_surfaces)
+    {
+        for (s = 0; s < num_surfaces; ++s)
+            oskar_splines_evaluate(splines[s], num_points, x, y,
+                    stride_out, offset_out[s], output, status);
+        return;
+    }
+    if (type != oskar_mem_type(x) || type != oskar_mem_type(y))
+    {
+        *status = OSKAR_ERR_TYPE_MISMATCH;
+        return;
+    }
+    if (location != oskar_mem_location(output) ||
+            location != oskar_mem_location(x) ||
+            location != oskar_mem_location(y))
+    {
+        *status = OSKAR_ERR_LOCATION_MISMATCH;
+        return;
+    }
+    if (type != OSKAR_SINGLE && type != OSKAR_DOUBLE)
+    {
+        *status = OSKAR_ERR_BAD_DATA_TYPE;
+        return;
+    }
+
+    /* Find the surfaces that can share knot spans and basis functions. */
+    for (s = 0; s < num_surfaces; ++s)
+    {
+        const oskar_Mem* knots_x = oskar_splines_knots_x_theta_const(splines[s]);
+        const oskar_Mem* knots_y = oskar_splines_knots_y_phi_const(splines[s]);
+        nx[s] = oskar_splines_num_knots_x_theta(splines[s]);
+        ny[s] = oskar_splines_num_knots_y_phi(splines[s]);
+        group[s] = s;
+        if (nx[s] == 0 || ny[s] == 0 || !oskar_mem_void_const(knots_x) ||
+                !oskar_mem_void_const(knots_y) || !oskar_mem_void_const(
+                        oskar_splines_coeff_const(splines[s])))
+        {
+            group[s] = -1;
+            continue;
+        }
+        for (t = 0; t < s; ++t)
+        {
+            if (group[t] != t || nx[t] != nx[s] || ny[t] != ny[s])
+                continue;
+            if (!oskar_mem_different(knots_x,
+                    oskar_splines_knots_x_theta_const(splines[t]),
+                    (size_t) nx[s], status) &&
+                    !oskar_mem_different(knots_y,
+                    oskar_splines_knots_y_phi_const(splines[t]),
+                    (size_t) ny[s], status))
+            {
+                group[s] = t;
+                break;
+            }
+        }
+    }
+    if (type == OSKAR_SINGLE)
+        evaluate_multi_f(num_surfaces, splines, group, num_points, x, y,
+                stride_out, offset_out, output, status);
+    else
+        evaluate_multi_d(num_surfaces, splines, group, num_points, x, y,
+                stride_out, offset_out, output, status);
+}
+
 #ifdef __cplusplus
 }
 #endif
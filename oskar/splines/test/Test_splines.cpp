@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "splines/oskar_splines.h"
+#include "splines/oskar_splines_evaluate.h"
+#include "splines/oskar_splines_fit.h"
+#include "utility/oskar_get_error_string.h"
+
+#include <cmath>
+#include <vector>
+
+static oskar_Splines* fit_surface(int which, int* status)
+{
+    const int n = 20;
+    std::vector<double> x, y, z, weight;
+    for (int j = 0; j < n; ++j)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            const double xx = (double) i / (n - 1);
+            const double yy = (double) j / (n - 1);
+            x.push_back(xx);
+            y.push_back(yy);
+            z.push_back(which == 0 ? sin(3.0 * xx) * cos(2.0 * yy) :
+                    xx * xx + 2.0 * yy * yy * yy);
+            weight.push_back(1.0);
+        }
+    }
+    double avg_frac_err = 0.01;
+    oskar_Splines* spline = oskar_splines_create(OSKAR_DOUBLE, OSKAR_CPU,
+            status);
+    oskar_splines_fit(spline, n * n, &x[0], &y[0], &z[0], &weight[0],
+            OSKAR_SPLINES_LINEAR, 1, &avg_frac_err, 1.5, 1.0, 1e-14, status);
+    return spline;
+}
+
+TEST(splines, evaluate_multi)
+{
+    int status = 0;
+    const int num_points = 333, num_surfaces = 10;
+    oskar_Splines* splines[num_surfaces];
+    int offsets[num_surfaces];
+
+    // Fit two different surfaces, and make copies of them with scaled
+    // coefficients, so that some surfaces share their knots.
+    // Also include a surface without any spline data.
+    splines[0] = fit_surface(0, &status);
+    splines[1] = fit_surface(1, &status);
+    splines[2] = oskar_splines_create(OSKAR_DOUBLE, OSKAR_CPU, &status);
+    for (int s = 3; s < num_surfaces; ++s)
+    {
+        splines[s] = oskar_splines_create(OSKAR_DOUBLE, OSKAR_CPU, &status);
+        oskar_splines_copy(splines[s], splines[s % 2], &status);
+        oskar_mem_scale_real(oskar_splines_coeff(splines[s]), 0.5 * s,
+                0, oskar_mem_length(oskar_splines_coeff(splines[s])),
+                &status);
+    }
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    ASSERT_GT(oskar_splines_num_knots_x_theta(splines[0]), 0);
+    ASSERT_GT(oskar_splines_num_knots_x_theta(splines[1]), 0);
+
+    // Generate evaluation points, including some outside the fitted range.
+    oskar_Mem* x = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points,
+            &status);
+    oskar_Mem* y = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points,
+            &status);
+    oskar_mem_random_range(x, -0.1, 1.1, &status);
+    oskar_mem_random_range(y, -0.1, 1.1, &status);
+
+    // Evaluate each surface in turn, and all surfaces together,
+    // interleaving the surfaces in the output.
+    oskar_Mem* out1 = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+            num_points * num_surfaces, &status);
+    oskar_Mem* out2 = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU,
+            num_points * num_surfaces, &status);
+    oskar_mem_set_value_real(out1, 1.0, 0, 0, &status);
+    oskar_mem_set_value_real(out2, 2.0, 0, 0, &status);
+    for (int s = 0; s < num_surfaces; ++s)
+    {
+        offsets[s] = (s * 7) % num_surfaces;
+        oskar_splines_evaluate(splines[s], num_points, x, y,
+                num_surfaces, offsets[s], out1, &status);
+    }
+    oskar_splines_evaluate_multi(num_surfaces, splines, num_points, x, y,
+            num_surfaces, offsets, out2, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Check that the results are the same.
+    const double* v1 = oskar_mem_double_const(out1, &status);
+    const double* v2 = oskar_mem_double_const(out2, &status);
+    for (int i = 0; i < num_points * num_surfaces; ++i)
+        EXPECT_DOUBLE_EQ(v1[i], v2[i]) << "index " << i;
+    for (int i = 0; i < num_points; ++i)
+        EXPECT_EQ(0.0, v2[i * num_surfaces + offsets[2]]);
+
+    // Free memory.
+    for (int s = 0; s < num_surfaces; ++s)
+        oskar_splines_free(splines[s], &status);
+    oskar_mem_free(x, &status);
+    oskar_mem_free(y, &status);
+    oskar_mem_free(out1, &status);
+    oskar_mem_free(out2, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
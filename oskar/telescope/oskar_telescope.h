@@ -58,6 +58,7 @@ enum OSKAR_POL_MODE_TYPE
 #include <telescope/station/oskar_station.h>
 #include <telescope/oskar_telescope_accessors.h>
 #include <telescope/oskar_telescope_analyse.h>
+#include <telescope/oskar_telescope_compile.h>
 #include <telescope/oskar_telescope_create.h>
 #include <telescope/oskar_telescope_create_copy.h>
 #include <telescope/oskar_telescope_duplicate_first_station.h>
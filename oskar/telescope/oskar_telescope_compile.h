@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef OSKAR_TELESCOPE_COMPILE_H_
+#define OSKAR_TELESCOPE_COMPILE_H_
+
+/**
+ * @file oskar_telescope_compile.h
+ */
+
+#include <oskar_global.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* To maintain binary compatibility, do not change the values
+ * in the lists below. */
+enum OSKAR_TELESCOPE_TAGS
+{
+    OSKAR_TELESCOPE_TAG_FORMAT_VERSION = 1,
+    OSKAR_TELESCOPE_TAG_SOURCE_HASH = 2,
+    OSKAR_TELESCOPE_TAG_PRECISION = 3,
+    OSKAR_TELESCOPE_TAG_POL_MODE = 4,
+    OSKAR_TELESCOPE_TAG_LON_RAD = 5,
+    OSKAR_TELESCOPE_TAG_LAT_RAD = 6,
+    OSKAR_TELESCOPE_TAG_ALT_METRES = 7,
+    OSKAR_TELESCOPE_TAG_PM_X_RAD = 8,
+    OSKAR_TELESCOPE_TAG_PM_Y_RAD = 9,
+    OSKAR_TELESCOPE_TAG_PHASE_CENTRE_COORD_TYPE = 10,
+    OSKAR_TELESCOPE_TAG_PHASE_CENTRE_RA_RAD = 11,
+    OSKAR_TELESCOPE_TAG_PHASE_CENTRE_DEC_RAD = 12,
+    OSKAR_TELESCOPE_TAG_CHANNEL_BANDWIDTH_HZ = 13,
+    OSKAR_TELESCOPE_TAG_TIME_AVERAGE_SEC = 14,
+    OSKAR_TELESCOPE_TAG_UV_FILTER_MIN = 15,
+    OSKAR_TELESCOPE_TAG_UV_FILTER_MAX = 16,
+    OSKAR_TELESCOPE_TAG_UV_FILTER_UNITS = 17,
+    OSKAR_TELESCOPE_TAG_NOISE_ENABLED = 18,
+    OSKAR_TELESCOPE_TAG_NOISE_SEED = 19,
+    OSKAR_TELESCOPE_TAG_SUPPLIED_COORD_TYPE = 20,
+    OSKAR_TELESCOPE_TAG_NUM_STATIONS = 21,
+    OSKAR_TELESCOPE_TAG_MAX_STATION_SIZE = 22,
+    OSKAR_TELESCOPE_TAG_MAX_STATION_DEPTH = 23,
+    OSKAR_TELESCOPE_TAG_IDENTICAL_STATIONS = 24,
+    OSKAR_TELESCOPE_TAG_ALLOW_STATION_BEAM_DUPLICATION = 25,
+    OSKAR_TELESCOPE_TAG_ENABLE_NUMERICAL_PATTERNS = 26,
+    OSKAR_TELESCOPE_TAG_STATION_TRUE_X_OFFSET_ECEF = 27,
+    OSKAR_TELESCOPE_TAG_STATION_TRUE_Y_OFFSET_ECEF = 28,
+    OSKAR_TELESCOPE_TAG_STATION_TRUE_Z_OFFSET_ECEF = 29,
+    OSKAR_TELESCOPE_TAG_STATION_TRUE_X_ENU = 30,
+    OSKAR_TELESCOPE_TAG_STATION_TRUE_Y_ENU = 31,
+    OSKAR_TELESCOPE_TAG_STATION_TRUE_Z_ENU = 32,
+    OSKAR_TELESCOPE_TAG_STATION_MEASURED_X_OFFSET_ECEF = 33,
+    OSKAR_TELESCOPE_TAG_STATION_MEASURED_Y_OFFSET_ECEF = 34,
+    OSKAR_TELESCOPE_TAG_STATION_MEASURED_Z_OFFSET_ECEF = 35,
+    OSKAR_TELESCOPE_TAG_STATION_MEASURED_X_ENU = 36,
+    OSKAR_TELESCOPE_TAG_STATION_MEASURED_Y_ENU = 37,
+    OSKAR_TELESCOPE_TAG_STATION_MEASURED_Z_ENU = 38
+};
+
+enum OSKAR_STATION_TAGS
+{
+    OSKAR_STATION_TAG_UNIQUE_ID = 1,
+    OSKAR_STATION_TAG_STATION_TYPE = 2,
+    OSKAR_STATION_TAG_NORMALISE_FINAL_BEAM = 3,
+    OSKAR_STATION_TAG_LON_RAD = 4,
+    OSKAR_STATION_TAG_LAT_RAD = 5,
+    OSKAR_STATION_TAG_ALT_METRES = 6,
+    OSKAR_STATION_TAG_PM_X_RAD = 7,
+    OSKAR_STATION_TAG_PM_Y_RAD = 8,
+    OSKAR_STATION_TAG_BEAM_LON_RAD = 9,
+    OSKAR_STATION_TAG_BEAM_LAT_RAD = 10,
+    OSKAR_STATION_TAG_BEAM_COORD_TYPE = 11,
+    OSKAR_STATION_TAG_NOISE_FREQ_HZ = 12,
+    OSKAR_STATION_TAG_NOISE_RMS_JY = 13,
+    OSKAR_STATION_TAG_GAUSSIAN_BEAM_FWHM_RAD = 14,
+    OSKAR_STATION_TAG_GAUSSIAN_BEAM_REF_FREQ_HZ = 15,
+    OSKAR_STATION_TAG_IDENTICAL_CHILDREN = 16,
+    OSKAR_STATION_TAG_NUM_ELEMENTS = 17,
+    OSKAR_STATION_TAG_NUM_ELEMENT_TYPES = 18,
+    OSKAR_STATION_TAG_NORMALISE_ARRAY_PATTERN = 19,
+    OSKAR_STATION_TAG_ENABLE_ARRAY_PATTERN = 20,
+    OSKAR_STATION_TAG_COMMON_ELEMENT_ORIENTATION = 21,
+    OSKAR_STATION_TAG_ARRAY_IS_3D = 22,
+    OSKAR_STATION_TAG_APPLY_ELEMENT_ERRORS = 23,
+    OSKAR_STATION_TAG_APPLY_ELEMENT_WEIGHT = 24,
+    OSKAR_STATION_TAG_SEED_TIME_VARIABLE_ERRORS = 25,
+    OSKAR_STATION_TAG_ELEMENT_TRUE_X_ENU = 26,
+    OSKAR_STATION_TAG_ELEMENT_TRUE_Y_ENU = 27,
+    OSKAR_STATION_TAG_ELEMENT_TRUE_Z_ENU = 28,
+    OSKAR_STATION_TAG_ELEMENT_MEASURED_X_ENU = 29,
+    OSKAR_STATION_TAG_ELEMENT_MEASURED_Y_ENU = 30,
+    OSKAR_STATION_TAG_ELEMENT_MEASURED_Z_ENU = 31,
+    OSKAR_STATION_TAG_ELEMENT_GAIN = 32,
+    OSKAR_STATION_TAG_ELEMENT_GAIN_ERROR = 33,
+    OSKAR_STATION_TAG_ELEMENT_PHASE_OFFSET = 34,
+    OSKAR_STATION_TAG_ELEMENT_PHASE_ERROR = 35,
+    OSKAR_STATION_TAG_ELEMENT_WEIGHT = 36,
+    OSKAR_STATION_TAG_ELEMENT_CABLE_LENGTH_ERROR = 37,
+    OSKAR_STATION_TAG_ELEMENT_TYPES = 38,
+    OSKAR_STATION_TAG_ELEMENT_TYPES_CPU = 39,
+    OSKAR_STATION_TAG_ELEMENT_MOUNT_TYPES_CPU = 40,
+    OSKAR_STATION_TAG_ELEMENT_X_ALPHA = 41,
+    OSKAR_STATION_TAG_ELEMENT_X_BETA = 42,
+    OSKAR_STATION_TAG_ELEMENT_X_GAMMA = 43,
+    OSKAR_STATION_TAG_ELEMENT_Y_ALPHA = 44,
+    OSKAR_STATION_TAG_ELEMENT_Y_BETA = 45,
+    OSKAR_STATION_TAG_ELEMENT_Y_GAMMA = 46,
+    OSKAR_STATION_TAG_HAS_CHILD = 47,
+    OSKAR_STATION_TAG_HAS_ELEMENT = 48,
+    OSKAR_STATION_TAG_NUM_PERMITTED_BEAMS = 49,
+    OSKAR_STATION_TAG_PERMITTED_BEAM_AZ_RAD = 50,
+    OSKAR_STATION_TAG_PERMITTED_BEAM_EL_RAD = 51
+};
+
+/**
+ * @brief
+ * Writes a fully-loaded telescope model to a single binary file.
+ *
+ * @details
+ * This function writes the contents of a telescope model, including all
+ * child stations and element pattern data, to a single OSKAR binary file,
+ * so that it can be loaded again quickly using
+ * oskar_telescope_load_compiled().
+ *
+ * The hash of the telescope model directory, as returned by
+ * oskar_telescope_source_hash(), should be supplied so that the file can
+ * be recognised as out of date if the directory contents change.
+ *
+ * @param[in] telescope    Telescope model to write.
+ * @param[in] filename     Pathname of file to write.
+ * @param[in] source_hash  Hash of the telescope model directory.
+ * @param[in,out] status   Status return code.
+ */
+OSKAR_EXPORT
+void oskar_telescope_compile(const oskar_Telescope* telescope,
+        const char* filename, const char* source_hash, int* status);
+
+/**
+ * @brief
+ * Loads a telescope model written by oskar_telescope_compile().
+ *
+ * @details
+ * The file is memory-mapped if possible, and arrays in the returned
+ * telescope model refer directly to the mapped data rather than being
+ * copied. The mapping is private, so the model can still be modified
+ * without changing the file. The file remains mapped until the telescope
+ * model is freed.
+ *
+ * If \p source_hash is not NULL, it is compared with the hash stored in
+ * the file. If the file does not exist, was written using a different
+ * format version, or the hashes are different, NULL is returned without
+ * setting an error, and the telescope model should be loaded from its
+ * directory instead.
+ *
+ * The returned telescope model is in CPU memory.
+ *
+ * @param[in] filename     Pathname of file to load.
+ * @param[in] source_hash  Expected hash of the telescope model directory.
+ * @param[in,out] status   Status return code.
+ *
+ * @return The telescope model, or NULL if not loaded.
+ */
+OSKAR_EXPORT
+oskar_Telescope* oskar_telescope_load_compiled(const char* filename,
+        const char* source_hash, int* status);
+
+/**
+ * @brief
+ * Returns a hash of the contents of a telescope model directory.
+ *
+ * @details
+ * This function returns a string containing a CRC-32C code of the
+ * names, sizes and modification times of all the files in the telescope
+ * model directory and its subdirectories, together with the options in
+ * \p telescope that affect how the directory is loaded by
+ * oskar_telescope_load(). File contents are not read.
+ *
+ * Any compiled telescope model file should therefore not be placed
+ * inside the directory itself.
+ *
+ * The returned string must be freed by the caller using free().
+ *
+ * @param[in] telescope    Telescope model with load options set.
+ * @param[in] dir_path     Pathname of telescope model directory.
+ * @param[in,out] status   Status return code.
+ *
+ * @return The hash string.
+ */
+OSKAR_EXPORT
+char* oskar_telescope_source_hash(const oskar_Telescope* telescope,
+        const char* dir_path, int* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OSKAR_TELESCOPE_COMPILE_H_ */
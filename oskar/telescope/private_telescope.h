@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011-2016, The University of Oxford
+ * Copyright (c) 2011-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -29,6 +29,7 @@
 #ifndef OSKAR_PRIVATE_TELESCOPE_H_
 #define OSKAR_PRIVATE_TELESCOPE_H_
 
+#include <binary/oskar_binary.h>
 #include <telescope/station/oskar_station.h>
 
 struct oskar_Telescope
@@ -76,6 +77,7 @@ struct oskar_Telescope
     int identical_stations;                           /* True if all stations are identical. */
     int allow_station_beam_duplication;               /* True if station beam duplication is allowed. */
     int enable_numerical_patterns;                    /* True if numerical element patterns are enabled. */
+    oskar_Binary* compiled_file;                      /* Handle to mapped compiled model file, if used. */
 };
 
 #ifndef OSKAR_TELESCOPE_TYPEDEF_
@@ -0,0 +1,1083 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "binary/oskar_binary.h"
+#include "binary/oskar_crc.h"
+#include "mem/oskar_binary_read_mem.h"
+#include "mem/oskar_binary_write_mem.h"
+#include "splines/private_splines.h"
+#include "splines/oskar_splines.h"
+#include "telescope/private_telescope.h"
+#include "telescope/oskar_telescope.h"
+#include "telescope/station/private_station.h"
+#include "telescope/station/element/private_element.h"
+#include "utility/oskar_dir.h"
+#include "utility/oskar_file_exists.h"
+#include "oskar_version.h"
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FORMAT_VERSION 1
+
+/* Flags for the data present at each element frequency. */
+#define HAS_X_SPLINES   0x01
+#define HAS_Y_SPLINES   0x02
+#define HAS_SCALAR      0x04
+#define HAS_SPH_WAVE    0x08
+#define HAS_FILENAME_X  0x10
+#define HAS_FILENAME_Y  0x20
+#define HAS_FILENAME_S  0x40
+
+/* Running totals of the objects in the file, used as tag indices. */
+struct Counters
+{
+    oskar_Binary* h;
+    int station, element, freq, splines;
+};
+typedef struct Counters Counters;
+
+/* Tables of the station fields, in order of tag ID. */
+static const int station_ints[] = {
+        OSKAR_STATION_TAG_UNIQUE_ID,
+        OSKAR_STATION_TAG_STATION_TYPE,
+        OSKAR_STATION_TAG_NORMALISE_FINAL_BEAM,
+        OSKAR_STATION_TAG_BEAM_COORD_TYPE,
+        OSKAR_STATION_TAG_IDENTICAL_CHILDREN,
+        OSKAR_STATION_TAG_NUM_ELEMENTS,
+        OSKAR_STATION_TAG_NORMALISE_ARRAY_PATTERN,
+        OSKAR_STATION_TAG_ENABLE_ARRAY_PATTERN,
+        OSKAR_STATION_TAG_COMMON_ELEMENT_ORIENTATION,
+        OSKAR_STATION_TAG_ARRAY_IS_3D,
+        OSKAR_STATION_TAG_APPLY_ELEMENT_ERRORS,
+        OSKAR_STATION_TAG_APPLY_ELEMENT_WEIGHT,
+        OSKAR_STATION_TAG_SEED_TIME_VARIABLE_ERRORS,
+        OSKAR_STATION_TAG_NUM_PERMITTED_BEAMS};
+static const int station_doubles[] = {
+        OSKAR_STATION_TAG_LON_RAD,
+        OSKAR_STATION_TAG_LAT_RAD,
+        OSKAR_STATION_TAG_ALT_METRES,
+        OSKAR_STATION_TAG_PM_X_RAD,
+        OSKAR_STATION_TAG_PM_Y_RAD,
+        OSKAR_STATION_TAG_BEAM_LON_RAD,
+        OSKAR_STATION_TAG_BEAM_LAT_RAD,
+        OSKAR_STATION_TAG_GAUSSIAN_BEAM_FWHM_RAD,
+        OSKAR_STATION_TAG_GAUSSIAN_BEAM_REF_FREQ_HZ};
+static const int station_mems[] = {
+        OSKAR_STATION_TAG_NOISE_FREQ_HZ,
+        OSKAR_STATION_TAG_NOISE_RMS_JY,
+        OSKAR_STATION_TAG_ELEMENT_TRUE_X_ENU,
+        OSKAR_STATION_TAG_ELEMENT_TRUE_Y_ENU,
+        OSKAR_STATION_TAG_ELEMENT_TRUE_Z_ENU,
+        OSKAR_STATION_TAG_ELEMENT_MEASURED_X_ENU,
+        OSKAR_STATION_TAG_ELEMENT_MEASURED_Y_ENU,
+        OSKAR_STATION_TAG_ELEMENT_MEASURED_Z_ENU,
+        OSKAR_STATION_TAG_ELEMENT_GAIN,
+        OSKAR_STATION_TAG_ELEMENT_GAIN_ERROR,
+        OSKAR_STATION_TAG_ELEMENT_PHASE_OFFSET,
+        OSKAR_STATION_TAG_ELEMENT_PHASE_ERROR,
+        OSKAR_STATION_TAG_ELEMENT_WEIGHT,
+        OSKAR_STATION_TAG_ELEMENT_CABLE_LENGTH_ERROR,
+        OSKAR_STATION_TAG_ELEMENT_TYPES,
+        OSKAR_STATION_TAG_ELEMENT_TYPES_CPU,
+        OSKAR_STATION_TAG_ELEMENT_MOUNT_TYPES_CPU,
+        OSKAR_STATION_TAG_ELEMENT_X_ALPHA,
+        OSKAR_STATION_TAG_ELEMENT_X_BETA,
+        OSKAR_STATION_TAG_ELEMENT_X_GAMMA,
+        OSKAR_STATION_TAG_ELEMENT_Y_ALPHA,
+        OSKAR_STATION_TAG_ELEMENT_Y_BETA,
+        OSKAR_STATION_TAG_ELEMENT_Y_GAMMA,
+        OSKAR_STATION_TAG_PERMITTED_BEAM_AZ_RAD,
+        OSKAR_STATION_TAG_PERMITTED_BEAM_EL_RAD};
+
+/* Tables of the element fields. */
+static const int element_ints[] = {
+        OSKAR_ELEMENT_TAG_COORD_SYS,
+        OSKAR_ELEMENT_TAG_X_ELEMENT_TYPE,
+        OSKAR_ELEMENT_TAG_Y_ELEMENT_TYPE,
+        OSKAR_ELEMENT_TAG_X_TAPER_TYPE,
+        OSKAR_ELEMENT_TAG_Y_TAPER_TYPE,
+        OSKAR_ELEMENT_TAG_X_DIPOLE_LENGTH_UNITS,
+        OSKAR_ELEMENT_TAG_Y_DIPOLE_LENGTH_UNITS,
+        OSKAR_ELEMENT_TAG_ELEMENT_TYPE,
+        OSKAR_ELEMENT_TAG_TAPER_TYPE,
+        OSKAR_ELEMENT_TAG_DIPOLE_LENGTH_UNITS,
+        OSKAR_ELEMENT_TAG_INTERPOLATE_FREQ};
+static const int element_doubles[] = {
+        OSKAR_ELEMENT_TAG_MAX_RADIUS,
+        OSKAR_ELEMENT_TAG_X_DIPOLE_LENGTH,
+        OSKAR_ELEMENT_TAG_Y_DIPOLE_LENGTH,
+        OSKAR_ELEMENT_TAG_X_TAPER_COSINE_POWER,
+        OSKAR_ELEMENT_TAG_Y_TAPER_COSINE_POWER,
+        OSKAR_ELEMENT_TAG_X_TAPER_GAUSSIAN_FWHM_RAD,
+        OSKAR_ELEMENT_TAG_Y_TAPER_GAUSSIAN_FWHM_RAD,
+        OSKAR_ELEMENT_TAG_X_TAPER_REF_FREQ_HZ,
+        OSKAR_ELEMENT_TAG_Y_TAPER_REF_FREQ_HZ,
+        OSKAR_ELEMENT_TAG_DIPOLE_LENGTH,
+        OSKAR_ELEMENT_TAG_COSINE_POWER,
+        OSKAR_ELEMENT_TAG_GAUSSIAN_FWHM_RAD};
+
+#define NUM(X) (sizeof(X) / sizeof(X[0]))
+#define FIELD(T, PTR, OFFSET) ((T*) ((char*) (PTR) + (OFFSET)))
+#define CONST_FIELD(T, PTR, OFFSET) \
+        ((T const*) ((const char*) (PTR) + (OFFSET)))
+
+static size_t station_int(int tag);
+static size_t station_double(int tag);
+static size_t station_mem(int tag);
+static size_t element_int(int tag);
+static size_t element_double(int tag);
+static size_t telescope_mem(int tag);
+static void write_mem(Counters* c, const oskar_Mem* mem,
+        unsigned char group, unsigned char tag, int index, int* status);
+static void write_station(Counters* c, const oskar_Station* s, int* status);
+static void write_element(Counters* c, const oskar_Element* e, int* status);
+static void write_splines(Counters* c, int num, oskar_Splines* const* s,
+        int* status);
+static void read_mem(Counters* c, unsigned char group, unsigned char tag,
+        int index, int alias, oskar_Mem** mem, int* status);
+static oskar_Station* read_station(Counters* c, int type, int* status);
+static void read_element(Counters* c, oskar_Element* e, int* status);
+static void read_splines(Counters* c, int num, oskar_Splines** s,
+        int* status);
+static void hash_dir(const oskar_CRC* crc_data, const char* dir_path,
+        const char* rel_path, unsigned long* crc, unsigned long* num_files,
+        unsigned long* num_bytes, int* status);
+
+
+void oskar_telescope_compile(const oskar_Telescope* telescope,
+        const char* filename, const char* source_hash, int* status)
+{
+    int i;
+    Counters c;
+    const unsigned char group = (unsigned char) OSKAR_TAG_GROUP_TELESCOPE;
+    const oskar_Telescope* t = telescope;
+    if (*status) return;
+    if (oskar_telescope_mem_location(telescope) != OSKAR_CPU)
+    {
+        *status = OSKAR_ERR_BAD_LOCATION;
+        return;
+    }
+
+    /* Create the file. */
+    memset(&c, 0, sizeof(Counters));
+    c.h = oskar_binary_create(filename, 'w', status);
+    if (*status)
+    {
+        oskar_binary_free(c.h);
+        return;
+    }
+
+    /* Write the telescope meta-data. */
+    oskar_binary_write_int(c.h, group,
+            OSKAR_TELESCOPE_TAG_FORMAT_VERSION, 0, FORMAT_VERSION, status);
+    if (!source_hash) source_hash = "";
+    oskar_binary_write(c.h, OSKAR_CHAR, group,
+            OSKAR_TELESCOPE_TAG_SOURCE_HASH, 0, 1 + strlen(source_hash),
+            source_hash, status);
+    oskar_binary_write_int(c.h, group, OSKAR_TELESCOPE_TAG_PRECISION, 0,
+            t->precision, status);
+    oskar_binary_write_int(c.h, group, OSKAR_TELESCOPE_TAG_POL_MODE, 0,
+            t->pol_mode, status);
+    oskar_binary_write_double(c.h, group, OSKAR_TELESCOPE_TAG_LON_RAD, 0,
+            t->lon_rad, status);
+    oskar_binary_write_double(c.h, group, OSKAR_TELESCOPE_TAG_LAT_RAD, 0,
+            t->lat_rad, status);
+    oskar_binary_write_double(c.h, group, OSKAR_TELESCOPE_TAG_ALT_METRES, 0,
+            t->alt_metres, status);
+    oskar_binary_write_double(c.h, group, OSKAR_TELESCOPE_TAG_PM_X_RAD, 0,
+            t->pm_x_rad, status);
+    oskar_binary_write_double(c.h, group, OSKAR_TELESCOPE_TAG_PM_Y_RAD, 0,
+            t->pm_y_rad, status);
+    oskar_binary_write_int(c.h, group,
+            OSKAR_TELESCOPE_TAG_PHASE_CENTRE_COORD_TYPE, 0,
+            t->phase_centre_coord_type, status);
+    oskar_binary_write_double(c.h, group,
+            OSKAR_TELESCOPE_TAG_PHASE_CENTRE_RA_RAD, 0,
+            t->phase_centre_ra_rad, status);
+    oskar_binary_write_double(c.h, group,
+            OSKAR_TELESCOPE_TAG_PHASE_CENTRE_DEC_RAD, 0,
+            t->phase_centre_dec_rad, status);
+    oskar_binary_write_double(c.h, group,
+            OSKAR_TELESCOPE_TAG_CHANNEL_BANDWIDTH_HZ, 0,
+            t->channel_bandwidth_hz, status);
+    oskar_binary_write_double(c.h, group,
+            OSKAR_TELESCOPE_TAG_TIME_AVERAGE_SEC, 0,
+            t->time_average_sec, status);
+    oskar_binary_write_double(c.h, group, OSKAR_TELESCOPE_TAG_UV_FILTER_MIN,
+            0, t->uv_filter_min, status);
+    oskar_binary_write_double(c.h, group, OSKAR_TELESCOPE_TAG_UV_FILTER_MAX,
+            0, t->uv_filter_max, status);
+    oskar_binary_write_int(c.h, group, OSKAR_TELESCOPE_TAG_UV_FILTER_UNITS,
+            0, t->uv_filter_units, status);
+    oskar_binary_write_int(c.h, group, OSKAR_TELESCOPE_TAG_NOISE_ENABLED,
+            0, t->noise_enabled, status);
+    oskar_binary_write_int(c.h, group, OSKAR_TELESCOPE_TAG_NOISE_SEED,
+            0, (int) t->noise_seed, status);
+    oskar_binary_write_int(c.h, group,
+            OSKAR_TELESCOPE_TAG_SUPPLIED_COORD_TYPE, 0,
+            t->supplied_coord_type, status);
+    oskar_binary_write_int(c.h, group, OSKAR_TELESCOPE_TAG_NUM_STATIONS,
+            0, t->num_stations, status);
+    oskar_binary_write_int(c.h, group, OSKAR_TELESCOPE_TAG_MAX_STATION_SIZE,
+            0, t->max_station_size, status);
+    oskar_binary_write_int(c.h, group, OSKAR_TELESCOPE_TAG_MAX_STATION_DEPTH,
+            0, t->max_station_depth, status);
+    oskar_binary_write_int(c.h, group,
+            OSKAR_TELESCOPE_TAG_IDENTICAL_STATIONS, 0,
+            t->identical_stations, status);
+    oskar_binary_write_int(c.h, group,
+            OSKAR_TELESCOPE_TAG_ALLOW_STATION_BEAM_DUPLICATION, 0,
+            t->allow_station_beam_duplication, status);
+    oskar_binary_write_int(c.h, group,
+            OSKAR_TELESCOPE_TAG_ENABLE_NUMERICAL_PATTERNS, 0,
+            t->enable_numerical_patterns, status);
+    for (i = OSKAR_TELESCOPE_TAG_STATION_TRUE_X_OFFSET_ECEF;
+            i <= OSKAR_TELESCOPE_TAG_STATION_MEASURED_Z_ENU; ++i)
+        write_mem(&c, *CONST_FIELD(oskar_Mem*, t, telescope_mem(i)),
+                group, (unsigned char) i, 0, status);
+
+    /* Write the stations, depth first. */
+    for (i = 0; i < t->num_stations; ++i)
+        write_station(&c, t->station[i], status);
+
+    /* Release the handle. */
+    oskar_binary_free(c.h);
+}
+
+
+oskar_Telescope* oskar_telescope_load_compiled(const char* filename,
+        const char* source_hash, int* status)
+{
+    int i, version = 0, type = 0, num_stations = 0, tmp = 0;
+    Counters c;
+    oskar_Telescope* t = 0;
+    oskar_Mem* hash = 0;
+    const unsigned char group = (unsigned char) OSKAR_TAG_GROUP_TELESCOPE;
+    if (*status || !filename || !oskar_file_exists(filename)) return 0;
+
+    /* Open the file and check the format version. */
+    memset(&c, 0, sizeof(Counters));
+    c.h = oskar_binary_create(filename, 'r', status);
+    oskar_binary_read_int(c.h, group, OSKAR_TELESCOPE_TAG_FORMAT_VERSION, 0,
+            &version, status);
+    if (*status || version != FORMAT_VERSION)
+    {
+        /* Not a compiled telescope model that can be read. */
+        *status = 0;
+        oskar_binary_free(c.h);
+        return 0;
+    }
+
+    /* Check the source hash. */
+    hash = oskar_mem_create(OSKAR_CHAR, OSKAR_CPU, 0, status);
+    oskar_binary_read_mem(c.h, hash, group, OSKAR_TELESCOPE_TAG_SOURCE_HASH,
+            0, status);
+    if (*status || (source_hash &&
+            strcmp(source_hash, oskar_mem_char_const(hash)) != 0))
+    {
+        /* Missing or out of date, so the caller should use the loader. */
+        *status = 0;
+        oskar_mem_free(hash, status);
+        oskar_binary_free(c.h);
+        return 0;
+    }
+    oskar_mem_free(hash, status);
+
+    /* Create the telescope model, which keeps the file open. */
+    oskar_binary_read_int(c.h, group, OSKAR_TELESCOPE_TAG_PRECISION, 0,
+            &type, status);
+    oskar_binary_read_int(c.h, group, OSKAR_TELESCOPE_TAG_NUM_STATIONS, 0,
+            &num_stations, status);
+    t = oskar_telescope_create(type, OSKAR_CPU, 0, status);
+    if (*status)
+    {
+        oskar_telescope_free(t, status);
+        oskar_binary_free(c.h);
+        return 0;
+    }
+    t->compiled_file = c.h;
+
+    /* Read the telescope meta-data. */
+    oskar_binary_read_int(c.h, group, OSKAR_TELESCOPE_TAG_POL_MODE, 0,
+            &t->pol_mode, status);
+    oskar_binary_read_double(c.h, group, OSKAR_TELESCOPE_TAG_LON_RAD, 0,
+            &t->lon_rad, status);
+    oskar_binary_read_double(c.h, group, OSKAR_TELESCOPE_TAG_LAT_RAD, 0,
+            &t->lat_rad, status);
+    oskar_binary_read_double(c.h, group, OSKAR_TELESCOPE_TAG_ALT_METRES, 0,
+            &t->alt_metres, status);
+    oskar_binary_read_double(c.h, group, OSKAR_TELESCOPE_TAG_PM_X_RAD, 0,
+            &t->pm_x_rad, status);
+    oskar_binary_read_double(c.h, group, OSKAR_TELESCOPE_TAG_PM_Y_RAD, 0,
+            &t->pm_y_rad, status);
+    oskar_binary_read_int(c.h, group,
+            OSKAR_TELESCOPE_TAG_PHASE_CENTRE_COORD_TYPE, 0,
+            &t->phase_centre_coord_type, status);
+    oskar_binary_read_double(c.h, group,
+            OSKAR_TELESCOPE_TAG_PHASE_CENTRE_RA_RAD, 0,
+            &t->phase_centre_ra_rad, status);
+    oskar_binary_read_double(c.h, group,
+            OSKAR_TELESCOPE_TAG_PHASE_CENTRE_DEC_RAD, 0,
+            &t->phase_centre_dec_rad, status);
+    oskar_binary_read_double(c.h, group,
+            OSKAR_TELESCOPE_TAG_CHANNEL_BANDWIDTH_HZ, 0,
+            &t->channel_bandwidth_hz, status);
+    oskar_binary_read_double(c.h, group,
+            OSKAR_TELESCOPE_TAG_TIME_AVERAGE_SEC, 0,
+            &t->time_average_sec, status);
+    oskar_binary_read_double(c.h, group, OSKAR_TELESCOPE_TAG_UV_FILTER_MIN,
+            0, &t->uv_filter_min, status);
+    oskar_binary_read_double(c.h, group, OSKAR_TELESCOPE_TAG_UV_FILTER_MAX,
+            0, &t->uv_filter_max, status);
+    oskar_binary_read_int(c.h, group, OSKAR_TELESCOPE_TAG_UV_FILTER_UNITS,
+            0, &t->uv_filter_units, status);
+    oskar_binary_read_int(c.h, group, OSKAR_TELESCOPE_TAG_NOISE_ENABLED,
+            0, &t->noise_enabled, status);
+    oskar_binary_read_int(c.h, group, OSKAR_TELESCOPE_TAG_NOISE_SEED,
+            0, &tmp, status);
+    t->noise_seed = (unsigned int) tmp;
+    oskar_binary_read_int(c.h, group,
+            OSKAR_TELESCOPE_TAG_SUPPLIED_COORD_TYPE, 0,
+            &t->supplied_coord_type, status);
+    oskar_binary_read_int(c.h, group, OSKAR_TELESCOPE_TAG_MAX_STATION_SIZE,
+            0, &t->max_station_size, status);
+    oskar_binary_read_int(c.h, group, OSKAR_TELESCOPE_TAG_MAX_STATION_DEPTH,
+            0, &t->max_station_depth, status);
+    oskar_binary_read_int(c.h, group,
+            OSKAR_TELESCOPE_TAG_IDENTICAL_STATIONS, 0,
+            &t->identical_stations, status);
+    oskar_binary_read_int(c.h, group,
+            OSKAR_TELESCOPE_TAG_ALLOW_STATION_BEAM_DUPLICATION, 0,
+            &t->allow_station_beam_duplication, status);
+    oskar_binary_read_int(c.h, group,
+            OSKAR_TELESCOPE_TAG_ENABLE_NUMERICAL_PATTERNS, 0,
+            &t->enable_numerical_patterns, status);
+    for (i = OSKAR_TELESCOPE_TAG_STATION_TRUE_X_OFFSET_ECEF;
+            i <= OSKAR_TELESCOPE_TAG_STATION_MEASURED_Z_ENU; ++i)
+        read_mem(&c, group, (unsigned char) i, 0, 1,
+                FIELD(oskar_Mem*, t, telescope_mem(i)), status);
+
+    /* Read the stations, depth first. */
+    if (!*status && num_stations > 0)
+    {
+        t->station = (oskar_Station**) calloc(num_stations,
+                sizeof(oskar_Station*));
+        for (i = 0; i < num_stations && !*status; ++i)
+        {
+            t->station[i] = read_station(&c, type, status);
+            t->num_stations = i + 1;
+        }
+    }
+
+    /* Check for errors. */
+    if (*status)
+    {
+        oskar_telescope_free(t, status);
+        return 0;
+    }
+    return t;
+}
+
+
+char* oskar_telescope_source_hash(const oskar_Telescope* telescope,
+        const char* dir_path, int* status)
+{
+    int options[8];
+    double position[3];
+    char* hash = 0;
+    unsigned long crc = 0, num_files = 0, num_bytes = 0;
+    oskar_CRC* crc_data = 0;
+    if (*status) return 0;
+    if (!oskar_dir_exists(dir_path))
+    {
+        *status = OSKAR_ERR_FILE_IO;
+        return 0;
+    }
+
+    /* Include the options that affect the load. */
+    memset(options, 0, sizeof(options));
+    options[0] = OSKAR_VERSION;
+    options[1] = FORMAT_VERSION;
+    options[2] = telescope->precision;
+    options[3] = telescope->pol_mode;
+    options[4] = telescope->enable_numerical_patterns;
+    options[5] = telescope->allow_station_beam_duplication;
+    options[6] = telescope->noise_enabled;
+    options[7] = (int) telescope->noise_seed;
+    position[0] = telescope->lon_rad;
+    position[1] = telescope->lat_rad;
+    position[2] = telescope->alt_metres;
+    crc_data = oskar_crc_create(OSKAR_CRC_32C);
+    crc = oskar_crc_compute(crc_data, options, sizeof(options));
+    crc = oskar_crc_update(crc_data, crc, position, sizeof(position));
+
+    /* Include the names, sizes and times of all files in the directory. */
+    hash_dir(crc_data, dir_path, "", &crc, &num_files, &num_bytes, status);
+    oskar_crc_free(crc_data);
+    if (*status) return 0;
+
+    /* Return the hash as a string. */
+    hash = (char*) calloc(64, sizeof(char));
+    sprintf(hash, "%08lx-%lu-%lu", crc & 0xFFFFFFFFul, num_files, num_bytes);
+    return hash;
+}
+
+
+static void write_mem(Counters* c, const oskar_Mem* mem,
+        unsigned char group, unsigned char tag, int index, int* status)
+{
+    /* Align payloads so that they can be used in place when mapped. */
+    oskar_binary_write_align(c->h, 8, status);
+    oskar_binary_write_mem(c->h, mem, group, tag, index, 0, status);
+}
+
+static void write_station(Counters* c, const oskar_Station* station,
+        int* status)
+{
+    int i;
+    const int id = c->station++;
+    const unsigned char group = (unsigned char) OSKAR_TAG_GROUP_STATION;
+    const oskar_Station* s = station;
+    if (*status) return;
+    for (i = 0; i < (int) NUM(station_ints); ++i)
+    {
+        const int tag = station_ints[i];
+        oskar_binary_write_int(c->h, group, (unsigned char) tag, id,
+                *CONST_FIELD(int, s, station_int(tag)), status);
+    }
+    for (i = 0; i < (int) NUM(station_doubles); ++i)
+    {
+        const int tag = station_doubles[i];
+        oskar_binary_write_double(c->h, group, (unsigned char) tag, id,
+                *CONST_FIELD(double, s, station_double(tag)), status);
+    }
+    for (i = 0; i < (int) NUM(station_mems); ++i)
+    {
+        const int tag = station_mems[i];
+        write_mem(c, *CONST_FIELD(oskar_Mem*, s, station_mem(tag)),
+                group, (unsigned char) tag, id, status);
+    }
+    oskar_binary_write_int(c->h, group, OSKAR_STATION_TAG_HAS_CHILD, id,
+            s->child ? 1 : 0, status);
+    oskar_binary_write_int(c->h, group, OSKAR_STATION_TAG_HAS_ELEMENT, id,
+            s->element ? 1 : 0, status);
+    oskar_binary_write_int(c->h, group, OSKAR_STATION_TAG_NUM_ELEMENT_TYPES,
+            id, s->element ? s->num_element_types : 0, status);
+    if (s->element)
+        for (i = 0; i < s->num_element_types; ++i)
+            write_element(c, s->element[i], status);
+    if (s->child)
+        for (i = 0; i < s->num_elements; ++i)
+            write_station(c, s->child[i], status);
+}
+
+static void write_element(Counters* c, const oskar_Element* element,
+        int* status)
+{
+    int i;
+    const int id = c->element++;
+    const unsigned char group = (unsigned char) OSKAR_TAG_GROUP_ELEMENT_DATA;
+    const oskar_Element* e = element;
+    if (*status) return;
+    for (i = 0; i < (int) NUM(element_ints); ++i)
+    {
+        const int tag = element_ints[i];
+        oskar_binary_write_int(c->h, group, (unsigned char) tag, id,
+                *CONST_FIELD(int, e, element_int(tag)), status);
+    }
+    for (i = 0; i < (int) NUM(element_doubles); ++i)
+    {
+        const int tag = element_doubles[i];
+        oskar_binary_write_double(c->h, group, (unsigned char) tag, id,
+                *CONST_FIELD(double, e, element_double(tag)), status);
+    }
+    oskar_binary_write_int(c->h, group, OSKAR_ELEMENT_TAG_NUM_FREQ, id,
+            e->num_freq, status);
+    for (i = 0; i < e->num_freq; ++i)
+    {
+        int flags = 0;
+        const int f = c->freq++;
+        if (e->x_h_re[i]) flags |= HAS_X_SPLINES;
+        if (e->y_h_re[i]) flags |= HAS_Y_SPLINES;
+        if (e->scalar_re[i]) flags |= HAS_SCALAR;
+        if (e->sph_wave[i]) flags |= HAS_SPH_WAVE;
+        if (e->filename_x[i]) flags |= HAS_FILENAME_X;
+        if (e->filename_y[i]) flags |= HAS_FILENAME_Y;
+        if (e->filename_scalar[i]) flags |= HAS_FILENAME_S;
+        oskar_binary_write_int(c->h, group,
+                OSKAR_ELEMENT_TAG_FREQ_DATA_FLAGS, f, flags, status);
+        oskar_binary_write_double(c->h, group, OSKAR_ELEMENT_TAG_FREQ_HZ,
+                f, e->freqs_hz[i], status);
+        oskar_binary_write_int(c->h, group, OSKAR_ELEMENT_TAG_L_MAX,
+                f, e->l_max[i], status);
+        if (flags & HAS_FILENAME_X)
+            write_mem(c, e->filename_x[i], group,
+                    OSKAR_ELEMENT_TAG_FILENAME_X, f, status);
+        if (flags & HAS_FILENAME_Y)
+            write_mem(c, e->filename_y[i], group,
+                    OSKAR_ELEMENT_TAG_FILENAME_Y, f, status);
+        if (flags & HAS_FILENAME_S)
+            write_mem(c, e->filename_scalar[i], group,
+                    OSKAR_ELEMENT_TAG_FILENAME_SCALAR, f, status);
+        if (flags & HAS_SPH_WAVE)
+            write_mem(c, e->sph_wave[i], group,
+                    OSKAR_ELEMENT_TAG_SPH_WAVE, f, status);
+        if (flags & HAS_X_SPLINES)
+        {
+            oskar_Splines* s[] = {
+                    e->x_h_re[i], e->x_h_im[i], e->x_v_re[i], e->x_v_im[i]};
+            write_splines(c, 4, s, status);
+        }
+        if (flags & HAS_Y_SPLINES)
+        {
+            oskar_Splines* s[] = {
+                    e->y_h_re[i], e->y_h_im[i], e->y_v_re[i], e->y_v_im[i]};
+            write_splines(c, 4, s, status);
+        }
+        if (flags & HAS_SCALAR)
+        {
+            oskar_Splines* s[] = {e->scalar_re[i], e->scalar_im[i]};
+            write_splines(c, 2, s, status);
+        }
+    }
+}
+
+static void write_splines(Counters* c, int num, oskar_Splines* const* s,
+        int* status)
+{
+    int i;
+    const unsigned char group = (unsigned char) OSKAR_TAG_GROUP_SPLINE_DATA;
+    for (i = 0; i < num; ++i)
+    {
+        const int id = c->splines++;
+        oskar_binary_write_int(c->h, group,
+                OSKAR_SPLINES_TAG_NUM_KNOTS_X_THETA, id,
+                s[i]->num_knots_x_theta, status);
+        oskar_binary_write_int(c->h, group,
+                OSKAR_SPLINES_TAG_NUM_KNOTS_Y_PHI, id,
+                s[i]->num_knots_y_phi, status);
+        oskar_binary_write_double(c->h, group,
+                OSKAR_SPLINES_TAG_SMOOTHING_FACTOR, id,
+                s[i]->smoothing_factor, status);
+        write_mem(c, s[i]->knots_x_theta, group,
+                OSKAR_SPLINES_TAG_KNOTS_X_THETA, id, status);
+        write_mem(c, s[i]->knots_y_phi, group,
+                OSKAR_SPLINES_TAG_KNOTS_Y_PHI, id, status);
+        write_mem(c, s[i]->coeff, group,
+                OSKAR_SPLINES_TAG_COEFF, id, status);
+    }
+}
+
+static void read_mem(Counters* c, unsigned char group, unsigned char tag,
+        int index, int alias, oskar_Mem** mem, int* status)
+{
+    int chunk, type;
+    oskar_Mem* t = 0;
+    if (*status) return;
+
+    /* Get the data type from the tag. */
+    chunk = oskar_binary_query(c->h, 0, group, tag, index, 0, status);
+    if (*status) return;
+    type = oskar_binary_tag_data_type(c->h, chunk);
+
+    /* Use the mapped data if allowed, otherwise read a copy. */
+    if (alias)
+        t = oskar_binary_read_mem_alias(c->h, type, group, tag, index,
+                status);
+    else
+    {
+        t = oskar_mem_create(type, OSKAR_CPU, 0, status);
+        oskar_binary_read_mem(c->h, t, group, tag, index, status);
+    }
+    if (*status)
+    {
+        oskar_mem_free(t, status);
+        return;
+    }
+
+    /* Replace the existing array. */
+    oskar_mem_free(*mem, status);
+    *mem = t;
+}
+
+static oskar_Station* read_station(Counters* c, int type, int* status)
+{
+    int i, has_child = 0, has_element = 0, num_element_types = 0;
+    const int id = c->station++;
+    const unsigned char group = (unsigned char) OSKAR_TAG_GROUP_STATION;
+    oskar_Station* s = 0;
+    if (*status) return 0;
+    s = oskar_station_create(type, OSKAR_CPU, 0, status);
+    if (*status) return s;
+    for (i = 0; i < (int) NUM(station_ints); ++i)
+    {
+        const int tag = station_ints[i];
+        oskar_binary_read_int(c->h, group, (unsigned char) tag, id,
+                FIELD(int, s, station_int(tag)), status);
+    }
+    for (i = 0; i < (int) NUM(station_doubles); ++i)
+    {
+        const int tag = station_doubles[i];
+        oskar_binary_read_double(c->h, group, (unsigned char) tag, id,
+                FIELD(double, s, station_double(tag)), status);
+    }
+
+    /* Per-element arrays refer to the mapped file. Noise and beam arrays
+     * are copied, as these are small and may be resized later. */
+    for (i = 0; i < (int) NUM(station_mems); ++i)
+    {
+        const int tag = station_mems[i];
+        const int alias = tag != OSKAR_STATION_TAG_NOISE_FREQ_HZ &&
+                tag != OSKAR_STATION_TAG_NOISE_RMS_JY &&
+                tag != OSKAR_STATION_TAG_PERMITTED_BEAM_AZ_RAD &&
+                tag != OSKAR_STATION_TAG_PERMITTED_BEAM_EL_RAD;
+        read_mem(c, group, (unsigned char) tag, id, alias,
+                FIELD(oskar_Mem*, s, station_mem(tag)), status);
+    }
+    oskar_binary_read_int(c->h, group, OSKAR_STATION_TAG_HAS_CHILD, id,
+            &has_child, status);
+    oskar_binary_read_int(c->h, group, OSKAR_STATION_TAG_HAS_ELEMENT, id,
+            &has_element, status);
+    oskar_binary_read_int(c->h, group, OSKAR_STATION_TAG_NUM_ELEMENT_TYPES,
+            id, &num_element_types, status);
+    if (*status) return s;
+
+    /* Read the element data. */
+    if (has_element)
+    {
+        if (num_element_types > 0)
+            oskar_station_resize_element_types(s, num_element_types, status);
+        else
+            s->element = (oskar_Element**) calloc(1, sizeof(oskar_Element*));
+        for (i = 0; i < num_element_types; ++i)
+            read_element(c, s->element[i], status);
+    }
+
+    /* Read the child stations. */
+    if (has_child && s->num_elements > 0)
+    {
+        s->child = (oskar_Station**) calloc(s->num_elements,
+                sizeof(oskar_Station*));
+        for (i = 0; i < s->num_elements; ++i)
+            s->child[i] = read_station(c, type, status);
+    }
+    return s;
+}
+
+static void read_element(Counters* c, oskar_Element* e, int* status)
+{
+    int i, num_freq = 0;
+    const int id = c->element++;
+    const unsigned char group = (unsigned char) OSKAR_TAG_GROUP_ELEMENT_DATA;
+    if (*status) return;
+    for (i = 0; i < (int) NUM(element_ints); ++i)
+    {
+        const int tag = element_ints[i];
+        oskar_binary_read_int(c->h, group, (unsigned char) tag, id,
+                FIELD(int, e, element_int(tag)), status);
+    }
+    for (i = 0; i < (int) NUM(element_doubles); ++i)
+    {
+        const int tag = element_doubles[i];
+        oskar_binary_read_double(c->h, group, (unsigned char) tag, id,
+                FIELD(double, e, element_double(tag)), status);
+    }
+    oskar_binary_read_int(c->h, group, OSKAR_ELEMENT_TAG_NUM_FREQ, id,
+            &num_freq, status);
+    oskar_element_resize_freq_data(e, num_freq, status);
+    for (i = 0; i < num_freq && !*status; ++i)
+    {
+        int flags = 0;
+        const int f = c->freq++;
+        const int prec = e->precision, loc = e->mem_location;
+        oskar_binary_read_int(c->h, group,
+                OSKAR_ELEMENT_TAG_FREQ_DATA_FLAGS, f, &flags, status);
+        oskar_binary_read_double(c->h, group, OSKAR_ELEMENT_TAG_FREQ_HZ,
+                f, &e->freqs_hz[i], status);
+        oskar_binary_read_int(c->h, group, OSKAR_ELEMENT_TAG_L_MAX,
+                f, &e->l_max[i], status);
+        if (flags & HAS_FILENAME_X)
+            read_mem(c, group, OSKAR_ELEMENT_TAG_FILENAME_X, f, 0,
+                    &e->filename_x[i], status);
+        if (flags & HAS_FILENAME_Y)
+            read_mem(c, group, OSKAR_ELEMENT_TAG_FILENAME_Y, f, 0,
+                    &e->filename_y[i], status);
+        if (flags & HAS_FILENAME_S)
+            read_mem(c, group, OSKAR_ELEMENT_TAG_FILENAME_SCALAR, f, 0,
+                    &e->filename_scalar[i], status);
+        if (flags & HAS_SPH_WAVE)
+            read_mem(c, group, OSKAR_ELEMENT_TAG_SPH_WAVE, f, 1,
+                    &e->sph_wave[i], status);
+        if (flags & HAS_X_SPLINES)
+        {
+            e->x_h_re[i] = oskar_splines_create(prec, loc, status);
+            e->x_h_im[i] = oskar_splines_create(prec, loc, status);
+            e->x_v_re[i] = oskar_splines_create(prec, loc, status);
+            e->x_v_im[i] = oskar_splines_create(prec, loc, status);
+            {
+                oskar_Splines* s[] = {
+                        e->x_h_re[i], e->x_h_im[i], e->x_v_re[i], e->x_v_im[i]};
+                read_splines(c, 4, s, status);
+            }
+        }
+        if (flags & HAS_Y_SPLINES)
+        {
+            e->y_h_re[i] = oskar_splines_create(prec, loc, status);
+            e->y_h_im[i] = oskar_splines_create(prec, loc, status);
+            e->y_v_re[i] = oskar_splines_create(prec, loc, status);
+            e->y_v_im[i] = oskar_splines_create(prec, loc, status);
+            {
+                oskar_Splines* s[] = {
+                        e->y_h_re[i], e->y_h_im[i], e->y_v_re[i], e->y_v_im[i]};
+                read_splines(c, 4, s, status);
+            }
+        }
+        if (flags & HAS_SCALAR)
+        {
+            e->scalar_re[i] = oskar_splines_create(prec, loc, status);
+            e->scalar_im[i] = oskar_splines_create(prec, loc, status);
+            {
+                oskar_Splines* s[] = {e->scalar_re[i], e->scalar_im[i]};
+                read_splines(c, 2, s, status);
+            }
+        }
+    }
+}
+
+static void read_splines(Counters* c, int num, oskar_Splines** s,
+        int* status)
+{
+    int i;
+    const unsigned char group = (unsigned char) OSKAR_TAG_GROUP_SPLINE_DATA;
+    for (i = 0; i < num && !*status; ++i)
+    {
+        const int id = c->splines++;
+        oskar_binary_read_int(c->h, group,
+                OSKAR_SPLINES_TAG_NUM_KNOTS_X_THETA, id,
+                &s[i]->num_knots_x_theta, status);
+        oskar_binary_read_int(c->h, group,
+                OSKAR_SPLINES_TAG_NUM_KNOTS_Y_PHI, id,
+                &s[i]->num_knots_y_phi, status);
+        oskar_binary_read_double(c->h, group,
+                OSKAR_SPLINES_TAG_SMOOTHING_FACTOR, id,
+                &s[i]->smoothing_factor, status);
+        read_mem(c, group, OSKAR_SPLINES_TAG_KNOTS_X_THETA, id, 1,
+                &s[i]->knots_x_theta, status);
+        read_mem(c, group, OSKAR_SPLINES_TAG_KNOTS_Y_PHI, id, 1,
+                &s[i]->knots_y_phi, status);
+        read_mem(c, group, OSKAR_SPLINES_TAG_COEFF, id, 1,
+                &s[i]->coeff, status);
+    }
+}
+
+static void hash_dir(const oskar_CRC* crc_data, const char* dir_path,
+        const char* rel_path, unsigned long* crc, unsigned long* num_files,
+        unsigned long* num_bytes, int* status)
+{
+    int i, num_items = 0;
+    char** items = 0;
+
+    /* Hash the names, sizes and modification times of the files in this
+     * directory, sorted by name. The contents are not read, as this would
+     * take too long for large element pattern files. */
+    oskar_dir_items(dir_path, NULL, 1, 0, &num_items, &items);
+    for (i = 0; i < num_items; ++i)
+    {
+        struct stat st;
+        long long info[2];
+        char* path = oskar_dir_get_path(dir_path, items[i]);
+        const int error = stat(path, &st);
+        free(path);
+        if (error)
+        {
+            *status = OSKAR_ERR_FILE_IO;
+            break;
+        }
+        info[0] = (long long) st.st_size;
+        info[1] = (long long) st.st_mtime;
+        *crc = oskar_crc_update(crc_data, *crc, rel_path, strlen(rel_path));
+        *crc = oskar_crc_update(crc_data, *crc, items[i],
+                1 + strlen(items[i]));
+        *crc = oskar_crc_update(crc_data, *crc, info, sizeof(info));
+        *num_bytes += (unsigned long) st.st_size;
+        (*num_files)++;
+    }
+    for (i = 0; i < num_items; ++i) free(items[i]);
+    free(items);
+    if (*status) return;
+
+    /* Recursively hash the subdirectories. */
+    items = 0;
+    num_items = 0;
+    oskar_dir_items(dir_path, NULL, 0, 1, &num_items, &items);
+    for (i = 0; i < num_items; ++i)
+    {
+        char *path = 0, *rel = 0;
+        path = oskar_dir_get_path(dir_path, items[i]);
+        rel = (char*) calloc(strlen(rel_path) + strlen(items[i]) + 2, 1);
+        sprintf(rel, "%s%s/", rel_path, items[i]);
+        hash_dir(crc_data, path, rel, crc, num_files, num_bytes, status);
+        free(path);
+        free(rel);
+    }
+    for (i = 0; i < num_items; ++i) free(items[i]);
+    free(items);
+}
+
+static size_t station_int(int tag)
+{
+    switch (tag)
+    {
+    case OSKAR_STATION_TAG_UNIQUE_ID:
+        return offsetof(oskar_Station, unique_id);
+    case OSKAR_STATION_TAG_STATION_TYPE:
+        return offsetof(oskar_Station, station_type);
+    case OSKAR_STATION_TAG_NORMALISE_FINAL_BEAM:
+        return offsetof(oskar_Station, normalise_final_beam);
+    case OSKAR_STATION_TAG_BEAM_COORD_TYPE:
+        return offsetof(oskar_Station, beam_coord_type);
+    case OSKAR_STATION_TAG_IDENTICAL_CHILDREN:
+        return offsetof(oskar_Station, identical_children);
+    case OSKAR_STATION_TAG_NUM_ELEMENTS:
+        return offsetof(oskar_Station, num_elements);
+    case OSKAR_STATION_TAG_NORMALISE_ARRAY_PATTERN:
+        return offsetof(oskar_Station, normalise_array_pattern);
+    case OSKAR_STATION_TAG_ENABLE_ARRAY_PATTERN:
+        return offsetof(oskar_Station, enable_array_pattern);
+    case OSKAR_STATION_TAG_COMMON_ELEMENT_ORIENTATION:
+        return offsetof(oskar_Station, common_element_orientation);
+    case OSKAR_STATION_TAG_ARRAY_IS_3D:
+        return offsetof(oskar_Station, array_is_3d);
+    case OSKAR_STATION_TAG_APPLY_ELEMENT_ERRORS:
+        return offsetof(oskar_Station, apply_element_errors);
+    case OSKAR_STATION_TAG_APPLY_ELEMENT_WEIGHT:
+        return offsetof(oskar_Station, apply_element_weight);
+    case OSKAR_STATION_TAG_SEED_TIME_VARIABLE_ERRORS:
+        return offsetof(oskar_Station, seed_time_variable_errors);
+    case OSKAR_STATION_TAG_NUM_PERMITTED_BEAMS:
+        return offsetof(oskar_Station, num_permitted_beams);
+    default:
+        return 0;
+    }
+}
+
+static size_t station_double(int tag)
+{
+    switch (tag)
+    {
+    case OSKAR_STATION_TAG_LON_RAD:
+        return offsetof(oskar_Station, lon_rad);
+    case OSKAR_STATION_TAG_LAT_RAD:
+        return offsetof(oskar_Station, lat_rad);
+    case OSKAR_STATION_TAG_ALT_METRES:
+        return offsetof(oskar_Station, alt_metres);
+    case OSKAR_STATION_TAG_PM_X_RAD:
+        return offsetof(oskar_Station, pm_x_rad);
+    case OSKAR_STATION_TAG_PM_Y_RAD:
+        return offsetof(oskar_Station, pm_y_rad);
+    case OSKAR_STATION_TAG_BEAM_LON_RAD:
+        return offsetof(oskar_Station, beam_lon_rad);
+    case OSKAR_STATION_TAG_BEAM_LAT_RAD:
+        return offsetof(oskar_Station, beam_lat_rad);
+    case OSKAR_STATION_TAG_GAUSSIAN_BEAM_FWHM_RAD:
+        return offsetof(oskar_Station, gaussian_beam_fwhm_rad);
+    case OSKAR_STATION_TAG_GAUSSIAN_BEAM_REF_FREQ_HZ:
+        return offsetof(oskar_Station, gaussian_beam_reference_freq_hz);
+    default:
+        return 0;
+    }
+}
+
+static size_t station_mem(int tag)
+{
+    switch (tag)
+    {
+    case OSKAR_STATION_TAG_NOISE_FREQ_HZ:
+        return offsetof(oskar_Station, noise_freq_hz);
+    case OSKAR_STATION_TAG_NOISE_RMS_JY:
+        return offsetof(oskar_Station, noise_rms_jy);
+    case OSKAR_STATION_TAG_ELEMENT_TRUE_X_ENU:
+        return offsetof(oskar_Station, element_true_x_enu_metres);
+    case OSKAR_STATION_TAG_ELEMENT_TRUE_Y_ENU:
+        return offsetof(oskar_Station, element_true_y_enu_metres);
+    case OSKAR_STATION_TAG_ELEMENT_TRUE_Z_ENU:
+        return offsetof(oskar_Station, element_true_z_enu_metres);
+    case OSKAR_STATION_TAG_ELEMENT_MEASURED_X_ENU:
+        return offsetof(oskar_Station, element_measured_x_enu_metres);
+    case OSKAR_STATION_TAG_ELEMENT_MEASURED_Y_ENU:
+        return offsetof(oskar_Station, element_measured_y_enu_metres);
+    case OSKAR_STATION_TAG_ELEMENT_MEASURED_Z_ENU:
+        return offsetof(oskar_Station, element_measured_z_enu_metres);
+    case OSKAR_STATION_TAG_ELEMENT_GAIN:
+        return offsetof(oskar_Station, element_gain);
+    case OSKAR_STATION_TAG_ELEMENT_GAIN_ERROR:
+        return offsetof(oskar_Station, element_gain_error);
+    case OSKAR_STATION_TAG_ELEMENT_PHASE_OFFSET:
+        return offsetof(oskar_Station, element_phase_offset_rad);
+    case OSKAR_STATION_TAG_ELEMENT_PHASE_ERROR:
+        return offsetof(oskar_Station, element_phase_error_rad);
+    case OSKAR_STATION_TAG_ELEMENT_WEIGHT:
+        return offsetof(oskar_Station, element_weight);
+    case OSKAR_STATION_TAG_ELEMENT_CABLE_LENGTH_ERROR:
+        return offsetof(oskar_Station, element_cable_length_error);
+    case OSKAR_STATION_TAG_ELEMENT_TYPES:
+        return offsetof(oskar_Station, element_types);
+    case OSKAR_STATION_TAG_ELEMENT_TYPES_CPU:
+        return offsetof(oskar_Station, element_types_cpu);
+    case OSKAR_STATION_TAG_ELEMENT_MOUNT_TYPES_CPU:
+        return offsetof(oskar_Station, element_mount_types_cpu);
+    case OSKAR_STATION_TAG_ELEMENT_X_ALPHA:
+        return offsetof(oskar_Station, element_x_alpha_cpu);
+    case OSKAR_STATION_TAG_ELEMENT_X_BETA:
+        return offsetof(oskar_Station, element_x_beta_cpu);
+    case OSKAR_STATION_TAG_ELEMENT_X_GAMMA:
+        return offsetof(oskar_Station, element_x_gamma_cpu);
+    case OSKAR_STATION_TAG_ELEMENT_Y_ALPHA:
+        return offsetof(oskar_Station, element_y_alpha_cpu);
+    case OSKAR_STATION_TAG_ELEMENT_Y_BETA:
+        return offsetof(oskar_Station, element_y_beta_cpu);
+    case OSKAR_STATION_TAG_ELEMENT_Y_GAMMA:
+        return offsetof(oskar_Station, element_y_gamma_cpu);
+    case OSKAR_STATION_TAG_PERMITTED_BEAM_AZ_RAD:
+        return offsetof(oskar_Station, permitted_beam_az_rad);
+    case OSKAR_STATION_TAG_PERMITTED_BEAM_EL_RAD:
+        return offsetof(oskar_Station, permitted_beam_el_rad);
+    default:
+        return 0;
+    }
+}
+
+static size_t element_int(int tag)
+{
+    switch (tag)
+    {
+    case OSKAR_ELEMENT_TAG_COORD_SYS:
+        return offsetof(oskar_Element, coord_sys);
+    case OSKAR_ELEMENT_TAG_X_ELEMENT_TYPE:
+        return offsetof(oskar_Element, x_element_type);
+    case OSKAR_ELEMENT_TAG_Y_ELEMENT_TYPE:
+        return offsetof(oskar_Element, y_element_type);
+    case OSKAR_ELEMENT_TAG_X_TAPER_TYPE:
+        return offsetof(oskar_Element, x_taper_type);
+    case OSKAR_ELEMENT_TAG_Y_TAPER_TYPE:
+        return offsetof(oskar_Element, y_taper_type);
+    case OSKAR_ELEMENT_TAG_X_DIPOLE_LENGTH_UNITS:
+        return offsetof(oskar_Element, x_dipole_length_units);
+    case OSKAR_ELEMENT_TAG_Y_DIPOLE_LENGTH_UNITS:
+        return offsetof(oskar_Element, y_dipole_length_units);
+    case OSKAR_ELEMENT_TAG_ELEMENT_TYPE:
+        return offsetof(oskar_Element, element_type);
+    case OSKAR_ELEMENT_TAG_TAPER_TYPE:
+        return offsetof(oskar_Element, taper_type);
+    case OSKAR_ELEMENT_TAG_DIPOLE_LENGTH_UNITS:
+        return offsetof(oskar_Element, dipole_length_units);
+    case OSKAR_ELEMENT_TAG_INTERPOLATE_FREQ:
+        return offsetof(oskar_Element, interpolate_freq);
+    default:
+        return 0;
+    }
+}
+
+static size_t element_double(int tag)
+{
+    switch (tag)
+    {
+    case OSKAR_ELEMENT_TAG_MAX_RADIUS:
+        return offsetof(oskar_Element, max_radius_rad);
+    case OSKAR_ELEMENT_TAG_X_DIPOLE_LENGTH:
+        return offsetof(oskar_Element, x_dipole_length);
+    case OSKAR_ELEMENT_TAG_Y_DIPOLE_LENGTH:
+        return offsetof(oskar_Element, y_dipole_length);
+    case OSKAR_ELEMENT_TAG_X_TAPER_COSINE_POWER:
+        return offsetof(oskar_Element, x_taper_cosine_power);
+    case OSKAR_ELEMENT_TAG_Y_TAPER_COSINE_POWER:
+        return offsetof(oskar_Element, y_taper_cosine_power);
+    case OSKAR_ELEMENT_TAG_X_TAPER_GAUSSIAN_FWHM_RAD:
+        return offsetof(oskar_Element, x_taper_gaussian_fwhm_rad);
+    case OSKAR_ELEMENT_TAG_Y_TAPER_GAUSSIAN_FWHM_RAD:
+        return offsetof(oskar_Element, y_taper_gaussian_fwhm_rad);
+    case OSKAR_ELEMENT_TAG_X_TAPER_REF_FREQ_HZ:
+        return offsetof(oskar_Element, x_taper_ref_freq_hz);
+    case OSKAR_ELEMENT_TAG_Y_TAPER_REF_FREQ_HZ:
+        return offsetof(oskar_Element, y_taper_ref_freq_hz);
+    case OSKAR_ELEMENT_TAG_DIPOLE_LENGTH:
+        return offsetof(oskar_Element, dipole_length);
+    case OSKAR_ELEMENT_TAG_COSINE_POWER:
+        return offsetof(oskar_Element, cosine_power);
+    case OSKAR_ELEMENT_TAG_GAUSSIAN_FWHM_RAD:
+        return offsetof(oskar_Element, gaussian_fwhm_rad);
+    default:
+        return 0;
+    }
+}
+
+static size_t telescope_mem(int tag)
+{
+    switch (tag)
+    {
+    case OSKAR_TELESCOPE_TAG_STATION_TRUE_X_OFFSET_ECEF:
+        return offsetof(oskar_Telescope, station_true_x_offset_ecef_metres);
+    case OSKAR_TELESCOPE_TAG_STATION_TRUE_Y_OFFSET_ECEF:
+        return offsetof(oskar_Telescope, station_true_y_offset_ecef_metres);
+    case OSKAR_TELESCOPE_TAG_STATION_TRUE_Z_OFFSET_ECEF:
+        return offsetof(oskar_Telescope, station_true_z_offset_ecef_metres);
+    case OSKAR_TELESCOPE_TAG_STATION_TRUE_X_ENU:
+        return offsetof(oskar_Telescope, station_true_x_enu_metres);
+    case OSKAR_TELESCOPE_TAG_STATION_TRUE_Y_ENU:
+        return offsetof(oskar_Telescope, station_true_y_enu_metres);
+    case OSKAR_TELESCOPE_TAG_STATION_TRUE_Z_ENU:
+        return offsetof(oskar_Telescope, station_true_z_enu_metres);
+    case OSKAR_TELESCOPE_TAG_STATION_MEASURED_X_OFFSET_ECEF:
+        return offsetof(oskar_Telescope, station_measured_x_offset_ecef_metres);
+    case OSKAR_TELESCOPE_TAG_STATION_MEASURED_Y_OFFSET_ECEF:
+        return offsetof(oskar_Telescope, station_measured_y_offset_ecef_metres);
+    case OSKAR_TELESCOPE_TAG_STATION_MEASURED_Z_OFFSET_ECEF:
+        return offsetof(oskar_Telescope, station_measured_z_offset_ecef_metres);
+    case OSKAR_TELESCOPE_TAG_STATION_MEASURED_X_ENU:
+        return offsetof(oskar_Telescope, station_measured_x_enu_metres);
+    case OSKAR_TELESCOPE_TAG_STATION_MEASURED_Y_ENU:
+        return offsetof(oskar_Telescope, station_measured_y_enu_metres);
+    case OSKAR_TELESCOPE_TAG_STATION_MEASURED_Z_ENU:
+        return offsetof(oskar_Telescope, station_measured_z_enu_metres);
+    default:
+        return 0;
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2016, The University of Oxford
+ * Copyright (c) 2013-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -71,6 +71,7 @@ oskar_Telescope* oskar_telescope_create(int type, int location,
     telescope->identical_stations = 0;
     telescope->allow_station_beam_duplication = 0;
     telescope->enable_numerical_patterns = 1;
+    telescope->compiled_file = 0;
     telescope->lon_rad = 0.0;
     telescope->lat_rad = 0.0;
     telescope->alt_metres = 0.0;
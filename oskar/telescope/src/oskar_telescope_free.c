@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2011-2015, The University of Oxford
+ * Copyright (c) 2011-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -63,6 +63,9 @@ void oskar_telescope_free(oskar_Telescope* telescope, int* status)
     /* Free the station array. */
     free(telescope->station);
 
+    /* Release the compiled model file, if any. */
+    oskar_binary_free(telescope->compiled_file);
+
     /* Free the structure itself. */
     free(telescope);
 }
@@ -4,7 +4,7 @@
 KERNEL(NAME) (const int n, const FP inv_2sigma_sq, GLOBAL_IN(FP, theta),\
         const int offset_out, GLOBAL_OUT(FP2, jones))\
 {\
-    KERNEL_LOOP_X(int, i, 0, n)\
+    KERNEL_LOOP_PAR_SIMD_X(int, i, 0, n)\
     FP theta_sq = theta[i]; theta_sq *= theta_sq;\
     const FP t = -theta_sq * inv_2sigma_sq;\
     const FP f = (FP) exp(t);\
@@ -18,7 +18,7 @@ OSKAR_REGISTER_KERNEL(NAME)
 KERNEL(NAME) (const int n, const FP inv_2sigma_sq, GLOBAL_IN(FP, theta),\
         const int offset_out, GLOBAL_OUT(FP4c, jones))\
 {\
-    KERNEL_LOOP_X(int, i, 0, n)\
+    KERNEL_LOOP_PAR_SIMD_X(int, i, 0, n)\
     FP theta_sq = theta[i]; theta_sq *= theta_sq;\
     const FP t = -theta_sq * inv_2sigma_sq;\
     const FP f = (FP) exp(t);\
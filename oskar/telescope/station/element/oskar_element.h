@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, The University of Oxford
+ * Copyright (c) 2013-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -51,7 +51,37 @@ enum OSKAR_ELEMENT_TAGS
 {
     OSKAR_ELEMENT_TAG_SURFACE_TYPE = 1,
     OSKAR_ELEMENT_TAG_COORD_SYS = 2,
-    OSKAR_ELEMENT_TAG_MAX_RADIUS = 3
+    OSKAR_ELEMENT_TAG_MAX_RADIUS = 3,
+    OSKAR_ELEMENT_TAG_X_ELEMENT_TYPE = 4,
+    OSKAR_ELEMENT_TAG_Y_ELEMENT_TYPE = 5,
+    OSKAR_ELEMENT_TAG_X_TAPER_TYPE = 6,
+    OSKAR_ELEMENT_TAG_Y_TAPER_TYPE = 7,
+    OSKAR_ELEMENT_TAG_X_DIPOLE_LENGTH_UNITS = 8,
+    OSKAR_ELEMENT_TAG_Y_DIPOLE_LENGTH_UNITS = 9,
+    OSKAR_ELEMENT_TAG_X_DIPOLE_LENGTH = 10,
+    OSKAR_ELEMENT_TAG_Y_DIPOLE_LENGTH = 11,
+    OSKAR_ELEMENT_TAG_X_TAPER_COSINE_POWER = 12,
+    OSKAR_ELEMENT_TAG_Y_TAPER_COSINE_POWER = 13,
+    OSKAR_ELEMENT_TAG_X_TAPER_GAUSSIAN_FWHM_RAD = 14,
+    OSKAR_ELEMENT_TAG_Y_TAPER_GAUSSIAN_FWHM_RAD = 15,
+    OSKAR_ELEMENT_TAG_X_TAPER_REF_FREQ_HZ = 16,
+    OSKAR_ELEMENT_TAG_Y_TAPER_REF_FREQ_HZ = 17,
+    OSKAR_ELEMENT_TAG_ELEMENT_TYPE = 18,
+    OSKAR_ELEMENT_TAG_TAPER_TYPE = 19,
+    OSKAR_ELEMENT_TAG_DIPOLE_LENGTH_UNITS = 20,
+    OSKAR_ELEMENT_TAG_DIPOLE_LENGTH = 21,
+    OSKAR_ELEMENT_TAG_COSINE_POWER = 22,
+    OSKAR_ELEMENT_TAG_GAUSSIAN_FWHM_RAD = 23,
+    OSKAR_ELEMENT_TAG_INTERPOLATE_FREQ = 24,
+    OSKAR_ELEMENT_TAG_NUM_FREQ = 25,
+    /* Tags below here are indexed by frequency, not by element. */
+    OSKAR_ELEMENT_TAG_FREQ_HZ = 26,
+    OSKAR_ELEMENT_TAG_FREQ_DATA_FLAGS = 27,
+    OSKAR_ELEMENT_TAG_FILENAME_X = 28,
+    OSKAR_ELEMENT_TAG_FILENAME_Y = 29,
+    OSKAR_ELEMENT_TAG_FILENAME_SCALAR = 30,
+    OSKAR_ELEMENT_TAG_L_MAX = 31,
+    OSKAR_ELEMENT_TAG_SPH_WAVE = 32
 };
 
 enum OSKAR_ELEMENT_SURFACE_TYPE
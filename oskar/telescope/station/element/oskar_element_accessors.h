@@ -71,6 +71,9 @@ const double* oskar_element_freqs_hz_const(const oskar_Element* data);
 OSKAR_EXPORT
 int oskar_element_is_isotropic(const oskar_Element* data);
 
+OSKAR_EXPORT
+int oskar_element_interpolate_freq(const oskar_Element* data);
+
 OSKAR_EXPORT
 int oskar_element_taper_type(const oskar_Element* data);
 
@@ -115,6 +118,21 @@ void oskar_element_set_gaussian_fwhm_rad(oskar_Element* data, double value);
 OSKAR_EXPORT
 void oskar_element_set_cosine_power(oskar_Element* data, double value);
 
+/**
+ * @brief
+ * Sets whether numerical element patterns are interpolated in frequency.
+ *
+ * @details
+ * If set, patterns at frequencies between those of the loaded data are
+ * interpolated linearly between the two closest frequencies, instead of
+ * using the data at the closest frequency.
+ *
+ * @param[in] data   Pointer to element model.
+ * @param[in] value  If true, interpolate between loaded frequencies.
+ */
+OSKAR_EXPORT
+void oskar_element_set_interpolate_freq(oskar_Element* data, int value);
+
 OSKAR_EXPORT
 void oskar_element_set_dipole_length(oskar_Element* data, double value,
         const char* units, int* status);
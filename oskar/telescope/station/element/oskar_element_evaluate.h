@@ -60,6 +60,9 @@ extern "C" {
  * @param[in,out] theta     Pointer to work array for computing theta values.
  * @param[in,out] phi_x     Pointer to work array for computing phi values.
  * @param[in,out] phi_y     Pointer to work array for computing phi values.
+ * @param[in,out] temp      Pointer to work array used when interpolating
+ *                          in frequency. This must have the same type and
+ *                          location as \p output, and is resized if needed.
  * @param[in] offset_out    Start offset into output array.
  * @param[in,out] output    Pointer to output array.
  * @param[in,out] status    Status return code.
@@ -78,6 +81,7 @@ void oskar_element_evaluate(
         oskar_Mem* theta,
         oskar_Mem* phi_x,
         oskar_Mem* phi_y,
+        oskar_Mem* temp,
         int offset_out,
         oskar_Mem* output,
         int* status);
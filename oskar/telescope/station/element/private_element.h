@@ -50,6 +50,7 @@ struct oskar_Element
     double dipole_length; /* Length of dipole. */
     double cosine_power; /* For a cosine taper, the power of the cosine. */
     double gaussian_fwhm_rad; /* For a Gaussian taper, the FWHM in radians. */
+    int interpolate_freq; /* If set, interpolate between loaded frequencies. */
 
     /* Data for numerically-defined element patterns. */
     /* The arrays of fitted data are per-frequency. */
@@ -45,6 +45,7 @@ void oskar_element_copy(oskar_Element* dst, const oskar_Element* src,
     dst->gaussian_fwhm_rad = src->gaussian_fwhm_rad;
     dst->dipole_length = src->dipole_length;
     dst->dipole_length_units = src->dipole_length_units;
+    dst->interpolate_freq = src->interpolate_freq;
     oskar_element_resize_freq_data(dst, src->num_freq, status);
     const int prec = dst->precision;
     const int loc = dst->mem_location;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2016, The University of Oxford
+ * Copyright (c) 2015-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -59,6 +59,13 @@ int oskar_element_different(const oskar_Element* a, const oskar_Element* b,
     if (a->y_taper_gaussian_fwhm_rad != b->y_taper_gaussian_fwhm_rad) return 1;
     if (a->x_taper_ref_freq_hz != b->x_taper_ref_freq_hz) return 1;
     if (a->y_taper_ref_freq_hz != b->y_taper_ref_freq_hz) return 1;
+    if (a->element_type != b->element_type) return 1;
+    if (a->taper_type != b->taper_type) return 1;
+    if (a->dipole_length != b->dipole_length) return 1;
+    if (a->dipole_length_units != b->dipole_length_units) return 1;
+    if (a->cosine_power != b->cosine_power) return 1;
+    if (a->gaussian_fwhm_rad != b->gaussian_fwhm_rad) return 1;
+    if (a->interpolate_freq != b->interpolate_freq) return 1;
 
     /* Check frequency-dependent data. */
     if (a->num_freq != b->num_freq) return 1;
@@ -45,6 +45,12 @@
 extern "C" {
 #endif
 
+static void evaluate_pattern(const oskar_Element* model, int id,
+        int num_points, const oskar_Mem* theta, const oskar_Mem* phi_x,
+        const oskar_Mem* phi_y, double frequency_hz, double dipole_length_m,
+        int offset_out, oskar_Mem* output, int* status);
+static int same_data(const oskar_Element* model, int id1, int id2);
+
 void oskar_element_evaluate(
         const oskar_Element* model,
         double orientation_x,
@@ -58,11 +64,13 @@ void oskar_element_evaluate(
         oskar_Mem* theta,
         oskar_Mem* phi_x,
         oskar_Mem* phi_y,
+        oskar_Mem* temp,
         int offset_out,
         oskar_Mem* output,
         int* status)
 {
-    double dipole_length_m;
+    double dipole_length_m, weight = 0.0;
+    int id, id_next = -1;
     if (*status) return;
     if (!oskar_mem_is_complex(output))
     {
@@ -75,20 +83,81 @@ void oskar_element_evaluate(
     oskar_mem_ensure(phi_y, num_points, status);
 
     /* Get the element model properties. */
-    const int element_type = model->element_type;
     const int taper_type   = model->taper_type;
-    const int id = oskar_find_closest_match_d(frequency_hz,
-            oskar_element_num_freq(model),
-            oskar_element_freqs_hz_const(model));
+    const int num_freq     = oskar_element_num_freq(model);
+    const double* freqs_hz = oskar_element_freqs_hz_const(model);
+    id = oskar_find_closest_match_d(frequency_hz, num_freq, freqs_hz);
     dipole_length_m = model->dipole_length;
     if (model->dipole_length_units == OSKAR_WAVELENGTHS)
         dipole_length_m *= (C_0 / frequency_hz);
 
+    /* Find the loaded frequencies either side of the required one,
+     * if interpolating between them. */
+    if (model->interpolate_freq && freqs_hz[id] != frequency_hz)
+    {
+        int i, id_lo = -1, id_hi = -1;
+        for (i = 0; i < num_freq; ++i)
+        {
+            if (freqs_hz[i] < frequency_hz &&
+                    (id_lo < 0 || freqs_hz[i] > freqs_hz[id_lo]))
+                id_lo = i;
+            if (freqs_hz[i] > frequency_hz &&
+                    (id_hi < 0 || freqs_hz[i] < freqs_hz[id_hi]))
+                id_hi = i;
+        }
+        if (id_lo >= 0 && id_hi >= 0 && same_data(model, id_lo, id_hi))
+        {
+            id = id_lo;
+            id_next = id_hi;
+            weight = (frequency_hz - freqs_hz[id_lo]) /
+                    (freqs_hz[id_hi] - freqs_hz[id_lo]);
+        }
+    }
+
     /* Compute theta and phi coordinates. */
     oskar_convert_enu_directions_to_theta_phi(offset_points, num_points,
             x, y, z, (M_PI/2) - orientation_x, (M_PI/2) - orientation_y,
             theta, phi_x, phi_y, status);
 
+    /* Evaluate the pattern, interpolating linearly in frequency
+     * if required. */
+    evaluate_pattern(model, id, num_points, theta, phi_x, phi_y,
+            frequency_hz, dipole_length_m, offset_out, output, status);
+    if (id_next >= 0)
+    {
+        if (!temp || oskar_mem_type(temp) != oskar_mem_type(output) ||
+                oskar_mem_location(temp) != oskar_mem_location(output))
+        {
+            *status = OSKAR_ERR_TYPE_MISMATCH;
+            return;
+        }
+        oskar_mem_ensure(temp, num_points, status);
+        evaluate_pattern(model, id_next, num_points, theta, phi_x, phi_y,
+                frequency_hz, dipole_length_m, 0, temp, status);
+        oskar_mem_scale_real(output, 1.0 - weight,
+                offset_out, num_points, status);
+        oskar_mem_scale_real(temp, weight, 0, num_points, status);
+        oskar_mem_add(output, output, temp,
+                offset_out, offset_out, 0, num_points, status);
+    }
+
+    /* Apply element tapering, if specified. */
+    if (taper_type == OSKAR_ELEMENT_TAPER_COSINE)
+        oskar_apply_element_taper_cosine(num_points,
+                model->cosine_power, theta, offset_out, output, status);
+    else if (taper_type == OSKAR_ELEMENT_TAPER_GAUSSIAN)
+        oskar_apply_element_taper_gaussian(num_points,
+                model->gaussian_fwhm_rad, theta, offset_out, output, status);
+}
+
+
+static void evaluate_pattern(const oskar_Element* model, int id,
+        int num_points, const oskar_Mem* theta, const oskar_Mem* phi_x,
+        const oskar_Mem* phi_y, double frequency_hz, double dipole_length_m,
+        int offset_out, oskar_Mem* output, int* status)
+{
+    const int element_type = model->element_type;
+
     /* Check if element type is isotropic. */
     if (element_type == OSKAR_ELEMENT_TYPE_ISOTROPIC)
         oskar_mem_set_value_real(output, 1.0, offset_out, num_points, status);
@@ -106,14 +175,14 @@ void oskar_element_evaluate(
             const int offset_out_cplx = offset_out * 4;
             if (oskar_element_has_x_spline_data(model, id))
             {
-                oskar_splines_evaluate(model->x_h_re[id], num_points, theta,
-                        phi_x, 8, offset_out_real + 0, output, status);
-                oskar_splines_evaluate(model->x_h_im[id], num_points, theta,
-                        phi_x, 8, offset_out_real + 1, output, status);
-                oskar_splines_evaluate(model->x_v_re[id], num_points, theta,
-                        phi_x, 8, offset_out_real + 2, output, status);
-                oskar_splines_evaluate(model->x_v_im[id], num_points, theta,
-                        phi_x, 8, offset_out_real + 3, output, status);
+                const oskar_Splines* const splines[] = {
+                        model->x_h_re[id], model->x_h_im[id],
+                        model->x_v_re[id], model->x_v_im[id]};
+                const int offsets[] = {
+                        offset_out_real + 0, offset_out_real + 1,
+                        offset_out_real + 2, offset_out_real + 3};
+                oskar_splines_evaluate_multi(4, splines, num_points, theta,
+                        phi_x, 8, offsets, output, status);
                 oskar_convert_ludwig3_to_theta_phi_components(num_points,
                         phi_x, 4, offset_out_cplx + 0, output, status);
             }
@@ -124,14 +193,14 @@ void oskar_element_evaluate(
 
             if (oskar_element_has_y_spline_data(model, id))
             {
-                oskar_splines_evaluate(model->y_h_re[id], num_points, theta,
-                        phi_y, 8, offset_out_real + 4, output, status);
-                oskar_splines_evaluate(model->y_h_im[id], num_points, theta,
-                        phi_y, 8, offset_out_real + 5, output, status);
-                oskar_splines_evaluate(model->y_v_re[id], num_points, theta,
-                        phi_y, 8, offset_out_real + 6, output, status);
-                oskar_splines_evaluate(model->y_v_im[id], num_points, theta,
-                        phi_y, 8, offset_out_real + 7, output, status);
+                const oskar_Splines* const splines[] = {
+                        model->y_h_re[id], model->y_h_im[id],
+                        model->y_v_re[id], model->y_v_im[id]};
+                const int offsets[] = {
+                        offset_out_real + 4, offset_out_real + 5,
+                        offset_out_real + 6, offset_out_real + 7};
+                oskar_splines_evaluate_multi(4, splines, num_points, theta,
+                        phi_y, 8, offsets, output, status);
                 oskar_convert_ludwig3_to_theta_phi_components(num_points,
                         phi_y, 4, offset_out_cplx + 2, output, status);
             }
@@ -146,24 +215,32 @@ void oskar_element_evaluate(
         const int offset_out_real = offset_out * 2;
         if (oskar_element_has_scalar_spline_data(model, id))
         {
-            oskar_splines_evaluate(model->scalar_re[id], num_points, theta,
-                    phi_x, 2, offset_out_real + 0, output, status);
-            oskar_splines_evaluate(model->scalar_im[id], num_points, theta,
-                    phi_x, 2, offset_out_real + 1, output, status);
+            const oskar_Splines* const splines[] = {
+                    model->scalar_re[id], model->scalar_im[id]};
+            const int offsets[] = {offset_out_real + 0, offset_out_real + 1};
+            oskar_splines_evaluate_multi(2, splines, num_points, theta,
+                    phi_x, 2, offsets, output, status);
         }
         else if (element_type == OSKAR_ELEMENT_TYPE_DIPOLE)
             oskar_evaluate_dipole_pattern(num_points, theta,
                     phi_x, frequency_hz, dipole_length_m,
                     1, offset_out, output, status);
     }
+}
 
-    /* Apply element tapering, if specified. */
-    if (taper_type == OSKAR_ELEMENT_TAPER_COSINE)
-        oskar_apply_element_taper_cosine(num_points,
-                model->cosine_power, theta, offset_out, output, status);
-    else if (taper_type == OSKAR_ELEMENT_TAPER_GAUSSIAN)
-        oskar_apply_element_taper_gaussian(num_points,
-                model->gaussian_fwhm_rad, theta, offset_out, output, status);
+
+/* Returns true if the same kinds of numerical data are loaded at both
+ * frequency indices, so that patterns can be interpolated between them. */
+static int same_data(const oskar_Element* model, int id1, int id2)
+{
+    return oskar_element_has_spherical_wave_data(model, id1) ==
+                    oskar_element_has_spherical_wave_data(model, id2) &&
+            oskar_element_has_x_spline_data(model, id1) ==
+                    oskar_element_has_x_spline_data(model, id2) &&
+            oskar_element_has_y_spline_data(model, id1) ==
+                    oskar_element_has_y_spline_data(model, id2) &&
+            oskar_element_has_scalar_spline_data(model, id1) ==
+                    oskar_element_has_scalar_spline_data(model, id2);
 }
 
 #ifdef __cplusplus
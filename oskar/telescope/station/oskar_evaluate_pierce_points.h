@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2014, The University of Oxford
+ * Copyright (c) 2013-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -89,6 +89,33 @@ void oskar_evaluate_pierce_points(
         const oskar_Mem* hor_z,
         int* status);
 
+/**
+ * @brief Evaluates pierce points for a station (double precision, CPU).
+ *
+ * @details
+ * This is the serial CPU implementation used by
+ * oskar_evaluate_pierce_points(), which takes plain arrays so that it
+ * can be called for each station from within a parallel region.
+ *
+ * @param[in] num_directions    Number of directions.
+ * @param[in] hor_x             Horizontal x direction cosines.
+ * @param[in] hor_y             Horizontal y direction cosines.
+ * @param[in] hor_z             Horizontal z direction cosines.
+ * @param[out] pp_lon_          Pierce point longitudes, in radians.
+ * @param[out] pp_lat_          Pierce point latitudes, in radians.
+ * @param[out] rel_path_len_    Relative path lengths [sec(alpha_prime)].
+ * @param[in] screen_height_m   Height of the screen, in metres.
+ * @param[in] station_ecef_x    Station x (ECEF) coordinate.
+ * @param[in] station_ecef_y    Station y (ECEF) coordinate.
+ * @param[in] station_ecef_z    Station z (ECEF) coordinate.
+ */
+OSKAR_EXPORT
+void oskar_evaluate_pierce_points_d(int num_directions, const double* hor_x,
+        const double* hor_y, const double* hor_z, double* pp_lon_,
+        double* pp_lat_, double* rel_path_len_, double screen_height_m,
+        const double station_ecef_x, const double station_ecef_y,
+        const double station_ecef_z);
+
 #ifdef __cplusplus
 }
 #endif
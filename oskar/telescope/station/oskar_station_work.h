@@ -35,6 +35,7 @@
 
 #include <oskar_global.h>
 #include <mem/oskar_mem.h>
+#include <telescope/station/element/oskar_element.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -75,6 +76,64 @@ oskar_StationWork* oskar_station_work_create(int type, int location,
 OSKAR_EXPORT
 void oskar_station_work_free(oskar_StationWork* work, int* status);
 
+/**
+ * @brief Evaluates an element pattern, reusing cached values if possible.
+ *
+ * @details
+ * This function evaluates an element pattern using oskar_element_evaluate(),
+ * using the work arrays held in the station work buffer.
+ *
+ * If the element cache is enabled and the data are in CPU memory,
+ * patterns are kept for each element ID, orientation and frequency.
+ * The cache holds one set of directions: cached values are reused only
+ * for directions which are identical to those used previously, so results
+ * are the same as those from oskar_element_evaluate().
+ * If the directions change (other than the last one, which may be a
+ * moving normalisation direction), the cache is cleared, and it is not
+ * used again until the same directions are seen twice in a row.
+ * This is only worthwhile when the same directions are used repeatedly,
+ * for example in horizon coordinates when making beam patterns.
+ *
+ * @param[in,out] work        Station work buffer.
+ * @param[in] element         Element model.
+ * @param[in] element_id      Identifier of the element model, unique
+ *                            within the telescope (used as the cache key).
+ * @param[in] orientation_x   Azimuth of X dipole in radians.
+ * @param[in] orientation_y   Azimuth of Y dipole in radians.
+ * @param[in] offset_points   Start offset of input points.
+ * @param[in] num_points      Number of points at which to evaluate.
+ * @param[in] x               Array of horizontal x direction cosines.
+ * @param[in] y               Array of horizontal y direction cosines.
+ * @param[in] z               Array of horizontal z direction cosines.
+ * @param[in] frequency_hz    The observing frequency in Hz.
+ * @param[in] offset_out      Start offset of output array.
+ * @param[out] output         Output element pattern.
+ * @param[in,out] status      Status return code.
+ */
+OSKAR_EXPORT
+void oskar_station_work_evaluate_element(oskar_StationWork* work,
+        const oskar_Element* element, int element_id, double orientation_x,
+        double orientation_y, int offset_points, int num_points,
+        const oskar_Mem* x, const oskar_Mem* y, const oskar_Mem* z,
+        double frequency_hz, int offset_out, oskar_Mem* output, int* status);
+
+/**
+ * @brief Sets whether element patterns are cached in the work buffer.
+ *
+ * @details
+ * Sets whether element patterns evaluated using
+ * oskar_station_work_evaluate_element() should be cached.
+ *
+ * Cache entries are identified by the element IDs used to create them,
+ * so the element models must not change while the cache is enabled.
+ * Disabling the cache clears it.
+ *
+ * @param[in,out] work   Station work buffer.
+ * @param[in] value      If true, enable the element pattern cache.
+ */
+OSKAR_EXPORT
+void oskar_station_work_set_element_cache(oskar_StationWork* work, int value);
+
 /* Accessors. */
 
 OSKAR_EXPORT
@@ -96,6 +155,10 @@ OSKAR_EXPORT
 oskar_Mem* oskar_station_work_beam_out(oskar_StationWork* work,
         const oskar_Mem* output_beam, size_t length, int* status);
 
+OSKAR_EXPORT
+oskar_Mem* oskar_station_work_element_temp(oskar_StationWork* work,
+        const oskar_Mem* output, int* status);
+
 OSKAR_EXPORT
 oskar_Mem* oskar_station_work_beam(oskar_StationWork* work,
         const oskar_Mem* output_beam, size_t length, int depth, int* status);
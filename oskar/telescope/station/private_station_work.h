@@ -30,6 +30,21 @@
 #define OSKAR_PRIVATE_STATION_WORK_H_
 
 #include <mem/oskar_mem.h>
+#include <telescope/station/element/oskar_element.h>
+
+#define OSKAR_STATION_WORK_MAX_ELEMENT_CACHE 32
+
+/* Element pattern evaluated at the cached ENU directions. */
+struct oskar_StationWorkElementCache
+{
+    int element_id;
+    double orientation_x;
+    double orientation_y;
+    double frequency_hz;
+    int num_valid;               /* Number of leading values that are valid. */
+    oskar_Mem* pattern;          /* Complex scalar or matrix. */
+};
+typedef struct oskar_StationWorkElementCache oskar_StationWorkElementCache;
 
 struct oskar_StationWork
 {
@@ -50,6 +65,18 @@ struct oskar_StationWork
 
     int num_depths;
     oskar_Mem** beam;            /* For hierarchical stations. */
+
+    oskar_Mem* element_temp;     /* For element frequency interpolation. */
+
+    int element_cache_enabled;
+    int element_cache_active;    /* Set if the directions were repeated. */
+    int element_cache_num_points;
+    oskar_Mem* element_cache_x;  /* Real scalar. Copy of ENU directions. */
+    oskar_Mem* element_cache_y;  /* Real scalar. Copy of ENU directions. */
+    oskar_Mem* element_cache_z;  /* Real scalar. Copy of ENU directions. */
+    int num_element_cache;
+    oskar_StationWorkElementCache element_cache[
+            OSKAR_STATION_WORK_MAX_ELEMENT_CACHE];
 };
 
 #ifndef OSKAR_STATION_WORK_TYPEDEF_
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2015, The University of Oxford
+ * Copyright (c) 2013-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -33,12 +33,6 @@
 extern "C" {
 #endif
 
-void oskar_evaluate_pierce_points_d(int num_directions, const double* hor_x,
-        const double* hor_y, const double* hor_z, double* pp_lon_,
-        double* pp_lat_, double* rel_path_len_, double screen_height_m,
-        const double station_ecef_x, const double station_ecef_y,
-        const double station_ecef_z);
-
 void oskar_evaluate_pierce_points(
         oskar_Mem* pierce_point_lon,
         oskar_Mem* pierce_point_lat,
@@ -98,7 +98,10 @@ void oskar_evaluate_station_beam(int num_points,
                 status);
     }
 
-    /* Evaluate the station beam for the given directions. */
+    /* Evaluate the station beam for the given directions.
+     * Element patterns can only be reused if the directions are fixed. */
+    oskar_station_work_set_element_cache(work,
+            coord_type == OSKAR_ENU_DIRECTIONS);
     if (coord_type == OSKAR_ENU_DIRECTIONS)
         evaluate_station_beam_enu_directions(out, num_points, x, y, z,
                 station, work, time_index, frequency_hz, GAST, status);
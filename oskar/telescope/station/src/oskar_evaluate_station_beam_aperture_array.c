@@ -32,6 +32,7 @@
 #include "telescope/station/oskar_evaluate_element_weights.h"
 #include "telescope/station/element/oskar_element_evaluate.h"
 #include "telescope/station/oskar_blank_below_horizon.h"
+#include "telescope/station/oskar_station_work.h"
 #include "telescope/station/private_station_work.h"
 
 #include "math/oskar_cmath.h"
@@ -116,11 +117,12 @@ static void oskar_evaluate_station_beam_aperture_array_private(
                 (oskar_station_common_element_orientation(s) ||
                         oskar_element_is_isotropic(element0)) )
         {
-            oskar_element_evaluate(element0,
+            oskar_station_work_evaluate_element(work, element0,
+                    oskar_station_unique_id(s),
                     oskar_station_element_x_alpha_rad(s, 0) + M_PI/2.0, /* FIXME Will change: This matches the old convention. */
                     oskar_station_element_y_alpha_rad(s, 0),
                     offset_points, num_points, x, y, z, frequency_hz,
-                    theta, phi_x, phi_y, offset_out, beam, status);
+                    offset_out, beam, status);
             if (oskar_station_enable_array_pattern(s))
             {
                 oskar_evaluate_element_weights(weights, weights_error,
@@ -160,7 +162,9 @@ static void oskar_evaluate_station_beam_aperture_array_private(
                         oskar_station_element_x_alpha_rad(s, i) + M_PI/2.0, /* FIXME Will change: This matches the old convention. */
                         oskar_station_element_y_alpha_rad(s, i),
                         offset_points, num_points, x, y, z, frequency_hz,
-                        theta, phi_x, phi_y, i * num_points, signal, status);
+                        theta, phi_x, phi_y,
+                        oskar_station_work_element_temp(work, signal, status),
+                        i * num_points, signal, status);
             }
             oskar_evaluate_element_weights(weights, weights_error,
                     wavenumber, s, beam_x, beam_y, beam_z,
@@ -182,34 +186,46 @@ static void oskar_evaluate_station_beam_aperture_array_private(
             *status = OSKAR_ERR_SETTINGS_TELESCOPE;
             return;
         }
-        signal = oskar_station_work_beam(work, beam,
-                num_elements * num_points, depth, status);
         if (oskar_station_identical_children(s))
         {
+            /* All children share the same beam, so it can be factored out
+             * of the sum: evaluate it once directly into the output and
+             * multiply by the array factor, as for separable elements. */
             oskar_evaluate_station_beam_aperture_array_private(
                     oskar_station_child_const(s, 0), work, offset_points,
                     num_points, x, y, z, time_index, gast, frequency_hz,
-                    depth + 1, 0, signal, status);
-            for (i = 1; i < num_elements; ++i)
-                oskar_mem_copy_contents(signal, signal, i * num_points, 0,
-                        num_points, status);
+                    depth + 1, offset_out, beam, status);
+            oskar_evaluate_element_weights(weights, weights_error,
+                    wavenumber, s, beam_x, beam_y, beam_z,
+                    time_index, status);
+            oskar_dftw(normalise, num_elements, wavenumber, weights,
+                    oskar_station_element_true_x_enu_metres_const(s),
+                    oskar_station_element_true_y_enu_metres_const(s),
+                    oskar_station_element_true_z_enu_metres_const(s),
+                    offset_points, num_points, x, y, (is_3d ? z : 0), 0,
+                    0, array, status);
+            oskar_mem_multiply(beam, beam, array,
+                    offset_out, offset_out, 0, num_points, status);
         }
         else
         {
+            signal = oskar_station_work_beam(work, beam,
+                    num_elements * num_points, depth, status);
             for (i = 0; i < num_elements; ++i)
                 oskar_evaluate_station_beam_aperture_array_private(
                         oskar_station_child_const(s, i), work, offset_points,
                         num_points, x, y, z, time_index, gast, frequency_hz,
                         depth + 1, i * num_points, signal, status);
+            oskar_evaluate_element_weights(weights, weights_error,
+                    wavenumber, s, beam_x, beam_y, beam_z,
+                    time_index, status);
+            oskar_dftw(normalise, num_elements, wavenumber, weights,
+                    oskar_station_element_true_x_enu_metres_const(s),
+                    oskar_station_element_true_y_enu_metres_const(s),
+                    oskar_station_element_true_z_enu_metres_const(s),
+                    offset_points, num_points, x, y, (is_3d ? z : 0), signal,
+                    offset_out, beam, status);
         }
-        oskar_evaluate_element_weights(weights, weights_error, wavenumber,
-                s, beam_x, beam_y, beam_z, time_index, status);
-        oskar_dftw(normalise, num_elements, wavenumber, weights,
-                oskar_station_element_true_x_enu_metres_const(s),
-                oskar_station_element_true_y_enu_metres_const(s),
-                oskar_station_element_true_z_enu_metres_const(s),
-                offset_points, num_points, x, y, (is_3d ? z : 0), signal,
-                offset_out, beam, status);
     }
 }
 
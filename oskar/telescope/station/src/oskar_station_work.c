@@ -87,16 +87,41 @@ void oskar_station_work_free(oskar_StationWork* work, int* status)
     oskar_mem_free(work->weights_error, status);
     oskar_mem_free(work->array_pattern, status);
     oskar_mem_free(work->beam_out_scratch, status);
+    oskar_mem_free(work->element_temp, status);
 
     for (i = 0; i < work->num_depths; ++i)
     {
         oskar_mem_free(work->beam[i], status);
     }
+    oskar_station_work_set_element_cache(work, 0);
 
     /* Free the structure. */
     free(work);
 }
 
+void oskar_station_work_set_element_cache(oskar_StationWork* work, int value)
+{
+    int i, status = 0;
+    work->element_cache_enabled = value;
+    if (value) return;
+
+    /* Clear the cache. */
+    for (i = 0; i < OSKAR_STATION_WORK_MAX_ELEMENT_CACHE; ++i)
+    {
+        oskar_mem_free(work->element_cache[i].pattern, &status);
+        work->element_cache[i].pattern = 0;
+    }
+    oskar_mem_free(work->element_cache_x, &status);
+    oskar_mem_free(work->element_cache_y, &status);
+    oskar_mem_free(work->element_cache_z, &status);
+    work->element_cache_x = 0;
+    work->element_cache_y = 0;
+    work->element_cache_z = 0;
+    work->element_cache_active = 0;
+    work->element_cache_num_points = 0;
+    work->num_element_cache = 0;
+}
+
 oskar_Mem* oskar_station_work_horizon_mask(oskar_StationWork* work)
 {
     return work->horizon_mask;
@@ -130,6 +155,13 @@ oskar_Mem* oskar_station_work_beam_out(oskar_StationWork* work,
     return work->beam_out_scratch;
 }
 
+oskar_Mem* oskar_station_work_element_temp(oskar_StationWork* work,
+        const oskar_Mem* output, int* status)
+{
+    get_mem_from_template(&work->element_temp, output, 0, status);
+    return work->element_temp;
+}
+
 oskar_Mem* oskar_station_work_beam(oskar_StationWork* work,
         const oskar_Mem* output_beam, size_t length, int depth, int* status)
 {
@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "telescope/station/oskar_station_work.h"
+#include "telescope/station/private_station_work.h"
+#include "telescope/station/element/oskar_element.h"
+#include "telescope/station/element/oskar_element_evaluate.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static int num_same(const oskar_Mem* a, int offset_a, const oskar_Mem* b,
+        int num_points, int* status);
+static void update_directions(oskar_StationWork* work, int offset_points,
+        int num_points, const oskar_Mem* x, const oskar_Mem* y,
+        const oskar_Mem* z, int* status);
+
+void oskar_station_work_evaluate_element(oskar_StationWork* work,
+        const oskar_Element* element, int element_id, double orientation_x,
+        double orientation_y, int offset_points, int num_points,
+        const oskar_Mem* x, const oskar_Mem* y, const oskar_Mem* z,
+        double frequency_hz, int offset_out, oskar_Mem* output, int* status)
+{
+    oskar_StationWorkElementCache* entry = 0;
+    int i, num_cached = 0;
+    if (*status) return;
+
+    /* Find or create the cache entry for this element and frequency. */
+    if (work->element_cache_enabled &&
+            oskar_mem_location(output) == OSKAR_CPU &&
+            oskar_mem_location(x) == OSKAR_CPU)
+    {
+        update_directions(work, offset_points, num_points, x, y, z, status);
+        for (i = 0; work->element_cache_active &&
+                i < work->num_element_cache; ++i)
+        {
+            oskar_StationWorkElementCache* t = &work->element_cache[i];
+            if (t->element_id == element_id &&
+                    t->frequency_hz == frequency_hz &&
+                    t->orientation_x == orientation_x &&
+                    t->orientation_y == orientation_y &&
+                    oskar_mem_type(t->pattern) == oskar_mem_type(output))
+            {
+                entry = t;
+                break;
+            }
+        }
+        if (!entry && work->element_cache_active &&
+                work->num_element_cache < OSKAR_STATION_WORK_MAX_ELEMENT_CACHE)
+        {
+            entry = &work->element_cache[work->num_element_cache++];
+            entry->element_id = element_id;
+            entry->orientation_x = orientation_x;
+            entry->orientation_y = orientation_y;
+            entry->frequency_hz = frequency_hz;
+            entry->num_valid = 0;
+            if (entry->pattern &&
+                    oskar_mem_type(entry->pattern) != oskar_mem_type(output))
+            {
+                oskar_mem_free(entry->pattern, status);
+                entry->pattern = 0;
+            }
+            if (!entry->pattern)
+                entry->pattern = oskar_mem_create(oskar_mem_type(output),
+                        OSKAR_CPU, num_points, status);
+            oskar_mem_ensure(entry->pattern, num_points, status);
+        }
+        if (entry) num_cached = entry->num_valid;
+    }
+
+    /* Copy the cached part of the pattern. */
+    if (num_cached > 0)
+        oskar_mem_copy_contents(output, entry->pattern,
+                offset_out, 0, num_cached, status);
+
+    /* Evaluate the rest of the pattern. */
+    if (num_cached < num_points)
+    {
+        const int n = num_points - num_cached;
+        oskar_element_evaluate(element, orientation_x, orientation_y,
+                offset_points + num_cached, n, x, y, z, frequency_hz,
+                work->theta_modified, work->phi_x, work->phi_y,
+                oskar_station_work_element_temp(work, output, status),
+                offset_out + num_cached, output, status);
+        if (entry && !*status)
+        {
+            oskar_mem_copy_contents(entry->pattern, output, num_cached,
+                    offset_out + num_cached, n, status);
+            entry->num_valid = num_points;
+        }
+    }
+}
+
+/* Compares the directions with those seen previously, and sets whether the
+ * cache can be used. Only the last direction is allowed to change while
+ * keeping the cache active, as this is used for beam normalisation. */
+static void update_directions(oskar_StationWork* work, int offset_points,
+        int num_points, const oskar_Mem* x, const oskar_Mem* y,
+        const oskar_Mem* z, int* status)
+{
+    int i, n = 0;
+    if (*status) return;
+    if (work->element_cache_x &&
+            work->element_cache_num_points == num_points &&
+            oskar_mem_type(work->element_cache_x) == oskar_mem_type(x))
+    {
+        n = num_same(x, offset_points, work->element_cache_x,
+                num_points, status);
+        if (n > 0)
+            n = num_same(y, offset_points, work->element_cache_y, n, status);
+        if (n > 0)
+            n = num_same(z, offset_points, work->element_cache_z, n, status);
+    }
+    if (n == num_points)
+    {
+        /* Same directions as last time. */
+        work->element_cache_active = 1;
+        return;
+    }
+    if (num_points > 1 && n == num_points - 1)
+    {
+        /* Only the last direction changed: invalidate it in every entry. */
+        for (i = 0; i < work->num_element_cache; ++i)
+            if (work->element_cache[i].num_valid > n)
+                work->element_cache[i].num_valid = n;
+        work->element_cache_active = 1;
+    }
+    else
+    {
+        /* Directions changed: clear the cache, keeping the buffers. */
+        for (i = 0; i < work->num_element_cache; ++i)
+            work->element_cache[i].num_valid = 0;
+        work->num_element_cache = 0;
+        work->element_cache_active = 0;
+        work->element_cache_num_points = num_points;
+        n = 0;
+        if (!work->element_cache_x ||
+                oskar_mem_type(work->element_cache_x) != oskar_mem_type(x))
+        {
+            const int type = oskar_mem_type(x);
+            oskar_mem_free(work->element_cache_x, status);
+            oskar_mem_free(work->element_cache_y, status);
+            oskar_mem_free(work->element_cache_z, status);
+            work->element_cache_x = oskar_mem_create(type, OSKAR_CPU, 0,
+                    status);
+            work->element_cache_y = oskar_mem_create(type, OSKAR_CPU, 0,
+                    status);
+            work->element_cache_z = oskar_mem_create(type, OSKAR_CPU, 0,
+                    status);
+        }
+        oskar_mem_ensure(work->element_cache_x, num_points, status);
+        oskar_mem_ensure(work->element_cache_y, num_points, status);
+        oskar_mem_ensure(work->element_cache_z, num_points, status);
+    }
+    oskar_mem_copy_contents(work->element_cache_x, x, n,
+            offset_points + n, num_points - n, status);
+    oskar_mem_copy_contents(work->element_cache_y, y, n,
+            offset_points + n, num_points - n, status);
+    oskar_mem_copy_contents(work->element_cache_z, z, n,
+            offset_points + n, num_points - n, status);
+}
+
+/* Returns the number of leading values in a which are identical to those
+ * in b. */
+static int num_same(const oskar_Mem* a, int offset_a, const oskar_Mem* b,
+        int num_points, int* status)
+{
+    int i = 0;
+    if (oskar_mem_precision(a) == OSKAR_DOUBLE)
+    {
+        const double *a_ = oskar_mem_double_const(a, status) + offset_a;
+        const double *b_ = oskar_mem_double_const(b, status);
+        while (i < num_points && a_[i] == b_[i]) ++i;
+    }
+    else
+    {
+        const float *a_ = oskar_mem_float_const(a, status) + offset_a;
+        const float *b_ = oskar_mem_float_const(b, status);
+        while (i < num_points && a_[i] == b_[i]) ++i;
+    }
+    return i;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <gtest/gtest.h>
+
+#include "telescope/station/element/oskar_element.h"
+#include "telescope/station/element/oskar_element_evaluate.h"
+#include "telescope/station/oskar_station_work.h"
+#include "utility/oskar_get_error_string.h"
+
+#include "math/oskar_cmath.h"
+#include <cstdio>
+#include <cstdlib>
+
+static void write_coeffs(const char* filename, double value)
+{
+    FILE* file = fopen(filename, "w");
+    fprintf(file, "%.3f %.3f %.3f\n", value, 0.5 * value, -0.25 * value);
+    fclose(file);
+}
+
+static void load_coeffs(oskar_Element* element, double freq_hz,
+        double scale, int* num_tmp, double** tmp, int* status)
+{
+    const char* names[] = {
+            "temp_sw_TE_RE.txt", "temp_sw_TE_IM.txt",
+            "temp_sw_TM_RE.txt", "temp_sw_TM_IM.txt"
+    };
+    for (int i = 0; i < 4; ++i)
+    {
+        write_coeffs(names[i], scale * (i + 1));
+        oskar_element_load_spherical_wave_coeff(element, names[i], freq_hz,
+                num_tmp, tmp, status);
+        remove(names[i]);
+    }
+}
+
+static oskar_Mem* evaluate(const oskar_Element* element, int num_points,
+        const oskar_Mem* x, const oskar_Mem* y, const oskar_Mem* z,
+        double freq_hz, int* status)
+{
+    oskar_Mem *theta, *phi_x, *phi_y, *temp, *out;
+    theta = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, status);
+    phi_x = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, status);
+    phi_y = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, status);
+    temp = oskar_mem_create(OSKAR_DOUBLE_COMPLEX_MATRIX, OSKAR_CPU, 0, status);
+    out = oskar_mem_create(OSKAR_DOUBLE_COMPLEX_MATRIX, OSKAR_CPU,
+            num_points, status);
+    oskar_element_evaluate(element, M_PI / 2.0, 0.0, 0, num_points, x, y, z,
+            freq_hz, theta, phi_x, phi_y, temp, 0, out, status);
+    oskar_mem_free(theta, status);
+    oskar_mem_free(phi_x, status);
+    oskar_mem_free(phi_y, status);
+    oskar_mem_free(temp, status);
+    return out;
+}
+
+TEST(element_evaluate, interpolate_freq)
+{
+    int status = 0, num_tmp = 0, num_points = 20;
+    double* tmp = 0;
+
+    // Load different spherical wave coefficients at two frequencies.
+    oskar_Element* element = oskar_element_create(OSKAR_DOUBLE,
+            OSKAR_CPU, &status);
+    load_coeffs(element, 100e6, 1.0, &num_tmp, &tmp, &status);
+    load_coeffs(element, 200e6, -3.0, &num_tmp, &tmp, &status);
+    free(tmp);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Generate some directions above the horizon.
+    oskar_Mem *x, *y, *z;
+    x = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &status);
+    y = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &status);
+    z = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &status);
+    double *x_ = oskar_mem_double(x, &status);
+    double *y_ = oskar_mem_double(y, &status);
+    double *z_ = oskar_mem_double(z, &status);
+    for (int i = 0; i < num_points; ++i)
+    {
+        const double theta = 0.07 * (i + 1), phi = 0.9 * i;
+        x_[i] = sin(theta) * cos(phi);
+        y_[i] = sin(theta) * sin(phi);
+        z_[i] = cos(theta);
+    }
+
+    // Evaluate the patterns at the loaded frequencies.
+    oskar_element_set_interpolate_freq(element, 1);
+    oskar_Mem* p100 = evaluate(element, num_points, x, y, z, 100e6, &status);
+    oskar_Mem* p200 = evaluate(element, num_points, x, y, z, 200e6, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Check interpolated pattern is the weighted sum of the two.
+    oskar_Mem* p130 = evaluate(element, num_points, x, y, z, 130e6, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    const double* a = oskar_mem_double_const(p100, &status);
+    const double* b = oskar_mem_double_const(p200, &status);
+    const double* c = oskar_mem_double_const(p130, &status);
+    int num_different = 0;
+    for (int i = 0; i < 8 * num_points; ++i)
+    {
+        EXPECT_NEAR(0.7 * a[i] + 0.3 * b[i], c[i], 1e-12);
+        if (fabs(a[i] - b[i]) > 1e-6) num_different++;
+    }
+    EXPECT_GT(num_different, 0);
+
+    // Check the closest frequency is used if not interpolating.
+    oskar_element_set_interpolate_freq(element, 0);
+    oskar_Mem* p130_closest = evaluate(element, num_points, x, y, z,
+            130e6, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    const double* d = oskar_mem_double_const(p130_closest, &status);
+    for (int i = 0; i < 8 * num_points; ++i)
+        EXPECT_DOUBLE_EQ(a[i], d[i]);
+
+    // Check the station work buffer gives the same result, with and
+    // without the element cache.
+    oskar_element_set_interpolate_freq(element, 1);
+    oskar_StationWork* work = oskar_station_work_create(OSKAR_DOUBLE,
+            OSKAR_CPU, &status);
+    oskar_Mem* out = oskar_mem_create(OSKAR_DOUBLE_COMPLEX_MATRIX, OSKAR_CPU,
+            num_points, &status);
+    oskar_station_work_set_element_cache(work, 1);
+    for (int pass = 0; pass < 3; ++pass)
+    {
+        oskar_mem_clear_contents(out, &status);
+        oskar_station_work_evaluate_element(work, element, 0, M_PI / 2.0,
+                0.0, 0, num_points, x, y, z, 130e6, 0, out, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        const double* e = oskar_mem_double_const(out, &status);
+        for (int i = 0; i < 8 * num_points; ++i)
+            EXPECT_DOUBLE_EQ(c[i], e[i]);
+    }
+    oskar_station_work_free(work, &status);
+
+    // Clean up.
+    oskar_mem_free(x, &status);
+    oskar_mem_free(y, &status);
+    oskar_mem_free(z, &status);
+    oskar_mem_free(p100, &status);
+    oskar_mem_free(p200, &status);
+    oskar_mem_free(p130, &status);
+    oskar_mem_free(p130_closest, &status);
+    oskar_mem_free(out, &status);
+    oskar_element_free(element, &status);
+}
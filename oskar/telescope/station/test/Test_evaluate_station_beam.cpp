@@ -29,9 +29,11 @@
 #include <gtest/gtest.h>
 
 #include "telescope/station/oskar_station.h"
+#include "telescope/station/oskar_evaluate_station_beam.h"
 #include "telescope/station/oskar_evaluate_station_beam_aperture_array.h"
 #include "telescope/station/oskar_evaluate_station_beam_gaussian.h"
 #include "telescope/station/oskar_evaluate_beam_horizon_direction.h"
+#include "sky/oskar_sky.h"
 #include "utility/oskar_get_error_string.h"
 #include "math/oskar_linspace.h"
 #include "math/oskar_meshgrid.h"
@@ -158,6 +160,179 @@ TEST(evaluate_station_beam, test_array_pattern)
 }
 
 
+static void set_up_station(oskar_Station* s, int dim, double spacing_m,
+        int* status)
+{
+    oskar_station_resize(s, dim * dim, status);
+    oskar_station_resize_element_types(s, 1, status);
+    oskar_station_set_position(s, 0.0, M_PI / 2.0, 0.0);
+    oskar_station_set_phase_centre(s,
+            OSKAR_SPHERICAL_TYPE_EQUATORIAL, 0.0, M_PI / 2.0);
+    oskar_element_set_element_type(oskar_station_element(s, 0),
+            "Isotropic", status);
+    for (int i = 0; i < dim * dim; ++i)
+    {
+        double xyz[] = {(i % dim) * spacing_m, (i / dim) * spacing_m, 0.0};
+        oskar_station_set_element_coords(s, i, xyz, xyz, status);
+    }
+}
+
+TEST(evaluate_station_beam, identical_children)
+{
+    int status = 0, finished = 0;
+    int tile_dim = 4, station_dim = 4, num_tile_elements = tile_dim * tile_dim;
+    double element_spacing = 1.25, tile_spacing = tile_dim * element_spacing;
+    double frequency = 100e6;
+
+    // Construct a two-level station with identical tiles.
+    oskar_Station* tiled = oskar_station_create(OSKAR_DOUBLE, OSKAR_CPU,
+            0, &status);
+    set_up_station(tiled, station_dim, tile_spacing, &status);
+    oskar_station_create_child_stations(tiled, &status);
+    for (int i = 0; i < station_dim * station_dim; ++i)
+        set_up_station(oskar_station_child(tiled, i), tile_dim,
+                element_spacing, &status);
+    oskar_station_analyse(tiled, &finished, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    ASSERT_EQ(1, oskar_station_identical_children(tiled));
+
+    // Construct the equivalent flat station.
+    int num_elements = station_dim * station_dim * num_tile_elements;
+    oskar_Station* flat = oskar_station_create(OSKAR_DOUBLE, OSKAR_CPU,
+            0, &status);
+    set_up_station(flat, 1, 0.0, &status);
+    oskar_station_resize(flat, num_elements, &status);
+    for (int i = 0; i < num_elements; ++i)
+    {
+        int t = i / num_tile_elements, e = i % num_tile_elements;
+        double xyz[] = {
+                (t % station_dim) * tile_spacing + (e % tile_dim) * element_spacing,
+                (t / station_dim) * tile_spacing + (e / tile_dim) * element_spacing,
+                0.0};
+        oskar_station_set_element_coords(flat, i, xyz, xyz, &status);
+    }
+    oskar_station_analyse(flat, &finished, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Generate horizontal lm coordinates.
+    int size = 64, num_points = size * size;
+    oskar_Mem *l, *m, *n, *beam_tiled, *beam_flat;
+    l = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &status);
+    m = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &status);
+    n = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points, &status);
+    double* lm = (double*)malloc(size * sizeof(double));
+    oskar_linspace_d(lm, -0.7, 0.7, size);
+    oskar_meshgrid_d(oskar_mem_double(l, &status),
+            oskar_mem_double(m, &status), lm, size, lm, size);
+    free(lm);
+    double *l_ = oskar_mem_double(l, &status);
+    double *m_ = oskar_mem_double(m, &status);
+    double *n_ = oskar_mem_double(n, &status);
+    for (int i = 0; i < num_points; ++i)
+        n_[i] = sqrt(1.0 - l_[i] * l_[i] - m_[i] * m_[i]);
+
+    // Evaluate both beams and compare.
+    oskar_StationWork* work = oskar_station_work_create(OSKAR_DOUBLE,
+            OSKAR_CPU, &status);
+    beam_tiled = oskar_mem_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+            num_points, &status);
+    beam_flat = oskar_mem_create(OSKAR_DOUBLE_COMPLEX, OSKAR_CPU,
+            num_points, &status);
+    oskar_evaluate_station_beam_aperture_array(beam_tiled, tiled,
+            num_points, l, m, n, 0.0, frequency, work, 0, &status);
+    oskar_evaluate_station_beam_aperture_array(beam_flat, flat,
+            num_points, l, m, n, 0.0, frequency, work, 0, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    const double2* a = oskar_mem_double2_const(beam_tiled, &status);
+    const double2* b = oskar_mem_double2_const(beam_flat, &status);
+    for (int i = 0; i < num_points; ++i)
+    {
+        EXPECT_NEAR(b[i].x, a[i].x, 1e-9 * num_elements);
+        EXPECT_NEAR(b[i].y, a[i].y, 1e-9 * num_elements);
+    }
+
+    // Clean up.
+    oskar_station_work_free(work, &status);
+    oskar_station_free(tiled, &status);
+    oskar_station_free(flat, &status);
+    oskar_mem_free(l, &status);
+    oskar_mem_free(m, &status);
+    oskar_mem_free(n, &status);
+    oskar_mem_free(beam_tiled, &status);
+    oskar_mem_free(beam_flat, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
+
+TEST(evaluate_station_beam, element_cache)
+{
+    int status = 0, finished = 0, dim = 8;
+    double frequency = 100e6;
+
+    // Construct a station of dipoles.
+    oskar_Station* s = oskar_station_create(OSKAR_DOUBLE, OSKAR_CPU,
+            0, &status);
+    set_up_station(s, dim, 1.5, &status);
+    oskar_element_set_element_type(oskar_station_element(s, 0),
+            "Dipole", &status);
+    oskar_station_set_normalise_final_beam(s, 1);
+    oskar_station_analyse(s, &finished, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Generate horizontal coordinates, with space for the beam direction.
+    int size = 32, num_points = size * size;
+    oskar_Mem *x, *y, *z, *beam_cached, *beam_direct;
+    x = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points + 1, &status);
+    y = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points + 1, &status);
+    z = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_points + 1, &status);
+    double* lm = (double*)malloc(size * sizeof(double));
+    oskar_linspace_d(lm, -0.7, 0.7, size);
+    oskar_meshgrid_d(oskar_mem_double(x, &status),
+            oskar_mem_double(y, &status), lm, size, lm, size);
+    free(lm);
+    double *x_ = oskar_mem_double(x, &status);
+    double *y_ = oskar_mem_double(y, &status);
+    double *z_ = oskar_mem_double(z, &status);
+    for (int i = 0; i < num_points; ++i)
+        z_[i] = sqrt(1.0 - x_[i] * x_[i] - y_[i] * y_[i]);
+
+    // Evaluate beams at several times, reusing a work buffer for one set.
+    // The cached element patterns must give identical results.
+    oskar_StationWork* work = oskar_station_work_create(OSKAR_DOUBLE,
+            OSKAR_CPU, &status);
+    beam_cached = oskar_mem_create(OSKAR_DOUBLE_COMPLEX_MATRIX, OSKAR_CPU,
+            num_points, &status);
+    beam_direct = oskar_mem_create(OSKAR_DOUBLE_COMPLEX_MATRIX, OSKAR_CPU,
+            num_points, &status);
+    for (int t = 0; t < 3; ++t)
+    {
+        double gast = 0.1 * t;
+        oskar_StationWork* work_direct = oskar_station_work_create(
+                OSKAR_DOUBLE, OSKAR_CPU, &status);
+        oskar_evaluate_station_beam(num_points, OSKAR_ENU_DIRECTIONS,
+                x, y, z, 0.1, 1.4, s, work, 0, frequency, gast,
+                0, beam_cached, &status);
+        oskar_evaluate_station_beam(num_points, OSKAR_ENU_DIRECTIONS,
+                x, y, z, 0.1, 1.4, s, work_direct, 0, frequency, gast,
+                0, beam_direct, &status);
+        oskar_station_work_free(work_direct, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        const double* a = oskar_mem_double_const(beam_cached, &status);
+        const double* b = oskar_mem_double_const(beam_direct, &status);
+        for (int i = 0; i < 8 * num_points; ++i)
+            ASSERT_EQ(b[i], a[i]);
+    }
+
+    // Clean up.
+    oskar_station_work_free(work, &status);
+    oskar_station_free(s, &status);
+    oskar_mem_free(x, &status);
+    oskar_mem_free(y, &status);
+    oskar_mem_free(z, &status);
+    oskar_mem_free(beam_cached, &status);
+    oskar_mem_free(beam_direct, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
+
 TEST(evaluate_station_beam, gaussian)
 {
     int error = 0;
@@ -315,3 +490,84 @@ TEST(evaluate_station_beam, gaussian)
         oskar_mem_free(beam, &error);
     }
 }
+
+TEST(evaluate_station_beam, normalised_sky_alias)
+{
+    int status = 0, finished = 0, num_sources = 100, num_channels = 3;
+    double frequency = 100e6;
+
+    // Construct a normalised station of dipoles.
+    oskar_Station* s = oskar_station_create(OSKAR_DOUBLE, OSKAR_CPU,
+            0, &status);
+    set_up_station(s, 8, 1.5, &status);
+    oskar_element_set_element_type(oskar_station_element(s, 0),
+            "Dipole", &status);
+    oskar_station_set_normalise_final_beam(s, 1);
+    oskar_station_analyse(s, &finished, &status);
+
+    // Create a sky model around the phase centre, and evaluate its fluxes.
+    oskar_Sky* sky = oskar_sky_create(OSKAR_DOUBLE, OSKAR_CPU,
+            num_sources, &status);
+    for (int i = 0; i < num_sources; ++i)
+        oskar_sky_set_source(sky, i, 0.05 * i, M_PI / 2.0 - 0.005 * i,
+                1.0 + i, 0.0, 0.0, 0.0, 100e6, -0.7, 0.0,
+                0.0, 0.0, 0.0, &status);
+    oskar_sky_evaluate_relative_directions(sky, 0.0, M_PI / 2.0, &status);
+    oskar_Mem* flux[4];
+    for (int k = 0; k < 4; ++k)
+        flux[k] = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, 0, &status);
+    oskar_sky_evaluate_flux(sky, num_channels, frequency, 10e6,
+            flux[0], flux[1], flux[2], flux[3], &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+
+    // Present each channel in turn using the same alias.
+    oskar_Sky* alias = oskar_sky_create_flux_alias(sky,
+            flux[0], flux[1], flux[2], flux[3], 0, &status);
+    for (int c = 0; c < num_channels; ++c)
+    {
+        oskar_sky_set_flux_alias(alias, flux[0], flux[1], flux[2], flux[3],
+                (size_t) c * num_sources, &status);
+        ASSERT_EQ(0, status) << oskar_get_error_string(status);
+        ASSERT_EQ(num_sources, oskar_sky_num_sources(alias));
+        EXPECT_EQ(oskar_mem_double_const(flux[0], &status) + c * num_sources,
+                oskar_mem_double_const(oskar_sky_I_const(alias), &status));
+    }
+
+    // The alias must keep the spare element used for normalisation.
+    ASSERT_LT((size_t) num_sources, oskar_mem_length(oskar_sky_l(alias)));
+
+    // Evaluate the normalised beam using the sky model and its alias.
+    oskar_StationWork* work = oskar_station_work_create(OSKAR_DOUBLE,
+            OSKAR_CPU, &status);
+    oskar_Mem *beam_sky, *beam_alias;
+    beam_sky = oskar_mem_create(OSKAR_DOUBLE_COMPLEX_MATRIX, OSKAR_CPU,
+            num_sources, &status);
+    beam_alias = oskar_mem_create(OSKAR_DOUBLE_COMPLEX_MATRIX, OSKAR_CPU,
+            num_sources, &status);
+    oskar_evaluate_station_beam(num_sources, OSKAR_RELATIVE_DIRECTIONS,
+            oskar_sky_l(sky), oskar_sky_m(sky), oskar_sky_n(sky),
+            0.0, M_PI / 2.0, s, work, 0, frequency, 0.0, 0, beam_sky, &status);
+    oskar_evaluate_station_beam(num_sources, OSKAR_RELATIVE_DIRECTIONS,
+            oskar_sky_l(alias), oskar_sky_m(alias), oskar_sky_n(alias),
+            0.0, M_PI / 2.0, s, work, 0, frequency, 0.0, 0, beam_alias,
+            &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+    const double* a = oskar_mem_double_const(beam_alias, &status);
+    const double* b = oskar_mem_double_const(beam_sky, &status);
+    for (int i = 0; i < 8 * num_sources; ++i)
+        ASSERT_EQ(b[i], a[i]);
+
+    // The source at the phase centre must have unit gain.
+    EXPECT_NEAR(1.0, sqrt(a[0] * a[0] + a[1] * a[1]), 1e-9);
+    EXPECT_NEAR(1.0, sqrt(a[6] * a[6] + a[7] * a[7]), 1e-9);
+
+    // Clean up.
+    oskar_sky_free(alias, &status);
+    oskar_sky_free(sky, &status);
+    for (int k = 0; k < 4; ++k) oskar_mem_free(flux[k], &status);
+    oskar_station_work_free(work, &status);
+    oskar_station_free(s, &status);
+    oskar_mem_free(beam_sky, &status);
+    oskar_mem_free(beam_alias, &status);
+    ASSERT_EQ(0, status) << oskar_get_error_string(status);
+}
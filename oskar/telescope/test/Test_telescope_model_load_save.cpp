@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2012-2016, The University of Oxford
+ * Copyright (c) 2012-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -30,8 +30,10 @@
 
 #include "utility/oskar_dir.h"
 #include "utility/oskar_get_error_string.h"
+#include "math/oskar_cmath.h"
 #include "mem/oskar_mem.h"
 #include "telescope/oskar_telescope.h"
+#include "telescope/station/element/oskar_element_evaluate.h"
 
 #include <cstdio>
 #include <cstdlib>
@@ -536,6 +538,193 @@ TEST(telescope_model_load_save, test_load_telescope_noise_rms)
 }
 
 
+TEST(telescope_model_load_save, test_compiled)
+{
+    int err = 0;
+    const char* tm = "temp_test_telescope_compiled";
+    const char* compiled = "temp_test_telescope_compiled.bin";
+
+    // Create and save a two-level telescope model.
+    int num_stations = 3, num_tiles = 4, num_elements = 8;
+    oskar_Telescope* telescope = oskar_telescope_create(OSKAR_DOUBLE,
+            OSKAR_CPU, num_stations, &err);
+    oskar_telescope_set_position(telescope, 0.1, 0.5, 1.0);
+    for (int i = 0; i < num_stations; ++i)
+    {
+        double xyz[3];
+        xyz[0] = 1.0 * i;
+        xyz[1] = 2.0 * i;
+        xyz[2] = 3.0 * i;
+        oskar_Station* st = oskar_telescope_station(telescope, i);
+        oskar_telescope_set_station_coords(telescope, i,
+                xyz, xyz, xyz, xyz, &err);
+        oskar_station_resize(st, num_tiles, &err);
+        oskar_station_create_child_stations(st, &err);
+        for (int j = 0; j < num_tiles; ++j)
+        {
+            xyz[0] = 10.0 * i + 1.0 * j;
+            xyz[1] = 20.0 * i + 1.0 * j;
+            xyz[2] = 30.0 * i + 1.0 * j;
+            oskar_station_set_element_coords(st, j, xyz, xyz, &err);
+            oskar_Station* child = oskar_station_child(st, j);
+            oskar_station_resize(child, num_elements, &err);
+            for (int k = 0; k < num_elements; ++k)
+            {
+                xyz[0] = 100.0 * i + 10.0 * j + 1.0 * k;
+                xyz[1] = 200.0 * i + 10.0 * j + 1.0 * k;
+                xyz[2] = 300.0 * i + 10.0 * j + 1.0 * k;
+                oskar_station_set_element_coords(child, k, xyz, xyz, &err);
+            }
+        }
+    }
+    ASSERT_EQ(0, err) << oskar_get_error_string(err);
+    if (oskar_dir_exists(tm)) oskar_dir_remove(tm);
+    oskar_telescope_save(telescope, tm, &err);
+    ASSERT_EQ(0, err) << oskar_get_error_string(err);
+    oskar_telescope_free(telescope, &err);
+
+    // Add numerical element pattern data at two frequencies.
+    const char* parts[] = {"te_re", "te_im", "tm_re", "tm_im"};
+    for (int i = 0; i < 2; ++i)
+    {
+        for (int j = 0; j < 4; ++j)
+        {
+            char name[64];
+            sprintf(name, "element_pattern_spherical_wave_%s_0_%d.txt",
+                    parts[j], 100 * (i + 1));
+            char* path = oskar_dir_get_path(tm, name);
+            FILE* f = fopen(path, "w");
+            fprintf(f, "%.2f, %.2f, %.2f\n", 0.1 * (i + j + 1),
+                    0.2 * (i - j), -0.3 * (i + 1));
+            fclose(f);
+            free(path);
+        }
+    }
+
+    // Load the directory, and compile it.
+    oskar_Telescope* telescope2 = oskar_telescope_create(OSKAR_DOUBLE,
+            OSKAR_CPU, 0, &err);
+    oskar_telescope_set_position(telescope2, 0.1, 0.5, 1.0);
+    oskar_telescope_set_enable_numerical_patterns(telescope2, 1);
+    char* hash = oskar_telescope_source_hash(telescope2, tm, &err);
+    oskar_telescope_load(telescope2, tm, NULL, &err);
+    ASSERT_EQ(0, err) << oskar_get_error_string(err);
+    {
+        const oskar_Element* e = oskar_station_element_const(
+                oskar_station_child_const(
+                        oskar_telescope_station_const(telescope2, 0), 0), 0);
+        ASSERT_EQ(2, oskar_element_num_freq(e));
+        ASSERT_TRUE(oskar_element_has_spherical_wave_data(e, 0));
+        ASSERT_TRUE(oskar_element_has_spherical_wave_data(e, 1));
+    }
+    remove(compiled);
+    EXPECT_TRUE(oskar_telescope_load_compiled(compiled, hash, &err) == 0);
+    oskar_telescope_compile(telescope2, compiled, hash, &err);
+    ASSERT_EQ(0, err) << oskar_get_error_string(err);
+
+    // Load the compiled model and check it is the same.
+    oskar_Telescope* telescope3 = oskar_telescope_load_compiled(compiled,
+            hash, &err);
+    ASSERT_EQ(0, err) << oskar_get_error_string(err);
+    ASSERT_TRUE(telescope3 != 0);
+    ASSERT_EQ(num_stations, oskar_telescope_num_stations(telescope3));
+    EXPECT_EQ(oskar_telescope_max_station_depth(telescope2),
+            oskar_telescope_max_station_depth(telescope3));
+    EXPECT_EQ(oskar_telescope_max_station_size(telescope2),
+            oskar_telescope_max_station_size(telescope3));
+    EXPECT_DOUBLE_EQ(oskar_telescope_lat_rad(telescope2),
+            oskar_telescope_lat_rad(telescope3));
+    EXPECT_FALSE(oskar_mem_different(
+            oskar_telescope_station_true_x_enu_metres(telescope2),
+            oskar_telescope_station_true_x_enu_metres(telescope3), 0, &err));
+    EXPECT_FALSE(oskar_mem_different(
+            oskar_telescope_station_measured_z_offset_ecef_metres(telescope2),
+            oskar_telescope_station_measured_z_offset_ecef_metres(telescope3),
+            0, &err));
+    for (int i = 0; i < num_stations; ++i)
+    {
+        oskar_Station* s2 = oskar_telescope_station(telescope2, i);
+        oskar_Station* s3 = oskar_telescope_station(telescope3, i);
+        EXPECT_FALSE(oskar_station_different(s2, s3, &err));
+        for (int j = 0; j < num_tiles; ++j)
+            EXPECT_FALSE(oskar_station_different(oskar_station_child(s2, j),
+                    oskar_station_child(s3, j), &err));
+    }
+    ASSERT_EQ(0, err) << oskar_get_error_string(err);
+
+    // Check the element patterns are the same.
+    {
+        const int num_dirs = 3;
+        const double freqs[] = {100e6, 200e6};
+        oskar_Mem *x, *y, *z, *theta, *phi_x, *phi_y, *temp, *p2, *p3;
+        x = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_dirs, &err);
+        y = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_dirs, &err);
+        z = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, num_dirs, &err);
+        theta = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, 0, &err);
+        phi_x = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, 0, &err);
+        phi_y = oskar_mem_create(OSKAR_DOUBLE, OSKAR_CPU, 0, &err);
+        temp = oskar_mem_create(OSKAR_DOUBLE_COMPLEX_MATRIX,
+                OSKAR_CPU, 0, &err);
+        p2 = oskar_mem_create(OSKAR_DOUBLE_COMPLEX_MATRIX,
+                OSKAR_CPU, num_dirs, &err);
+        p3 = oskar_mem_create(OSKAR_DOUBLE_COMPLEX_MATRIX,
+                OSKAR_CPU, num_dirs, &err);
+        for (int i = 0; i < num_dirs; ++i)
+        {
+            oskar_mem_double(x, &err)[i] = 0.1 * i;
+            oskar_mem_double(y, &err)[i] = 0.2 * i;
+            oskar_mem_double(z, &err)[i] = sqrt(1.0 - 0.05 * i * i);
+        }
+        for (int f = 0; f < 2; ++f)
+        {
+            const oskar_Element* e2 = oskar_station_element_const(
+                    oskar_station_child_const(
+                            oskar_telescope_station_const(telescope2, 1), 2),
+                    0);
+            const oskar_Element* e3 = oskar_station_element_const(
+                    oskar_station_child_const(
+                            oskar_telescope_station_const(telescope3, 1), 2),
+                    0);
+            oskar_element_evaluate(e2, 0.0, M_PI / 2.0, 0, num_dirs,
+                    x, y, z, freqs[f], theta, phi_x, phi_y, temp, 0, p2, &err);
+            oskar_element_evaluate(e3, 0.0, M_PI / 2.0, 0, num_dirs,
+                    x, y, z, freqs[f], theta, phi_x, phi_y, temp, 0, p3, &err);
+            ASSERT_EQ(0, err) << oskar_get_error_string(err);
+            EXPECT_FALSE(oskar_mem_different(p2, p3, 0, &err));
+        }
+        oskar_mem_free(x, &err);
+        oskar_mem_free(y, &err);
+        oskar_mem_free(z, &err);
+        oskar_mem_free(theta, &err);
+        oskar_mem_free(phi_x, &err);
+        oskar_mem_free(phi_y, &err);
+        oskar_mem_free(temp, &err);
+        oskar_mem_free(p2, &err);
+        oskar_mem_free(p3, &err);
+    }
+
+    // Check that a change to the model directory is detected.
+    char* path = oskar_dir_get_path(tm, "layout.txt");
+    FILE* f = fopen(path, "a");
+    fprintf(f, "1000.0, 1000.0, 0.0\n");
+    fclose(f);
+    free(path);
+    char* hash2 = oskar_telescope_source_hash(telescope2, tm, &err);
+    ASSERT_EQ(0, err) << oskar_get_error_string(err);
+    EXPECT_STRNE(hash, hash2);
+    EXPECT_TRUE(oskar_telescope_load_compiled(compiled, hash2, &err) == 0);
+    EXPECT_EQ(0, err) << oskar_get_error_string(err);
+
+    // Clean up.
+    free(hash);
+    free(hash2);
+    oskar_telescope_free(telescope2, &err);
+    oskar_telescope_free(telescope3, &err);
+    oskar_dir_remove(tm);
+    remove(compiled);
+}
+
+
 static void generate_noisy_telescope(const char* dir, int num_stations,
         const vector<double>& freqs, const vector<double>& noise)
 {
@@ -54,6 +54,8 @@
     if (I >= N) return;\
 
 #define KERNEL_LOOP_PAR_X(TYPE, I, OFFSET, N) KERNEL_LOOP_X(TYPE, I, OFFSET, N)
+#define KERNEL_LOOP_PAR_SIMD_X(TYPE, I, OFFSET, N)\
+    KERNEL_LOOP_X(TYPE, I, OFFSET, N)
 #define KERNEL_LOOP_END \
 
 #define LOCAL __shared__
@@ -167,6 +169,8 @@
     if (I >= N) return;\
 
 #define KERNEL_LOOP_PAR_X(TYPE, I, OFFSET, N) KERNEL_LOOP_X(TYPE, I, OFFSET, N)
+#define KERNEL_LOOP_PAR_SIMD_X(TYPE, I, OFFSET, N)\
+    KERNEL_LOOP_X(TYPE, I, OFFSET, N)
 #define KERNEL_LOOP_END \
 
 #define LOCAL local
@@ -228,6 +232,26 @@
     DO_PRAGMA(omp parallel for private(I))\
     for (I = OFFSET; I < N; I++) {\
 
+/* Element-wise loops that are cheap per iteration are only run in
+ * parallel if there are enough of them to amortise the cost of starting
+ * the threads. The number of threads is the caller's OpenMP thread budget
+ * (see oskar_get_thread_budget()). */
+#ifndef KERNEL_PAR_MIN_ITER
+#define KERNEL_PAR_MIN_ITER 4096
+#endif
+#if defined(_OPENMP) && _OPENMP >= 201307
+#define KERNEL_LOOP_PAR_SIMD_X(TYPE, I, OFFSET, N)\
+    TYPE I;\
+    KERNEL_PAR_SIMD_PRAGMA_((N) - (OFFSET) >= KERNEL_PAR_MIN_ITER)\
+    for (I = OFFSET; I < N; I++) {\
+
+#define KERNEL_PAR_SIMD_PRAGMA_(COND)\
+    DO_PRAGMA(omp parallel for simd if(COND) schedule(static))
+#else
+#define KERNEL_LOOP_PAR_SIMD_X(TYPE, I, OFFSET, N)\
+    KERNEL_LOOP_X(TYPE, I, OFFSET, N)
+#endif
+
 #define KERNEL_LOOP_END }\
 
 #define LOCAL
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017, The University of Oxford
+ * Copyright (c) 2017-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -42,9 +42,11 @@ extern "C" {
 struct oskar_Mutex;
 struct oskar_Thread;
 struct oskar_Barrier;
+struct oskar_ConditionVar;
 typedef struct oskar_Mutex oskar_Mutex;
 typedef struct oskar_Thread oskar_Thread;
 typedef struct oskar_Barrier oskar_Barrier;
+typedef struct oskar_ConditionVar oskar_ConditionVar;
 
 /**
  * @brief Creates a mutex.
@@ -90,6 +92,76 @@ void oskar_mutex_lock(oskar_Mutex* mutex);
 OSKAR_EXPORT
 void oskar_mutex_unlock(oskar_Mutex* mutex);
 
+/**
+ * @brief Creates a condition variable.
+ *
+ * @details
+ * Creates a condition variable, together with the mutex that protects it.
+ * Returns NULL if memory could not be allocated.
+ */
+OSKAR_EXPORT
+oskar_ConditionVar* oskar_condition_create(void);
+
+/**
+ * @brief Destroys the condition variable.
+ *
+ * @details
+ * Destroys the condition variable.
+ *
+ * @param[in,out] var Pointer to condition variable.
+ */
+OSKAR_EXPORT
+void oskar_condition_free(oskar_ConditionVar* var);
+
+/**
+ * @brief Locks the mutex associated with the condition variable.
+ *
+ * @details
+ * Locks the mutex associated with the condition variable.
+ *
+ * @param[in,out] var Pointer to condition variable.
+ */
+OSKAR_EXPORT
+void oskar_condition_lock(oskar_ConditionVar* var);
+
+/**
+ * @brief Unlocks the mutex associated with the condition variable.
+ *
+ * @details
+ * Unlocks the mutex associated with the condition variable.
+ *
+ * @param[in,out] var Pointer to condition variable.
+ */
+OSKAR_EXPORT
+void oskar_condition_unlock(oskar_ConditionVar* var);
+
+/**
+ * @brief Wakes all threads waiting on the condition variable.
+ *
+ * @details
+ * Wakes all threads waiting on the condition variable.
+ *
+ * @param[in,out] var Pointer to condition variable.
+ */
+OSKAR_EXPORT
+void oskar_condition_notify_all(oskar_ConditionVar* var);
+
+/**
+ * @brief Waits on the condition variable.
+ *
+ * @details
+ * Releases the associated mutex, which must be locked by the caller,
+ * and blocks the calling thread until it is woken.
+ * The mutex is locked again before returning.
+ *
+ * Spurious wake-ups are possible, so the caller should check the
+ * condition it is waiting for in a loop.
+ *
+ * @param[in,out] var Pointer to condition variable.
+ */
+OSKAR_EXPORT
+void oskar_condition_wait(oskar_ConditionVar* var);
+
 /**
  * @brief Creates and starts a thread.
  *
@@ -163,6 +235,23 @@ void oskar_barrier_set_num_threads(oskar_Barrier* barrier, int num_threads);
 OSKAR_EXPORT
 int oskar_barrier_wait(oskar_Barrier* barrier);
 
+/**
+ * @brief Atomically adds to an integer.
+ *
+ * @details
+ * Atomically adds \p increment to the integer at \p value, and returns
+ * the value it held beforehand.
+ *
+ * This is safe to use between any threads, including those created by
+ * oskar_thread_create(). Where the compiler provides no atomic operations,
+ * a global mutex is used instead.
+ *
+ * @param[in,out] value   Pointer to integer to update.
+ * @param[in] increment   Amount to add.
+ */
+OSKAR_EXPORT
+int oskar_atomic_fetch_add_int(int* value, int increment);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2013-2014, The University of Oxford
+ * Copyright (c) 2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -26,25 +26,27 @@
  * POSSIBILITY OF SUCH DAMAGE.
  */
 
-#ifndef OSKAR_SETTINGS_LOAD_TID_PARAMETER_FILE_H_
-#define OSKAR_SETTINGS_LOAD_TID_PARAMETER_FILE_H_
+#include "utility/oskar_get_thread_budget.h"
 
-/**
- * @file oskar_load_tid_parameter_file.h
- */
-
-#include <oskar_global.h>
-#include <oskar_Settings_old.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-void oskar_settings_load_tid_parameter_file(oskar_SettingsTIDscreen* settings,
-        const char* filename, int* status);
+int oskar_get_thread_budget(int num_host_threads)
+{
+    int num_threads = 1;
+#ifdef _OPENMP
+    num_threads = omp_get_max_threads();
+#endif
+    if (num_host_threads > 1)
+        num_threads /= num_host_threads;
+    return (num_threads > 0) ? num_threads : 1;
+}
 
 #ifdef __cplusplus
 }
 #endif
-
-#endif /* OSKAR_SETTINGS_LOAD_TID_PARAMETER_FILE_H_ */
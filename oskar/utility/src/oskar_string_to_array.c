@@ -80,13 +80,15 @@ size_t oskar_string_to_array_f(char* str, size_t n, float* data)
 size_t oskar_string_to_array_d(char* str, size_t n, double* data)
 {
     size_t i = 0;
-    char *save_ptr = 0, *token = 0;
+    char *save_ptr = 0, *token = 0, *end = 0;
     do
     {
+        double val;
         token = strtok_r(str, DELIMITERS, &save_ptr);
         str = NULL;
         if (!token || token[0] == '#') break;
-        if (sscanf(token, "%lf", &data[i]) > 0) i++;
+        val = strtod(token, &end);
+        if (end != token) data[i++] = val;
     }
     while (i < n);
     return i;
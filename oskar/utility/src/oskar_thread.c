@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017, The University of Oxford
+ * Copyright (c) 2017-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -120,7 +120,6 @@ struct oskar_ConditionVar
     pthread_cond_t var;
 #endif
 };
-typedef struct oskar_ConditionVar oskar_ConditionVar;
 
 static void oskar_condition_init(oskar_ConditionVar* var)
 {
@@ -142,17 +141,33 @@ static void oskar_condition_uninit(oskar_ConditionVar* var)
 #endif
 }
 
-static void oskar_condition_lock(oskar_ConditionVar* var)
+oskar_ConditionVar* oskar_condition_create(void)
+{
+    oskar_ConditionVar* var;
+    var = (oskar_ConditionVar*) calloc(1, sizeof(oskar_ConditionVar));
+    if (!var) return 0;
+    oskar_condition_init(var);
+    return var;
+}
+
+void oskar_condition_free(oskar_ConditionVar* var)
+{
+    if (!var) return;
+    oskar_condition_uninit(var);
+    free(var);
+}
+
+void oskar_condition_lock(oskar_ConditionVar* var)
 {
     oskar_mutex_lock(&var->lock);
 }
 
-static void oskar_condition_unlock(oskar_ConditionVar* var)
+void oskar_condition_unlock(oskar_ConditionVar* var)
 {
     oskar_mutex_unlock(&var->lock);
 }
 
-static void oskar_condition_notify_all(oskar_ConditionVar* var)
+void oskar_condition_notify_all(oskar_ConditionVar* var)
 {
 #if defined(OSKAR_OS_WIN)
     WakeAllConditionVariable(&var->var);
@@ -161,7 +176,7 @@ static void oskar_condition_notify_all(oskar_ConditionVar* var)
 #endif
 }
 
-static void oskar_condition_wait(oskar_ConditionVar* var)
+void oskar_condition_wait(oskar_ConditionVar* var)
 {
 #if defined(OSKAR_OS_WIN)
     SleepConditionVariableCS(&var->var, &(var->lock.lock), INFINITE);
@@ -302,6 +317,31 @@ int oskar_barrier_wait(oskar_Barrier* barrier)
     return 0;
 }
 
+
+/* =========================================================================
+ *  ATOMIC
+ * =========================================================================*/
+
+#if !defined(OSKAR_OS_WIN) && !defined(__ATOMIC_SEQ_CST)
+static pthread_mutex_t atomic_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+int oskar_atomic_fetch_add_int(int* value, int increment)
+{
+#if defined(OSKAR_OS_WIN)
+    return (int) InterlockedExchangeAdd((volatile LONG*) value, increment);
+#elif defined(__ATOMIC_SEQ_CST)
+    return __atomic_fetch_add(value, increment, __ATOMIC_SEQ_CST);
+#else
+    int old;
+    pthread_mutex_lock(&atomic_lock);
+    old = *value;
+    *value += increment;
+    pthread_mutex_unlock(&atomic_lock);
+    return old;
+#endif
+}
+
 #ifdef __cplusplus
 }
 #endif
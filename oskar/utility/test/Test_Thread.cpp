@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017, The University of Oxford
+ * Copyright (c) 2017-2019, The University of Oxford
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -68,6 +68,14 @@ void* thread_barriers(void* arg)
     return 0;
 }
 
+void* thread_counter(void* arg)
+{
+    int* counter = (int*) arg;
+    for (int i = 0; i < 100000; ++i)
+        oskar_atomic_fetch_add_int(counter, 1);
+    return 0;
+}
+
 TEST(thread, create_and_join)
 {
     // Get the number of CPU cores.
@@ -124,3 +132,24 @@ TEST(thread, barriers)
     free(args);
     free(threads);
 }
+
+TEST(thread, atomic_fetch_add)
+{
+    int counter = 0, num_threads = 8;
+
+    // Increment a shared counter from all threads.
+    oskar_Thread** threads = (oskar_Thread**)
+            calloc((size_t) num_threads, sizeof(oskar_Thread*));
+    for (int i = 0; i < num_threads; ++i)
+        threads[i] = oskar_thread_create(thread_counter, (void*)&counter, 0);
+    for (int i = 0; i < num_threads; ++i)
+        oskar_thread_join(threads[i]);
+    EXPECT_EQ(num_threads * 100000, counter);
+    EXPECT_EQ(num_threads * 100000, oskar_atomic_fetch_add_int(&counter, 5));
+    EXPECT_EQ(num_threads * 100000 + 5, counter);
+
+    // Clean up.
+    for (int i = 0; i < num_threads; ++i)
+        oskar_thread_free(threads[i]);
+    free(threads);
+}
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2019, The University of Oxford
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ * 1. Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 3. Neither the name of the University of Oxford nor the names of its
+ *    contributors may be used to endorse or promote products derived from this
+ *    software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "convert/oskar_convert_enu_directions_to_relative_directions.h"
+#include "convert/oskar_convert_enu_directions_to_theta_phi.h"
+#include "convert/oskar_convert_relative_directions_to_enu_directions.h"
+#include "interferometer/oskar_evaluate_jones_K.h"
+#include "interferometer/oskar_jones.h"
+#include "mem/oskar_mem.h"
+#include "sky/oskar_update_horizon_mask.h"
+#include "telescope/station/element/oskar_evaluate_dipole_pattern.h"
+#include "utility/oskar_get_error_string.h"
+#include "utility/oskar_get_thread_budget.h"
+#include "utility/oskar_timer.h"
+
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+enum {
+    JONES_K, MEM_ADD, MEM_MULTIPLY, ENU_TO_REL, REL_TO_ENU, ENU_TO_THETA_PHI,
+    HORIZON_MASK, DIPOLE_PATTERN, NUM_KERNELS
+};
+static const char* names[] = {
+    "evaluate_jones_K", "mem_add", "mem_multiply",
+    "enu_to_relative_directions", "relative_to_enu_directions",
+    "enu_to_theta_phi", "update_horizon_mask", "evaluate_dipole_pattern"
+};
+
+struct Data
+{
+    int n, num_stations;
+    oskar_Mem *x, *y, *z, *a, *b, *c, *cplx1, *cplx2, *cplx3, *mask;
+    oskar_Mem *u, *v, *w;
+    oskar_Jones* K;
+};
+
+static void run_kernel(int k, struct Data* d, int* status)
+{
+    const int n = d->n;
+    switch (k)
+    {
+    case JONES_K:
+        oskar_evaluate_jones_K(d->K, n, d->x, d->y, d->z, d->u, d->v, d->w,
+                100e6, d->a, -DBL_MAX, DBL_MAX, 0, status);
+        break;
+    case MEM_ADD:
+        oskar_mem_add(d->c, d->a, d->b, 0, 0, 0, n, status);
+        break;
+    case MEM_MULTIPLY:
+        oskar_mem_multiply(d->cplx3, d->cplx1, d->cplx2, 0, 0, 0, n, status);
+        break;
+    case ENU_TO_REL:
+        oskar_convert_enu_directions_to_relative_directions(0, n,
+                d->x, d->y, d->z, 0.1, -0.5, 0.7, 0, d->a, d->b, d->c,
+                status);
+        break;
+    case REL_TO_ENU:
+        oskar_convert_relative_directions_to_enu_directions(0, 0, 0, n,
+                d->x, d->y, d->z, 0.1, -0.5, 0.7, 0, d->a, d->b, d->c,
+                status);
+        break;
+    case ENU_TO_THETA_PHI:
+        oskar_convert_enu_directions_to_theta_phi(0, n, d->x, d->y, d->z,
+                0.0, 0.5, d->a, d->b, d->c, status);
+        break;
+    case HORIZON_MASK:
+        oskar_update_horizon_mask(n, d->x, d->y, d->z, 0.1, -0.5, 0.7,
+                d->mask, status);
+        break;
+    case DIPOLE_PATTERN:
+        oskar_evaluate_dipole_pattern(n, d->a, d->b, 100e6, 1.5, 1, 0,
+                d->cplx1, status);
+        break;
+    default:
+        break;
+    }
+}
+
+static double time_kernel(int k, struct Data* d, int num_threads,
+        int num_repeats, int* status)
+{
+    int i;
+    double t;
+    oskar_Timer* timer;
+#ifdef _OPENMP
+    omp_set_num_threads(num_threads);
+#else
+    (void) num_threads;
+#endif
+    run_kernel(k, d, status); /* Warm up. */
+    timer = oskar_timer_create(OSKAR_TIMER_NATIVE);
+    oskar_timer_start(timer);
+    for (i = 0; i < num_repeats; ++i)
+        run_kernel(k, d, status);
+    t = oskar_timer_elapsed(timer) / num_repeats;
+    oskar_timer_free(timer);
+    return t;
+}
+
+/*
+ * Times each CPU kernel using one thread, and using all the threads
+ * available to a single host thread, and prints the speedup.
+ */
+int main(int argc, char** argv)
+{
+    int k, n = 1 << 20, num_repeats = 20, status = 0;
+    const int num_threads = oskar_get_thread_budget(1);
+    const int type = OSKAR_DOUBLE, loc = OSKAR_CPU;
+    struct Data d;
+
+    if (argc > 1) n = atoi(argv[1]);
+    if (argc > 2) num_repeats = atoi(argv[2]);
+    if (n < 1 || num_repeats < 1)
+    {
+        fprintf(stderr, "Usage: %s [number of points] [number of repeats]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    /* Create test data. */
+    d.n = n;
+    d.num_stations = 4;
+    d.x = oskar_mem_create(type, loc, n, &status);
+    d.y = oskar_mem_create(type, loc, n, &status);
+    d.z = oskar_mem_create(type, loc, n, &status);
+    d.a = oskar_mem_create(type, loc, n, &status);
+    d.b = oskar_mem_create(type, loc, n, &status);
+    d.c = oskar_mem_create(type, loc, n, &status);
+    d.cplx1 = oskar_mem_create(type | OSKAR_COMPLEX, loc, n, &status);
+    d.cplx2 = oskar_mem_create(type | OSKAR_COMPLEX, loc, n, &status);
+    d.cplx3 = oskar_mem_create(type | OSKAR_COMPLEX, loc, n, &status);
+    d.mask = oskar_mem_create(OSKAR_INT, loc, n, &status);
+    d.u = oskar_mem_create(type, loc, d.num_stations, &status);
+    d.v = oskar_mem_create(type, loc, d.num_stations, &status);
+    d.w = oskar_mem_create(type, loc, d.num_stations, &status);
+    d.K = oskar_jones_create(type | OSKAR_COMPLEX, loc, d.num_stations, n,
+            &status);
+    oskar_mem_random_range(d.x, -0.5, 0.5, &status);
+    oskar_mem_random_range(d.y, -0.5, 0.5, &status);
+    oskar_mem_random_range(d.z, 0.5, 1.0, &status);
+    oskar_mem_random_range(d.a, 0.0, 1.5, &status);
+    oskar_mem_random_range(d.b, 0.0, 6.0, &status);
+    oskar_mem_random_range(d.cplx1, -1.0, 1.0, &status);
+    oskar_mem_random_range(d.cplx2, -1.0, 1.0, &status);
+    oskar_mem_random_range(d.u, -1000.0, 1000.0, &status);
+    oskar_mem_random_range(d.v, -1000.0, 1000.0, &status);
+    oskar_mem_random_range(d.w, -10.0, 10.0, &status);
+    oskar_mem_clear_contents(d.mask, &status);
+
+    /* Time each kernel. */
+    printf("Points: %d, threads: %d\n", n, num_threads);
+    printf("%-28s %13s %14s %8s\n", "Kernel", "1 thread [ms]",
+            "N threads [ms]", "Speedup");
+    for (k = 0; k < NUM_KERNELS && !status; ++k)
+    {
+        const double t1 = time_kernel(k, &d, 1, num_repeats, &status);
+        const double tn = time_kernel(k, &d, num_threads, num_repeats,
+                &status);
+        printf("%-28s %13.3f %14.3f %8.2f\n", names[k],
+                1e3 * t1, 1e3 * tn, t1 / tn);
+    }
+    if (status)
+        fprintf(stderr, "Error: %s\n", oskar_get_error_string(status));
+
+    /* Clean up. */
+    oskar_mem_free(d.x, &status);
+    oskar_mem_free(d.y, &status);
+    oskar_mem_free(d.z, &status);
+    oskar_mem_free(d.a, &status);
+    oskar_mem_free(d.b, &status);
+    oskar_mem_free(d.c, &status);
+    oskar_mem_free(d.cplx1, &status);
+    oskar_mem_free(d.cplx2, &status);
+    oskar_mem_free(d.cplx3, &status);
+    oskar_mem_free(d.mask, &status);
+    oskar_mem_free(d.u, &status);
+    oskar_mem_free(d.v, &status);
+    oskar_mem_free(d.w, &status);
+    oskar_jones_free(d.K, &status);
+    return status ? EXIT_FAILURE : 0;
+}
@@ -157,6 +157,15 @@ class Imager(object):
         self.capsule_ensure()
         return _imager_lib.channel_snapshots(self._capsule)
 
+    def get_coords_cache_size(self):
+        """Returns the maximum size of the coordinate cache, in megabytes.
+
+        Returns:
+            float: The maximum size of the coordinate cache, in megabytes.
+        """
+        self.capsule_ensure()
+        return _imager_lib.coords_cache_size(self._capsule)
+
     def get_coords_only(self):
         """Returns flag specifying whether imager is in coordinate-only mode.
 
@@ -247,6 +256,15 @@ class Imager(object):
         self.capsule_ensure()
         return _imager_lib.ms_column(self._capsule)
 
+    def get_num_threads(self):
+        """Returns the number of CPU threads used by the gridder.
+
+        Returns:
+            int: The number of CPU threads used by the gridder.
+        """
+        self.capsule_ensure()
+        return _imager_lib.num_threads(self._capsule)
+
     def get_num_w_planes(self):
         """Returns the number of W-planes used.
 
@@ -491,6 +509,19 @@ class Imager(object):
         self.capsule_ensure()
         _imager_lib.set_channel_snapshots(self._capsule, value)
 
+    def set_coords_cache_size(self, size_mb):
+        """Sets the maximum size of the coordinate cache, in megabytes.
+
+        With uniform weighting or W-projection, coordinates read from
+        input files on the first pass are cached and reused by run(),
+        so that only the visibility data need to be read again.
+
+        Args:
+            size_mb (float): Maximum size of the cache, in megabytes.
+        """
+        self.capsule_ensure()
+        _imager_lib.set_coords_cache_size(self._capsule, size_mb)
+
     def set_coords_only(self, flag):
         """Sets the imager to ignore visibility data and use coordinates only.
 
@@ -630,6 +661,18 @@ class Imager(object):
         self.capsule_ensure()
         _imager_lib.set_ms_column(self._capsule, column)
 
+    def set_num_threads(self, value):
+        """Sets the number of CPU threads used by the gridder.
+
+        This is currently only used by the W-projection gridder on the CPU.
+        A number less than or equal to zero means 'automatic'.
+
+        Args:
+            value (int): Number of CPU threads to use.
+        """
+        self.capsule_ensure()
+        _imager_lib.set_num_threads(self._capsule, value)
+
     def set_num_w_planes(self, num_planes):
         """Sets the number of W-planes to use, if using W-projection.
 
@@ -869,6 +912,8 @@ class Imager(object):
     cell_size_arcsec = property(get_cellsize, set_cellsize)
     channel_snapshots = property(get_channel_snapshots,
                                  set_channel_snapshots)
+    coords_cache_size = property(get_coords_cache_size,
+                                 set_coords_cache_size)
     coords_only = property(get_coords_only, set_coords_only)
     fft_on_gpu = property(get_fft_on_gpu, set_fft_on_gpu)
     fov = property(get_fov, set_fov)
@@ -883,6 +928,7 @@ class Imager(object):
     input_files = property(get_input_file, set_input_file)
     input_vis_data = property(get_input_file, set_input_file)
     ms_column = property(get_ms_column, set_ms_column)
+    num_threads = property(get_num_threads, set_num_threads)
     num_w_planes = property(get_num_w_planes, set_num_w_planes)
     output_root = property(get_output_root, set_output_root)
     plane_size = property(get_plane_size)
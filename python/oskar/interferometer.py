@@ -276,6 +276,20 @@ class Interferometer(object):
         self.capsule_ensure()
         _interferometer_lib.set_horizon_clip(self._capsule, value)
 
+    def set_max_channels_per_beam(self, value):
+        """Sets the maximum number of channels that may share a station beam.
+
+        If greater than 1, the station beam is evaluated only at the first
+        channel of each batch of neighbouring channels, so that the batch
+        can be correlated together. This is faster, but approximate:
+        use only for small batches of narrow channels.
+
+        Args:
+            value (int): Maximum number of channels per station beam.
+        """
+        self.capsule_ensure()
+        _interferometer_lib.set_max_channels_per_beam(self._capsule, value)
+
     def set_max_sources_per_chunk(self, value):
         """Sets the maximum number of sources processed concurrently on one GPU.
 
@@ -309,6 +323,18 @@ class Interferometer(object):
         self.capsule_ensure()
         _interferometer_lib.set_num_devices(self._capsule, value)
 
+    def set_num_threads_per_device(self, value):
+        """Sets the number of OpenMP threads used by each compute device.
+
+        If the value is zero or negative, the available CPU cores are
+        shared evenly between the compute devices.
+
+        Args:
+            value (int): Number of threads per compute device.
+        """
+        self.capsule_ensure()
+        _interferometer_lib.set_num_threads_per_device(self._capsule, value)
+
     def set_observation_frequency(self, start_frequency_hz,
                                   inc_hz=0.0, num_channels=1):
         """Sets observation start frequency, increment, and number of channels.
@@ -374,6 +400,19 @@ class Interferometer(object):
         self._sky_model_set = True
         _interferometer_lib.set_sky_model(self._capsule, sky_model.capsule)
 
+    def set_sky_model_file(self, filename):
+        """Sets the sky model used for the simulation from a binary file.
+
+        If the file was written in chunks, the chunks are used directly
+        from the file, instead of being copied.
+
+        Args:
+            filename (str): Path to an OSKAR binary sky model file.
+        """
+        self.capsule_ensure()
+        self._sky_model_set = True
+        _interferometer_lib.set_sky_model_file(self._capsule, filename)
+
     def set_telescope_model(self, telescope_model):
         """Sets the telescope model used for the simulation.
 
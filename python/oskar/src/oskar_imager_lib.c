@@ -160,6 +160,16 @@ static PyObject* check_init(PyObject* self, PyObject* args)
 }
 
 
+static PyObject* coords_cache_size(PyObject* self, PyObject* args)
+{
+    oskar_Imager* h = 0;
+    PyObject* capsule = 0;
+    if (!PyArg_ParseTuple(args, "O", &capsule)) return 0;
+    if (!(h = (oskar_Imager*) get_handle(capsule, name))) return 0;
+    return Py_BuildValue("d", oskar_imager_coords_cache_size(h));
+}
+
+
 static PyObject* coords_only(PyObject* self, PyObject* args)
 {
     oskar_Imager* h = 0;
@@ -448,6 +458,16 @@ static PyObject* ms_column(PyObject* self, PyObject* args)
 }
 
 
+static PyObject* num_threads(PyObject* self, PyObject* args)
+{
+    oskar_Imager* h = 0;
+    PyObject* capsule = 0;
+    if (!PyArg_ParseTuple(args, "O", &capsule)) return 0;
+    if (!(h = (oskar_Imager*) get_handle(capsule, name))) return 0;
+    return Py_BuildValue("i", oskar_imager_num_threads(h));
+}
+
+
 static PyObject* num_w_planes(PyObject* self, PyObject* args)
 {
     oskar_Imager* h = 0;
@@ -768,6 +788,18 @@ static PyObject* set_channel_snapshots(PyObject* self, PyObject* args)
 }
 
 
+static PyObject* set_coords_cache_size(PyObject* self, PyObject* args)
+{
+    oskar_Imager* h = 0;
+    PyObject* capsule = 0;
+    double size_mb = 0.0;
+    if (!PyArg_ParseTuple(args, "Od", &capsule, &size_mb)) return 0;
+    if (!(h = (oskar_Imager*) get_handle(capsule, name))) return 0;
+    oskar_imager_set_coords_cache_size(h, size_mb);
+    return Py_BuildValue("");
+}
+
+
 static PyObject* set_coords_only(PyObject* self, PyObject* args)
 {
     oskar_Imager* h = 0;
@@ -992,6 +1024,18 @@ static PyObject* set_ms_column(PyObject* self, PyObject* args)
 }
 
 
+static PyObject* set_num_threads(PyObject* self, PyObject* args)
+{
+    oskar_Imager* h = 0;
+    PyObject* capsule = 0;
+    int num = 0;
+    if (!PyArg_ParseTuple(args, "Oi", &capsule, &num)) return 0;
+    if (!(h = (oskar_Imager*) get_handle(capsule, name))) return 0;
+    oskar_imager_set_num_threads(h, num);
+    return Py_BuildValue("");
+}
+
+
 static PyObject* set_num_w_planes(PyObject* self, PyObject* args)
 {
     oskar_Imager* h = 0;
@@ -1741,6 +1785,8 @@ static PyMethodDef methods[] =
         {"channel_snapshots", (PyCFunction)channel_snapshots,
                 METH_VARARGS, "channel_snapshots()"},
         {"check_init", (PyCFunction)check_init, METH_VARARGS, "check_init()"},
+        {"coords_cache_size", (PyCFunction)coords_cache_size,
+                METH_VARARGS, "coords_cache_size()"},
         {"coords_only", (PyCFunction)coords_only,
                 METH_VARARGS, "coords_only()"},
         {"create", (PyCFunction)create, METH_VARARGS, "create(type)"},
@@ -1762,6 +1808,8 @@ static PyMethodDef methods[] =
         {"ms_column", (PyCFunction)ms_column, METH_VARARGS, "ms_column()"},
         {"make_image", (PyCFunction)make_image, METH_VARARGS,
                 "make_image(uu, vv, ww, amp, weight, fov_deg, size)"},
+        {"num_threads", (PyCFunction)num_threads,
+                METH_VARARGS, "num_threads()"},
         {"num_w_planes", (PyCFunction)num_w_planes,
                 METH_VARARGS, "num_w_planes()"},
         {"output_root", (PyCFunction)output_root,
@@ -1784,6 +1832,8 @@ static PyMethodDef methods[] =
                 METH_VARARGS, "set_cellsize(value)"},
         {"set_channel_snapshots", (PyCFunction)set_channel_snapshots,
                 METH_VARARGS, "set_channel_snapshots(value)"},
+        {"set_coords_cache_size", (PyCFunction)set_coords_cache_size,
+                METH_VARARGS, "set_coords_cache_size(size_mb)"},
         {"set_coords_only", (PyCFunction)set_coords_only,
                 METH_VARARGS, "set_coords_only(flag)"},
         {"set_default_direction", (PyCFunction)set_default_direction,
@@ -1810,6 +1860,8 @@ static PyMethodDef methods[] =
                 METH_VARARGS, "set_input_file(filename)"},
         {"set_ms_column", (PyCFunction)set_ms_column,
                 METH_VARARGS, "set_ms_column(column)"},
+        {"set_num_threads", (PyCFunction)set_num_threads,
+                METH_VARARGS, "set_num_threads(value)"},
         {"set_num_w_planes", (PyCFunction)set_num_w_planes,
                 METH_VARARGS, "set_num_w_planes(value)"},
         {"set_output_root", (PyCFunction)set_output_root,
@@ -387,6 +387,18 @@ static PyObject* set_horizon_clip(PyObject* self, PyObject* args)
 }
 
 
+static PyObject* set_max_channels_per_beam(PyObject* self, PyObject* args)
+{
+    oskar_Interferometer* h = 0;
+    PyObject* capsule = 0;
+    int value = 0;
+    if (!PyArg_ParseTuple(args, "Oi", &capsule, &value)) return 0;
+    if (!(h = (oskar_Interferometer*) get_handle(capsule, name))) return 0;
+    oskar_interferometer_set_max_channels_per_beam(h, value);
+    return Py_BuildValue("");
+}
+
+
 static PyObject* set_max_sources_per_chunk(PyObject* self, PyObject* args)
 {
     oskar_Interferometer* h = 0;
@@ -423,6 +435,18 @@ static PyObject* set_num_devices(PyObject* self, PyObject* args)
 }
 
 
+static PyObject* set_num_threads_per_device(PyObject* self, PyObject* args)
+{
+    oskar_Interferometer* h = 0;
+    PyObject* capsule = 0;
+    int value = 0;
+    if (!PyArg_ParseTuple(args, "Oi", &capsule, &value)) return 0;
+    if (!(h = (oskar_Interferometer*) get_handle(capsule, name))) return 0;
+    oskar_interferometer_set_num_threads_per_device(h, value);
+    return Py_BuildValue("");
+}
+
+
 static PyObject* set_observation_frequency(PyObject* self, PyObject* args)
 {
     oskar_Interferometer* h = 0;
@@ -513,6 +537,28 @@ static PyObject* set_sky_model(PyObject* self, PyObject* args)
 }
 
 
+static PyObject* set_sky_model_file(PyObject* self, PyObject* args)
+{
+    oskar_Interferometer* h = 0;
+    PyObject* capsule = 0;
+    const char* filename;
+    int status = 0;
+    if (!PyArg_ParseTuple(args, "Os", &capsule, &filename)) return 0;
+    if (!(h = (oskar_Interferometer*) get_handle(capsule, name))) return 0;
+    oskar_interferometer_set_sky_model_file(h, filename, &status);
+
+    /* Check for errors. */
+    if (status)
+    {
+        PyErr_Format(PyExc_RuntimeError,
+                "oskar_interferometer_set_sky_model_file() failed with code %d (%s).",
+                status, oskar_get_error_string(status));
+        return 0;
+    }
+    return Py_BuildValue("");
+}
+
+
 static PyObject* set_telescope_model(PyObject* self, PyObject* args)
 {
     oskar_Interferometer* h = 0;
@@ -631,12 +677,17 @@ static PyMethodDef methods[] =
                 METH_VARARGS, "set_gpus(device_ids)"},
         {"set_horizon_clip", (PyCFunction)set_horizon_clip,
                 METH_VARARGS, "set_horizon_clip(value)"},
+        {"set_max_channels_per_beam", (PyCFunction)set_max_channels_per_beam,
+                METH_VARARGS, "set_max_channels_per_beam(value)"},
         {"set_max_sources_per_chunk", (PyCFunction)set_max_sources_per_chunk,
                 METH_VARARGS, "set_max_sources_per_chunk(value)"},
         {"set_max_times_per_block", (PyCFunction)set_max_times_per_block,
                 METH_VARARGS, "set_max_times_per_block(value)"},
         {"set_num_devices", (PyCFunction)set_num_devices,
                 METH_VARARGS, "set_num_devices(value)"},
+        {"set_num_threads_per_device",
+                (PyCFunction)set_num_threads_per_device,
+                METH_VARARGS, "set_num_threads_per_device(value)"},
         {"set_observation_frequency", (PyCFunction)set_observation_frequency,
                 METH_VARARGS,
                 "set_observation_frequency(start_freq_hz, inc_hz, "
@@ -653,6 +704,8 @@ static PyMethodDef methods[] =
                 METH_VARARGS, "set_settings_path(filename)"},
         {"set_sky_model", (PyCFunction)set_sky_model,
                 METH_VARARGS, "set_sky_model(sky)"},
+        {"set_sky_model_file", (PyCFunction)set_sky_model_file,
+                METH_VARARGS, "set_sky_model_file(filename)"},
         {"set_telescope_model", (PyCFunction)set_telescope_model,
                 METH_VARARGS, "set_telescope_model(telescope)"},
         {"set_zero_failed_gaussians", (PyCFunction)set_zero_failed_gaussians,